@@ -18,6 +18,13 @@ LOG_MODULE_REGISTER(wm8904, CONFIG_WM8904_LOG_LEVEL);
 
 #define DT_DRV_COMPAT cirrus_wm8904
 
+/* Register addresses are 8 bits */
+#define WM8904_REG_COUNT 256
+/* Register writes held in the cache before they are sent to the codec */
+#define WM8904_PENDING_MAX 16
+/* Registers written in a single I2C transfer */
+#define WM8904_BURST_MAX 8
+
 struct wm8904_data {
 	/* Cached configuration settings */
 	uint16_t dac_digital_settings;
@@ -34,6 +41,17 @@ struct wm8904_data {
 	/* Volume settings */
 	uint8_t hp_volume_left;
 	uint8_t hp_volume_right;
+	/* Shadow of the codec registers. A register is valid once it has been written or read
+	 * since the last reset, and dirty while its value is pending.
+	 */
+	uint16_t reg_cache[WM8904_REG_COUNT];
+	ATOMIC_DEFINE(reg_valid, WM8904_REG_COUNT);
+	ATOMIC_DEFINE(reg_dirty, WM8904_REG_COUNT);
+	/* Registers to write to the codec, in the order they were written to the cache */
+	uint8_t pending[WM8904_PENDING_MAX];
+	uint8_t pending_count;
+	/* Serialises access to the cache and the codec */
+	struct k_mutex lock;
 };
 
 /* Error handling is done directly in the functions */
@@ -66,7 +84,170 @@ static int cwm_i2c_rd(const struct i2c_dt_spec *spec, uint8_t reg_addr, uint16_t
 	return 0;
 }
 
+/* Registers that change by themselves or start an action when written, which are never cached */
+static bool cwm_reg_is_volatile(uint8_t reg)
+{
+	switch (reg) {
+	case WM8904_SW_RESET_AND_ID:
+	case WM8904_DC_SERVO_1:
+	case WM8904_WRITE_SEQUENCER_0:
+	case WM8094_WRITE_SEQUENCER_4:
+	case WM8904_INTERRUPT_STATUS:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* Forget all register values, as after a reset of the codec */
+static void cwm_reg_invalidate(const struct device *dev)
+{
+	struct wm8904_data *data = dev->data;
+
+	for (size_t i = 0; i < ARRAY_SIZE(data->reg_valid); i++) {
+		atomic_clear(&data->reg_valid[i]);
+		atomic_clear(&data->reg_dirty[i]);
+	}
+	data->pending_count = 0;
+}
+
+/**
+ * @brief Write the pending registers to the codec.
+ *
+ * Registers are written in the order they were written to the cache. Runs of consecutive
+ * registers are written in a single transfer, using the register address auto-increment of the
+ * control interface.
+ */
+static int cwm_reg_sync(const struct device *dev)
+{
+	const struct wm8904_driver_config *dev_cfg = dev->config;
+	struct wm8904_data *data = dev->data;
+	uint8_t buf[1 + (WM8904_BURST_MAX * sizeof(uint16_t))];
+	size_t i = 0;
+	int ret = 0;
+
+	while (i < data->pending_count) {
+		uint8_t const first = data->pending[i];
+		size_t count = 0;
+
+		buf[0] = first;
+
+		do {
+			uint16_t const value = data->reg_cache[first + count];
+
+			buf[1 + (count * 2)] = value >> 8;
+			buf[2 + (count * 2)] = value & 0xFF;
+			atomic_clear_bit(data->reg_dirty, first + count);
+			count++;
+			i++;
+		} while (IS_ENABLED(CONFIG_WM8904_I2C_BURST) && (i < data->pending_count) &&
+			 (count < WM8904_BURST_MAX) && (data->pending[i] == first + count));
+
+		ret = i2c_write_dt(&dev_cfg->i2c, buf, 1 + (count * sizeof(uint16_t)));
+		if (ret) {
+			break;
+		}
+	}
+
+	if (ret) {
+		/* The codec may or may not hold the values not written */
+		for (size_t j = 0; j < data->pending_count; j++) {
+			atomic_clear_bit(data->reg_dirty, data->pending[j]);
+			atomic_clear_bit(data->reg_valid, data->pending[j]);
+		}
+	}
+
+	data->pending_count = 0;
+
+	return ret;
+}
+
+/**
+ * @brief Write a register through the cache.
+ *
+ * The write is skipped if the register already holds the value, and is otherwise held until the
+ * next cwm_reg_sync. Writing a register again while it is pending first writes the pending value,
+ * so that the codec sees every value in the order written.
+ */
+static int cwm_reg_write(const struct device *dev, uint8_t reg, uint16_t value)
+{
+	const struct wm8904_driver_config *dev_cfg = dev->config;
+	struct wm8904_data *data = dev->data;
+	int ret;
+
+	if (cwm_reg_is_volatile(reg)) {
+		ret = cwm_reg_sync(dev);
+		if (ret) {
+			return ret;
+		}
+
+		return cwm_i2c_wr(&dev_cfg->i2c, reg, value);
+	}
+
+	if (atomic_test_bit(data->reg_valid, reg) && (data->reg_cache[reg] == value)) {
+		return 0;
+	}
+
+	if (atomic_test_bit(data->reg_dirty, reg) || (data->pending_count == WM8904_PENDING_MAX)) {
+		ret = cwm_reg_sync(dev);
+		if (ret) {
+			return ret;
+		}
+	}
+
+	data->reg_cache[reg] = value;
+	atomic_set_bit(data->reg_valid, reg);
+	atomic_set_bit(data->reg_dirty, reg);
+	data->pending[data->pending_count++] = reg;
+
+	return 0;
+}
+
+/* Write the pending registers, then give the codec time to act on them */
+static int cwm_reg_sync_and_sleep(const struct device *dev, int32_t ms)
+{
+	int ret = cwm_reg_sync(dev);
+
+	if (ret) {
+		return ret;
+	}
+
+	k_msleep(ms);
+
+	return 0;
+}
+
+/* Read a register from the cache, or from the codec if it is not cached */
+static int cwm_reg_read(const struct device *dev, uint8_t reg, uint16_t *value)
+{
+	const struct wm8904_driver_config *dev_cfg = dev->config;
+	struct wm8904_data *data = dev->data;
+	bool const cached = !cwm_reg_is_volatile(reg);
+	int ret;
+
+	if (cached && atomic_test_bit(data->reg_valid, reg)) {
+		*value = data->reg_cache[reg];
+		return 0;
+	}
+
+	/* The codec must see the writes before the read */
+	ret = cwm_reg_sync(dev);
+	if (ret) {
+		return ret;
+	}
+
+	ret = cwm_i2c_rd(&dev_cfg->i2c, reg, value);
+	if (ret) {
+		return ret;
+	}
+
+	if (cached) {
+		data->reg_cache[reg] = *value;
+		atomic_set_bit(data->reg_valid, reg);
+	}
 
+	return 0;
+}
 
 /* Configure audio interface format */
 static int cwm_configure_audio_interface(const struct device *dev, struct audio_codec_cfg *cfg)
@@ -136,8 +317,8 @@ static int cwm_configure_clock_rate(const struct device *dev, uint32_t rate)
 	return 0;
 }
 
-/* Configure the codec according to the provided configuration */
-static int cwm_configure(const struct device *dev, struct audio_codec_cfg *cfg)
+/* Store the configuration to apply on the next start, called with the lock held */
+static int cwm_configure_locked(const struct device *dev, struct audio_codec_cfg *cfg)
 {
 	struct wm8904_data *data = dev->data;
 	int ret;
@@ -217,39 +398,56 @@ static int cwm_configure(const struct device *dev, struct audio_codec_cfg *cfg)
 	return 0;
 }
 
-/* Start the codec output */
-static void cwm_start_output(const struct device *dev)
+/* Configure the codec according to the provided configuration */
+static int cwm_configure(const struct device *dev, struct audio_codec_cfg *cfg)
+{
+	struct wm8904_data *data = dev->data;
+
+	k_mutex_lock(&data->lock, K_FOREVER);
+
+	int const ret = cwm_configure_locked(dev, cfg);
+
+	k_mutex_unlock(&data->lock);
+
+	return ret;
+}
+
+/* Power up the codec outputs, called with the lock held */
+static void cwm_power_up(const struct device *dev)
 {
-	const struct wm8904_driver_config *dev_cfg = dev->config;
-	const struct i2c_dt_spec *i2c = &dev_cfg->i2c;
 	struct wm8904_data *data = dev->data;
 	int ret;
 
 	/* Program sample rate register(s) based on configuration */
-	ret = cwm_i2c_wr(i2c, WM8904_CLOCK_RATES_1, data->clock_rate);
+	ret = cwm_reg_write(dev, WM8904_CLOCK_RATES_1, data->clock_rate);
 	if (ret) {
 		LOG_ERR("Failed to set sample rate (clock rates 1): %d", ret);
 		return;
 	}
 
 	/* Set high performance bias and disable bias current generator */
-	ret = cwm_i2c_wr(i2c, WM8904_BIAS_CONTROL_0, BIAS_CNTL_ISEL_HP_BIAS);
+	ret = cwm_reg_write(dev, WM8904_BIAS_CONTROL_0, BIAS_CNTL_ISEL_HP_BIAS);
 	if (ret) {
 		LOG_ERR("Failed to set bias control: %d", ret);
 		return;
 	}
 
 	/* Enable VMID buffer to unused outputs, vmid reference voltage with fast startup */
-	ret = cwm_i2c_wr(i2c, WM8904_VMID_CONTROL_0,
+	ret = cwm_reg_write(dev, WM8904_VMID_CONTROL_0,
 		VMID_CNTL0_VMID_BUF_ENA | VMID_CNTL0_VMID_RES_FAST | VMID_CNTL0_VMID_ENA);
 	if (ret) {
 		LOG_ERR("Failed to enable VMID buffer: %d", ret);
 		return;
 	}
-	k_msleep(100); /* Delay for VMID startup */
+	/* Delay for VMID startup */
+	ret = cwm_reg_sync_and_sleep(dev, 100);
+	if (ret) {
+		LOG_ERR("Failed to write registers: %d", ret);
+		return;
+	}
 
 	/* VMID reference voltage setup with normal operation */
-	ret = cwm_i2c_wr(i2c, WM8904_VMID_CONTROL_0,
+	ret = cwm_reg_write(dev, WM8904_VMID_CONTROL_0,
 		VMID_CNTL0_VMID_BUF_ENA | VMID_CNTL0_VMID_RES_NORMAL | VMID_CNTL0_VMID_ENA);
 	if (ret) {
 		LOG_ERR("Failed to set VMID reference voltage: %d", ret);
@@ -257,7 +455,7 @@ static void cwm_start_output(const struct device *dev)
 	}
 
 	/* Enable bias current generator */
-	ret = cwm_i2c_wr(i2c, WM8904_BIAS_CONTROL_0,
+	ret = cwm_reg_write(dev, WM8904_BIAS_CONTROL_0,
 		BIAS_CNTL_ISEL_HP_BIAS | BIAS_CNTL_BIAS_ENA);
 	if (ret) {
 		LOG_ERR("Failed to enable bias current generator: %d", ret);
@@ -265,7 +463,7 @@ static void cwm_start_output(const struct device *dev)
 	}
 
 	/* Enable ADC left and right input programmable gain amplifiers */
-	ret = cwm_i2c_wr(i2c, WM8904_POWER_MANAGEMENT_0,
+	ret = cwm_reg_write(dev, WM8904_POWER_MANAGEMENT_0,
 		PWR_MGMT0_INL_ENA | PWR_MGMT0_INR_ENA);
 	if (ret) {
 		LOG_ERR("Failed to enable ADC input gain amplifiers: %d", ret);
@@ -273,7 +471,7 @@ static void cwm_start_output(const struct device *dev)
 	}
 
 	/* Enable left and right headphone output */
-	ret = cwm_i2c_wr(i2c, WM8904_POWER_MANAGEMENT_2,
+	ret = cwm_reg_write(dev, WM8904_POWER_MANAGEMENT_2,
 		PWR_MGMT2_HPL_PGA_ENA | PWR_MGMT2_HPR_PGA_ENA);
 	if (ret) {
 		LOG_ERR("Failed to enable headphone output: %d", ret);
@@ -281,7 +479,7 @@ static void cwm_start_output(const struct device *dev)
 	}
 
 	/* Configure DAC digital settings based on cached parameters */
-	ret = cwm_i2c_wr(i2c, WM8904_DAC_DIGITAL_1, data->dac_digital_settings);
+	ret = cwm_reg_write(dev, WM8904_DAC_DIGITAL_1, data->dac_digital_settings);
 	if (ret) {
 		LOG_ERR("Failed to configure DAC digital settings: %d", ret);
 		return;
@@ -290,21 +488,21 @@ static void cwm_start_output(const struct device *dev)
 	/* Configure output routing. Input select for left/right headphone and left/right line
 	 * output mux. No bypass used.
 	 */
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_OUT12_ZC, 0x0000);
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_OUT12_ZC, 0x0000);
 	if (ret) {
 		LOG_ERR("Failed to configure output routing: %d", ret);
 		return;
 	}
 
 	/* Enable charge pump digits. Adjusts output voltage to optimize power consumption */
-	ret = cwm_i2c_wr(i2c, WM8904_CHARGE_PUMP_0, CHRG_PMP_CP_ENA);
+	ret = cwm_reg_write(dev, WM8904_CHARGE_PUMP_0, CHRG_PMP_CP_ENA);
 	if (ret) {
 		LOG_ERR("Failed to enable charge pump: %d", ret);
 		return;
 	}
 
 	/* Enable dynamic charge pump power based on real time audio level */
-	ret = cwm_i2c_wr(i2c, WM8904_CHARGE_PUMP_0, CLS_W0_CP_DYN_PWR);
+	ret = cwm_reg_write(dev, WM8904_CHARGE_PUMP_0, CLS_W0_CP_DYN_PWR);
 	if (ret) {
 		LOG_ERR("Failed to enable dynamic charge pump power: %d", ret);
 		return;
@@ -359,14 +557,14 @@ static void cwm_start_output(const struct device *dev)
 	 * K = 0.0 --> register value is 0.0 * 65536 = 0
 	 */
 	/* Configure FLL for system clock */
-	ret = cwm_i2c_wr(i2c, WM8904_FLL_CONTROL_1, 0x0000);
+	ret = cwm_reg_write(dev, WM8904_FLL_CONTROL_1, 0x0000);
 	if (ret) {
 		LOG_ERR("Failed to configure FLL control 1: %d", ret);
 		return;
 	}
 
 	/* Configure FLL parameters using values from cwm_configure */
-	ret = cwm_i2c_wr(i2c, WM8904_FLL_CONTROL_2,
+	ret = cwm_reg_write(dev, WM8904_FLL_CONTROL_2,
 		FLL_C2_OUTDIV(data->fll_outdiv) |
 		(data->fll_fratio == 8 ? FLL_C2_FRATIO_DIV8 : 0));
 	if (ret) {
@@ -374,40 +572,45 @@ static void cwm_start_output(const struct device *dev)
 		return;
 	}
 
-	ret = cwm_i2c_wr(i2c, WM8904_FLL_CONTROL_3, FLL_C3_K(data->fll_k));
+	ret = cwm_reg_write(dev, WM8904_FLL_CONTROL_3, FLL_C3_K(data->fll_k));
 	if (ret) {
 		LOG_ERR("Failed to configure FLL control 3: %d", ret);
 		return;
 	}
 
-	ret = cwm_i2c_wr(i2c, WM8904_FLL_CONTROL_4, FLL_C4_N(data->fll_n));
+	ret = cwm_reg_write(dev, WM8904_FLL_CONTROL_4, FLL_C4_N(data->fll_n));
 	if (ret) {
 		LOG_ERR("Failed to configure FLL control 4: %d", ret);
 		return;
 	}
 
-	ret = cwm_i2c_wr(i2c, WM8904_FLL_CONTROL_5, FLL_C5_CLK_REF_SRC_BCLK);
+	ret = cwm_reg_write(dev, WM8904_FLL_CONTROL_5, FLL_C5_CLK_REF_SRC_BCLK);
 	if (ret) {
 		LOG_ERR("Failed to configure FLL control 5: %d", ret);
 		return;
 	}
 
-	ret = cwm_i2c_wr(i2c, WM8904_FLL_CONTROL_1, FLL_C1_FRACN_ENA | FLL_C1_FLL_ENA);
+	ret = cwm_reg_write(dev, WM8904_FLL_CONTROL_1, FLL_C1_FRACN_ENA | FLL_C1_FLL_ENA);
 	if (ret) {
 		LOG_ERR("Failed to enable FLL: %d", ret);
 		return;
 	}
-	k_msleep(5); /* Delay for FLL startup */
+	/* Delay for FLL startup */
+	ret = cwm_reg_sync_and_sleep(dev, 5);
+	if (ret) {
+		LOG_ERR("Failed to write registers: %d", ret);
+		return;
+	}
 
 	/* Apply sample rate configuration */
-	ret = cwm_i2c_wr(i2c, WM8904_CLOCK_RATES_0, data->clock_rate);
+	ret = cwm_reg_write(dev, WM8904_CLOCK_RATES_0, data->clock_rate);
 	if (ret) {
 		LOG_ERR("Failed to configure sample rate: %d", ret);
 		return;
 	}
 
 	/* Set SYSCLK source to FLL output, Enable system clock, DSP clock enable */
-	ret = cwm_i2c_wr(i2c, WM8904_CLOCK_RATES_2,
+	ret = cwm_reg_write(dev, WM8904_CLOCK_RATES_2,
 		CLK_RTE2_SYSCLK_SRC | CLK_RTE2_CLK_SYS_ENA | CLK_RTE2_CLK_DSP_ENA);
 	if (ret) {
 		LOG_ERR("Failed to configure system clock source: %d", ret);
@@ -415,19 +618,19 @@ static void cwm_start_output(const struct device *dev)
 	}
 
 	/* Apply audio interface format configuration */
-	ret = cwm_i2c_wr(i2c, WM8904_AUDIO_INTERFACE_1, data->aif_format);
+	ret = cwm_reg_write(dev, WM8904_AUDIO_INTERFACE_1, data->aif_format);
 	if (ret) {
 		LOG_ERR("Failed to configure audio interface format: %d", ret);
 		return;
 	}
 
 	/* Set up IN2L and IN2R as the ADC inputs, Single ended mode(default) */
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_LEFT_INPUT_1, ANLG_LIN1_IP_SEL_N_IN2L);
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_LEFT_INPUT_1, ANLG_LIN1_IP_SEL_N_IN2L);
 	if (ret) {
 		LOG_ERR("Failed to configure left input: %d", ret);
 		return;
 	}
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_RIGHT_INPUT_1, ANLG_RIN1_IP_SEL_N_IN2R);
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_RIGHT_INPUT_1, ANLG_RIN1_IP_SEL_N_IN2R);
 	if (ret) {
 		LOG_ERR("Failed to configure right input: %d", ret);
 		return;
@@ -436,13 +639,13 @@ static void cwm_start_output(const struct device *dev)
 	/* Configure mono/stereo mode */
 	if (data->is_mono) {
 		/* Send left input to both DACs */
-		ret = cwm_i2c_wr(i2c, WM8904_AUDIO_INTERFACE_0, 0);
+		ret = cwm_reg_write(dev, WM8904_AUDIO_INTERFACE_0, 0);
 		if (ret) {
 			LOG_ERR("Failed to configure mono mode: %d", ret);
 			return;
 		}
 	} else {
-		ret = cwm_i2c_wr(i2c, WM8904_AUDIO_INTERFACE_0,
+		ret = cwm_reg_write(dev, WM8904_AUDIO_INTERFACE_0,
 			AUD_INT0_AIFADCR_SRC | AUD_INT0_AIFDACR_SRC);
 		if (ret) {
 			LOG_ERR("Failed to configure stereo mode: %d", ret);
@@ -451,22 +654,27 @@ static void cwm_start_output(const struct device *dev)
 	}
 
 	/* Enable DAC and ADC */
-	ret = cwm_i2c_wr(i2c, WM8904_POWER_MANAGEMENT_6,
+	ret = cwm_reg_write(dev, WM8904_POWER_MANAGEMENT_6,
 		PWR_MGMT6_DACL_ENA | PWR_MGMT6_DACR_ENA | PWR_MGMT6_ADCL_ENA | PWR_MGMT6_ADCR_ENA);
 	if (ret) {
 		LOG_ERR("Failed to enable DAC and ADC: %d", ret);
 		return;
 	}
-	k_msleep(5); /* Delay for DAC/ADC startup */
+	/* Delay for DAC/ADC startup */
+	ret = cwm_reg_sync_and_sleep(dev, 5);
+	if (ret) {
+		LOG_ERR("Failed to write registers: %d", ret);
+		return;
+	}
 
 	/* Unmute analog input PGA and use 0dB default volume */
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_LEFT_INPUT_0, ANLG_LIN0_VOL(0x05));
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_LEFT_INPUT_0, ANLG_LIN0_VOL(0x05));
 	if (ret) {
 		LOG_ERR("Failed to set left input volume: %d", ret);
 		return;
 	}
 
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_RIGHT_INPUT_0, ANLG_RIN0_VOL(0x05));
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_RIGHT_INPUT_0, ANLG_RIN0_VOL(0x05));
 	if (ret) {
 		LOG_ERR("Failed to set right input volume: %d", ret);
 		return;
@@ -474,14 +682,14 @@ static void cwm_start_output(const struct device *dev)
 
 	/* Enable headphone output stages in sequence */
 	/* Enable input stage of headphones */
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_HP_0, ANLG_HP0_HPL_ENA | ANLG_HP0_HPR_ENA);
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_HP_0, ANLG_HP0_HPL_ENA | ANLG_HP0_HPR_ENA);
 	if (ret) {
 		LOG_ERR("Failed to enable headphone input stage: %d", ret);
 		return;
 	}
 
 	/* Enable intermediate stage of headphones */
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_HP_0,
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_HP_0,
 		ANLG_HP0_HPL_ENA |
 		ANLG_HP0_HPR_ENA |
 		ANLG_HP0_HPL_ENA_DLY |
@@ -492,7 +700,7 @@ static void cwm_start_output(const struct device *dev)
 	}
 
 	/* Enable DC servo channels */
-	ret = cwm_i2c_wr(i2c, WM8904_DC_SERVO_0,
+	ret = cwm_reg_write(dev, WM8904_DC_SERVO_0,
 		DC_SRV0_DCS_ENA_CHAN_0 | DC_SRV0_DCS_ENA_CHAN_1 |
 		DC_SRV0_DCS_ENA_CHAN_2 | DC_SRV0_DCS_ENA_CHAN_3);
 	if (ret) {
@@ -501,17 +709,22 @@ static void cwm_start_output(const struct device *dev)
 	}
 
 	/* Enable DC servo startup mode */
-	ret = cwm_i2c_wr(i2c, WM8904_DC_SERVO_1,
+	ret = cwm_reg_write(dev, WM8904_DC_SERVO_1,
 		DC_SRV1_DCS_TRIG_STARTUP_0 | DC_SRV1_DCS_TRIG_STARTUP_1 |
 		DC_SRV1_DCS_TRIG_STARTUP_2 | DC_SRV1_DCS_TRIG_STARTUP_3);
 	if (ret) {
 		LOG_ERR("Failed to enable DC servo startup mode: %d", ret);
 		return;
 	}
-	k_msleep(100); /* Delay for DC servo startup */
+	/* Delay for DC servo startup */
+	ret = cwm_reg_sync_and_sleep(dev, 100);
+	if (ret) {
+		LOG_ERR("Failed to write registers: %d", ret);
+		return;
+	}
 
 	/* Enable output stage of headphones */
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_HP_0,
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_HP_0,
 		ANLG_HP0_HPL_ENA_OUTP | ANLG_HP0_HPR_ENA_OUTP |
 		ANLG_HP0_HPL_ENA_DLY | ANLG_HP0_HPR_ENA_DLY |
 		ANLG_HP0_HPL_ENA | ANLG_HP0_HPR_ENA);
@@ -521,7 +734,7 @@ static void cwm_start_output(const struct device *dev)
 	}
 
 	/* Remove shorts from headphone outputs */
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_HP_0,
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_HP_0,
 		ANLG_HP0_HPL_ENA_OUTP | ANLG_HP0_HPR_ENA_OUTP |
 		ANLG_HP0_HPL_ENA_DLY | ANLG_HP0_HPR_ENA_DLY |
 		ANLG_HP0_HPL_ENA | ANLG_HP0_HPR_ENA |
@@ -532,32 +745,37 @@ static void cwm_start_output(const struct device *dev)
 	}
 
 	/* Set headphone volume (both channels) */
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_OUT1_LEFT,
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_OUT1_LEFT,
 		ANLG_OUT1_HPOUTL_VU | data->hp_volume_left);
 	if (ret) {
 		LOG_ERR("Failed to set left headphone volume: %d", ret);
 		return;
 	}
 
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_OUT1_RIGHT,
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_OUT1_RIGHT,
 		ANLG_OUT1_HPOUTR_VU | data->hp_volume_right);
 	if (ret) {
 		LOG_ERR("Failed to set right headphone volume: %d", ret);
 		return;
 	}
 
-	k_msleep(100); /* Delay for volume setting to take effect */
+	/* Delay for volume setting to take effect */
+	ret = cwm_reg_sync_and_sleep(dev, 100);
+	if (ret) {
+		LOG_ERR("Failed to write registers: %d", ret);
+		return;
+	}
 
 	/* Unmute DAC digital path */
 	uint16_t current_dac_settings;
 
-	ret = cwm_i2c_rd(i2c, WM8904_DAC_DIGITAL_1, &current_dac_settings);
+	ret = cwm_reg_read(dev, WM8904_DAC_DIGITAL_1, &current_dac_settings);
 	if (ret) {
 		LOG_ERR("Failed to read current DAC settings: %d", ret);
 		return;
 	}
 	current_dac_settings &= ~DAC_DG1_MUTE;
-	ret = cwm_i2c_wr(i2c, WM8904_DAC_DIGITAL_1, current_dac_settings);
+	ret = cwm_reg_write(dev, WM8904_DAC_DIGITAL_1, current_dac_settings);
 	if (ret) {
 		LOG_ERR("Failed to unmute DAC: %d", ret);
 		return;
@@ -566,13 +784,13 @@ static void cwm_start_output(const struct device *dev)
 	/* Unmute headphone left output */
 	uint16_t current_hpoutl_settings;
 
-	ret = cwm_i2c_rd(i2c, WM8904_ANALOGUE_OUT1_LEFT, &current_hpoutl_settings);
+	ret = cwm_reg_read(dev, WM8904_ANALOGUE_OUT1_LEFT, &current_hpoutl_settings);
 	if (ret) {
 		LOG_ERR("Failed to read current headphone left settings: %d", ret);
 		return;
 	}
 	current_hpoutl_settings &= ~ANLG_OUT1_HPOUTL_MUTE;
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_OUT1_LEFT, current_hpoutl_settings);
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_OUT1_LEFT, current_hpoutl_settings);
 	if (ret) {
 		LOG_ERR("Failed to unmute headphone left output: %d", ret);
 		return;
@@ -581,36 +799,38 @@ static void cwm_start_output(const struct device *dev)
 	/* Unmute headphone right output */
 	uint16_t current_hpoutr_settings;
 
-	ret = cwm_i2c_rd(i2c, WM8904_ANALOGUE_OUT1_RIGHT, &current_hpoutr_settings);
+	ret = cwm_reg_read(dev, WM8904_ANALOGUE_OUT1_RIGHT, &current_hpoutr_settings);
 	if (ret) {
 		LOG_ERR("Failed to read current headphone right settings: %d", ret);
 		return;
 	}
 	current_hpoutr_settings &= ~ANLG_OUT1_HPOUTR_MUTE;
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_OUT1_RIGHT, current_hpoutr_settings);
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_OUT1_RIGHT, current_hpoutr_settings);
 	if (ret) {
 		LOG_ERR("Failed to unmute headphone right output: %d", ret);
 		return;
 	}
 
 	/* Add small delay to allow outputs to settle */
-	k_msleep(5);
+	ret = cwm_reg_sync_and_sleep(dev, 5);
+	if (ret) {
+		LOG_ERR("Failed to write registers: %d", ret);
+		return;
+	}
 
 	LOG_DBG("Started");
 }
 
-/* Stop the codec output for power saving, allowing later reconfiguration and restart */
-static void cwm_stop_output(const struct device *dev)
+/* Power down the codec outputs, called with the lock held */
+static void cwm_power_down(const struct device *dev)
 {
-	const struct wm8904_driver_config *dev_cfg = dev->config;
-	const struct i2c_dt_spec *i2c = &dev_cfg->i2c;
 	int ret;
 
 	/* 1. Mute DAC outputs first to prevent pops while preserving other settings */
 	/* Mute DAC digital path */
 	uint16_t current_dac_settings;
 
-	ret = cwm_i2c_rd(i2c, WM8904_DAC_DIGITAL_1, &current_dac_settings);
+	ret = cwm_reg_read(dev, WM8904_DAC_DIGITAL_1, &current_dac_settings);
 	if (ret) {
 		LOG_ERR("Failed to read current DAC settings: %d", ret);
 		return;
@@ -618,7 +838,7 @@ static void cwm_stop_output(const struct device *dev)
 
 	current_dac_settings |= DAC_DG1_MUTE;
 
-	ret = cwm_i2c_wr(i2c, WM8904_DAC_DIGITAL_1, current_dac_settings);
+	ret = cwm_reg_write(dev, WM8904_DAC_DIGITAL_1, current_dac_settings);
 	if (ret) {
 		LOG_ERR("Failed to mute DAC: %d", ret);
 		return;
@@ -627,7 +847,7 @@ static void cwm_stop_output(const struct device *dev)
 	/* Mute headphone left output */
 	uint16_t current_hpoutl_settings;
 
-	ret = cwm_i2c_rd(i2c, WM8904_ANALOGUE_OUT1_LEFT, &current_hpoutl_settings);
+	ret = cwm_reg_read(dev, WM8904_ANALOGUE_OUT1_LEFT, &current_hpoutl_settings);
 	if (ret) {
 		LOG_ERR("Failed to read current headphone left settings: %d", ret);
 		return;
@@ -635,7 +855,7 @@ static void cwm_stop_output(const struct device *dev)
 
 	current_hpoutl_settings |= ANLG_OUT1_HPOUTL_MUTE;
 
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_OUT1_LEFT, current_hpoutl_settings);
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_OUT1_LEFT, current_hpoutl_settings);
 	if (ret) {
 		LOG_ERR("Failed to mute headphone left output: %d", ret);
 		return;
@@ -644,7 +864,7 @@ static void cwm_stop_output(const struct device *dev)
 	/* Mute headphone right output */
 	uint16_t current_hpoutr_settings;
 
-	ret = cwm_i2c_rd(i2c, WM8904_ANALOGUE_OUT1_RIGHT, &current_hpoutr_settings);
+	ret = cwm_reg_read(dev, WM8904_ANALOGUE_OUT1_RIGHT, &current_hpoutr_settings);
 	if (ret) {
 		LOG_ERR("Failed to read current headphone right settings: %d", ret);
 		return;
@@ -652,18 +872,22 @@ static void cwm_stop_output(const struct device *dev)
 
 	current_hpoutr_settings |= ANLG_OUT1_HPOUTR_MUTE;
 
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_OUT1_RIGHT, current_hpoutr_settings);
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_OUT1_RIGHT, current_hpoutr_settings);
 	if (ret) {
 		LOG_ERR("Failed to mute headphone right output: %d", ret);
 		return;
 	}
 
 	/* Allow mute to take effect */
-	k_msleep(2);
+	ret = cwm_reg_sync_and_sleep(dev, 2);
+	if (ret) {
+		LOG_ERR("Failed to write registers: %d", ret);
+		return;
+	}
 
 	/* Safely power down headphone outputs according to spec v4.1 */
 	/* Re-apply shorts to headphone outputs (removing RMV_SHORT flags) */
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_HP_0,
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_HP_0,
 		ANLG_HP0_HPL_ENA_OUTP | ANLG_HP0_HPR_ENA_OUTP |
 		ANLG_HP0_HPL_ENA_DLY | ANLG_HP0_HPR_ENA_DLY |
 		ANLG_HP0_HPL_ENA | ANLG_HP0_HPR_ENA);
@@ -673,7 +897,7 @@ static void cwm_stop_output(const struct device *dev)
 	}
 
 	/* Disable output stage of headphones */
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_HP_0,
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_HP_0,
 		ANLG_HP0_HPL_ENA_DLY | ANLG_HP0_HPR_ENA_DLY |
 		ANLG_HP0_HPL_ENA | ANLG_HP0_HPR_ENA);
 	if (ret) {
@@ -682,7 +906,7 @@ static void cwm_stop_output(const struct device *dev)
 	}
 
 	/* Disable intermediate stage of headphones */
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_HP_0,
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_HP_0,
 		ANLG_HP0_HPL_ENA | ANLG_HP0_HPR_ENA);
 	if (ret) {
 		LOG_ERR("Failed to disable headphone intermediate stage: %d", ret);
@@ -690,66 +914,88 @@ static void cwm_stop_output(const struct device *dev)
 	}
 
 	/* Disable input stage of headphones */
-	ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_HP_0, 0);
+	ret = cwm_reg_write(dev, WM8904_ANALOGUE_HP_0, 0);
 	if (ret) {
 		LOG_ERR("Failed to disable headphone input stage: %d", ret);
 		return;
 	}
 
 	/* Disable DAC and ADC to save power */
-	ret = cwm_i2c_wr(i2c, WM8904_POWER_MANAGEMENT_6, 0);
+	ret = cwm_reg_write(dev, WM8904_POWER_MANAGEMENT_6, 0);
 	if (ret) {
 		LOG_ERR("Failed to disable DAC and ADC: %d", ret);
 		return;
 	}
 
 	/* Disable clocks to save power */
-	ret = cwm_i2c_wr(i2c, WM8904_CLOCK_RATES_2, 0);
+	ret = cwm_reg_write(dev, WM8904_CLOCK_RATES_2, 0);
 	if (ret) {
 		LOG_ERR("Failed to disable clocks: %d", ret);
 		return;
 	}
 
 	/* Disable FLL if it was enabled */
-	ret = cwm_i2c_wr(i2c, WM8904_FLL_CONTROL_1, 0);
+	ret = cwm_reg_write(dev, WM8904_FLL_CONTROL_1, 0);
 	if (ret) {
 		LOG_ERR("Failed to disable FLL: %d", ret);
 		return;
 	}
 
 	/* Disable charge pump */
-	ret = cwm_i2c_wr(i2c, WM8904_CHARGE_PUMP_0, 0);
+	ret = cwm_reg_write(dev, WM8904_CHARGE_PUMP_0, 0);
 	if (ret) {
 		LOG_ERR("Failed to disable charge pump: %d", ret);
 		return;
 	}
 
 	/* Disable VMID */
-	ret = cwm_i2c_wr(i2c, WM8904_VMID_CONTROL_0, 0);
+	ret = cwm_reg_write(dev, WM8904_VMID_CONTROL_0, 0);
 	if (ret) {
 		LOG_ERR("Failed to disable VMID: %d", ret);
 		return;
 	}
 
 	/* Disable bias generator */
-	ret = cwm_i2c_wr(i2c, WM8904_BIAS_CONTROL_0, 0);
+	ret = cwm_reg_write(dev, WM8904_BIAS_CONTROL_0, 0);
 	if (ret) {
 		LOG_ERR("Failed to disable bias generator: %d", ret);
 		return;
 	}
 
 	/* Add small delay to allow outputs to settle */
-	k_msleep(5);
+	ret = cwm_reg_sync_and_sleep(dev, 5);
+	if (ret) {
+		LOG_ERR("Failed to write registers: %d", ret);
+		return;
+	}
 
 	LOG_DBG("Stopped");
 }
 
-/* Set a codec property */
-static int cwm_set_property(const struct device *dev, audio_property_t property,
-			       audio_channel_t channel, audio_property_value_t val)
+/* Start the codec output */
+static void cwm_start_output(const struct device *dev)
+{
+	struct wm8904_data *data = dev->data;
+
+	k_mutex_lock(&data->lock, K_FOREVER);
+	cwm_power_up(dev);
+	k_mutex_unlock(&data->lock);
+}
+
+/* Stop the codec output for power saving, allowing later reconfiguration and restart */
+static void cwm_stop_output(const struct device *dev)
+{
+	struct wm8904_data *data = dev->data;
+
+	k_mutex_lock(&data->lock, K_FOREVER);
+	cwm_power_down(dev);
+	k_mutex_unlock(&data->lock);
+}
+
+/* Set a codec property, called with the lock held */
+static int cwm_set_property_locked(const struct device *dev, audio_property_t property,
+				   audio_channel_t channel, audio_property_value_t val)
 {
-	const struct wm8904_driver_config *dev_cfg = dev->config;
-	const struct i2c_dt_spec *i2c = &dev_cfg->i2c;
 	struct wm8904_data *data = dev->data;
 	int ret;
 
@@ -764,8 +1010,9 @@ static int cwm_set_property(const struct device *dev, audio_property_t property,
 		uint16_t const volume = ANLG_OUT1_HPOUTL_VOL(val.vol >> 1);
 		bool const both = channel == AUDIO_CHANNEL_ALL;
 
+		/* Both channels are written in a single transfer, as the registers are adjacent */
 		if (both || channel == AUDIO_CHANNEL_FRONT_LEFT) {
-			ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_OUT1_LEFT,
+			ret = cwm_reg_write(dev, WM8904_ANALOGUE_OUT1_LEFT,
 				ANLG_OUT1_HPOUTL_VU | volume);
 			if (ret) {
 				LOG_ERR("Failed to set left headphone volume: %d", ret);
@@ -775,7 +1022,7 @@ static int cwm_set_property(const struct device *dev, audio_property_t property,
 			data->hp_volume_left = volume;
 		}
 		if (both || channel == AUDIO_CHANNEL_FRONT_RIGHT) {
-			ret = cwm_i2c_wr(i2c, WM8904_ANALOGUE_OUT1_RIGHT,
+			ret = cwm_reg_write(dev, WM8904_ANALOGUE_OUT1_RIGHT,
 				ANLG_OUT1_HPOUTR_VU | volume);
 			if (ret) {
 				LOG_ERR("Failed to set right headphone volume: %d", ret);
@@ -789,7 +1036,7 @@ static int cwm_set_property(const struct device *dev, audio_property_t property,
 	}
 
 	case AUDIO_PROPERTY_OUTPUT_MUTE:
-		ret = cwm_i2c_wr(i2c, WM8904_DAC_DIGITAL_1,
+		ret = cwm_reg_write(dev, WM8904_DAC_DIGITAL_1,
 				 data->dac_digital_settings | (val.mute ? DAC_DG1_MUTE : 0));
 		if (ret) {
 			LOG_ERR("Failed to set mute state: %d", ret);
@@ -801,7 +1048,27 @@ static int cwm_set_property(const struct device *dev, audio_property_t property,
 		return -EINVAL;
 	}
 
-	return 0;
+	ret = cwm_reg_sync(dev);
+	if (ret) {
+		LOG_ERR("Failed to write property %d: %d", property, ret);
+	}
+
+	return ret;
+}
+
+/* Set a codec property */
+static int cwm_set_property(const struct device *dev, audio_property_t property,
+			       audio_channel_t channel, audio_property_value_t val)
+{
+	struct wm8904_data *data = dev->data;
+
+	k_mutex_lock(&data->lock, K_FOREVER);
+
+	int const ret = cwm_set_property_locked(dev, property, channel, val);
+
+	k_mutex_unlock(&data->lock);
+
+	return ret;
 }
 
 /* Apply any cached properties */
@@ -843,6 +1110,8 @@ int cwm_init(const struct device *dev)
 
 	LOG_DBG("Initializing");
 
+	k_mutex_init(&data->lock);
+
 	/* Reset device and then read ID */
 	ret = cwm_i2c_wr(i2c, WM8904_SW_RESET_AND_ID, 0xFFFF);
 	if (ret) {
@@ -850,6 +1119,9 @@ int cwm_init(const struct device *dev)
 		return ret;
 	}
 
+	/* Registers are cached as they are written or read from now on */
+	cwm_reg_invalidate(dev);
+
 	/* Verify I2C device is responsive */
 	ret = cwm_i2c_rd(i2c, WM8904_SW_RESET_AND_ID, &dev_id);
 	if (ret) {
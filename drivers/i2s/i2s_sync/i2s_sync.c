@@ -21,6 +21,7 @@
 #include <soc_common.h>
 
 #include "i2s_sync_int.h"
+#include "i2s_sync_stats.h"
 
 LOG_MODULE_REGISTER(i2s_sync, CONFIG_I2S_SYNC_LOG_LEVEL);
 
@@ -41,23 +42,59 @@ LOG_MODULE_REGISTER(i2s_sync, CONFIG_I2S_SYNC_LOG_LEVEL);
 #define INT_RAMFUNC
 #endif
 
+/* Blocks queued behind the one being transferred */
+#define QUEUE_CAPACITY (CONFIG_I2S_SYNC_QUEUE_DEPTH - 1)
+
+struct i2s_sync_block {
+	void *buf;
+	size_t len;
+};
+
 struct i2s_sync_channel {
 	i2s_sync_cb_t cb;
+	/* Block being transferred, NULL if idle */
 	void *buf;
 	size_t block_bytes;
 	size_t samples;
 	size_t count;
 	size_t idx;
+	struct i2s_sync_block queue[MAX(QUEUE_CAPACITY, 1)];
+	uint8_t queue_head;
+	uint8_t queue_count;
+	/* Queued blocks linked behind the one being transferred in the running DMA transfer */
+	uint8_t dma_linked;
+	struct dma_block_config dma_blocks[CONFIG_I2S_SYNC_QUEUE_DEPTH];
+	uint32_t underruns;
 	bool overrun;
 	bool running;
+#ifdef CONFIG_I2S_SYNC_STATS
+	struct i2s_sync_chn_stats stats;
+#endif
+#ifdef CONFIG_I2S_SYNC_STREAM
+	/* Ring buffer of the running stream, stream.buf is NULL when not streaming */
+	struct i2s_sync_stream_config stream;
+	size_t period_bytes;
+	/* Period being transferred */
+	uint8_t period;
+	struct dma_block_config stream_blocks[CONFIG_I2S_SYNC_STREAM_MAX_PERIODS];
+#endif
 };
 
 struct i2s_sync_data {
 	struct i2s_sync_channel tx;
 	struct i2s_sync_channel rx;
+	struct k_spinlock lock;
 	uint32_t sample_rate;
 	uint32_t bit_depth;
 	uint8_t channel_count;
+	uint8_t slots;
+	uint8_t tx_slot_mask;
+	uint8_t rx_slot_mask;
+	enum i2s_sync_layout layout;
+	/* Slots transferred in each direction and buffer layout, resolved from the above */
+	uint8_t tx_mask;
+	uint8_t rx_mask;
+	bool planar;
 };
 
 struct i2s_sync_dma_ch {
@@ -103,22 +140,303 @@ static int i2s_register_cb(const struct device *dev, enum i2s_dir dir, i2s_sync_
 	return 0;
 }
 
+/* Size in the buffers of a frame of the given slots */
+INT_RAMFUNC static inline size_t frame_bytes(const struct i2s_sync_data *const dev_data,
+					     uint8_t const mask)
+{
+	return __builtin_popcount(mask) * i2s_sync_sample_bytes(dev_data->bit_depth);
+}
+
+/* Index in the buffer of a channel of a frame */
+INT_RAMFUNC static inline size_t sample_index(const struct i2s_sync_data *const dev_data,
+					      const struct i2s_sync_channel *const chn,
+					      size_t const frame, size_t const channel,
+					      size_t const channels)
+{
+	if (dev_data->planar) {
+		return (channel * (chn->samples / channels)) + frame;
+	}
+
+	return (frame * channels) + channel;
+}
+
+INT_RAMFUNC static inline uint32_t buf_read(const void *const buf, size_t const idx,
+					    size_t const sample_bytes)
+{
+	if (sample_bytes == sizeof(int16_t)) {
+		return (uint32_t)((const int16_t *)buf)[idx];
+	}
+
+	return ((const uint32_t *)buf)[idx];
+}
+
+INT_RAMFUNC static inline void buf_write(void *const buf, size_t const idx,
+					 size_t const sample_bytes, uint32_t const value)
+{
+	if (sample_bytes == sizeof(int16_t)) {
+		((int16_t *)buf)[idx] = (int16_t)value;
+	} else {
+		((uint32_t *)buf)[idx] = value;
+	}
+}
+
+INT_RAMFUNC static int channel_queue_block(struct i2s_sync_channel *const chn, void *const buf,
+					   size_t const len)
+{
+	if (chn->queue_count == QUEUE_CAPACITY) {
+		return -EINPROGRESS;
+	}
+
+	struct i2s_sync_block *const block =
+		&chn->queue[(chn->queue_head + chn->queue_count) % ARRAY_SIZE(chn->queue)];
+
+	block->buf = buf;
+	block->len = len;
+	chn->queue_count++;
+
+	return 0;
+}
+
+/* Make the next queued block, if any, the block being transferred */
+INT_RAMFUNC static bool channel_next_block(struct i2s_sync_channel *const chn,
+					   size_t const bytes_per_sample)
+{
+	chn->samples = 0;
+	chn->count = 0;
+	chn->idx = 0;
+
+	if (!chn->queue_count) {
+		chn->buf = NULL;
+		return false;
+	}
+
+	struct i2s_sync_block const *const block = &chn->queue[chn->queue_head];
+
+	chn->queue_head = (chn->queue_head + 1) % ARRAY_SIZE(chn->queue);
+	chn->queue_count--;
+	chn->buf = block->buf;
+	chn->block_bytes = block->len;
+	chn->samples = block->len / bytes_per_sample;
+
+	return true;
+}
+
+/* Called after the completion callback. If the callback did not provide a block either, the
+ * transfer has stopped while the direction is still enabled.
+ */
+INT_RAMFUNC static void channel_check_underrun(struct i2s_sync_data *const dev_data,
+					       struct i2s_sync_channel *const chn)
+{
+	k_spinlock_key_t const key = k_spin_lock(&dev_data->lock);
+
+	if (chn->running && !chn->buf) {
+		chn->underruns++;
+		i2s_sync_stats_underrun(I2S_SYNC_CHN_STATS(chn));
+	}
+
+	k_spin_unlock(&dev_data->lock, key);
+}
+
+/* Count an overrun reported by the interrupt */
+INT_RAMFUNC static void channel_count_overrun(struct i2s_sync_data *const dev_data,
+					      struct i2s_sync_channel *const chn)
+{
+	if (!IS_ENABLED(CONFIG_I2S_SYNC_STATS)) {
+		return;
+	}
+
+	k_spinlock_key_t const key = k_spin_lock(&dev_data->lock);
+
+	i2s_sync_stats_overrun(I2S_SYNC_CHN_STATS(chn));
+
+	k_spin_unlock(&dev_data->lock, key);
+}
+
+/* Blocks accepted and not yet completed, including the one being transferred */
+INT_RAMFUNC static inline uint8_t channel_queued(const struct i2s_sync_channel *const chn)
+{
+	return !!chn->buf + chn->queue_count;
+}
+
+/* Drop the blocks queued behind a failed transfer, they would otherwise never be started */
+INT_RAMFUNC static void channel_abort_blocks(struct i2s_sync_channel *const chn)
+{
+	chn->buf = NULL;
+	chn->queue_count = 0;
+	chn->dma_linked = 0;
+}
+
+/* Describe the block being transferred and every block queued behind it as one chain of DMA
+ * blocks, so that the controller moves on to the queued blocks by itself. Blocks queued after the
+ * transfer has started cannot be added to it, they are linked when the chain has completed.
+ * Returns the number of blocks in the chain.
+ */
+INT_RAMFUNC static uint32_t channel_link_dma_blocks(struct i2s_sync_channel *const chn,
+						   bool const tx, uint32_t const fifo)
+{
+	uint32_t const count = 1 + chn->queue_count;
+
+	for (uint32_t i = 0; i < count; i++) {
+		void *buf = chn->buf;
+		size_t len = chn->block_bytes;
+
+		if (i) {
+			struct i2s_sync_block const *const queued =
+				&chn->queue[(chn->queue_head + i - 1) % ARRAY_SIZE(chn->queue)];
+
+			buf = queued->buf;
+			len = queued->len;
+		}
+
+#if CONFIG_DCACHE
+		if (tx) {
+			sys_cache_data_flush_and_invd_range(buf, len);
+		}
+#endif
+
+		chn->dma_blocks[i] = (struct dma_block_config){
+			.source_address = tx ? POINTER_TO_UINT(buf) : fifo,
+			.dest_address = tx ? fifo : POINTER_TO_UINT(buf),
+			.block_size = len,
+			.source_addr_adj = tx ? DMA_ADDR_ADJ_INCREMENT : DMA_ADDR_ADJ_NO_CHANGE,
+			.dest_addr_adj = tx ? DMA_ADDR_ADJ_NO_CHANGE : DMA_ADDR_ADJ_INCREMENT,
+			.next_block = (i + 1 < count) ? &chn->dma_blocks[i + 1] : NULL,
+		};
+	}
+
+	chn->dma_linked = count - 1;
+
+	return count;
+}
+
+/* Move on to the next block after a DMA block has completed. Returns true if it has to be started,
+ * false if it was linked into the running transfer or there is none.
+ */
+INT_RAMFUNC static bool channel_next_dma_block(struct i2s_sync_channel *const chn,
+					       size_t const bytes_per_sample)
+{
+	if (!channel_next_block(chn, bytes_per_sample)) {
+		chn->dma_linked = 0;
+		return false;
+	}
+
+	if (chn->dma_linked) {
+		chn->dma_linked--;
+		return false;
+	}
+
+	return true;
+}
+
+#ifdef CONFIG_I2S_SYNC_STREAM
+INT_RAMFUNC static inline bool channel_is_streaming(const struct i2s_sync_channel *const chn)
+{
+	return chn->stream.buf != NULL;
+}
+
+/* Move on to the next period of the ring buffer, and pass the one that completed to the
+ * application. A TX period refilled by the callback is written back before the DMA reads it again.
+ * The timestamp is the cycle count read on entry to the interrupt, unless the application gave a
+ * clock of its own to read.
+ */
+INT_RAMFUNC static void channel_stream_period_done(const struct device *dev,
+						   struct i2s_sync_channel *const chn,
+						   enum i2s_sync_status const status,
+						   uint32_t timestamp, bool const tx)
+{
+	struct i2s_sync_data *const dev_data = dev->data;
+
+	if (chn->stream.get_time) {
+		timestamp = chn->stream.get_time();
+	}
+
+	uint8_t *const period = (uint8_t *)chn->stream.buf + chn->period * chn->period_bytes;
+
+	chn->period = (chn->period + 1) % chn->stream.periods;
+
+	/* The FIFO interrupt handler carries on from the start of the next period */
+	chn->buf = (uint8_t *)chn->stream.buf + chn->period * chn->period_bytes;
+	chn->count = 0;
+	chn->idx = 0;
+
+#if CONFIG_DCACHE
+	if (!tx) {
+		sys_cache_data_invd_range(period, chn->period_bytes);
+	}
+#endif
+
+	if (IS_ENABLED(CONFIG_I2S_SYNC_STATS)) {
+		k_spinlock_key_t const key = k_spin_lock(&dev_data->lock);
+
+		i2s_sync_stats_period_done(I2S_SYNC_CHN_STATS(chn));
+		k_spin_unlock(&dev_data->lock, key);
+	}
+
+	if (chn->stream.cb) {
+		uint32_t const cb_start = k_cycle_get_32();
+
+		chn->stream.cb(dev, status, period, timestamp, chn->stream.user_data);
+		i2s_sync_stats_callback(&dev_data->lock, I2S_SYNC_CHN_STATS(chn), cb_start);
+	}
+
+#if CONFIG_DCACHE
+	if (tx) {
+		sys_cache_data_flush_range(period, chn->period_bytes);
+	}
+#else
+	ARG_UNUSED(tx);
+#endif
+}
+#else
+INT_RAMFUNC static inline bool channel_is_streaming(const struct i2s_sync_channel *const chn)
+{
+	ARG_UNUSED(chn);
+	return false;
+}
+#endif /* CONFIG_I2S_SYNC_STREAM */
+
+INT_RAMFUNC static int i2s_transmitter_start_dma(const struct device *const dev,
+						 size_t const bytes_per_sample);
+INT_RAMFUNC static int i2s_receiver_start_dma(const struct device *const dev,
+					      size_t const bytes_per_sample);
 
 INT_RAMFUNC static void dma_tx_callback(const struct device *dma_dev, void *p_user_data,
 					uint32_t const channel, int const status)
 {
+	uint32_t const complete = k_cycle_get_32();
 	const struct device *const dev = p_user_data;
 	struct i2s_sync_data *const dev_data = dev->data;
 	void *tx_buf = dev_data->tx.buf;
+	size_t const bytes_per_sample = i2s_sync_sample_bytes(dev_data->bit_depth);
+
+	/* The DMA controller carries on with a linked block by itself. Otherwise start the next
+	 * queued block first, so that it does not wait on the callback.
+	 */
+	k_spinlock_key_t const key = k_spin_lock(&dev_data->lock);
+
+	if (status) {
+		channel_abort_blocks(&dev_data->tx);
+	} else if (channel_next_dma_block(&dev_data->tx, bytes_per_sample)) {
+		i2s_transmitter_start_dma(dev, bytes_per_sample);
+	}
+
+	i2s_sync_stats_block_done(I2S_SYNC_CHN_STATS(&dev_data->tx), complete,
+				  channel_queued(&dev_data->tx));
 
-	dev_data->tx.buf = NULL;
+	k_spin_unlock(&dev_data->lock, key);
 
 	if (dev_data->tx.cb) {
 		enum i2s_sync_status cb_status =
 			status ? I2S_SYNC_STATUS_TX_ERROR : I2S_SYNC_STATUS_OK;
+		uint32_t const cb_start = k_cycle_get_32();
+
 		dev_data->tx.cb(dev, cb_status, tx_buf);
+		i2s_sync_stats_callback(&dev_data->lock, I2S_SYNC_CHN_STATS(&dev_data->tx),
+					cb_start);
 	}
 
+	channel_check_underrun(dev_data, &dev_data->tx);
+
 	if (status) {
 		LOG_ERR("I2S:%s tx dma callback ch:%d error: %d", dev->name, channel, status);
 		return;
@@ -134,26 +452,20 @@ INT_RAMFUNC static int i2s_transmitter_start_dma(const struct device *const dev,
 	struct i2s_sync_data *dev_data = dev->data;
 	int ret = 0;
 
-#if CONFIG_DCACHE
-	sys_cache_data_flush_and_invd_range(dev_data->tx.buf, dev_data->tx.block_bytes);
-#endif
-
-	struct dma_block_config dma_block_cfg = {
-		.source_address = POINTER_TO_UINT(dev_data->tx.buf),
-		.dest_address = POINTER_TO_UINT(&i2s->TXDMA),
-		.block_size = dev_data->tx.block_bytes,
-		.source_addr_adj = DMA_ADDR_ADJ_INCREMENT,
-		.dest_addr_adj = DMA_ADDR_ADJ_NO_CHANGE,
-	};
+	uint32_t const block_count =
+		channel_link_dma_blocks(&dev_data->tx, true, POINTER_TO_UINT(&i2s->TXDMA));
 
 	struct dma_config dma_cfg = {
 		.dma_slot = dev_cfg->dma_tx.request,
 		.channel_direction = MEMORY_TO_PERIPHERAL,
+		/* Interrupt at the end of each linked block, not only the last */
+		.complete_callback_en = 1,
 		.source_data_size = bytes_per_sample,
 		.dest_data_size = bytes_per_sample,
 		.source_burst_length = I2S_FIFO_TRG_LEVEL_TX,
 		.dest_burst_length = I2S_FIFO_TRG_LEVEL_TX,
-		.head_block = &dma_block_cfg,
+		.block_count = block_count,
+		.head_block = &dev_data->tx.dma_blocks[0],
 		.user_data = (void *)dev,
 		.dma_callback = dma_tx_callback,
 	};
@@ -203,16 +515,25 @@ INT_RAMFUNC static int i2s_send(const struct device *dev, void *buf, size_t len)
 
 	const struct i2s_sync_config_priv *dev_cfg = dev->config;
 	struct i2s_sync_data *dev_data = dev->data;
+	size_t const bytes_per_sample = i2s_sync_sample_bytes(dev_data->bit_depth);
 
-	if (dev_data->tx.buf) {
-		return -EINPROGRESS;
+	if ((len % frame_bytes(dev_data, dev_data->tx_mask)) != 0) {
+		LOG_ERR("Invalid buffer size");
+		return -EINVAL;
 	}
 
-	size_t const bytes_per_sample = dev_data->bit_depth / 8U;
+	int ret = 0;
+	k_spinlock_key_t const key = k_spin_lock(&dev_data->lock);
+
+	if (channel_is_streaming(&dev_data->tx)) {
+		ret = -EBUSY;
+		goto unlock;
+	}
 
-	if ((len % (dev_data->channel_count * bytes_per_sample)) != 0) {
-		LOG_ERR("Invalid buffer size");
-		return -EINVAL;
+	if (dev_data->tx.buf) {
+		/* Started when the blocks ahead of it complete */
+		ret = channel_queue_block(&dev_data->tx, buf, len);
+		goto unlock;
 	}
 
 	dev_data->tx.buf = buf;
@@ -220,7 +541,8 @@ INT_RAMFUNC static int i2s_send(const struct device *dev, void *buf, size_t len)
 
 	if (dev_cfg->dma_tx.enabled) {
 		/* Configure and start DMA */
-		return i2s_transmitter_start_dma(dev, bytes_per_sample);
+		ret = i2s_transmitter_start_dma(dev, bytes_per_sample);
+		goto unlock;
 	}
 
 	dev_data->tx.samples = len / bytes_per_sample;
@@ -234,28 +556,61 @@ INT_RAMFUNC static int i2s_send(const struct device *dev, void *buf, size_t len)
 		i2s_tx_interrupt_enable(dev_cfg->paddr);
 	}
 
-	return 0;
+unlock:
+	if (!ret) {
+		i2s_sync_stats_block_added(I2S_SYNC_CHN_STATS(&dev_data->tx),
+					   channel_queued(&dev_data->tx));
+	}
+
+	k_spin_unlock(&dev_data->lock, key);
+
+	return ret;
 }
 
 INT_RAMFUNC static void dma_rx_callback(const struct device *dma_dev, void *p_user_data,
 					uint32_t const channel, int const status)
 {
+	uint32_t const complete = k_cycle_get_32();
 	const struct device *const dev = p_user_data;
 	struct i2s_sync_data *const dev_data = dev->data;
 	void *rx_buf = dev_data->rx.buf;
+	size_t const rx_bytes = dev_data->rx.block_bytes;
+	size_t const bytes_per_sample = i2s_sync_sample_bytes(dev_data->bit_depth);
 
-	dev_data->rx.buf = NULL;
+	/* The DMA controller carries on with a linked buffer by itself. Otherwise start the next
+	 * queued buffer first, so that it does not wait on the callback.
+	 */
+	k_spinlock_key_t const key = k_spin_lock(&dev_data->lock);
+
+	if (status < 0) {
+		channel_abort_blocks(&dev_data->rx);
+	} else if (channel_next_dma_block(&dev_data->rx, bytes_per_sample)) {
+		i2s_receiver_start_dma(dev, bytes_per_sample);
+	}
+
+	i2s_sync_stats_block_done(I2S_SYNC_CHN_STATS(&dev_data->rx), complete,
+				  channel_queued(&dev_data->rx));
+
+	k_spin_unlock(&dev_data->lock, key);
 
 #if CONFIG_DCACHE
-	sys_cache_data_invd_range(rx_buf, dev_data->rx.block_bytes);
+	sys_cache_data_invd_range(rx_buf, rx_bytes);
+#else
+	ARG_UNUSED(rx_bytes);
 #endif
 
 	if (dev_data->rx.cb) {
 		enum i2s_sync_status cb_status =
 			status ? I2S_SYNC_STATUS_RX_ERROR : I2S_SYNC_STATUS_OK;
+		uint32_t const cb_start = k_cycle_get_32();
+
 		dev_data->rx.cb(dev, cb_status, rx_buf);
+		i2s_sync_stats_callback(&dev_data->lock, I2S_SYNC_CHN_STATS(&dev_data->rx),
+					cb_start);
 	}
 
+	channel_check_underrun(dev_data, &dev_data->rx);
+
 	if (status < 0) {
 		LOG_ERR("I2S:%s rx dma callback ch:%d error: %d", dev->name, channel, status);
 		return;
@@ -271,22 +626,20 @@ INT_RAMFUNC static int i2s_receiver_start_dma(const struct device *const dev,
 	struct i2s_sync_data *dev_data = dev->data;
 	int ret = 0;
 
-	struct dma_block_config dma_block_cfg = {
-		.source_address = POINTER_TO_UINT(&i2s->RXDMA),
-		.dest_address = POINTER_TO_UINT(dev_data->rx.buf),
-		.block_size = dev_data->rx.block_bytes,
-		.source_addr_adj = DMA_ADDR_ADJ_NO_CHANGE,
-		.dest_addr_adj = DMA_ADDR_ADJ_INCREMENT,
-	};
+	uint32_t const block_count =
+		channel_link_dma_blocks(&dev_data->rx, false, POINTER_TO_UINT(&i2s->RXDMA));
 
 	struct dma_config dma_cfg = {
 		.dma_slot = dev_cfg->dma_rx.request,
 		.channel_direction = PERIPHERAL_TO_MEMORY,
+		/* Interrupt at the end of each linked buffer, not only the last */
+		.complete_callback_en = 1,
 		.source_data_size = bytes_per_sample,
 		.dest_data_size = bytes_per_sample,
 		.source_burst_length = I2S_FIFO_TRG_LEVEL_RX,
 		.dest_burst_length = I2S_FIFO_TRG_LEVEL_RX,
-		.head_block = &dma_block_cfg,
+		.block_count = block_count,
+		.head_block = &dev_data->rx.dma_blocks[0],
 		.user_data = (void *)dev,
 		.dma_callback = dma_rx_callback,
 	};
@@ -334,16 +687,25 @@ INT_RAMFUNC static int i2s_recv(const struct device *dev, void *buf, size_t len)
 
 	const struct i2s_sync_config_priv *dev_cfg = dev->config;
 	struct i2s_sync_data *dev_data = dev->data;
+	size_t const bytes_per_sample = i2s_sync_sample_bytes(dev_data->bit_depth);
 
-	if (dev_data->rx.buf) {
-		return -EINPROGRESS;
+	if ((len % frame_bytes(dev_data, dev_data->rx_mask)) != 0) {
+		LOG_ERR("Invalid buffer size");
+		return -EINVAL;
 	}
 
-	size_t const bytes_per_sample = dev_data->bit_depth / 8U;
+	int ret = 0;
+	k_spinlock_key_t const key = k_spin_lock(&dev_data->lock);
 
-	if ((len % (dev_data->channel_count * bytes_per_sample)) != 0) {
-		LOG_ERR("Invalid buffer size");
-		return -EINVAL;
+	if (channel_is_streaming(&dev_data->rx)) {
+		ret = -EBUSY;
+		goto unlock;
+	}
+
+	if (dev_data->rx.buf) {
+		/* Filled when the buffers ahead of it complete */
+		ret = channel_queue_block(&dev_data->rx, buf, len);
+		goto unlock;
 	}
 
 	dev_data->rx.buf = buf;
@@ -351,7 +713,8 @@ INT_RAMFUNC static int i2s_recv(const struct device *dev, void *buf, size_t len)
 
 	if (dev_cfg->dma_rx.enabled) {
 		/* Configure DMA RX */
-		return i2s_receiver_start_dma(dev, bytes_per_sample);
+		ret = i2s_receiver_start_dma(dev, bytes_per_sample);
+		goto unlock;
 	}
 
 	dev_data->rx.samples = len / bytes_per_sample;
@@ -365,8 +728,126 @@ INT_RAMFUNC static int i2s_recv(const struct device *dev, void *buf, size_t len)
 		i2s_rx_interrupt_enable(dev_cfg->paddr);
 	}
 
+unlock:
+	if (!ret) {
+		i2s_sync_stats_block_added(I2S_SYNC_CHN_STATS(&dev_data->rx),
+					   channel_queued(&dev_data->rx));
+	}
+
+	k_spin_unlock(&dev_data->lock, key);
+
+	return ret;
+}
+
+#ifdef CONFIG_I2S_SYNC_STREAM
+INT_RAMFUNC static void dma_stream_callback(const struct device *dma_dev, void *p_user_data,
+					    uint32_t const channel, int const status)
+{
+	uint32_t const timestamp = k_cycle_get_32();
+	const struct device *const dev = p_user_data;
+	const struct i2s_sync_config_priv *dev_cfg = dev->config;
+	struct i2s_sync_data *const dev_data = dev->data;
+	bool const tx = dev_cfg->dma_tx.enabled && (channel == dev_cfg->dma_tx.ch);
+	struct i2s_sync_channel *const chn = tx ? &dev_data->tx : &dev_data->rx;
+
+	if (!channel_is_streaming(chn)) {
+		/* Stream stopped while the period was completing */
+		return;
+	}
+
+	enum i2s_sync_status cb_status = I2S_SYNC_STATUS_OK;
+
+	if (status < 0) {
+		cb_status = tx ? I2S_SYNC_STATUS_TX_ERROR : I2S_SYNC_STATUS_RX_ERROR;
+		LOG_ERR("I2S:%s stream dma callback ch:%d error: %d", dev->name, channel, status);
+	}
+
+	channel_stream_period_done(dev, chn, cb_status, timestamp, tx);
+}
+
+/* Configure a cyclic DMA transfer with one block per period, so that the DMA controller wraps
+ * around the ring buffer by itself and interrupts at the end of each period
+ */
+static int stream_start_dma(const struct device *const dev, struct i2s_sync_channel *const chn,
+			    bool const tx, size_t const bytes_per_sample)
+{
+	const struct i2s_sync_config_priv *dev_cfg = dev->config;
+	const struct i2s_sync_dma_ch *const dma_ch = tx ? &dev_cfg->dma_tx : &dev_cfg->dma_rx;
+	struct i2s_t *i2s = dev_cfg->paddr;
+	uint32_t const fifo = tx ? POINTER_TO_UINT(&i2s->TXDMA) : POINTER_TO_UINT(&i2s->RXDMA);
+	int ret;
+
+	for (size_t i = 0; i < chn->stream.periods; i++) {
+		uint32_t const period =
+			POINTER_TO_UINT(chn->stream.buf) + (i * chn->period_bytes);
+		bool const last = (i + 1) == chn->stream.periods;
+
+		chn->stream_blocks[i] = (struct dma_block_config){
+			.source_address = tx ? period : fifo,
+			.dest_address = tx ? fifo : period,
+			.block_size = chn->period_bytes,
+			.source_addr_adj = tx ? DMA_ADDR_ADJ_INCREMENT : DMA_ADDR_ADJ_NO_CHANGE,
+			.dest_addr_adj = tx ? DMA_ADDR_ADJ_NO_CHANGE : DMA_ADDR_ADJ_INCREMENT,
+			.next_block = last ? NULL : &chn->stream_blocks[i + 1],
+		};
+	}
+
+#if CONFIG_DCACHE
+	sys_cache_data_flush_and_invd_range(chn->stream.buf, chn->stream.len);
+#endif
+
+	struct dma_config dma_cfg = {
+		.dma_slot = dma_ch->request,
+		.channel_direction = tx ? MEMORY_TO_PERIPHERAL : PERIPHERAL_TO_MEMORY,
+		.complete_callback_en = 1,
+		.cyclic = 1,
+		.source_data_size = bytes_per_sample,
+		.dest_data_size = bytes_per_sample,
+		.source_burst_length = tx ? I2S_FIFO_TRG_LEVEL_TX : I2S_FIFO_TRG_LEVEL_RX,
+		.dest_burst_length = tx ? I2S_FIFO_TRG_LEVEL_TX : I2S_FIFO_TRG_LEVEL_RX,
+		.block_count = chn->stream.periods,
+		.head_block = &chn->stream_blocks[0],
+		.user_data = (void *)dev,
+		.dma_callback = dma_stream_callback,
+	};
+
+	ret = dma_config(dev_cfg->dma_dev, dma_ch->ch, &dma_cfg);
+	if (ret < 0) {
+		LOG_ERR("I2S:%s stream dma_config failed %d", dev->name, ret);
+		return ret == -EINVAL ? -ENOTSUP : ret;
+	}
+
+	ret = dma_start(dev_cfg->dma_dev, dma_ch->ch);
+	if (ret < 0) {
+		LOG_ERR("I2S:%s stream dma_start failed %d", dev->name, ret);
+		return ret;
+	}
+
+	if (chn->running) {
+		return 0;
+	}
+
+	chn->running = true;
+
+	if (tx) {
+		i2s_tx_fifo_clear(i2s);
+		i2s_interrupt_clear_tx_overrun(i2s);
+		i2s_tx_overrun_interrupt_enable(i2s);
+		i2s_tx_channel_enable(i2s);
+		i2s_tx_block_enable(i2s);
+	} else {
+		i2s_rx_fifo_clear(i2s);
+		i2s_interrupt_clear_rx_overrun(i2s);
+		i2s_rx_channel_enable(i2s);
+		i2s_rx_block_enable(i2s);
+	}
+
+	LOG_DBG("I2S:%s %s stream started. %u periods of %u bytes", dev->name, tx ? "tx" : "rx",
+		chn->stream.periods, chn->period_bytes);
+
 	return 0;
 }
+#endif /* CONFIG_I2S_SYNC_STREAM */
 
 static void channel_reset(struct i2s_sync_channel *chn)
 {
@@ -374,6 +855,13 @@ static void channel_reset(struct i2s_sync_channel *chn)
 	chn->samples = 0;
 	chn->count = 0;
 	chn->idx = 0;
+	/* Queued blocks are dropped without being returned through the callback */
+	chn->queue_head = 0;
+	chn->queue_count = 0;
+	chn->dma_linked = 0;
+#ifdef CONFIG_I2S_SYNC_STREAM
+	chn->stream.buf = NULL;
+#endif
 }
 
 static void channel_disable(struct i2s_sync_channel *chn)
@@ -381,6 +869,7 @@ static void channel_disable(struct i2s_sync_channel *chn)
 	chn->running = false;
 	chn->overrun = false;
 	channel_reset(chn);
+	i2s_sync_stats_stopped(I2S_SYNC_CHN_STATS(chn));
 }
 
 static void i2s_disable_tx(const struct device *dev)
@@ -459,10 +948,144 @@ static int i2s_sync_get_config_impl(const struct device *dev, struct i2s_sync_co
 	cfg->sample_rate = dev_data->sample_rate;
 	cfg->bit_depth = dev_data->bit_depth;
 	cfg->channel_count = dev_data->channel_count;
+	cfg->slots = dev_data->slots;
+	cfg->tx_slot_mask = dev_data->tx_slot_mask;
+	cfg->rx_slot_mask = dev_data->rx_slot_mask;
+	cfg->layout = dev_data->layout;
 
 	return 0;
 }
 
+static int i2s_sync_get_queue_status_impl(const struct device *dev, enum i2s_dir dir,
+					  struct i2s_sync_queue_status *status)
+{
+	if (!dev || !status) {
+		return -EINVAL;
+	}
+
+	struct i2s_sync_data *dev_data = dev->data;
+	struct i2s_sync_channel const *chn;
+
+	if (dir == I2S_DIR_TX) {
+		chn = &dev_data->tx;
+	} else if (dir == I2S_DIR_RX) {
+		chn = &dev_data->rx;
+	} else {
+		return -EINVAL;
+	}
+
+	k_spinlock_key_t const key = k_spin_lock(&dev_data->lock);
+
+	status->queued = channel_queued(chn);
+	status->capacity = CONFIG_I2S_SYNC_QUEUE_DEPTH;
+	status->underruns = chn->underruns;
+
+	k_spin_unlock(&dev_data->lock, key);
+
+	return 0;
+}
+
+#ifdef CONFIG_I2S_SYNC_STATS
+static int i2s_sync_get_stats_impl(const struct device *dev, struct i2s_sync_stats *stats,
+				   bool clear)
+{
+	if (!dev || !stats) {
+		return -EINVAL;
+	}
+
+	struct i2s_sync_data *dev_data = dev->data;
+	k_spinlock_key_t const key = k_spin_lock(&dev_data->lock);
+
+	i2s_sync_stats_read(I2S_SYNC_CHN_STATS(&dev_data->tx), &stats->tx, clear);
+	i2s_sync_stats_read(I2S_SYNC_CHN_STATS(&dev_data->rx), &stats->rx, clear);
+
+	k_spin_unlock(&dev_data->lock, key);
+
+	return 0;
+}
+#endif /* CONFIG_I2S_SYNC_STATS */
+
+#ifdef CONFIG_I2S_SYNC_STREAM
+static int i2s_sync_stream_start_impl(const struct device *dev, enum i2s_dir dir,
+				      const struct i2s_sync_stream_config *cfg)
+{
+	if (!dev || !cfg || !cfg->buf || (cfg->periods < 2) ||
+	    (cfg->periods > CONFIG_I2S_SYNC_STREAM_MAX_PERIODS) || (cfg->len % cfg->periods)) {
+		return -EINVAL;
+	}
+
+	const struct i2s_sync_config_priv *dev_cfg = dev->config;
+	struct i2s_sync_data *dev_data = dev->data;
+	size_t const bytes_per_sample = i2s_sync_sample_bytes(dev_data->bit_depth);
+	size_t const period_bytes = cfg->len / cfg->periods;
+	struct i2s_sync_channel *chn;
+	bool dma_enabled;
+
+	uint8_t mask;
+
+	if (dir == I2S_DIR_TX) {
+		chn = &dev_data->tx;
+		dma_enabled = dev_cfg->dma_tx.enabled;
+		mask = dev_data->tx_mask;
+	} else if (dir == I2S_DIR_RX) {
+		chn = &dev_data->rx;
+		dma_enabled = dev_cfg->dma_rx.enabled;
+		mask = dev_data->rx_mask;
+	} else {
+		return -EINVAL;
+	}
+
+	if (!period_bytes || (period_bytes % frame_bytes(dev_data, mask))) {
+		LOG_ERR("Invalid period size");
+		return -EINVAL;
+	}
+
+	int ret = 0;
+	k_spinlock_key_t const key = k_spin_lock(&dev_data->lock);
+
+	if (chn->buf || channel_is_streaming(chn)) {
+		ret = -EBUSY;
+		goto unlock;
+	}
+
+	chn->stream = *cfg;
+	chn->period_bytes = period_bytes;
+	chn->period = 0;
+	chn->buf = cfg->buf;
+	chn->block_bytes = period_bytes;
+	chn->samples = period_bytes / bytes_per_sample;
+	chn->count = 0;
+	chn->idx = 0;
+
+	if (dma_enabled) {
+		ret = stream_start_dma(dev, chn, dir == I2S_DIR_TX, bytes_per_sample);
+		if (ret) {
+			channel_reset(chn);
+		}
+		goto unlock;
+	}
+
+	/* Without DMA, the FIFO interrupt handler wraps around the ring buffer */
+	if (!chn->running) {
+		if (dir == I2S_DIR_TX) {
+			i2s_transmitter_start(dev_cfg->paddr);
+		} else {
+			i2s_receiver_start(dev_cfg->paddr);
+		}
+		chn->running = true;
+	} else if (dir == I2S_DIR_TX) {
+		i2s_tx_interrupt_enable(dev_cfg->paddr);
+	} else {
+		i2s_rx_interrupt_enable(dev_cfg->paddr);
+	}
+
+unlock:
+	k_spin_unlock(&dev_data->lock, key);
+
+	return ret;
+}
+#endif /* CONFIG_I2S_SYNC_STREAM */
+
 static int get_wss_cycles(size_t const bit_depth)
 {
 	switch (bit_depth) {
@@ -510,6 +1133,45 @@ static int configure_clock_source(struct i2s_t *i2s, const uint32_t bit_depth,
 	return 0;
 }
 
+/* The controller has a single stereo channel, so frames always have two slots */
+static int check_slots(const struct i2s_sync_config_priv *dev_cfg,
+		       struct i2s_sync_config const *cfg)
+{
+	if ((cfg->slots != 0) && (cfg->slots != 2)) {
+		LOG_ERR("TDM with %u slots is not supported", cfg->slots);
+		return -ENOTSUP;
+	}
+
+	uint8_t const tx_mask = i2s_sync_slot_mask(cfg, I2S_DIR_TX);
+	uint8_t const rx_mask = i2s_sync_slot_mask(cfg, I2S_DIR_RX);
+
+	if (!tx_mask || !rx_mask) {
+		return -EINVAL;
+	}
+
+	if ((tx_mask | rx_mask) & ~BIT_MASK(2)) {
+		LOG_ERR("Slots other than left and right are not supported");
+		return -ENOTSUP;
+	}
+
+	/* DMA moves consecutive samples of the buffer to the left and right slots in turn */
+	bool const planar = cfg->layout == I2S_SYNC_LAYOUT_PLANAR;
+
+	if (dev_cfg->dma_tx.enabled &&
+	    (planar || (cfg->tx_slot_mask && (cfg->tx_slot_mask != BIT_MASK(2))))) {
+		LOG_ERR("TX slot mask or layout not supported with DMA");
+		return -ENOTSUP;
+	}
+
+	if (dev_cfg->dma_rx.enabled &&
+	    (planar || (cfg->rx_slot_mask && (cfg->rx_slot_mask != BIT_MASK(2))))) {
+		LOG_ERR("RX slot mask or layout not supported with DMA");
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
 static int i2s_sync_configure_impl(const struct device *dev, struct i2s_sync_config const *cfg)
 {
 	if (!dev || !cfg) {
@@ -528,6 +1190,10 @@ static int i2s_sync_configure_impl(const struct device *dev, struct i2s_sync_con
 	struct i2s_sync_data *const dev_data = dev->data;
 	struct i2s_t *i2s = dev_cfg->paddr;
 
+	ret = check_slots(dev_cfg, cfg);
+	if (ret) {
+		return ret;
+	}
 
 	/* check device availability */
 	if (!device_is_ready(dev_cfg->clk_dev)) {
@@ -583,6 +1249,13 @@ static int i2s_sync_configure_impl(const struct device *dev, struct i2s_sync_con
 	dev_data->sample_rate = cfg->sample_rate;
 	dev_data->bit_depth = cfg->bit_depth;
 	dev_data->channel_count = cfg->channel_count;
+	dev_data->slots = cfg->slots;
+	dev_data->tx_slot_mask = cfg->tx_slot_mask;
+	dev_data->rx_slot_mask = cfg->rx_slot_mask;
+	dev_data->layout = cfg->layout;
+	dev_data->tx_mask = i2s_sync_slot_mask(cfg, I2S_DIR_TX);
+	dev_data->rx_mask = i2s_sync_slot_mask(cfg, I2S_DIR_RX);
+	dev_data->planar = i2s_sync_is_planar(cfg);
 
 	return 0;
 }
@@ -649,34 +1322,40 @@ INT_RAMFUNC static void i2s_sync_tx_isr_handler(const struct device *dev)
 	const struct i2s_sync_config_priv *dev_cfg = dev->config;
 	struct i2s_sync_data *dev_data = dev->data;
 	struct i2s_t *i2s = dev_cfg->paddr;
-	int16_t *buf = (int16_t *)dev_data->tx.buf;
+	void *buf = dev_data->tx.buf;
 	uint32_t tx_free = I2S_FIFO_TRG_LEVEL_TX;
+	uint32_t const timestamp = k_cycle_get_32();
+	uint8_t const mask = dev_data->tx_mask;
+	size_t const channels = __builtin_popcount(mask);
+	size_t const sample_bytes = i2s_sync_sample_bytes(dev_data->bit_depth);
+	/* In mono mode, right channel is duplicated left channel data */
+	bool const mono = (dev_data->channel_count == 1U) && !dev_data->tx_slot_mask;
 
 	while (buf && tx_free && (dev_data->tx.count < dev_data->tx.samples)) {
-		/* Left channel is always output from first buffer position */
-		i2s_write_left_tx(i2s, (uint32_t)buf[dev_data->tx.idx]);
+		uint32_t slot[2] = {0};
+		size_t channel = 0;
+
+		/* Slots not selected by the mask are transmitted as zero */
+		for (size_t i = 0; i < ARRAY_SIZE(slot); i++) {
+			if (mask & BIT(i)) {
+				size_t const idx = sample_index(dev_data, &dev_data->tx,
+								dev_data->tx.idx, channel++,
+								channels);
+
+				slot[i] = buf_read(buf, idx, sample_bytes);
+			}
+		}
 
-		/* TODO Use correct config variable here! */
-		if (dev_data->channel_count == 1U) {
-			/* In mono mode, right channel is duplicated left channel data */
-			i2s_write_right_tx(i2s, (uint32_t)buf[dev_data->tx.idx]);
-		} else {
-#ifdef CONFIG_I2S_SYNC_BUFFER_FORMAT_SEQUENTIAL
-			/* For sequential buffer format, right channel comes from the second half of
-			 * buffer
-			 */
-			i2s_write_right_tx(
-				i2s, (uint32_t)buf[dev_data->tx.idx + (dev_data->tx.samples / 2)]);
-#else
-			/* For interleaved buffer format, right channel comes from next sample of
-			 * buffer. Buffer index must be incremented.
-			 */
-			i2s_write_right_tx(i2s, (uint32_t)buf[++dev_data->tx.idx]);
-#endif
+		if (mono) {
+			slot[1] = slot[0];
 		}
 
+		i2s_write_left_tx(i2s, slot[0]);
+		i2s_write_right_tx(i2s, slot[1]);
+
+		/* Index of the next frame */
 		dev_data->tx.idx++;
-		dev_data->tx.count += dev_data->channel_count;
+		dev_data->tx.count += channels;
 		tx_free--;
 	}
 
@@ -687,23 +1366,47 @@ INT_RAMFUNC static void i2s_sync_tx_isr_handler(const struct device *dev)
 		i2s_tx_overrun_interrupt_disable(i2s);
 		i2s_interrupt_clear_tx_overrun(i2s);
 		dev_data->tx.overrun = true;
+		channel_count_overrun(dev_data, &dev_data->tx);
 	}
 
-	if (dev_data->tx.count == dev_data->tx.samples) {
-		i2s_tx_interrupt_disable(i2s);
+	if (buf && dev_data->tx.count == dev_data->tx.samples) {
+		enum i2s_sync_status const status =
+			dev_data->tx.overrun ? I2S_SYNC_STATUS_OVERRUN : I2S_SYNC_STATUS_OK;
 
-		dev_data->tx.buf = NULL;
-		dev_data->tx.samples = 0;
-		dev_data->tx.idx = 0;
+		dev_data->tx.overrun = false;
+
+#ifdef CONFIG_I2S_SYNC_STREAM
+		if (channel_is_streaming(&dev_data->tx)) {
+			/* Wrap around the ring buffer instead of stopping */
+			channel_stream_period_done(dev, &dev_data->tx, status, timestamp,
+						   true);
+			return;
+		}
+#endif
+
+		k_spinlock_key_t const key = k_spin_lock(&dev_data->lock);
+
+		/* Carry straight on with the next queued block, the FIFO is refilled from it on the
+		 * next interrupt
+		 */
+		if (!channel_next_block(&dev_data->tx, i2s_sync_sample_bytes(dev_data->bit_depth))) {
+			i2s_tx_interrupt_disable(i2s);
+		}
+
+		i2s_sync_stats_block_done(I2S_SYNC_CHN_STATS(&dev_data->tx), timestamp,
+					  channel_queued(&dev_data->tx));
+
+		k_spin_unlock(&dev_data->lock, key);
 
 		if (dev_data->tx.cb) {
-			enum i2s_sync_status status =
-				dev_data->tx.overrun ? I2S_SYNC_STATUS_OVERRUN : I2S_SYNC_STATUS_OK;
+			uint32_t const cb_start = k_cycle_get_32();
 
 			dev_data->tx.cb(dev, status, buf);
+			i2s_sync_stats_callback(&dev_data->lock,
+						I2S_SYNC_CHN_STATS(&dev_data->tx), cb_start);
 		}
 
-		dev_data->tx.overrun = false;
+		channel_check_underrun(dev_data, &dev_data->tx);
 	}
 }
 
@@ -712,33 +1415,38 @@ INT_RAMFUNC static void i2s_sync_rx_isr_handler(const struct device *dev)
 	const struct i2s_sync_config_priv *dev_cfg = (struct i2s_sync_config_priv *)dev->config;
 	struct i2s_sync_data *dev_data = dev->data;
 	struct i2s_t *i2s = dev_cfg->paddr;
-	int16_t *buf = (int16_t *)dev_data->rx.buf;
+	void *buf = dev_data->rx.buf;
 	uint32_t rx_avail = I2S_FIFO_TRG_LEVEL_RX;
+	uint32_t const timestamp = k_cycle_get_32();
+	uint8_t const mask = dev_data->rx_mask;
+	size_t const channels = __builtin_popcount(mask);
+	size_t const sample_bytes = i2s_sync_sample_bytes(dev_data->bit_depth);
 
 	while (buf && rx_avail && (dev_data->rx.count < dev_data->rx.samples)) {
-		/* Left channel is always placed in first buffer position */
-		buf[dev_data->rx.idx] = (int16_t)i2s_read_left_rx(i2s);
-
-		if (dev_data->channel_count == 1U) {
-			/* In mono mode, right channel should be read and then discarded */
-			(void)i2s_read_right_rx(i2s);
-		} else {
-#ifdef CONFIG_I2S_SYNC_BUFFER_FORMAT_SEQUENTIAL
-			/* For sequential buffer format, right channel is placed in second half of
-			 * buffer
-			 */
-			buf[dev_data->rx.idx + (dev_data->rx.samples / 2)] =
-				(int16_t)i2s_read_right_rx(i2s);
-#else
-			/* For interleaved buffer format, right channel is placed in the next sample
-			 * of buffer. Buffer index must be incremented.
-			 */
-			buf[++dev_data->rx.idx] = (int16_t)i2s_read_right_rx(i2s);
-#endif
+		uint32_t slot[2];
+		size_t channel = 0;
+
+		/* Left channel is always read first */
+		slot[0] = i2s_read_left_rx(i2s);
+		slot[1] = i2s_read_right_rx(i2s);
+
+		/* Slots not selected by the mask are read and then discarded */
+		for (size_t i = 0; i < ARRAY_SIZE(slot); i++) {
+			if (mask & BIT(i)) {
+				size_t const idx = sample_index(dev_data, &dev_data->rx,
+								dev_data->rx.idx, channel++,
+								channels);
+				uint32_t const sample = (dev_data->bit_depth == 24)
+								? sign_extend(slot[i], 23)
+								: slot[i];
+
+				buf_write(buf, idx, sample_bytes, sample);
+			}
 		}
 
+		/* Index of the next frame */
 		dev_data->rx.idx++;
-		dev_data->rx.count += dev_data->channel_count;
+		dev_data->rx.count += channels;
 		rx_avail--;
 	}
 
@@ -749,23 +1457,45 @@ INT_RAMFUNC static void i2s_sync_rx_isr_handler(const struct device *dev)
 		i2s_rx_overrun_interrupt_disable(i2s);
 		i2s_interrupt_clear_rx_overrun(i2s);
 		dev_data->rx.overrun = true;
+		channel_count_overrun(dev_data, &dev_data->rx);
 	}
 
-	if (dev_data->rx.count == dev_data->rx.samples) {
-		i2s_rx_interrupt_disable(i2s);
+	if (buf && dev_data->rx.count == dev_data->rx.samples) {
+		enum i2s_sync_status const status =
+			dev_data->rx.overrun ? I2S_SYNC_STATUS_OVERRUN : I2S_SYNC_STATUS_OK;
 
-		dev_data->rx.buf = NULL;
-		dev_data->rx.samples = 0;
-		dev_data->rx.idx = 0;
+		dev_data->rx.overrun = false;
+
+#ifdef CONFIG_I2S_SYNC_STREAM
+		if (channel_is_streaming(&dev_data->rx)) {
+			/* Wrap around the ring buffer instead of stopping */
+			channel_stream_period_done(dev, &dev_data->rx, status, timestamp,
+						   false);
+			return;
+		}
+#endif
+
+		k_spinlock_key_t const key = k_spin_lock(&dev_data->lock);
+
+		/* Carry straight on with the next queued buffer */
+		if (!channel_next_block(&dev_data->rx, i2s_sync_sample_bytes(dev_data->bit_depth))) {
+			i2s_rx_interrupt_disable(i2s);
+		}
+
+		i2s_sync_stats_block_done(I2S_SYNC_CHN_STATS(&dev_data->rx), timestamp,
+					  channel_queued(&dev_data->rx));
+
+		k_spin_unlock(&dev_data->lock, key);
 
 		if (dev_data->rx.cb) {
-			enum i2s_sync_status status =
-				dev_data->rx.overrun ? I2S_SYNC_STATUS_OVERRUN : I2S_SYNC_STATUS_OK;
+			uint32_t const cb_start = k_cycle_get_32();
 
 			dev_data->rx.cb(dev, status, buf);
+			i2s_sync_stats_callback(&dev_data->lock,
+						I2S_SYNC_CHN_STATS(&dev_data->rx), cb_start);
 		}
 
-		dev_data->rx.overrun = false;
+		channel_check_underrun(dev_data, &dev_data->rx);
 	}
 }
 
@@ -782,6 +1512,7 @@ INT_RAMFUNC static void i2s_sync_isr(const struct device *dev)
 			i2s_sync_tx_isr_handler(dev);
 		} else {
 			i2s_interrupt_clear_tx_overrun(i2s);
+			channel_count_overrun(dev_data, &dev_data->tx);
 			LOG_ERR("I2S:%s TX overrun!", dev->name);
 		}
 	}
@@ -791,6 +1522,7 @@ INT_RAMFUNC static void i2s_sync_isr(const struct device *dev)
 			i2s_sync_rx_isr_handler(dev);
 		} else {
 			i2s_interrupt_clear_rx_overrun(i2s);
+			channel_count_overrun(dev_data, &dev_data->rx);
 			LOG_ERR("I2S:%s RX overrun!", dev->name);
 		}
 	}
@@ -801,7 +1533,17 @@ static const struct i2s_sync_driver_api i2s_sync_api = {.register_cb = i2s_regis
 							.recv = i2s_recv,
 							.disable = i2s_sync_disable_impl,
 							.get_config = i2s_sync_get_config_impl,
-							.configure = i2s_sync_configure_impl};
+							.configure = i2s_sync_configure_impl,
+							.get_queue_status =
+								i2s_sync_get_queue_status_impl,
+#ifdef CONFIG_I2S_SYNC_STREAM
+							.stream_start =
+								i2s_sync_stream_start_impl,
+#endif
+#ifdef CONFIG_I2S_SYNC_STATS
+							.get_stats = i2s_sync_get_stats_impl,
+#endif
+};
 
 #if defined(CONFIG_PM_DEVICE)
 
@@ -0,0 +1,675 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+/* Emulated I2S sync device. Transfers take the time they would on the bus at the configured sample
+ * rate, measured on the system clock and scaled by the clock error set for the device, and complete
+ * from a timer as they would from the DMA or FIFO interrupt. With the loopback property, data
+ * transmitted is received in the same order. The loopback carries whole frames of all slots, so
+ * each direction can select different slots.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/ring_buffer.h>
+#include <zephyr/sys/util.h>
+#include <drivers/i2s_sync.h>
+#include <drivers/i2s_sync_emul.h>
+
+#include "i2s_sync_stats.h"
+
+LOG_MODULE_REGISTER(i2s_sync_emul, CONFIG_I2S_SYNC_LOG_LEVEL);
+
+#define DT_DRV_COMPAT alif_i2s_sync_emul
+
+/* Blocks queued behind the one being transferred */
+#define QUEUE_CAPACITY (CONFIG_I2S_SYNC_QUEUE_DEPTH - 1)
+
+struct i2s_sync_emul_block {
+	void *buf;
+	size_t len;
+};
+
+struct i2s_sync_emul_channel {
+	const struct device *dev;
+	enum i2s_dir dir;
+	i2s_sync_cb_t cb;
+	i2s_sync_emul_hook_t hook;
+	struct k_timer timer;
+	/* Block or period being transferred, NULL if idle */
+	void *buf;
+	size_t len;
+	/* Start and end of the transfer on the bus, in nanoseconds of system uptime */
+	int64_t start_ns;
+	int64_t end_ns;
+	struct i2s_sync_emul_block queue[MAX(QUEUE_CAPACITY, 1)];
+	uint8_t queue_head;
+	uint8_t queue_count;
+	uint32_t underruns;
+	bool running;
+#ifdef CONFIG_I2S_SYNC_STATS
+	struct i2s_sync_chn_stats stats;
+#endif
+#ifdef CONFIG_I2S_SYNC_STREAM
+	/* Ring buffer of the running stream, stream.buf is NULL when not streaming */
+	struct i2s_sync_stream_config stream;
+	size_t period_bytes;
+	uint8_t period;
+#endif
+};
+
+struct i2s_sync_emul_data {
+	struct i2s_sync_emul_channel tx;
+	struct i2s_sync_emul_channel rx;
+	struct i2s_sync_config cfg;
+	struct i2s_sync_emul_counters counters;
+	int32_t clock_ppm;
+	/* Frames transmitted and not yet received when looped back, one word per slot */
+	struct ring_buf line;
+	uint8_t line_buf[CONFIG_I2S_SYNC_EMUL_LOOPBACK_SIZE];
+	struct k_spinlock lock;
+};
+
+struct i2s_sync_emul_config {
+	uint32_t sample_rate;
+	uint32_t bit_depth;
+	uint8_t channel_count;
+	uint8_t slots;
+	uint8_t tx_slot_mask;
+	uint8_t rx_slot_mask;
+	bool loopback;
+};
+
+static inline bool channel_is_streaming(const struct i2s_sync_emul_channel *const chn)
+{
+#ifdef CONFIG_I2S_SYNC_STREAM
+	return chn->stream.buf != NULL;
+#else
+	ARG_UNUSED(chn);
+	return false;
+#endif
+}
+
+static int64_t now_ns(void)
+{
+	return (int64_t)k_ticks_to_ns_floor64(k_uptime_ticks());
+}
+
+static size_t frame_bytes(const struct i2s_sync_emul_data *const data, enum i2s_dir const dir)
+{
+	return i2s_sync_frame_bytes(&data->cfg, dir);
+}
+
+static uint8_t bus_slots(const struct i2s_sync_emul_data *const data)
+{
+	return data->cfg.slots ? data->cfg.slots : 2;
+}
+
+static int64_t transfer_ns(const struct i2s_sync_emul_data *const data,
+			   const struct i2s_sync_emul_channel *const chn, size_t const len)
+{
+	uint64_t const frames = len / frame_bytes(data, chn->dir);
+	uint64_t const nominal_ns = (frames * NSEC_PER_SEC) / data->cfg.sample_rate;
+
+	return (int64_t)((nominal_ns * 1000000ULL) / (uint64_t)(1000000 + data->clock_ppm));
+}
+
+/* Index in the buffer of a channel of a frame */
+static size_t sample_index(const struct i2s_sync_emul_data *const data, size_t const frames,
+			   size_t const frame, size_t const channel, size_t const channels)
+{
+	if (i2s_sync_is_planar(&data->cfg)) {
+		return (channel * frames) + frame;
+	}
+
+	return (frame * channels) + channel;
+}
+
+static int32_t read_sample(const struct i2s_sync_emul_data *const data, const void *const buf,
+			   size_t const idx)
+{
+	switch (data->cfg.bit_depth) {
+	case 16:
+		return ((const int16_t *)buf)[idx];
+	case 24:
+		return sign_extend(((const uint32_t *)buf)[idx], 23);
+	default:
+		return ((const int32_t *)buf)[idx];
+	}
+}
+
+static void write_sample(const struct i2s_sync_emul_data *const data, void *const buf,
+			 size_t const idx, int32_t const sample)
+{
+	switch (data->cfg.bit_depth) {
+	case 16:
+		((int16_t *)buf)[idx] = (int16_t)sample;
+		break;
+	case 24:
+		((int32_t *)buf)[idx] = sign_extend((uint32_t)sample, 23);
+		break;
+	default:
+		((int32_t *)buf)[idx] = sample;
+		break;
+	}
+}
+
+/* Put the frames of a transmitted block on the loopback, called with the lock held */
+static void transmit_block(struct i2s_sync_emul_data *const data, const void *const buf,
+			   size_t const len)
+{
+	uint8_t const mask = i2s_sync_slot_mask(&data->cfg, I2S_DIR_TX);
+	size_t const channels = i2s_sync_channels(&data->cfg, I2S_DIR_TX);
+	size_t const frames = len / frame_bytes(data, I2S_DIR_TX);
+	uint32_t const bus_frame_bytes = bus_slots(data) * sizeof(int32_t);
+	uint32_t const space = ring_buf_space_get(&data->line);
+	uint32_t const needed = frames * bus_frame_bytes;
+
+	/* The receiver has fallen behind, drop the oldest frames */
+	if (space < needed) {
+		ring_buf_get(&data->line, NULL, ROUND_UP(needed - space, bus_frame_bytes));
+	}
+
+	for (size_t frame = 0; frame < frames; frame++) {
+		int32_t bus_frame[I2S_SYNC_MAX_SLOTS] = {0};
+		size_t channel = 0;
+
+		/* Slots not selected by the mask are transmitted as zero */
+		for (size_t slot = 0; slot < bus_slots(data); slot++) {
+			if (mask & BIT(slot)) {
+				bus_frame[slot] = read_sample(
+					data, buf,
+					sample_index(data, frames, frame, channel++, channels));
+			}
+		}
+
+		ring_buf_put(&data->line, (uint8_t *)bus_frame, bus_frame_bytes);
+	}
+}
+
+static struct i2s_sync_emul_channel *get_channel(struct i2s_sync_emul_data *const data,
+						 enum i2s_dir const dir)
+{
+	return dir == I2S_DIR_TX ? &data->tx : dir == I2S_DIR_RX ? &data->rx : NULL;
+}
+
+/* Put a block on the bus, called with the lock held */
+static void begin_transfer(const struct device *dev, struct i2s_sync_emul_channel *const chn,
+			   void *const buf, size_t const len, int64_t const start_ns)
+{
+	const struct i2s_sync_emul_config *const cfg = dev->config;
+	struct i2s_sync_emul_data *const data = dev->data;
+
+	chn->buf = buf;
+	chn->len = len;
+	chn->start_ns = start_ns;
+	chn->end_ns = start_ns + transfer_ns(data, chn, len);
+	chn->running = true;
+
+	if (chn->dir == I2S_DIR_TX) {
+		if (chn->hook) {
+			chn->hook(buf, len, (uint32_t)(start_ns / NSEC_PER_USEC));
+		}
+
+		if (cfg->loopback) {
+			transmit_block(data, buf, len);
+		}
+	}
+
+	k_timer_start(&chn->timer, K_TIMEOUT_ABS_NS(chn->end_ns), K_NO_WAIT);
+}
+
+/* Fill a received block from the loopback, or with silence. Called with the lock held. */
+static void receive_block(const struct device *dev, void *const buf, size_t const len)
+{
+	const struct i2s_sync_emul_config *const cfg = dev->config;
+	struct i2s_sync_emul_data *const data = dev->data;
+	uint8_t const mask = i2s_sync_slot_mask(&data->cfg, I2S_DIR_RX);
+	size_t const channels = i2s_sync_channels(&data->cfg, I2S_DIR_RX);
+	size_t const frames = len / frame_bytes(data, I2S_DIR_RX);
+	uint32_t const bus_frame_bytes = bus_slots(data) * sizeof(int32_t);
+
+	for (size_t frame = 0; frame < frames; frame++) {
+		int32_t bus_frame[I2S_SYNC_MAX_SLOTS] = {0};
+		size_t channel = 0;
+
+		if (cfg->loopback) {
+			ring_buf_get(&data->line, (uint8_t *)bus_frame, bus_frame_bytes);
+		}
+
+		for (size_t slot = 0; slot < bus_slots(data); slot++) {
+			if (mask & BIT(slot)) {
+				write_sample(data, buf,
+					     sample_index(data, frames, frame, channel++, channels),
+					     bus_frame[slot]);
+			}
+		}
+	}
+}
+
+static void on_transfer_complete(struct k_timer *timer)
+{
+	uint32_t const timestamp = k_cycle_get_32();
+	struct i2s_sync_emul_channel *const chn =
+		CONTAINER_OF(timer, struct i2s_sync_emul_channel, timer);
+	const struct device *const dev = chn->dev;
+	struct i2s_sync_emul_data *const data = dev->data;
+	k_spinlock_key_t key = k_spin_lock(&data->lock);
+	void *const buf = chn->buf;
+	size_t const len = chn->len;
+
+	if (!buf) {
+		/* Disabled while the transfer was completing */
+		k_spin_unlock(&data->lock, key);
+		return;
+	}
+
+	if (chn->dir == I2S_DIR_RX) {
+		receive_block(dev, buf, len);
+		if (chn->hook) {
+			chn->hook(buf, len, (uint32_t)(chn->start_ns / NSEC_PER_USEC));
+		}
+		data->counters.rx_blocks++;
+	} else {
+		data->counters.tx_blocks++;
+	}
+
+#ifdef CONFIG_I2S_SYNC_STREAM
+	if (channel_is_streaming(chn)) {
+		struct i2s_sync_stream_config const stream = chn->stream;
+		uint32_t const stream_time = stream.get_time ? stream.get_time() : timestamp;
+
+		/* Wrap around the ring buffer without a gap */
+		chn->period = (chn->period + 1) % stream.periods;
+		begin_transfer(dev, chn, (uint8_t *)stream.buf + chn->period * chn->period_bytes,
+			       chn->period_bytes, chn->end_ns);
+
+		i2s_sync_stats_period_done(I2S_SYNC_CHN_STATS(chn));
+
+		k_spin_unlock(&data->lock, key);
+
+		if (stream.cb) {
+			uint32_t const cb_start = k_cycle_get_32();
+
+			stream.cb(dev, I2S_SYNC_STATUS_OK, buf, stream_time, stream.user_data);
+			i2s_sync_stats_callback(&data->lock, I2S_SYNC_CHN_STATS(chn), cb_start);
+		}
+		return;
+	}
+#endif
+
+	/* As with the hardware, the next queued block follows on without waiting for the callback */
+	if (chn->queue_count) {
+		struct i2s_sync_emul_block const next = chn->queue[chn->queue_head];
+
+		chn->queue_head = (chn->queue_head + 1) % ARRAY_SIZE(chn->queue);
+		chn->queue_count--;
+		begin_transfer(dev, chn, next.buf, next.len, chn->end_ns);
+	} else {
+		chn->buf = NULL;
+	}
+
+	i2s_sync_stats_block_done(I2S_SYNC_CHN_STATS(chn), timestamp,
+				  !!chn->buf + chn->queue_count);
+
+	k_spin_unlock(&data->lock, key);
+
+	if (chn->cb) {
+		uint32_t const cb_start = k_cycle_get_32();
+
+		chn->cb(dev, I2S_SYNC_STATUS_OK, buf);
+		i2s_sync_stats_callback(&data->lock, I2S_SYNC_CHN_STATS(chn), cb_start);
+	}
+
+	key = k_spin_lock(&data->lock);
+	if (chn->running && !chn->buf) {
+		chn->underruns++;
+		if (chn->dir == I2S_DIR_TX) {
+			data->counters.tx_underruns++;
+		}
+		i2s_sync_stats_underrun(I2S_SYNC_CHN_STATS(chn));
+	}
+	k_spin_unlock(&data->lock, key);
+}
+
+static int start_block(const struct device *dev, struct i2s_sync_emul_channel *const chn,
+		       void *const buf, size_t const len)
+{
+	struct i2s_sync_emul_data *const data = dev->data;
+
+	if (!buf || !len || (len % frame_bytes(data, chn->dir))) {
+		return -EINVAL;
+	}
+
+	int ret = 0;
+	k_spinlock_key_t const key = k_spin_lock(&data->lock);
+
+	if (channel_is_streaming(chn)) {
+		ret = -EBUSY;
+	} else if (chn->buf) {
+		if (chn->queue_count == QUEUE_CAPACITY) {
+			ret = -EINPROGRESS;
+		} else {
+			struct i2s_sync_emul_block *const block =
+				&chn->queue[(chn->queue_head + chn->queue_count) %
+					    ARRAY_SIZE(chn->queue)];
+
+			block->buf = buf;
+			block->len = len;
+			chn->queue_count++;
+		}
+	} else {
+		/* A block provided from the completion callback follows straight on */
+		int64_t const start_ns = chn->running ? MAX(chn->end_ns, now_ns()) : now_ns();
+
+		begin_transfer(dev, chn, buf, len, start_ns);
+	}
+
+	if (!ret) {
+		i2s_sync_stats_block_added(I2S_SYNC_CHN_STATS(chn), !!chn->buf + chn->queue_count);
+	}
+
+	k_spin_unlock(&data->lock, key);
+
+	return ret;
+}
+
+static int i2s_sync_emul_register_cb(const struct device *dev, enum i2s_dir dir,
+				     i2s_sync_cb_t cb)
+{
+	struct i2s_sync_emul_channel *const chn = get_channel(dev->data, dir);
+
+	if (!chn) {
+		return -EINVAL;
+	}
+
+	chn->cb = cb;
+
+	return 0;
+}
+
+static int i2s_sync_emul_send(const struct device *dev, void *buf, size_t len)
+{
+	struct i2s_sync_emul_data *const data = dev->data;
+
+	return start_block(dev, &data->tx, buf, len);
+}
+
+static int i2s_sync_emul_recv(const struct device *dev, void *buf, size_t len)
+{
+	struct i2s_sync_emul_data *const data = dev->data;
+
+	return start_block(dev, &data->rx, buf, len);
+}
+
+static void disable_channel(struct i2s_sync_emul_data *const data,
+			    struct i2s_sync_emul_channel *const chn)
+{
+	k_timer_stop(&chn->timer);
+
+	k_spinlock_key_t const key = k_spin_lock(&data->lock);
+
+	chn->buf = NULL;
+	chn->queue_head = 0;
+	chn->queue_count = 0;
+	chn->running = false;
+#ifdef CONFIG_I2S_SYNC_STREAM
+	chn->stream.buf = NULL;
+#endif
+	i2s_sync_stats_stopped(I2S_SYNC_CHN_STATS(chn));
+
+	if (chn->dir == I2S_DIR_RX) {
+		/* Data still on its way is lost */
+		ring_buf_reset(&data->line);
+	}
+
+	k_spin_unlock(&data->lock, key);
+}
+
+static int i2s_sync_emul_disable(const struct device *dev, enum i2s_dir dir)
+{
+	struct i2s_sync_emul_data *const data = dev->data;
+
+	switch (dir) {
+	case I2S_DIR_TX:
+		disable_channel(data, &data->tx);
+		break;
+	case I2S_DIR_RX:
+		disable_channel(data, &data->rx);
+		break;
+	case I2S_DIR_BOTH:
+		disable_channel(data, &data->rx);
+		disable_channel(data, &data->tx);
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int i2s_sync_emul_get_config(const struct device *dev, struct i2s_sync_config *cfg)
+{
+	const struct i2s_sync_emul_data *const data = dev->data;
+
+	if (!cfg) {
+		return -EINVAL;
+	}
+
+	*cfg = data->cfg;
+
+	return 0;
+}
+
+static int i2s_sync_emul_configure(const struct device *dev, struct i2s_sync_config const *cfg)
+{
+	struct i2s_sync_emul_data *const data = dev->data;
+
+	if (!cfg || !cfg->sample_rate || !cfg->channel_count) {
+		return -EINVAL;
+	}
+
+	if ((cfg->bit_depth != 16) && (cfg->bit_depth != 24) && (cfg->bit_depth != 32)) {
+		LOG_ERR("Bit depth other than 16, 24 or 32 is not supported");
+		return -EINVAL;
+	}
+
+	uint8_t const slots = cfg->slots ? cfg->slots : 2;
+	uint8_t const tx_mask = i2s_sync_slot_mask(cfg, I2S_DIR_TX);
+	uint8_t const rx_mask = i2s_sync_slot_mask(cfg, I2S_DIR_RX);
+
+	if ((slots < 2) || (slots > I2S_SYNC_MAX_SLOTS) || (cfg->layout > I2S_SYNC_LAYOUT_PLANAR)) {
+		return -EINVAL;
+	}
+
+	if (!tx_mask || !rx_mask || ((tx_mask | rx_mask) & ~BIT_MASK(slots))) {
+		LOG_ERR("Slot masks 0x%02x and 0x%02x invalid for %u slots", tx_mask, rx_mask,
+			slots);
+		return -EINVAL;
+	}
+
+	if (data->tx.running || data->rx.running) {
+		return -EBUSY;
+	}
+
+	data->cfg = *cfg;
+
+	return 0;
+}
+
+static int i2s_sync_emul_get_queue_status(const struct device *dev, enum i2s_dir dir,
+					  struct i2s_sync_queue_status *status)
+{
+	struct i2s_sync_emul_data *const data = dev->data;
+	struct i2s_sync_emul_channel const *const chn = get_channel(data, dir);
+
+	if (!chn || !status) {
+		return -EINVAL;
+	}
+
+	k_spinlock_key_t const key = k_spin_lock(&data->lock);
+
+	status->queued = !!chn->buf + chn->queue_count;
+	status->capacity = CONFIG_I2S_SYNC_QUEUE_DEPTH;
+	status->underruns = chn->underruns;
+
+	k_spin_unlock(&data->lock, key);
+
+	return 0;
+}
+
+#ifdef CONFIG_I2S_SYNC_STATS
+static int i2s_sync_emul_get_stats(const struct device *dev, struct i2s_sync_stats *stats,
+				   bool clear)
+{
+	struct i2s_sync_emul_data *const data = dev->data;
+
+	if (!stats) {
+		return -EINVAL;
+	}
+
+	k_spinlock_key_t const key = k_spin_lock(&data->lock);
+
+	i2s_sync_stats_read(I2S_SYNC_CHN_STATS(&data->tx), &stats->tx, clear);
+	i2s_sync_stats_read(I2S_SYNC_CHN_STATS(&data->rx), &stats->rx, clear);
+
+	k_spin_unlock(&data->lock, key);
+
+	return 0;
+}
+#endif /* CONFIG_I2S_SYNC_STATS */
+
+#ifdef CONFIG_I2S_SYNC_STREAM
+static int i2s_sync_emul_stream_start(const struct device *dev, enum i2s_dir dir,
+				      const struct i2s_sync_stream_config *cfg)
+{
+	struct i2s_sync_emul_data *const data = dev->data;
+	struct i2s_sync_emul_channel *const chn = get_channel(data, dir);
+
+	if (!chn || !cfg || !cfg->buf || (cfg->periods < 2) ||
+	    (cfg->periods > CONFIG_I2S_SYNC_STREAM_MAX_PERIODS) || (cfg->len % cfg->periods)) {
+		return -EINVAL;
+	}
+
+	size_t const period_bytes = cfg->len / cfg->periods;
+
+	if (!period_bytes || (period_bytes % frame_bytes(data, dir))) {
+		return -EINVAL;
+	}
+
+	int ret = 0;
+	k_spinlock_key_t const key = k_spin_lock(&data->lock);
+
+	if (chn->buf || channel_is_streaming(chn)) {
+		ret = -EBUSY;
+	} else {
+		chn->stream = *cfg;
+		chn->period_bytes = period_bytes;
+		chn->period = 0;
+		begin_transfer(dev, chn, cfg->buf, period_bytes, now_ns());
+	}
+
+	k_spin_unlock(&data->lock, key);
+
+	return ret;
+}
+#endif /* CONFIG_I2S_SYNC_STREAM */
+
+void i2s_sync_emul_set_clock_ppm(const struct device *dev, int32_t const ppm)
+{
+	struct i2s_sync_emul_data *const data = dev->data;
+	k_spinlock_key_t const key = k_spin_lock(&data->lock);
+
+	data->clock_ppm = ppm;
+
+	k_spin_unlock(&data->lock, key);
+}
+
+void i2s_sync_emul_set_hooks(const struct device *dev, i2s_sync_emul_hook_t const tx_hook,
+			     i2s_sync_emul_hook_t const rx_hook)
+{
+	struct i2s_sync_emul_data *const data = dev->data;
+	k_spinlock_key_t const key = k_spin_lock(&data->lock);
+
+	data->tx.hook = tx_hook;
+	data->rx.hook = rx_hook;
+
+	k_spin_unlock(&data->lock, key);
+}
+
+void i2s_sync_emul_get_counters(const struct device *dev,
+				struct i2s_sync_emul_counters *const counters, bool const clear)
+{
+	struct i2s_sync_emul_data *const data = dev->data;
+	k_spinlock_key_t const key = k_spin_lock(&data->lock);
+
+	if (counters) {
+		*counters = data->counters;
+	}
+	if (clear) {
+		data->counters = (struct i2s_sync_emul_counters){0};
+	}
+
+	k_spin_unlock(&data->lock, key);
+}
+
+static int i2s_sync_emul_init(const struct device *dev)
+{
+	const struct i2s_sync_emul_config *const cfg = dev->config;
+	struct i2s_sync_emul_data *const data = dev->data;
+
+	data->cfg.sample_rate = cfg->sample_rate;
+	data->cfg.bit_depth = cfg->bit_depth;
+	data->cfg.channel_count = cfg->channel_count;
+	data->cfg.slots = cfg->slots;
+	data->cfg.tx_slot_mask = cfg->tx_slot_mask;
+	data->cfg.rx_slot_mask = cfg->rx_slot_mask;
+	data->tx.dev = dev;
+	data->tx.dir = I2S_DIR_TX;
+	data->rx.dev = dev;
+	data->rx.dir = I2S_DIR_RX;
+	ring_buf_init(&data->line, sizeof(data->line_buf), data->line_buf);
+	k_timer_init(&data->tx.timer, on_transfer_complete, NULL);
+	k_timer_init(&data->rx.timer, on_transfer_complete, NULL);
+
+	return 0;
+}
+
+static const struct i2s_sync_driver_api i2s_sync_emul_api = {
+	.register_cb = i2s_sync_emul_register_cb,
+	.send = i2s_sync_emul_send,
+	.recv = i2s_sync_emul_recv,
+	.disable = i2s_sync_emul_disable,
+	.get_config = i2s_sync_emul_get_config,
+	.configure = i2s_sync_emul_configure,
+	.get_queue_status = i2s_sync_emul_get_queue_status,
+#ifdef CONFIG_I2S_SYNC_STREAM
+	.stream_start = i2s_sync_emul_stream_start,
+#endif
+#ifdef CONFIG_I2S_SYNC_STATS
+	.get_stats = i2s_sync_emul_get_stats,
+#endif
+};
+
+#define I2S_SYNC_EMUL_DEFINE(inst)                                                                 \
+	static struct i2s_sync_emul_data i2s_sync_emul_data_##inst;                                \
+	static const struct i2s_sync_emul_config i2s_sync_emul_config_##inst = {                   \
+		.sample_rate = DT_INST_PROP(inst, sample_rate),                                    \
+		.bit_depth = DT_INST_PROP(inst, bit_depth),                                        \
+		.channel_count = DT_INST_PROP(inst, mono_mode) ? 1 : 2,                            \
+		.slots = DT_INST_PROP_OR(inst, slots, 0),                                          \
+		.tx_slot_mask = DT_INST_PROP_OR(inst, tx_slot_mask, 0),                            \
+		.rx_slot_mask = DT_INST_PROP_OR(inst, rx_slot_mask, 0),                            \
+		.loopback = DT_INST_PROP(inst, loopback),                                          \
+	};                                                                                         \
+	DEVICE_DT_INST_DEFINE(inst, i2s_sync_emul_init, NULL, &i2s_sync_emul_data_##inst,          \
+			      &i2s_sync_emul_config_##inst, POST_KERNEL,                           \
+			      CONFIG_I2S_INIT_PRIORITY, &i2s_sync_emul_api);
+
+DT_INST_FOREACH_STATUS_OKAY(I2S_SYNC_EMUL_DEFINE)
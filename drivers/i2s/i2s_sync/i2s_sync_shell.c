@@ -0,0 +1,82 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/shell/shell.h>
+#include <drivers/i2s_sync.h>
+
+static const struct device *get_device(const struct shell *sh, const char *name)
+{
+	const struct device *const dev = device_get_binding(name);
+
+	if (!dev) {
+		shell_error(sh, "Device %s not found", name);
+	}
+
+	return dev;
+}
+
+static void print_dir(const struct shell *sh, const char *dir,
+		      const struct i2s_sync_dir_stats *const stats)
+{
+	shell_print(sh, "%s: %u blocks, %u underruns, %u overruns", dir, stats->blocks,
+		    stats->underruns, stats->overruns);
+	shell_print(sh, "    queue low %u high %u", stats->queue_low, stats->queue_high);
+	shell_print(sh, "    restart max %u ns", stats->restart_max_ns);
+	shell_print(sh, "    callback max %u ns avg %u ns", stats->callback_max_ns,
+		    stats->callback_avg_ns);
+}
+
+static int cmd_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	const struct device *const dev = get_device(sh, argv[1]);
+	struct i2s_sync_stats stats;
+
+	if (!dev) {
+		return -ENODEV;
+	}
+
+	int const ret = i2s_sync_get_stats(dev, &stats, false);
+
+	if (ret) {
+		shell_error(sh, "Failed to get statistics of %s, err %d", dev->name, ret);
+		return ret;
+	}
+
+	print_dir(sh, "tx", &stats.tx);
+	print_dir(sh, "rx", &stats.rx);
+
+	return 0;
+}
+
+static int cmd_clear(const struct shell *sh, size_t argc, char **argv)
+{
+	const struct device *const dev = get_device(sh, argv[1]);
+	struct i2s_sync_stats stats;
+
+	if (!dev) {
+		return -ENODEV;
+	}
+
+	int const ret = i2s_sync_get_stats(dev, &stats, true);
+
+	if (ret) {
+		shell_error(sh, "Failed to clear statistics of %s, err %d", dev->name, ret);
+	}
+
+	return ret;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+	sub_cmds, SHELL_CMD_ARG(stats, NULL, "Print runtime statistics: stats <device>", cmd_stats,
+				2, 0),
+	SHELL_CMD_ARG(clear, NULL, "Reset runtime statistics: clear <device>", cmd_clear, 2, 0),
+	SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(i2s_sync, &sub_cmds, "I2S sync driver runtime statistics", NULL);
@@ -0,0 +1,168 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#ifndef _DRIVER_I2S_SYNC_STATS_H
+#define _DRIVER_I2S_SYNC_STATS_H
+
+/**
+ * @file
+ * @brief Runtime statistics of a direction, shared by the I2S sync drivers. Times are measured in
+ * cycles of k_cycle_get_32() and converted when read. The statistics start from zero in the
+ * zero-initialised driver data. Without CONFIG_I2S_SYNC_STATS the channels of the drivers have no
+ * statistics and the helpers do nothing.
+ *
+ * The helpers are called with the lock of the driver held, as i2s_sync_stats_read() is, so that a
+ * read and clear cannot lose an update. The exception is i2s_sync_stats_callback(), which is
+ * called once the completion callback returns and takes the lock itself.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <drivers/i2s_sync.h>
+
+struct i2s_sync_chn_stats {
+	uint32_t blocks;
+	uint32_t underruns;
+	uint32_t overruns;
+	uint8_t queue_low;
+	uint8_t queue_high;
+	/* queue_low holds the level after a completion */
+	bool queue_sampled;
+	/* A block completed with none queued, the next one starts when it is provided */
+	bool restart_pending;
+	uint32_t complete_cycles;
+	uint32_t restart_max_cycles;
+	uint32_t callbacks;
+	uint32_t callback_max_cycles;
+	uint64_t callback_total_cycles;
+};
+
+/* Statistics of a driver channel, which only has them with CONFIG_I2S_SYNC_STATS */
+#ifdef CONFIG_I2S_SYNC_STATS
+#define I2S_SYNC_CHN_STATS(chn) (&(chn)->stats)
+#else
+#define I2S_SYNC_CHN_STATS(chn) ((struct i2s_sync_chn_stats *)NULL)
+#endif
+
+/* A block completed at complete_cycles, and queued blocks remain once the next one, if any, has
+ * been started
+ */
+static inline void i2s_sync_stats_block_done(struct i2s_sync_chn_stats *const s,
+					     uint32_t const complete_cycles, uint8_t const queued)
+{
+	if (!IS_ENABLED(CONFIG_I2S_SYNC_STATS)) {
+		return;
+	}
+
+	s->blocks++;
+	s->queue_low = s->queue_sampled ? MIN(s->queue_low, queued) : queued;
+	s->queue_sampled = true;
+
+	if (queued) {
+		s->restart_max_cycles =
+			MAX(s->restart_max_cycles, k_cycle_get_32() - complete_cycles);
+	} else {
+		s->complete_cycles = complete_cycles;
+		s->restart_pending = true;
+	}
+}
+
+/* A block was accepted, with queued blocks now including it */
+static inline void i2s_sync_stats_block_added(struct i2s_sync_chn_stats *const s,
+					      uint8_t const queued)
+{
+	if (!IS_ENABLED(CONFIG_I2S_SYNC_STATS)) {
+		return;
+	}
+
+	s->queue_high = MAX(s->queue_high, queued);
+
+	if (s->restart_pending) {
+		s->restart_max_cycles =
+			MAX(s->restart_max_cycles, k_cycle_get_32() - s->complete_cycles);
+		s->restart_pending = false;
+	}
+}
+
+/* A period of a stream completed, the transfer carries on by itself */
+static inline void i2s_sync_stats_period_done(struct i2s_sync_chn_stats *const s)
+{
+	if (IS_ENABLED(CONFIG_I2S_SYNC_STATS)) {
+		s->blocks++;
+	}
+}
+
+/* The direction stopped, the next block is not a restart */
+static inline void i2s_sync_stats_stopped(struct i2s_sync_chn_stats *const s)
+{
+	if (IS_ENABLED(CONFIG_I2S_SYNC_STATS)) {
+		s->restart_pending = false;
+	}
+}
+
+static inline void i2s_sync_stats_underrun(struct i2s_sync_chn_stats *const s)
+{
+	if (IS_ENABLED(CONFIG_I2S_SYNC_STATS)) {
+		s->underruns++;
+	}
+}
+
+static inline void i2s_sync_stats_overrun(struct i2s_sync_chn_stats *const s)
+{
+	if (IS_ENABLED(CONFIG_I2S_SYNC_STATS)) {
+		s->overruns++;
+	}
+}
+
+/* A completion callback called at start_cycles has returned. Called without the lock held. */
+static inline void i2s_sync_stats_callback(struct k_spinlock *const lock,
+					   struct i2s_sync_chn_stats *const s,
+					   uint32_t const start_cycles)
+{
+	if (!IS_ENABLED(CONFIG_I2S_SYNC_STATS)) {
+		return;
+	}
+
+	uint32_t const cycles = k_cycle_get_32() - start_cycles;
+	k_spinlock_key_t const key = k_spin_lock(lock);
+
+	s->callbacks++;
+	s->callback_max_cycles = MAX(s->callback_max_cycles, cycles);
+	s->callback_total_cycles += cycles;
+
+	k_spin_unlock(lock, key);
+}
+
+static inline void i2s_sync_stats_read(struct i2s_sync_chn_stats *const s,
+				       struct i2s_sync_dir_stats *const out, bool const clear)
+{
+	out->blocks = s->blocks;
+	out->underruns = s->underruns;
+	out->overruns = s->overruns;
+	out->queue_low = s->queue_low;
+	out->queue_high = s->queue_high;
+	out->restart_max_ns = (uint32_t)k_cyc_to_ns_floor64(s->restart_max_cycles);
+	out->callback_max_ns = (uint32_t)k_cyc_to_ns_floor64(s->callback_max_cycles);
+	out->callback_avg_ns =
+		s->callbacks ? (uint32_t)k_cyc_to_ns_floor64(s->callback_total_cycles / s->callbacks)
+			     : 0;
+
+	if (clear) {
+		bool const restart_pending = s->restart_pending;
+		uint32_t const complete_cycles = s->complete_cycles;
+
+		/* A restart in progress is still measured */
+		memset(s, 0, sizeof(*s));
+		s->restart_pending = restart_pending;
+		s->complete_cycles = complete_cycles;
+	}
+}
+
+#endif /* _DRIVER_I2S_SYNC_STATS_H */
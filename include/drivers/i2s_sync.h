@@ -17,11 +17,31 @@
  * called. In the callback, the next block can be sent (TX direction) or buffer can be provided (RX
  * direction). The callback-based driver allows more precise control of the I2S timing than the
  * Zephyr API, since the user can check exactly when a block was completed in the callback.
+ *
+ * Several blocks can be queued in each direction, up to CONFIG_I2S_SYNC_QUEUE_DEPTH. The driver
+ * starts the next queued block as soon as the current one completes, before calling the callback,
+ * so the transfer does not depend on the callback re-arming it before the FIFO drains.
+ *
+ * Alternatively, with CONFIG_I2S_SYNC_STREAM, a direction can be run in streaming mode. The
+ * application provides a single ring buffer divided into periods, and the driver transfers it
+ * continuously, wrapping around at the end, until the direction is disabled. A callback is called
+ * with a timestamp as each period completes, and that period can then be refilled (TX direction)
+ * or consumed (RX direction) while the others are transferred. No per-block configuration is
+ * needed once the stream is running. The I2S controller cannot capture the time of a period
+ * boundary, so the timestamp is read in software in the completion interrupt, from the clock
+ * chosen in the stream configuration.
+ *
+ * Frames on the bus have two slots (left and right) by default, or up to I2S_SYNC_MAX_SLOTS slots
+ * in TDM mode. Each direction transfers the slots selected by its slot mask, and the buffers hold
+ * only those slots, as channels in increasing slot order. Samples of 16 bits take two bytes in the
+ * buffers, samples of 24 or 32 bits take four bytes, with 24-bit samples right-aligned and sign
+ * extended.
  */
 
 #include <zephyr/types.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/i2s.h>
+#include <zephyr/sys/util.h>
 
 enum i2s_sync_status {
 	I2S_SYNC_STATUS_OK = 0,
@@ -30,14 +50,155 @@ enum i2s_sync_status {
 	I2S_SYNC_STATUS_TX_ERROR,
 };
 
+/** Maximum number of slots in a TDM frame */
+#define I2S_SYNC_MAX_SLOTS 8
+
+enum i2s_sync_layout {
+	/** Interleaved, or planar if CONFIG_I2S_SYNC_BUFFER_FORMAT_SEQUENTIAL is set */
+	I2S_SYNC_LAYOUT_DEFAULT = 0,
+	/** Channels of each frame next to each other: {a0, b0, a1, b1, ..., an, bn} */
+	I2S_SYNC_LAYOUT_INTERLEAVED,
+	/** Each channel in a contiguous block: {a0, a1, ..., an, b0, b1, ..., bn} */
+	I2S_SYNC_LAYOUT_PLANAR,
+};
+
 struct i2s_sync_config {
 	uint32_t sample_rate;
 	uint32_t bit_depth;
+	/** Channels in the buffers of a direction with a zero slot mask */
 	uint8_t channel_count;
+	/** Slots in each frame on the bus. 0 or 2 for standard I2S, more for TDM. */
+	uint8_t slots;
+	/** Slots transmitted, bit n for slot n. 0 selects the first channel_count slots. */
+	uint8_t tx_slot_mask;
+	/** Slots received, bit n for slot n. 0 selects the first channel_count slots. */
+	uint8_t rx_slot_mask;
+	/** Arrangement of the channels in the buffers */
+	enum i2s_sync_layout layout;
+};
+
+struct i2s_sync_queue_status {
+	/** Blocks accepted and not yet completed, including the one being transferred */
+	uint8_t queued;
+	/** Maximum number of blocks that can be accepted */
+	uint8_t capacity;
+	/** Times a block completed with no further block provided, so the transfer stopped */
+	uint32_t underruns;
+};
+
+/** Statistics of one direction, gathered with CONFIG_I2S_SYNC_STATS */
+struct i2s_sync_dir_stats {
+	/** Blocks or stream periods completed */
+	uint32_t blocks;
+	/** Times a block completed with no further block provided, so the transfer stopped */
+	uint32_t underruns;
+	/** FIFO overruns (TX FIFO empty or RX FIFO full) reported by the controller */
+	uint32_t overruns;
+	/** Fewest blocks queued just after a block completed, 0 after an underrun */
+	uint8_t queue_low;
+	/** Most blocks queued, including the one being transferred */
+	uint8_t queue_high;
+	/** Longest time from the completion of a block to the start of the next, in nanoseconds.
+	 * The next block is started before the callback if it was queued, otherwise by the
+	 * i2s_sync_send or i2s_sync_recv call that provides it.
+	 */
+	uint32_t restart_max_ns;
+	/** Longest execution time of the completion callback, in nanoseconds */
+	uint32_t callback_max_ns;
+	/** Average execution time of the completion callback, in nanoseconds */
+	uint32_t callback_avg_ns;
+};
+
+struct i2s_sync_stats {
+	struct i2s_sync_dir_stats tx;
+	struct i2s_sync_dir_stats rx;
 };
 
+/**
+ * @brief Get the slots transferred in a direction
+ *
+ * @param cfg I2S configuration
+ * @param dir I2S_DIR_TX or I2S_DIR_RX
+ *
+ * @return Slot mask, with bit n set if slot n is transferred
+ */
+static inline uint8_t i2s_sync_slot_mask(const struct i2s_sync_config *cfg, enum i2s_dir dir)
+{
+	uint8_t const mask = (dir == I2S_DIR_TX) ? cfg->tx_slot_mask : cfg->rx_slot_mask;
+
+	return mask ? mask : (uint8_t)BIT_MASK(cfg->channel_count);
+}
+
+/**
+ * @brief Get the number of channels in the buffers of a direction
+ */
+static inline uint8_t i2s_sync_channels(const struct i2s_sync_config *cfg, enum i2s_dir dir)
+{
+	return (uint8_t)__builtin_popcount(i2s_sync_slot_mask(cfg, dir));
+}
+
+/**
+ * @brief Get the size in bytes of a sample in the buffers
+ */
+static inline size_t i2s_sync_sample_bytes(uint32_t bit_depth)
+{
+	return (bit_depth > 16) ? sizeof(int32_t) : sizeof(int16_t);
+}
+
+/**
+ * @brief Get the size in bytes of one frame in the buffers of a direction
+ */
+static inline size_t i2s_sync_frame_bytes(const struct i2s_sync_config *cfg, enum i2s_dir dir)
+{
+	return i2s_sync_channels(cfg, dir) * i2s_sync_sample_bytes(cfg->bit_depth);
+}
+
+/**
+ * @brief Check whether the buffers hold each channel in a contiguous block
+ */
+static inline bool i2s_sync_is_planar(const struct i2s_sync_config *cfg)
+{
+	return (cfg->layout == I2S_SYNC_LAYOUT_PLANAR) ||
+	       ((cfg->layout == I2S_SYNC_LAYOUT_DEFAULT) &&
+		IS_ENABLED(CONFIG_I2S_SYNC_BUFFER_FORMAT_SEQUENTIAL));
+}
+
 typedef void (*i2s_sync_cb_t)(const struct device *dev, enum i2s_sync_status status, void *buffer);
 
+/**
+ * @brief Streaming mode callback, called each time a period of the ring buffer completes
+ *
+ * @param dev Pointer to the device structure for the driver instance
+ * @param status Status of the transfer of the period
+ * @param period Start of the period that completed. It is not transferred again until all other
+ * periods of the ring buffer have been.
+ * @param timestamp Time read in the completion interrupt, from the get_time function of the
+ * stream configuration or k_cycle_get_32() if it has none. It lags the end of the period by the
+ * interrupt latency.
+ * @param user_data User data given in the stream configuration
+ */
+typedef void (*i2s_sync_stream_cb_t)(const struct device *dev, enum i2s_sync_status status,
+				     void *period, uint32_t timestamp, void *user_data);
+
+struct i2s_sync_stream_config {
+	/** Ring buffer, transferred from start to end then from the start again */
+	void *buf;
+	/** Size of the ring buffer in bytes, a whole number of periods of whole frames */
+	size_t len;
+	/** Number of periods the ring buffer is divided into, from 2 to
+	 * CONFIG_I2S_SYNC_STREAM_MAX_PERIODS
+	 */
+	uint8_t periods;
+	/** Called as each period completes */
+	i2s_sync_stream_cb_t cb;
+	void *user_data;
+	/** Clock the period timestamps are read from, for example the clock the application
+	 * schedules the audio against. Called from the completion interrupt. NULL for
+	 * k_cycle_get_32().
+	 */
+	uint32_t (*get_time)(void);
+};
+
 typedef int (*i2s_sync_api_register_cb_t)(const struct device *dev, enum i2s_dir dir,
 					  i2s_sync_cb_t cb);
 typedef int (*i2s_sync_api_send_t)(const struct device *dev, void *buf, size_t len);
@@ -46,6 +207,12 @@ typedef int (*i2s_sync_api_disable_t)(const struct device *dev, enum i2s_dir dir
 typedef int (*i2s_sync_api_get_config_t)(const struct device *dev, struct i2s_sync_config *cfg);
 typedef int (*i2s_sync_api_configure_t)(const struct device *dev,
 					struct i2s_sync_config const *cfg);
+typedef int (*i2s_sync_api_get_queue_status_t)(const struct device *dev, enum i2s_dir dir,
+					       struct i2s_sync_queue_status *status);
+typedef int (*i2s_sync_api_stream_start_t)(const struct device *dev, enum i2s_dir dir,
+					   const struct i2s_sync_stream_config *cfg);
+typedef int (*i2s_sync_api_get_stats_t)(const struct device *dev, struct i2s_sync_stats *stats,
+					bool clear);
 
 __subsystem struct i2s_sync_driver_api {
 	i2s_sync_api_register_cb_t register_cb;
@@ -54,6 +221,9 @@ __subsystem struct i2s_sync_driver_api {
 	i2s_sync_api_disable_t disable;
 	i2s_sync_api_get_config_t get_config;
 	i2s_sync_api_configure_t configure;
+	i2s_sync_api_get_queue_status_t get_queue_status;
+	i2s_sync_api_stream_start_t stream_start;
+	i2s_sync_api_get_stats_t get_stats;
 };
 
 /**
@@ -79,11 +249,17 @@ static inline int z_impl_i2s_sync_register_cb(const struct device *dev, enum i2s
 /**
  * @brief Send data over I2S
  *
+ * The block is transmitted as soon as the blocks queued before it have been transmitted. Blocks
+ * queued before a DMA transfer starts are linked into it, so the DMA controller moves on to them
+ * without waiting for the completion interrupt.
+ *
  * @param dev Pointer to the device structure for the driver instance
  * @param buf Pointer to data to be transmitted
  * @param len Size in bytes of data to be transmitted
  *
- * @retval 0 if successful, negative error on failure
+ * @retval 0 if successful
+ * @retval -EINPROGRESS if CONFIG_I2S_SYNC_QUEUE_DEPTH blocks are already queued
+ * @retval Other negative error on failure
  */
 __syscall int i2s_sync_send(const struct device *dev, void *buf, size_t len);
 
@@ -97,11 +273,16 @@ static inline int z_impl_i2s_sync_send(const struct device *dev, void *buf, size
 /**
  * @brief Receive data over I2S
  *
+ * The buffer is filled as soon as the buffers queued before it have been filled. Buffers queued
+ * before a DMA transfer starts are linked into it, as for i2s_sync_send().
+ *
  * @param dev Pointer to the device structure for the driver instance
  * @param buf Pointer to buffer for received data to be placed in
  * @param len Size of receive buffer in bytes
  *
- * @retval 0 if successful, negative error on failure
+ * @retval 0 if successful
+ * @retval -EINPROGRESS if CONFIG_I2S_SYNC_QUEUE_DEPTH buffers are already queued
+ * @retval Other negative error on failure
  */
 __syscall int i2s_sync_recv(const struct device *dev, void *buf, size_t len);
 
@@ -152,7 +333,9 @@ static inline int z_impl_i2s_sync_get_config(const struct device *dev, struct i2
  * @param dev Pointer to the device structure for the driver instance
  * @param cfg Pointer to the i2s_sync_config structure to be filled with the I2S config parameters
  *
- * @return 0 if successful, negative error on failure
+ * @retval 0 if successful
+ * @retval -ENOTSUP if the slots, slot masks or layout are not supported by the device
+ * @retval Other negative error on failure
  */
 __syscall int i2s_sync_configure(const struct device *dev, const struct i2s_sync_config *cfg);
 
@@ -164,6 +347,95 @@ static inline int z_impl_i2s_sync_configure(const struct device *dev,
 	return api->configure(dev, cfg);
 }
 
+/**
+ * @brief Get the number of blocks queued in a direction, and its underrun count
+ *
+ * @param dev Pointer to the device structure for the driver instance
+ * @param dir Direction to query, I2S_DIR_TX or I2S_DIR_RX
+ * @param status Pointer to the structure to be filled with the queue status
+ *
+ * @retval 0 if successful
+ * @retval -ENOSYS if the driver does not support queue status
+ * @retval Other negative error on failure
+ */
+__syscall int i2s_sync_get_queue_status(const struct device *dev, enum i2s_dir dir,
+					struct i2s_sync_queue_status *status);
+
+static inline int z_impl_i2s_sync_get_queue_status(const struct device *dev, enum i2s_dir dir,
+						   struct i2s_sync_queue_status *status)
+{
+	const struct i2s_sync_driver_api *api = (const struct i2s_sync_driver_api *)dev->api;
+
+	if (!api->get_queue_status) {
+		return -ENOSYS;
+	}
+
+	return api->get_queue_status(dev, dir, status);
+}
+
+/**
+ * @brief Start streaming a ring buffer continuously in one direction
+ *
+ * The stream runs until the direction is disabled with i2s_sync_disable. While it runs,
+ * i2s_sync_send or i2s_sync_recv in the same direction return -EBUSY. For the TX direction, the
+ * whole ring buffer should be filled before the stream is started.
+ *
+ * @param dev Pointer to the device structure for the driver instance
+ * @param dir Direction to stream, I2S_DIR_TX or I2S_DIR_RX
+ * @param cfg Ring buffer and callback. The structure is copied, the ring buffer must remain valid
+ * until the direction is disabled.
+ *
+ * @retval 0 if successful
+ * @retval -EBUSY if the direction is already transferring
+ * @retval -ENOSYS if the driver does not support streaming mode
+ * @retval -ENOTSUP if streaming mode is not supported with the configuration of the device
+ * @retval Other negative error on failure
+ */
+__syscall int i2s_sync_stream_start(const struct device *dev, enum i2s_dir dir,
+				    const struct i2s_sync_stream_config *cfg);
+
+static inline int z_impl_i2s_sync_stream_start(const struct device *dev, enum i2s_dir dir,
+					       const struct i2s_sync_stream_config *cfg)
+{
+	const struct i2s_sync_driver_api *api = (const struct i2s_sync_driver_api *)dev->api;
+
+	if (!api->stream_start) {
+		return -ENOSYS;
+	}
+
+	return api->stream_start(dev, dir, cfg);
+}
+
+/**
+ * @brief Get the runtime statistics of both directions
+ *
+ * Statistics are gathered from the time the device is initialised, or from the last time they
+ * were cleared. The queue watermarks stand in for FIFO watermarks, as the controller does not
+ * report its FIFO level, and show how close each direction came to an underrun.
+ *
+ * @param dev Pointer to the device structure for the driver instance
+ * @param stats Pointer to the structure to be filled with the statistics
+ * @param clear Reset the statistics once they have been read
+ *
+ * @retval 0 if successful
+ * @retval -ENOSYS if the driver does not gather statistics, or CONFIG_I2S_SYNC_STATS is not set
+ * @retval Other negative error on failure
+ */
+__syscall int i2s_sync_get_stats(const struct device *dev, struct i2s_sync_stats *stats,
+				 bool clear);
+
+static inline int z_impl_i2s_sync_get_stats(const struct device *dev,
+					    struct i2s_sync_stats *stats, bool clear)
+{
+	const struct i2s_sync_driver_api *api = (const struct i2s_sync_driver_api *)dev->api;
+
+	if (!api->get_stats) {
+		return -ENOSYS;
+	}
+
+	return api->get_stats(dev, stats, clear);
+}
+
 #include <syscalls/i2s_sync.h>
 
 #endif /* _DRIVERS_I2S_SYNC_H */
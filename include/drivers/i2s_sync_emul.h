@@ -0,0 +1,76 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#ifndef _DRIVERS_I2S_SYNC_EMUL_H
+#define _DRIVERS_I2S_SYNC_EMUL_H
+
+/**
+ * @file
+ * @brief Test controls of the emulated I2S sync device
+ *
+ * The emulated device implements the I2S sync API on the system clock. Each transfer takes the
+ * time its frames would take on the bus at the configured sample rate, scaled by a clock error
+ * that can be set to model drift between the audio clock and another clock of the system. Hooks
+ * let a test see the samples as they go out on the bus, or provide the samples captured, with the
+ * time of the first frame.
+ */
+
+#include <zephyr/device.h>
+#include <drivers/i2s_sync.h>
+
+/**
+ * @brief Hook called for each block or period transferred
+ *
+ * For transmit it is called as the transfer starts on the bus, with the samples about to be
+ * played. For receive it is called on completion, before the callback, after the samples have
+ * been received from the loopback or filled with silence, and may overwrite them. It is called
+ * with the lock of the device held and must not call back into the device, other than to get its
+ * configuration.
+ *
+ * @param buf Transfer buffer
+ * @param len Length of the transfer in bytes
+ * @param start_us System uptime in microseconds at which the first frame is on the bus
+ */
+typedef void (*i2s_sync_emul_hook_t)(void *buf, size_t len, uint32_t start_us);
+
+struct i2s_sync_emul_counters {
+	/** Transmit blocks or periods completed */
+	uint32_t tx_blocks;
+	/** Times the transmitter ran out of blocks while enabled */
+	uint32_t tx_underruns;
+	/** Receive blocks or periods completed */
+	uint32_t rx_blocks;
+};
+
+/**
+ * @brief Set the error of the emulated audio clock
+ *
+ * @param dev Emulated I2S device
+ * @param ppm Clock error in parts per million, positive for a fast clock. Applies to transfers
+ * started after the call.
+ */
+void i2s_sync_emul_set_clock_ppm(const struct device *dev, int32_t ppm);
+
+/**
+ * @brief Set the hooks called for each transfer, NULL for none
+ */
+void i2s_sync_emul_set_hooks(const struct device *dev, i2s_sync_emul_hook_t tx_hook,
+			     i2s_sync_emul_hook_t rx_hook);
+
+/**
+ * @brief Get and optionally clear the transfer counters
+ *
+ * @param dev Emulated I2S device
+ * @param counters Counters since they were last cleared, or NULL to only clear them
+ * @param clear Whether to clear the counters
+ */
+void i2s_sync_emul_get_counters(const struct device *dev, struct i2s_sync_emul_counters *counters,
+				bool clear);
+
+#endif /* _DRIVERS_I2S_SYNC_EMUL_H */
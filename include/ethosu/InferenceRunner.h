@@ -3,6 +3,9 @@
 
 #include <zephyr/kernel.h>
 
+#include <type_traits>
+#include <utility>
+
 /**
  * @brief InferenceRunner: A reusable threaded inference loop for embedded ML using Zephyr RTOS.
  *
@@ -24,6 +27,18 @@
  *                        Notes:
  *                        - InputSize must exactly match Input::OutputSize.
  *
+ *                        InferenceMode::Pipelined additionally requires the model to hold two
+ *                        pre-processed inputs, so that one is pre-processed while the NPU runs on
+ *                        the other:
+ *                        ----------------------------------------
+ *                        bool PreProcess(size_t slot);   // Pre-process into input slot 0 or 1
+ *                        bool RunInference(size_t slot); // Run on input slot 0 or 1
+ *                        ----------------------------------------
+ *                        Notes:
+ *                        - GetInputBuffer() and PreProcess() are called from one thread, and
+ *                          RunInference(), PostProcess() and GetResult() from another.
+ *                        - A slot is not pre-processed again before RunInference() on it returned.
+ *
  * @tparam Input          Class responsible for supplying raw input data to the model.
  *                        Required interface:
  *                        ----------------------------------------
@@ -34,6 +49,13 @@
  * OutputSize bytes
  *                        ----------------------------------------
  *
+ *                        An Input that drops data can report it, and a model that keeps earlier
+ *                        input can then drop it, before the buffer is pre-processed:
+ *                        ----------------------------------------
+ *                        bool Discontinuous();   // Input: data was dropped before the buffer
+ *                        void ResetInput();      // Model: forget the input before the buffer
+ *                        ----------------------------------------
+ *
  * @tparam OutputHandler  Class responsible for consuming the model's result.
  *                        Required interface:
  *                        ----------------------------------------
@@ -49,10 +71,17 @@
  *
  * @tparam StackSize      Size of the Zephyr thread's stack (default: 2024 bytes).
  * @tparam ThreadPriority Zephyr thread priority (default: 10).
+ * @tparam Mode           InferenceMode::Serial runs all stages in turn on one thread.
+ *                        InferenceMode::Pipelined acquires and pre-processes frame N+1 on one
+ *                        thread while a second thread, with the same stack size and priority,
+ *                        runs frame N on the NPU and post-processes it (default: Serial).
  *
  * @note Copy/move constructors and assignment operators are disabled due to internal thread/stack
  * ownership.
  * @note The thread starts once via `Start()` and terminates cleanly in the destructor.
+ * @note `GetStats()` returns the average time of each stage per frame.
+ * @note An Input may block until it has input worth running the model on, for example a voice
+ * activity gate, in which case only the frames it passed on are counted.
  *
  * @example
  *   using MyRunner = InferenceRunner<MyModel, MyInput, MyOutputHandler<MyModel::Result>>;
@@ -60,8 +89,22 @@
  *   runner.Start();
  */
 
+enum class InferenceMode {
+	Serial,
+	Pipelined,
+};
+
+/* Average time of each stage per frame, in microseconds */
+struct InferenceRunnerStats {
+	uint32_t frames;
+	uint32_t acquireUs;
+	uint32_t preProcessUs;
+	uint32_t inferenceUs;
+	uint32_t postProcessUs;
+};
+
 template <typename Model, typename Input, typename OutputHandler, size_t StackSize = 2024,
-	int ThreadPriority = 10>
+	int ThreadPriority = 10, InferenceMode Mode = InferenceMode::Serial>
 class InferenceRunner
 {
 public:
@@ -70,6 +113,8 @@ public:
 	InferenceRunner()
 	{
 		k_sem_init(&m_inferenceSem, 0, 1);
+		k_sem_init(&m_freeSem, Slots, Slots);
+		k_sem_init(&m_readySem, 0, Slots);
 	}
 
 	InferenceRunner(const InferenceRunner &) = delete;
@@ -79,9 +124,17 @@ public:
 
 	~InferenceRunner()
 	{
+		if (!m_started) {
+			return;
+		}
+
 		m_input.Stop();
 		k_sem_give(&m_inferenceSem);
 		k_thread_join(&m_inferenceThread, K_FOREVER);
+
+		if (m_npuStarted) {
+			k_thread_join(&m_npuThread, K_FOREVER);
+		}
 	}
 
 	void Start(void)
@@ -96,12 +149,108 @@ public:
 				ThreadEntry, this, NULL, NULL, ThreadPriority, 0, K_NO_WAIT);
 	}
 
+	/* Read the stage times averaged over the frames since the last clear */
+	InferenceRunnerStats GetStats(bool clear = false)
+	{
+		k_spinlock_key_t key = k_spin_lock(&m_statsLock);
+		const uint32_t frames = m_stats.frames;
+		InferenceRunnerStats stats = {};
+
+		stats.frames = frames;
+		if (frames) {
+			stats.acquireUs = AverageUs(m_stats.acquire, frames);
+			stats.preProcessUs = AverageUs(m_stats.preProcess, frames);
+			stats.inferenceUs = AverageUs(m_stats.inference, frames);
+			stats.postProcessUs = AverageUs(m_stats.postProcess, frames);
+		}
+
+		if (clear) {
+			m_stats = {};
+		}
+
+		k_spin_unlock(&m_statsLock, key);
+
+		return stats;
+	}
+
+	/* The input, for statistics of its own */
+	Input &GetInput(void)
+	{
+		return m_input;
+	}
+
 private:
+	static constexpr unsigned int Slots = 2;
+	/* The NPU thread only exists in pipelined mode */
+	static constexpr size_t NpuStackSize = (Mode == InferenceMode::Pipelined) ? StackSize : 1;
+
+	/* Cycles spent in each stage, summed over frames */
+	struct StageCycles {
+		uint32_t frames;
+		uint64_t acquire;
+		uint64_t preProcess;
+		uint64_t inference;
+		uint64_t postProcess;
+	};
+
+	static uint32_t AverageUs(uint64_t cycles, uint32_t frames)
+	{
+		return static_cast<uint32_t>(k_cyc_to_us_floor64(cycles / frames));
+	}
+
 	static void ThreadEntry(void *ctx, void *, void *)
 	{
 		static_cast<InferenceRunner *>(ctx)->Run();
 	}
 
+	static void NpuThreadEntry(void *ctx, void *, void *)
+	{
+		static_cast<InferenceRunner *>(ctx)->RunNpu();
+	}
+
+	template <typename M, typename I, typename = void>
+	struct TracksDiscontinuity : std::false_type {
+	};
+
+	template <typename M, typename I>
+	struct TracksDiscontinuity<M, I,
+				   std::void_t<decltype(std::declval<M &>().ResetInput()),
+					       decltype(std::declval<I &>().Discontinuous())>>
+		: std::true_type {
+	};
+
+	/* Acquire the next input into the model buffer */
+	bool Acquire(void)
+	{
+		if (!m_input.GetInputData(m_model.GetInputBuffer())) {
+			return false;
+		}
+
+		if constexpr (TracksDiscontinuity<Model, Input>::value) {
+			if (m_input.Discontinuous()) {
+				m_model.ResetInput();
+			}
+		}
+
+		return true;
+	}
+
+	/* Add the cycles a stage took since start, and return the time the stage ended */
+	uint32_t AddStage(uint64_t StageCycles::*stage, uint32_t start, bool frameDone = false)
+	{
+		const uint32_t now = k_cycle_get_32();
+		k_spinlock_key_t key = k_spin_lock(&m_statsLock);
+
+		m_stats.*stage += now - start;
+		if (frameDone) {
+			m_stats.frames++;
+		}
+
+		k_spin_unlock(&m_statsLock, key);
+
+		return now;
+	}
+
 	void Run(void)
 	{
 		if (!m_model.Init()) {
@@ -112,31 +261,122 @@ private:
 			return;
 		}
 
+		if constexpr (Mode == InferenceMode::Pipelined) {
+			m_npuStarted = true;
+			k_thread_create(&m_npuThread, m_npuStack, K_THREAD_STACK_SIZEOF(m_npuStack),
+					NpuThreadEntry, this, NULL, NULL, ThreadPriority, 0,
+					K_NO_WAIT);
+
+			RunAcquire();
+		} else {
+			RunSerial();
+		}
+
+		m_input.Stop();
+	}
+
+	void RunSerial(void)
+	{
 		while (true) {
 			if (k_sem_take(&m_inferenceSem, K_NO_WAIT) == 0) {
 				break;
 			}
 
-			if (!m_input.GetInputData(m_model.GetInputBuffer())) {
+			uint32_t start = k_cycle_get_32();
+
+			if (!Acquire()) {
 				break;
 			}
 
+			start = AddStage(&StageCycles::acquire, start);
+
 			if (!m_model.PreProcess()) {
 				break;
 			}
 
+			start = AddStage(&StageCycles::preProcess, start);
+
 			if (!m_model.RunInference()) {
 				break;
 			}
 
+			start = AddStage(&StageCycles::inference, start);
+
 			if (!m_model.PostProcess()) {
 				break;
 			}
 
 			m_outputHandler.ProcessOutput(m_model.GetResult());
+			AddStage(&StageCycles::postProcess, start, true);
 		}
+	}
 
-		m_input.Stop();
+	/* Acquire and pre-process frames into free slots, for the NPU thread to run */
+	void RunAcquire(void)
+	{
+		for (size_t slot = 0; !m_stopping; slot = (slot + 1) % Slots) {
+			if (k_sem_take(&m_inferenceSem, K_NO_WAIT) == 0) {
+				break;
+			}
+
+			uint32_t start = k_cycle_get_32();
+
+			/* Raw input does not depend on a slot, so it is acquired while waiting */
+			if (!Acquire()) {
+				break;
+			}
+
+			start = AddStage(&StageCycles::acquire, start);
+
+			k_sem_take(&m_freeSem, K_FOREVER);
+			if (m_stopping) {
+				break;
+			}
+
+			start = k_cycle_get_32();
+
+			if (!m_model.PreProcess(slot)) {
+				break;
+			}
+
+			AddStage(&StageCycles::preProcess, start);
+			k_sem_give(&m_readySem);
+		}
+
+		m_stopping = true;
+		k_sem_give(&m_readySem);
+	}
+
+	/* Run the pre-processed slots in order and post-process their results */
+	void RunNpu(void)
+	{
+		for (size_t slot = 0;; slot = (slot + 1) % Slots) {
+			k_sem_take(&m_readySem, K_FOREVER);
+			if (m_stopping) {
+				break;
+			}
+
+			uint32_t start = k_cycle_get_32();
+			const bool ok = m_model.RunInference(slot);
+
+			/* The input has been consumed, pre-processing can reuse the slot */
+			k_sem_give(&m_freeSem);
+			if (!ok) {
+				break;
+			}
+
+			start = AddStage(&StageCycles::inference, start);
+
+			if (!m_model.PostProcess()) {
+				break;
+			}
+
+			m_outputHandler.ProcessOutput(m_model.GetResult());
+			AddStage(&StageCycles::postProcess, start, true);
+		}
+
+		m_stopping = true;
+		k_sem_give(&m_freeSem);
 	}
 
 private:
@@ -144,9 +384,17 @@ private:
 	Input m_input;
 	OutputHandler m_outputHandler;
 	K_KERNEL_STACK_MEMBER(m_stack, StackSize);
+	K_KERNEL_STACK_MEMBER(m_npuStack, NpuStackSize);
 	struct k_thread m_inferenceThread;
+	struct k_thread m_npuThread;
 	struct k_sem m_inferenceSem;
+	struct k_sem m_freeSem;
+	struct k_sem m_readySem;
+	struct k_spinlock m_statsLock;
+	StageCycles m_stats = {};
+	volatile bool m_stopping = false;
 	bool m_started = false;
+	bool m_npuStarted = false;
 };
 
 #endif /* INFERENCERUNNER_H */
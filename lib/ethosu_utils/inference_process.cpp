@@ -13,8 +13,10 @@
 #include <tensorflow/lite/micro/micro_profiler.h>
 #include <tensorflow/lite/schema/schema_generated.h>
 
+#include <algorithm>
 #include <cmsis_compiler.h>
 #include <inttypes.h>
+#include <string.h>
 #include <zephyr/kernel.h>
 
 using namespace std;
@@ -33,6 +35,12 @@ bool copyOutput(const TfLiteTensor &src, InferenceProcess::DataPtr &dst)
 		return true;
 	}
 
+	/* Already in place when the job reads the output from the arena */
+	if (dst.data == src.data.data) {
+		dst.size = src.bytes;
+		return false;
+	}
+
 	copy(src.data.uint8, src.data.uint8 + src.bytes, static_cast<uint8_t *>(dst.data));
 	dst.size = src.bytes;
 
@@ -107,10 +115,37 @@ void InferenceJob::clean()
 	}
 }
 
-bool InferenceProcess::runJob(InferenceJob &job)
+void InferenceProcess::addOperators()
 {
+	resolver.AddEthosU();
+}
+
+void InferenceProcess::resetInterpreter()
+{
+	interpreter.reset();
+	interpreterModel = DataPtr();
+}
+
+bool InferenceProcess::prepareInterpreter(const DataPtr &networkModel)
+{
+	/* The arena is only used by this interpreter, so it can be reused while the model is the
+	 * same. Variable tensors are cleared as they would be in a new interpreter.
+	 */
+	if (interpreter && (interpreterModel.data == networkModel.data) &&
+	    (interpreterModel.size == networkModel.size)) {
+		if (interpreter->ResetVariableTensors() != kTfLiteOk) {
+			printk("Failed to reset variable tensors. model=%p\n", networkModel.data);
+			resetInterpreter();
+			return true;
+		}
+
+		return false;
+	}
+
+	resetInterpreter();
+
 	/* Get model handle and verify that the version is correct */
-	const tflite::Model *model = ::tflite::GetModel(job.networkModel.data);
+	const tflite::Model *model = ::tflite::GetModel(networkModel.data);
 	if (model->version() != TFLITE_SCHEMA_VERSION) {
 		printk("Model schema version unsupported: version=%" PRIu32 ", supported=%d.\n",
 		       model->version(), TFLITE_SCHEMA_VERSION);
@@ -118,28 +153,94 @@ bool InferenceProcess::runJob(InferenceJob &job)
 	}
 
 	/* Create the TFL micro interpreter */
-	tflite::MicroMutableOpResolver <1> resolver;
-	resolver.AddEthosU();
-
-	tflite::MicroInterpreter interpreter(model, resolver, tensorArena, tensorArenaSize);
+	interpreter = make_unique<tflite::MicroInterpreter>(model, resolver, tensorArena,
+							      tensorArenaSize);
 
 	/* Allocate tensors */
-	TfLiteStatus allocate_status = interpreter.AllocateTensors();
+	TfLiteStatus allocate_status = interpreter->AllocateTensors();
 	if (allocate_status != kTfLiteOk) {
-		printk("Failed to allocate tensors for inference. job=%p\n", &job);
+		printk("Failed to allocate tensors for inference. model=%p\n", networkModel.data);
+		resetInterpreter();
+		return true;
+	}
+
+	interpreterModel = networkModel;
+	generation++;
+
+	return false;
+}
+
+size_t InferenceProcess::arenaUsedBytes() const
+{
+	return interpreter ? interpreter->arena_used_bytes() : 0;
+}
+
+bool InferenceProcess::getTensors(InferenceJob &job)
+{
+	if (prepareInterpreter(job.networkModel)) {
 		return true;
 	}
 
-	if (job.input.size() != interpreter.inputs_size()) {
+	job.input.clear();
+	for (size_t i = 0; i < interpreter->inputs_size(); ++i) {
+		const TfLiteTensor *tensor = interpreter->input(i);
+
+		job.input.emplace_back(tensor->data.data, tensor->bytes);
+	}
+
+	job.output.clear();
+	for (size_t i = 0; i < interpreter->outputs_size(); ++i) {
+		const TfLiteTensor *tensor = interpreter->output(i);
+
+		job.output.emplace_back(tensor->data.data, tensor->bytes);
+	}
+
+	job.tensorGeneration = generation;
+
+	return false;
+}
+
+bool InferenceProcess::usesArena(const InferenceJob &job) const
+{
+	auto inArena = [this](const DataPtr &ptr) {
+		const uint8_t *data = static_cast<const uint8_t *>(ptr.data);
+
+		return (data >= tensorArena) && (data < tensorArena + tensorArenaSize);
+	};
+
+	return any_of(job.input.begin(), job.input.end(), inArena) ||
+	       any_of(job.output.begin(), job.output.end(), inArena);
+}
+
+bool InferenceProcess::runJob(InferenceJob &job)
+{
+	uint32_t start = k_cycle_get_32();
+
+	if (prepareInterpreter(job.networkModel)) {
+		return true;
+	}
+
+	job.setupCycles = k_cycle_get_32() - start;
+
+	/* The arena tensors of another interpreter have moved, and their data is lost */
+	if (usesArena(job) && (job.tensorGeneration != generation)) {
+		printk("Job tensors are stale, another model was prepared in the arena. job=%s\n",
+		       job.name.c_str());
+		return true;
+	}
+
+	start = k_cycle_get_32();
+
+	if (job.input.size() != interpreter->inputs_size()) {
 		printk("Number of job and network inputs do not match. input=%zu, network=%zu\n",
-		       job.input.size(), interpreter.inputs_size());
+		       job.input.size(), interpreter->inputs_size());
 		return true;
 	}
 
 	/* Copy input data */
-	for (size_t i = 0; i < interpreter.inputs_size(); ++i) {
+	for (size_t i = 0; i < interpreter->inputs_size(); ++i) {
 		const DataPtr &input = job.input[i];
-		const TfLiteTensor *tensor = interpreter.input(i);
+		const TfLiteTensor *tensor = interpreter->input(i);
 
 		if (input.size != tensor->bytes) {
 			printk("Input tensor size mismatch. index=%zu, input=%zu, network=%u\n", i,
@@ -147,42 +248,55 @@ bool InferenceProcess::runJob(InferenceJob &job)
 			return true;
 		}
 
-		copy(static_cast<char *>(input.data), static_cast<char *>(input.data) + input.size,
-		     tensor->data.uint8);
+		/* Not copied when the producer wrote the input in place */
+		if (input.data != tensor->data.data) {
+			copy(static_cast<char *>(input.data),
+			     static_cast<char *>(input.data) + input.size, tensor->data.uint8);
+		}
 	}
 
+	job.inputCycles = k_cycle_get_32() - start;
+
 	/* Run the inference */
-	TfLiteStatus invoke_status = interpreter.Invoke();
+	start = k_cycle_get_32();
+	TfLiteStatus invoke_status = interpreter->Invoke();
+	job.invokeCycles = k_cycle_get_32() - start;
+
 	if (invoke_status != kTfLiteOk) {
 		printk("Invoke failed for inference. job=%s\n", job.name.c_str());
+		resetInterpreter();
 		return true;
 	}
 
 	/* Copy output data */
+	start = k_cycle_get_32();
+
 	if (job.output.size() > 0) {
-		if (interpreter.outputs_size() != job.output.size()) {
+		if (interpreter->outputs_size() != job.output.size()) {
 			printk("Number of job and network outputs do not match. job=%zu, network=%u\n",
-			       job.output.size(), interpreter.outputs_size());
+			       job.output.size(), interpreter->outputs_size());
 			return true;
 		}
 
-		for (unsigned i = 0; i < interpreter.outputs_size(); ++i) {
-			if (copyOutput(*interpreter.output(i), job.output[i])) {
+		for (unsigned i = 0; i < interpreter->outputs_size(); ++i) {
+			if (copyOutput(*interpreter->output(i), job.output[i])) {
 				return true;
 			}
 		}
 	}
 
+	job.outputCycles = k_cycle_get_32() - start;
+
 	if (job.expectedOutput.size() > 0) {
-		if (job.expectedOutput.size() != interpreter.outputs_size()) {
+		if (job.expectedOutput.size() != interpreter->outputs_size()) {
 			printk("Number of job and network expected outputs do not match. job=%zu, network=%zu\n",
-			       job.expectedOutput.size(), interpreter.outputs_size());
+			       job.expectedOutput.size(), interpreter->outputs_size());
 			return true;
 		}
 
-		for (unsigned int i = 0; i < interpreter.outputs_size(); i++) {
+		for (unsigned int i = 0; i < interpreter->outputs_size(); i++) {
 			const DataPtr &expected = job.expectedOutput[i];
-			const TfLiteTensor *output = interpreter.output(i);
+			const TfLiteTensor *output = interpreter->output(i);
 
 			if (expected.size != output->bytes) {
 				printk("Expected output tensor size mismatch. index=%u, expected=%zu, network=%zu\n",
@@ -190,14 +304,17 @@ bool InferenceProcess::runJob(InferenceJob &job)
 				return true;
 			}
 
-			for (unsigned int j = 0; j < output->bytes; ++j) {
-				if (output->data.uint8[j] !=
-				    static_cast<uint8_t *>(expected.data)[j]) {
-					printk("Expected output tensor data mismatch. index=%u, offset=%u, expected=%02x, network=%02x\n",
-					       i, j, static_cast<uint8_t *>(expected.data)[j],
-					       output->data.uint8[j]);
-					return true;
-				}
+			const uint8_t *expectedData = static_cast<const uint8_t *>(expected.data);
+
+			/* Only look for the offset when the output differs */
+			if (memcmp(output->data.uint8, expectedData, output->bytes) != 0) {
+				auto diff = mismatch(output->data.uint8,
+						     output->data.uint8 + output->bytes, expectedData);
+				unsigned int j = diff.first - output->data.uint8;
+
+				printk("Expected output tensor data mismatch. index=%u, offset=%u, expected=%02x, network=%02x\n",
+				       i, j, expectedData[j], output->data.uint8[j]);
+				return true;
 			}
 		}
 	}
@@ -6,12 +6,21 @@
 
 #pragma once
 
+#include <tensorflow/lite/micro/micro_interpreter.h>
+#include <tensorflow/lite/micro/micro_mutable_op_resolver.h>
+
 #include <array>
+#include <memory>
 #include <queue>
 #include <stdlib.h>
 #include <string>
 #include <vector>
 
+/* Operators the resolver holds, for applications whose models need more than the Ethos-U one */
+#ifndef INFERENCE_PROCESS_MAX_OPS
+#define INFERENCE_PROCESS_MAX_OPS 1
+#endif
+
 namespace InferenceProcess
 {
 struct DataPtr {
@@ -31,6 +40,18 @@ struct InferenceJob {
 	std::vector<DataPtr> output;
 	std::vector<DataPtr> expectedOutput;
 
+	/* Cycles spent preparing the interpreter, only a check when the previous one is reused */
+	uint32_t setupCycles = 0;
+	/* Cycles spent copying the input into the arena */
+	uint32_t inputCycles = 0;
+	/* Cycles spent running the network */
+	uint32_t invokeCycles = 0;
+	/* Cycles spent copying the output out of the arena */
+	uint32_t outputCycles = 0;
+
+	/* Interpreter that getTensors took the arena tensors of the job from */
+	uint32_t tensorGeneration = 0;
+
 	InferenceJob();
 	InferenceJob(const std::string &name, const DataPtr &networkModel,
 		     const std::vector<DataPtr> &input, const std::vector<DataPtr> &output,
@@ -45,12 +66,39 @@ class InferenceProcess {
 	InferenceProcess(uint8_t *_tensorArena, size_t _tensorArenaSize)
 		: tensorArena(_tensorArena), tensorArenaSize(_tensorArenaSize)
 	{
+		addOperators();
 	}
 
 	bool runJob(InferenceJob &job);
 
+	/* Prepare the interpreter for the model of a job and set the job input and output to its
+	 * tensors in the tensor arena. Job buffers that are these tensors are not copied: a producer
+	 * writes the input in place before each job, and the output can be read in place until the
+	 * next job. The tensors are valid until another model is prepared in the arena, after which
+	 * runJob fails the job until getTensors is called again.
+	 */
+	bool getTensors(InferenceJob &job);
+
+	/* Arena used by the interpreter of the last model run, 0 when there is none */
+	size_t arenaUsedBytes() const;
+
+	/* Drop the cached interpreter, for when the model data changes in place */
+	void resetInterpreter();
+
     private:
+	/* Register the operators of the models, defined with runJob */
+	void addOperators();
+	bool prepareInterpreter(const DataPtr &networkModel);
+	bool usesArena(const InferenceJob &job) const;
+
 	uint8_t *tensorArena;
 	const size_t tensorArenaSize;
+
+	/* The interpreter of the last model run, reused while jobs run the same model */
+	tflite::MicroMutableOpResolver<INFERENCE_PROCESS_MAX_OPS> resolver;
+	std::unique_ptr<tflite::MicroInterpreter> interpreter;
+	DataPtr interpreterModel;
+	/* Incremented for each interpreter prepared, which moves the tensors in the arena */
+	uint32_t generation = 0;
 };
 } /* namespace InferenceProcess */
@@ -0,0 +1,134 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include "inference_scheduler.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace InferenceProcess
+{
+ScheduledJob::ScheduledJob(const string &_name, const DataPtr &_networkModel,
+			   const vector<DataPtr> &_input, const vector<DataPtr> &_output,
+			   const vector<DataPtr> &_expectedOutput, int _priority,
+			   int64_t _deadline, Callback _done, void *_userData)
+	: InferenceJob(_name, _networkModel, _input, _output, _expectedOutput),
+	  priority(_priority), deadline(_deadline), done(_done), userData(_userData)
+{
+}
+
+InferenceScheduler::InferenceScheduler(uint8_t *tensorArena, size_t tensorArenaSize)
+	: process(tensorArena, tensorArenaSize)
+{
+	k_sem_init(&pending, 0, K_SEM_MAX_LIMIT);
+	sys_dlist_init(&queue);
+}
+
+void InferenceScheduler::start(k_thread_stack_t *stack, size_t stackSize, int threadPriority)
+{
+	k_thread_create(&thread, stack, stackSize, threadEntry, this, NULL, NULL, threadPriority,
+			0, K_NO_WAIT);
+}
+
+/* Insertion condition: the queued job runs after the new one */
+int InferenceScheduler::runsBefore(sys_dnode_t *node, void *data)
+{
+	const ScheduledJob *queued = CONTAINER_OF(node, ScheduledJob::QueueNode, node)->job;
+	const ScheduledJob *job = static_cast<const ScheduledJob *>(data);
+
+	if (job->priority != queued->priority) {
+		return job->priority < queued->priority;
+	}
+
+	/* Jobs without a deadline run after those with one, in submission order */
+	return (job->deadline != 0) &&
+	       ((queued->deadline == 0) || (job->deadline < queued->deadline));
+}
+
+void InferenceScheduler::submit(ScheduledJob &job)
+{
+	job.status = false;
+	job.queueDelayUs = 0;
+	job.deadlineMissed = false;
+	job.submitCycles = k_cycle_get_32();
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	job.queueNode.job = &job;
+	sys_dlist_insert_at(&queue, &job.queueNode.node, runsBefore, &job);
+
+	k_spin_unlock(&lock, key);
+
+	k_sem_give(&pending);
+}
+
+SchedulerStats InferenceScheduler::getStats(bool clear)
+{
+	SchedulerStats stats = {};
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	stats.jobs = jobs;
+	stats.deadlineMisses = deadlineMisses;
+	stats.queueDelayMaxUs = k_cyc_to_us_floor32(queueDelayMaxCycles);
+	if (jobs) {
+		stats.queueDelayAvgUs =
+			static_cast<uint32_t>(k_cyc_to_us_floor64(queueDelayTotalCycles / jobs));
+	}
+
+	if (clear) {
+		jobs = 0;
+		deadlineMisses = 0;
+		queueDelayMaxCycles = 0;
+		queueDelayTotalCycles = 0;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return stats;
+}
+
+void InferenceScheduler::threadEntry(void *ctx, void *, void *)
+{
+	static_cast<InferenceScheduler *>(ctx)->run();
+}
+
+void InferenceScheduler::run()
+{
+	for (;;) {
+		k_sem_take(&pending, K_FOREVER);
+
+		k_spinlock_key_t key = k_spin_lock(&lock);
+		sys_dnode_t *node = sys_dlist_get(&queue);
+		k_spin_unlock(&lock, key);
+
+		if (node == nullptr) {
+			continue;
+		}
+
+		ScheduledJob &job = *CONTAINER_OF(node, ScheduledJob::QueueNode, node)->job;
+		const uint32_t queueDelayCycles = k_cycle_get_32() - job.submitCycles;
+
+		job.queueDelayUs = k_cyc_to_us_floor32(queueDelayCycles);
+		job.status = process.runJob(job);
+		job.deadlineMissed = (job.deadline != 0) && (k_uptime_get() > job.deadline);
+
+		key = k_spin_lock(&lock);
+		jobs++;
+		deadlineMisses += job.deadlineMissed ? 1 : 0;
+		queueDelayMaxCycles = max(queueDelayMaxCycles, queueDelayCycles);
+		queueDelayTotalCycles += queueDelayCycles;
+		k_spin_unlock(&lock, key);
+
+		if (job.done != nullptr) {
+			job.done(job, job.userData);
+		}
+	}
+}
+} /* namespace InferenceProcess */
@@ -0,0 +1,99 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#pragma once
+
+#include "inference_process.hpp"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
+
+namespace InferenceProcess
+{
+struct ScheduledJob : public InferenceJob {
+	using Callback = void (*)(ScheduledJob &job, void *userData);
+
+	/* Lower values run first, as with thread priorities */
+	int priority = 0;
+	/* Uptime in milliseconds by which the job should complete, 0 for none. Jobs of the same
+	 * priority run earliest deadline first.
+	 */
+	int64_t deadline = 0;
+	/* Called from the scheduler thread once the job completed */
+	Callback done = nullptr;
+	void *userData = nullptr;
+
+	/* Results */
+	bool status = false;
+	uint32_t queueDelayUs = 0;
+	bool deadlineMissed = false;
+
+	ScheduledJob() = default;
+	ScheduledJob(const std::string &name, const DataPtr &networkModel,
+		     const std::vector<DataPtr> &input, const std::vector<DataPtr> &output,
+		     const std::vector<DataPtr> &expectedOutput, int priority, int64_t deadline,
+		     Callback done, void *userData);
+
+    private:
+	friend class InferenceScheduler;
+
+	/* Queue link, standard layout so that the job can be found from the list node */
+	struct QueueNode {
+		sys_dnode_t node;
+		ScheduledJob *job;
+	};
+
+	QueueNode queueNode = {};
+	uint32_t submitCycles = 0;
+};
+
+struct SchedulerStats {
+	uint32_t jobs;
+	uint32_t deadlineMisses;
+	uint32_t queueDelayMaxUs;
+	uint32_t queueDelayAvgUs;
+};
+
+/*
+ * Owns the NPU and runs the submitted jobs one at a time on its own thread, by priority and then
+ * deadline. All models share the one tensor arena, which must be large enough for the largest.
+ * A running job is not preempted, so a high priority job waits at most for the job on the NPU.
+ */
+class InferenceScheduler {
+    public:
+	InferenceScheduler(uint8_t *tensorArena, size_t tensorArenaSize);
+
+	InferenceScheduler(const InferenceScheduler &) = delete;
+	InferenceScheduler &operator=(const InferenceScheduler &) = delete;
+
+	void start(k_thread_stack_t *stack, size_t stackSize, int threadPriority);
+
+	/* Queue a job, which must remain valid until its callback */
+	void submit(ScheduledJob &job);
+
+	SchedulerStats getStats(bool clear = false);
+
+    private:
+	static void threadEntry(void *ctx, void *, void *);
+	static int runsBefore(sys_dnode_t *node, void *data);
+
+	void run();
+
+	InferenceProcess process;
+	k_thread thread;
+	k_sem pending;
+	k_spinlock lock = {};
+	sys_dlist_t queue;
+
+	uint32_t jobs = 0;
+	uint32_t deadlineMisses = 0;
+	uint32_t queueDelayMaxCycles = 0;
+	uint64_t queueDelayTotalCycles = 0;
+};
+} /* namespace InferenceProcess */
@@ -40,6 +40,11 @@ static struct mic_source_env mic_source;
 
 #define INPUT_LEVEL_CALC(_s)   (((int)(_s) * CONFIG_INPUT_VOLUME_LEVEL) / 100)
 #define NUMBER_OF_MIC_CHANNELS 2
+#define MIC_BLOCK_SIZE (MAX_SAMPLES_PER_AUDIO_BLOCK * NUMBER_OF_MIC_CHANNELS * sizeof(pcm_sample_t))
+#define MIC_BLOCK_COUNT        4
+
+/* The DMIC driver allocates its PCM blocks from a memory slab */
+K_MEM_SLAB_DEFINE_STATIC(mic_mem_slab, MIC_BLOCK_SIZE, MIC_BLOCK_COUNT, sizeof(uint32_t));
 
 LOG_MODULE_DECLARE(audio_datapath, CONFIG_BLE_AUDIO_LOG_LEVEL);
 
@@ -57,7 +62,6 @@ INT_RAMFUNC static void audio_encoder_mixer_thread_func(void *p1, void *p2, void
 	 */
 
 	struct audio_queue *audio_queue_in1 = p1; /* input I2S codec (WM8904) */
-	struct audio_queue *audio_queue_in2 = p2; /* input PDM MIC */
 	struct audio_queue *audio_queue_out = p3; /* output (to LC3 encoder) */
 	struct audio_block *audio_in1;
 	struct audio_block *audio_out;
@@ -69,9 +73,8 @@ INT_RAMFUNC static void audio_encoder_mixer_thread_func(void *p1, void *p2, void
 
 	while (1) {
 
-		audio_out = audio_in1 = NULL;
-		ret = k_msgq_get(&audio_queue_in1->msgq, &audio_in1, K_FOREVER);
-		if (ret || !audio_in1) {
+		audio_in1 = block_ring_get(&audio_queue_in1->ring, K_FOREVER);
+		if (!audio_in1) {
 			continue;
 		}
 
@@ -104,25 +107,22 @@ INT_RAMFUNC static void audio_encoder_mixer_thread_func(void *p1, void *p2, void
 			}
 		}
 		if (!ret && buffer) {
-			k_mem_slab_free(&audio_queue_in2->slab, buffer);
+			k_mem_slab_free(&mic_mem_slab, buffer);
 			buffer = NULL;
 		}
 
-		ret = k_mem_slab_alloc(&audio_queue_out->slab, (void **)&audio_out, K_NO_WAIT);
-		if (ret || !audio_out) {
+		audio_out = block_ring_acquire(&audio_queue_out->ring, K_NO_WAIT);
+		if (!audio_out) {
 			LOG_ERR("Failed to allocate audio output block");
-			k_mem_slab_free(&audio_queue_in1->slab, audio_in1);
+			block_ring_release(&audio_queue_in1->ring, audio_in1);
 			continue;
 		}
 
 		/* Copy in1 to out */
 		memcpy(audio_out, audio_in1, sizeof(*audio_out));
 
-		ret = k_msgq_put(&audio_queue_out->msgq, &audio_out, K_NO_WAIT);
-		if (ret) {
-			k_mem_slab_free(&audio_queue_out->slab, audio_out);
-		}
-		k_mem_slab_free(&audio_queue_in1->slab, audio_in1);
+		block_ring_commit(&audio_queue_out->ring, audio_out);
+		block_ring_release(&audio_queue_in1->ring, audio_in1);
 	}
 }
 
@@ -163,7 +163,7 @@ static int configure_pdm_source(const struct device *pdm_dev, struct audio_queue
 	pdm_coef_reg.ch_iir_coef = CONFIG_AUDIO_IIR_COEF;
 
 	cfg.streams = &stream;
-	cfg.streams[0].mem_slab = &audio_queue_mic->slab;
+	cfg.streams[0].mem_slab = &mic_mem_slab;
 	cfg.channel.req_num_streams = 1;
 	cfg.channel.req_num_chan = NUMBER_OF_MIC_CHANNELS;
 	cfg.streams[0].block_size = audio_queue_mic->audio_block_samples * NUMBER_OF_MIC_CHANNELS *
@@ -212,12 +212,12 @@ int mic_configure(const struct device *mic_dev, const struct device *i2s_dev,
 	}
 
 	/*
-	 * Two input queues are used for audio mixing:
+	 * Two inputs are used for audio mixing:
 	 *   - audio_queue_i2s: receives audio from the audio jack via I2S
-	 *   - audio_queue_mic: receives audio from the PDM microphone
+	 *   - mic_mem_slab: receives audio from the PDM microphone via dmic_read
 	 *
 	 * Configured (audio encoder input) audio I2S input queue will be changed
-	 * to audio_queue_i2s and the created thread will mix audio_queue_mic
+	 * to audio_queue_i2s and the created thread will mix the microphone data
 	 * into audio_queue_i2s. Result will be copied and pushed to
 	 * audio_queue_current (audio encoder input queue).
 	 */
@@ -229,23 +229,13 @@ int mic_configure(const struct device *mic_dev, const struct device *i2s_dev,
 		return -ENODEV;
 	}
 
-	struct audio_queue *audio_queue_mic, *audio_queue_i2s;
-
-	audio_queue_mic = audio_queue_create(audio_queue_current->item_count,
-					     audio_queue_current->sampling_freq_hz,
-					     audio_queue_current->frame_duration_us);
-
-	if (!audio_queue_mic) {
-		LOG_ERR("Failed to create audio queue");
-		return -ENOMEM;
-	}
+	struct audio_queue *audio_queue_i2s;
 
 	audio_queue_i2s = audio_queue_create(audio_queue_current->item_count,
 					     audio_queue_current->sampling_freq_hz,
 					     audio_queue_current->frame_duration_us);
 
 	if (!audio_queue_i2s) {
-		audio_queue_delete(audio_queue_mic);
 		LOG_ERR("Failed to create audio queue");
 		return -ENOMEM;
 	}
@@ -254,15 +244,13 @@ int mic_configure(const struct device *mic_dev, const struct device *i2s_dev,
 
 	if (ret != 0) {
 		audio_queue_delete(audio_queue_i2s);
-		audio_queue_delete(audio_queue_mic);
 		LOG_ERR("Failed to configure audio source I2S, err %d", ret);
 		return ret;
 	}
 
-	ret = configure_pdm_source(mic_dev, audio_queue_mic);
+	ret = configure_pdm_source(mic_dev, audio_queue_current);
 	if (ret != 0) {
 		audio_queue_delete(audio_queue_i2s);
-		audio_queue_delete(audio_queue_mic);
 		LOG_ERR("Failed to configure mic, err %d", ret);
 		return ret;
 	}
@@ -272,12 +260,10 @@ int mic_configure(const struct device *mic_dev, const struct device *i2s_dev,
 
 	k_tid_t tid = k_thread_create(
 		&mixer_thread, mixer_thread_stack, K_THREAD_STACK_SIZEOF(mixer_thread_stack),
-		audio_encoder_mixer_thread_func, audio_queue_i2s, audio_queue_mic,
-		audio_queue_current, CONFIG_ALIF_BLE_HOST_THREAD_PRIORITY + 1, 0, K_NO_WAIT);
+		audio_encoder_mixer_thread_func, audio_queue_i2s, NULL, audio_queue_current, CONFIG_ALIF_BLE_HOST_THREAD_PRIORITY + 1, 0, K_NO_WAIT);
 
 	if (!tid) {
 		audio_queue_delete(audio_queue_i2s);
-		audio_queue_delete(audio_queue_mic);
 		LOG_ERR("Failed to create mixer thread");
 		return -EINVAL;
 	}
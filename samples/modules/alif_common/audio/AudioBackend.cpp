@@ -8,6 +8,7 @@
  */
 
 #include "AudioBackend.hpp"
+#include "AudioRing.hpp"
 
 #include <zephyr/logging/log.h>
 #include <zephyr/devicetree.h>
@@ -16,12 +17,24 @@
 #include <zephyr/drivers/i2s.h>
 #include <zephyr/audio/dmic.h>
 #include <zephyr/drivers/pdm/pdm_alif.h>
+#include <zephyr/sys/atomic.h>
+
+#include <string.h>
+
+#if __ARM_FEATURE_MVE & 1
+#include <arm_mve.h>
+#endif
 
 LOG_MODULE_REGISTER(AudioBackend, LOG_LEVEL_DBG);
 
 BUILD_ASSERT(CONFIG_AUDIO_STRIDE % CONFIG_SAMPLE_CNT == 0,
 	     "CONFIG_AUDIO_STRIDE must be a multiple of CONFIG_SAMPLE_CNT");
 BUILD_ASSERT(CONFIG_SAMPLE_CNT % 4 == 0, "CONFIG_SAMPLE_CNT must be a multiple of 4");
+BUILD_ASSERT(CONFIG_AUDIO_CHANNELS == 2, "Capture mixes two channels to mono");
+BUILD_ASSERT((CONFIG_AUDIO_RING_SAMPLES & (CONFIG_AUDIO_RING_SAMPLES - 1)) == 0,
+	     "CONFIG_AUDIO_RING_SAMPLES must be a power of two");
+BUILD_ASSERT(CONFIG_AUDIO_RING_SAMPLES >= 2 * CONFIG_SAMPLE_CNT,
+	     "CONFIG_AUDIO_RING_SAMPLES must hold at least two slab buffers");
 
 #define I2S_MICS DT_NODE_EXISTS(DT_ALIAS(i2s_mic))
 
@@ -40,6 +53,9 @@ BUILD_ASSERT(CONFIG_SAMPLE_CNT % 4 == 0, "CONFIG_SAMPLE_CNT must be a multiple o
 #define THREAD_STACK_SIZE CONFIG_THREAD_STACK_SIZE
 #define THREAD_PRIORITY   CONFIG_THREAD_PRIORITY
 #define I2S_GAIN          CONFIG_I2S_GAIN
+#define RING_SAMPLES      CONFIG_AUDIO_RING_SAMPLES
+#define RING_MASK         (RING_SAMPLES - 1)
+#define MAX_READERS       CONFIG_AUDIO_MAX_READERS
 #define CHANNEL_4         4
 #define CHANNEL_5         5
 #define PDM_CHANNELS      PDM_MASK_CHANNEL_4 | PDM_MASK_CHANNEL_5
@@ -54,6 +70,12 @@ BUILD_ASSERT(CONFIG_SAMPLE_CNT % 4 == 0, "CONFIG_SAMPLE_CNT must be a multiple o
 #define START               true
 #define STOP                false
 
+#if I2S_MICS && defined(CONFIG_AUDIO_CAPTURE_GAIN)
+#define CAPTURE_GAIN I2S_GAIN
+#else
+#define CAPTURE_GAIN 1
+#endif
+
 struct pdm_ch_config pdm_coef_reg;
 
 uint32_t pdm_fir[18] = {0x00000001, 0x00000003, 0x00000003, 0x000007F4, 0x00000004, 0x000007ED,
@@ -67,36 +89,65 @@ K_THREAD_STACK_DEFINE(audio_thread_stack, THREAD_STACK_SIZE);
 static const struct device *mic = DEVICE_DT_GET(AUDIO_DEVICE);
 
 static struct k_thread audio_thread;
-static struct k_sem rx_start;
-static struct k_sem rx_ready;
+/* Mono capture ring. The worker thread is its only writer and readers never
+ * write to it, so it needs no lock: ring_written is published after the
+ * samples it counts have been written. */
+static int16_t ring[RING_SAMPLES] __aligned(16);
+static atomic_t ring_written;
+static struct audio_reader *readers[MAX_READERS];
+static struct k_spinlock readers_lock;
+/* Reader behind get_audio_data() and wait_for_audio() */
+static struct audio_reader user_reader;
+static bool user_reader_open;
 static int16_t *user_ptr;
 static int user_len;
 /* Set by audio_uninit() to ask the worker thread to stop. Volatile because it
  * is written from the caller's context and read from the worker thread. */
 static volatile bool audio_stop_requested = false;
-/* Result of the last capture attempt, published by the worker and returned to
- * the caller via wait_for_audio(). 0 means a chunk is ready; a negative value
- * means the worker stopped (mic start/read error). Volatile because it is
- * written by the worker and read by the caller's thread. */
+/* Cleared by the worker thread when it stops capturing */
+static volatile bool audio_running = false;
+/* Why the worker stopped: 0 on request, or a negative mic start/read error
+ * returned to the readers. Volatile because it is written by the worker and
+ * read by the readers' threads. */
 static volatile int audio_status = 0;
 
-static int mix_mono_output(int16_t *in, size_t in_size, int16_t *out, size_t out_size)
+/* Mix interleaved stereo frames to mono and apply the capture gain, saturating */
+static void mix_mono(const int16_t *in, int16_t *out, size_t frames)
 {
-	size_t num_samples = in_size / 2;
+	size_t i = 0;
 
-	if (out_size < num_samples) {
-		LOG_ERR("mix_mono_output param failure %d - %d", out_size, num_samples);
-		return -EINVAL;
+#if __ARM_FEATURE_MVE & 1
+	const int16x8_t gain = vdupq_n_s16(CAPTURE_GAIN);
+
+	for (; i + 8 <= frames; i += 8) {
+		const int16x8x2_t stereo = vld2q_s16(&in[2 * i]);
+		const int16x8_t mono = vhaddq_s16(stereo.val[0], stereo.val[1]);
+		int16x8_t scaled;
+
+		/* Widen the even and odd lanes, then narrow them back in place */
+		scaled = vqmovnbq_s32(vdupq_n_s16(0), vmullbq_int_s16(mono, gain));
+		scaled = vqmovntq_s32(scaled, vmulltq_int_s16(mono, gain));
+		vst1q_s16(&out[i], scaled);
+	}
+#endif
+	for (; i < frames; ++i) {
+		const int32_t mono = (in[2 * i] + in[2 * i + 1]) >> 1;
+
+		out[i] = (int16_t)CLAMP(mono * CAPTURE_GAIN, INT16_MIN, INT16_MAX);
 	}
+}
 
-	for (size_t i = 0; i < num_samples; ++i) {
-		int16_t left_channel = in[2 * i];
-		int16_t right_channel = in[2 * i + 1];
+static void notify_readers(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&readers_lock);
 
-		out[i] = (int16_t)((left_channel + right_channel) / 2);
+	for (size_t i = 0; i < MAX_READERS; ++i) {
+		if (readers[i] != NULL) {
+			k_sem_give(&readers[i]->ready);
+		}
 	}
 
-	return 0;
+	k_spin_unlock(&readers_lock, key);
 }
 
 static int trigger_audio(bool start)
@@ -117,45 +168,46 @@ static int trigger_audio(bool start)
 #endif
 }
 
-static int audio_handle_rx(void)
+/* Capture one slab buffer into the ring. Returns 1 when asked to stop. */
+static int audio_capture_block(void)
 {
 	void *buffer = NULL;
 	size_t size = 0;
-	int offset = 0;
 
-	while (offset < user_len) {
 #if I2S_MICS
-		int rc = i2s_read(mic, &buffer, &size);
+	int rc = i2s_read(mic, &buffer, &size);
 #else
-		int rc = dmic_read(mic, 0, &buffer, &size, PDM_READ_TIMEOUT);
+	int rc = dmic_read(mic, 0, &buffer, &size, PDM_READ_TIMEOUT);
 #endif
-		/* audio_uninit() sets audio_stop_requested while the mic is still
-		 * running, so this read returns a valid buffer. Release it and
-		 * exit promptly instead of finishing the chunk; otherwise the
-		 * buffer is leaked and the slab is eventually exhausted, which
-		 * makes a later mic start fail and the next session hang. */
-		if (audio_stop_requested) {
-			if (rc == 0 && buffer != NULL) {
-				k_mem_slab_free(&mem_slab, buffer);
-			}
-			return 0;
-		}
-		if (rc != 0) {
-			LOG_ERR("mic read failed: %i", rc);
-			return rc;
+	/* audio_uninit() sets audio_stop_requested while the mic is still
+	 * running, so this read returns a valid buffer. Release it and exit
+	 * promptly; otherwise the buffer is leaked and the slab is eventually
+	 * exhausted, which makes a later mic start fail and the next session
+	 * hang. */
+	if (audio_stop_requested) {
+		if (rc == 0 && buffer != NULL) {
+			k_mem_slab_free(&mem_slab, buffer);
 		}
+		return 1;
+	}
+	if (rc != 0) {
+		LOG_ERR("mic read failed: %i", rc);
+		return rc;
+	}
 
-		int stero_samples = size / SAMPLE_SIZE;
-		rc = mix_mono_output(static_cast<int16_t *>(buffer), stero_samples,
-				     user_ptr + offset, user_len - offset);
-		if (rc < 0) {
-			LOG_ERR("mix_mono_output failed: %i", rc);
-			return rc;
-		}
+	const size_t frames = MIN(size / (AUDIO_CHANNELS * SAMPLE_SIZE), (size_t)SAMPLE_CNT);
+	const uint32_t written = (uint32_t)atomic_get(&ring_written);
+	const size_t start = written & RING_MASK;
+	const size_t first = MIN(frames, (size_t)(RING_SAMPLES - start));
+	const int16_t *in = static_cast<const int16_t *>(buffer);
+
+	mix_mono(in, &ring[start], first);
+	mix_mono(&in[AUDIO_CHANNELS * first], ring, frames - first);
+	k_mem_slab_free(&mem_slab, buffer);
+
+	atomic_set(&ring_written, (atomic_val_t)(written + frames));
+	notify_readers();
 
-		offset += stero_samples / 2;
-		k_mem_slab_free(&mem_slab, buffer);
-	}
 	return 0;
 }
 
@@ -164,43 +216,29 @@ static void audio_worker_thread(void *, void *, void *)
 	/* Start the mic here, immediately before the first read, to keep the
 	 * window between START and the first read as short as possible. The mic
 	 * free-runs into a limited set of slab buffers, so starting it too early
-	 * (e.g. in audio_init(), before the caller requests the first chunk) can
-	 * overrun and push the I2S stream into ERROR before the first read. */
+	 * can overrun and push the I2S stream into ERROR before the first read.
+	 * From then on the thread keeps reading, whether or not anyone reads the
+	 * ring, so the mic cannot overrun because of a slow reader. */
 	int rc = trigger_audio(START);
 	if (rc < 0) {
 		LOG_ERR("mic start failed: %d", rc);
 		audio_status = rc;
 	} else {
-		while (1) {
-			k_sem_take(&rx_start, K_FOREVER);
+		do {
+			rc = audio_capture_block();
+		} while (rc == 0);
 
-			if (audio_stop_requested) {
-				break;
-			}
-
-			if (user_ptr == NULL) {
-				LOG_ERR("user_ptr is NULL");
-				audio_status = -EINVAL;
-				break;
-			}
-
-			rc = audio_handle_rx();
-			if (rc < 0) {
-				audio_status = rc;
-				break;
-			}
-
-			k_sem_give(&rx_ready);
+		if (rc < 0) {
+			audio_status = rc;
 		}
 	}
 
-	/* Always wake a thread that may be blocked in wait_for_audio() so it can
-	 * observe audio_status instead of blocking forever - a stranded waiter
-	 * would leave every thread blocked and idle the whole system. On a clean
-	 * stop this extra give is harmless; audio_uninit() resets the semaphore.
-	 * The mic is stopped in audio_uninit() after this thread is joined, so
-	 * the worker never stops the mic itself. */
-	k_sem_give(&rx_ready);
+	/* Always wake the readers so that they observe the stop instead of
+	 * blocking forever - a stranded reader would leave every thread blocked
+	 * and idle the whole system. The mic is stopped in audio_uninit() after
+	 * this thread is joined, so the worker never stops the mic itself. */
+	audio_running = false;
+	notify_readers();
 }
 
 #if I2S_MICS
@@ -330,12 +368,12 @@ int audio_init(int sampling_rate)
 	 * session and exit immediately. */
 	audio_stop_requested = false;
 	audio_status = 0;
+	audio_running = true;
+	atomic_set(&ring_written, 0);
+	user_reader_open = false;
 	user_ptr = NULL;
 	user_len = 0;
 
-	k_sem_init(&rx_start, 0, 1);
-	k_sem_init(&rx_ready, 0, 1);
-
 	k_thread_create(&audio_thread, audio_thread_stack,
 			K_THREAD_STACK_SIZEOF(audio_thread_stack), audio_worker_thread, NULL, NULL,
 			NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
@@ -347,15 +385,13 @@ int audio_init(int sampling_rate)
 
 void audio_uninit(void)
 {
-	/* Ask the worker to stop and wake it if it is waiting for the next
-	 * get_audio_data(). The mic is deliberately left running here: a worker
-	 * blocked inside a mic read is only unblocked by the next buffer being
-	 * delivered, so the read returns promptly, the worker sees the stop
+	/* Ask the worker to stop. The mic is deliberately left running here: a
+	 * worker blocked inside a mic read is only unblocked by the next buffer
+	 * being delivered, so the read returns promptly, the worker sees the stop
 	 * request, releases the buffer and exits. Stopping the mic first would
 	 * instead halt the data flow and leave that read blocked forever,
 	 * deadlocking the join below. */
 	audio_stop_requested = true;
-	k_sem_give(&rx_start);
 	k_thread_join(&audio_thread, K_FOREVER);
 
 	/* The worker has exited, so it is now safe to stop the mic and clear the
@@ -366,33 +402,159 @@ void audio_uninit(void)
 	if (rc < 0) {
 		LOG_ERR("mic stop failed: %d", rc);
 	}
+
+	k_spinlock_key_t key = k_spin_lock(&readers_lock);
+
+	memset(readers, 0, sizeof(readers));
+	k_spin_unlock(&readers_lock, key);
+
+	user_reader_open = false;
 	user_ptr = NULL;
 	user_len = 0;
-	k_sem_reset(&rx_start);
-	k_sem_reset(&rx_ready);
 }
 
 int get_audio_data(int16_t *data, int len)
 {
+	if (!user_reader_open) {
+		int rc = audio_reader_open(&user_reader);
+		if (rc < 0) {
+			return rc;
+		}
+		user_reader_open = true;
+	}
+
 	user_ptr = data;
 	user_len = len;
-	k_sem_give(&rx_start);
 
 	return 0;
 }
 
 int wait_for_audio(void)
 {
-	k_sem_take(&rx_ready, K_FOREVER);
+	bool overrun = false;
+	int offset = 0;
+
+	if (user_ptr == NULL) {
+		LOG_ERR("user_ptr is NULL");
+		return -EINVAL;
+	}
 
-	return audio_status;
+	while (offset < user_len) {
+		const int16_t *data;
+		int rc = audio_reader_claim(&user_reader, &data,
+					    MIN(user_len - offset, RING_SAMPLES / 2), K_FOREVER);
+
+		/* The chunk starts over from the newest audio */
+		if (rc == -EOVERFLOW) {
+			overrun = true;
+			offset = 0;
+			continue;
+		}
+		if (rc < 0) {
+			return rc;
+		}
+
+		memcpy(&user_ptr[offset], data, rc * SAMPLE_SIZE);
+
+		if (audio_reader_release(&user_reader, rc) == 0) {
+			offset += rc;
+		} else {
+			overrun = true;
+			offset = 0;
+		}
+	}
+
+	if (overrun) {
+		LOG_WRN("audio overrun, the chunk does not follow the previous one");
+		return -EOVERFLOW;
+	}
+
+	return 0;
 }
 
 void audio_preprocessing(int16_t *data, int len)
 {
-#if I2S_MICS
+#if I2S_MICS && !defined(CONFIG_AUDIO_CAPTURE_GAIN)
 	for (int i = 0; i < len; ++i) {
 		data[i] = data[i] * I2S_GAIN;
 	}
 #endif
 }
+
+int audio_reader_open(struct audio_reader *reader)
+{
+	int rc = -ENOMEM;
+
+	reader->position = (uint32_t)atomic_get(&ring_written);
+	reader->overruns = 0;
+	k_sem_init(&reader->ready, 0, 1);
+
+	k_spinlock_key_t key = k_spin_lock(&readers_lock);
+
+	for (size_t i = 0; i < MAX_READERS; ++i) {
+		if (readers[i] == NULL) {
+			readers[i] = reader;
+			rc = 0;
+			break;
+		}
+	}
+
+	k_spin_unlock(&readers_lock, key);
+
+	return rc;
+}
+
+void audio_reader_close(struct audio_reader *reader)
+{
+	k_spinlock_key_t key = k_spin_lock(&readers_lock);
+
+	for (size_t i = 0; i < MAX_READERS; ++i) {
+		if (readers[i] == reader) {
+			readers[i] = NULL;
+		}
+	}
+
+	k_spin_unlock(&readers_lock, key);
+}
+
+int audio_reader_claim(struct audio_reader *reader, const int16_t **data, int len,
+		       k_timeout_t timeout)
+{
+	if (len <= 0 || len > RING_SAMPLES / 2) {
+		return -EINVAL;
+	}
+
+	while (true) {
+		/* Read before the samples, which were written before it */
+		const uint32_t written = (uint32_t)atomic_get(&ring_written);
+		uint32_t start;
+		const int rc = audio_ring_claim(reader, written, RING_SAMPLES, SAMPLE_CNT, len,
+						&start);
+
+		if (rc != 0) {
+			if (rc > 0) {
+				*data = &ring[start];
+			}
+			return rc;
+		}
+
+		if (!audio_running) {
+			return (audio_status < 0) ? audio_status : -ESHUTDOWN;
+		}
+
+		if (k_sem_take(&reader->ready, timeout) != 0) {
+			return -EAGAIN;
+		}
+	}
+}
+
+int audio_reader_release(struct audio_reader *reader, int len)
+{
+	return audio_ring_release(reader, (uint32_t)atomic_get(&ring_written), RING_SAMPLES,
+				  SAMPLE_CNT, len);
+}
+
+uint32_t audio_reader_overruns(const struct audio_reader *reader)
+{
+	return reader->overruns;
+}
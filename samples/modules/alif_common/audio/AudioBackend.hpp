@@ -11,14 +11,34 @@
 #define AUDIOBACKEND_H
 
 #include <stdint.h>
+#include <zephyr/kernel.h>
+
+/**
+ * @brief Reader of the capture ring.
+ *
+ * Any number of readers, up to CONFIG_AUDIO_MAX_READERS, consume the same
+ * captured audio at their own pace, reading it in place from the ring. The
+ * capture never waits for a reader: one that falls more than the ring behind
+ * overruns, which is reported to it alone, and skips ahead to the newest audio.
+ * The fields are private to the backend.
+ */
+struct audio_reader {
+	/* Samples captured before the next one to read */
+	uint32_t position;
+	/* Times the reader skipped ahead */
+	uint32_t overruns;
+	/* Given by the audio thread whenever it has captured more */
+	struct k_sem ready;
+};
 
 /**
  * @brief Initialize the audio capture backend.
  *
  * Configures the microphone device (I2S or PDM, selected at build time) for the
  * requested sampling rate and starts a worker thread that captures audio in the
- * background. Must be called before any other function in this API and paired
- * with @ref audio_uninit when capture is no longer needed.
+ * background, mixed to mono, into the capture ring. Must be called before any
+ * other function in this API and paired with @ref audio_uninit when capture is
+ * no longer needed.
  *
  * @param sampling_rate Desired sampling rate in Hz. For PDM microphones only a
  *                      fixed set of rates is supported (8000, 16000, 32000,
@@ -34,7 +54,8 @@ int audio_init(int sampling_rate);
  * @brief Stop audio capture and release the backend.
  *
  * Signals the worker thread to stop, waits for it to exit, stops the
- * microphone and clears the internal session state. Safe to call after
+ * microphone and clears the internal session state, closing all readers.
+ * Readers waiting for audio return -ESHUTDOWN. Safe to call after
  * @ref audio_init; afterwards @ref audio_init must be called again before
  * capturing more audio.
  */
@@ -43,10 +64,11 @@ void audio_uninit(void);
 /**
  * @brief Request the next chunk of audio samples.
  *
- * Hands the destination buffer to the worker thread and returns immediately
- * without blocking. The buffer is filled asynchronously; call
- * @ref wait_for_audio to block until the requested samples are available. The
- * buffer must remain valid until @ref wait_for_audio returns.
+ * Records the destination buffer and returns immediately without blocking. The
+ * audio is captured into the ring meanwhile, and copied to the buffer by
+ * @ref wait_for_audio, which blocks until the requested samples are available.
+ * The buffer must remain valid until @ref wait_for_audio returns. The first
+ * call opens a reader of the ring for these two functions.
  *
  * @param data Pointer to the buffer that receives the captured samples.
  * @param len  Number of int16_t samples to capture into @p data.
@@ -59,22 +81,87 @@ int get_audio_data(int16_t *data, int len);
  * @brief Wait for the pending audio capture to complete.
  *
  * Blocks until the chunk requested by the previous @ref get_audio_data call has
- * been written to the destination buffer, or until the worker thread stops.
+ * been written to the destination buffer, or until the worker thread stops. If
+ * the caller fell more than the ring behind, the audio it missed is lost and
+ * the whole chunk is filled with the newest audio instead.
  *
- * @return 0 when a chunk is ready, or a negative error code if the worker
- *         stopped due to a microphone start or read error.
+ * @return 0 when a chunk is ready, -EOVERFLOW when a chunk is ready but does
+ *         not follow the previous one because of an overrun, or another
+ *         negative error code if the worker stopped due to a microphone start
+ *         or read error.
  */
 int wait_for_audio(void);
 
 /**
  * @brief Apply gain preprocessing to captured audio samples in place.
  *
- * Scales each sample by the configured I2S gain. For PDM microphones this is a
- * no-op.
+ * Scales each sample by the configured I2S gain. For PDM microphones, and when
+ * CONFIG_AUDIO_CAPTURE_GAIN applies the gain at capture, this is a no-op.
  *
  * @param data Pointer to the buffer of samples to process in place.
  * @param len  Number of int16_t samples in @p data.
  */
 void audio_preprocessing(int16_t *data, int len);
 
+/**
+ * @brief Open a reader of the capture ring.
+ *
+ * The reader starts at the newest audio. Must be called after @ref audio_init.
+ *
+ * @param reader Reader to open, which must remain valid until it is closed.
+ *
+ * @return 0 on success, or -ENOMEM if CONFIG_AUDIO_MAX_READERS readers are
+ *         already open.
+ */
+int audio_reader_open(struct audio_reader *reader);
+
+/**
+ * @brief Close a reader of the capture ring.
+ *
+ * @param reader Reader opened by @ref audio_reader_open.
+ */
+void audio_reader_close(struct audio_reader *reader);
+
+/**
+ * @brief Wait for audio and get it in place in the ring.
+ *
+ * Blocks until @p len samples past the reader's position have been captured
+ * and points @p data at them. Where the ring wraps, fewer samples are
+ * contiguous: the return value tells how many, and the rest follow from the
+ * start of the ring on the next call. The samples remain valid until the
+ * reader falls more than the ring behind, which @ref audio_reader_release
+ * reports.
+ *
+ * @param reader  Open reader.
+ * @param data    Set to the first sample.
+ * @param len     Number of samples to wait for, at most half the ring.
+ * @param timeout How long to wait.
+ *
+ * @return Number of contiguous samples at @p data, at most @p len, or a
+ *         negative error code: -EOVERFLOW if the reader overran and skipped
+ *         ahead, -EAGAIN on timeout, -ESHUTDOWN once capture stopped, or the
+ *         error that stopped it.
+ */
+int audio_reader_claim(struct audio_reader *reader, const int16_t **data, int len,
+		       k_timeout_t timeout);
+
+/**
+ * @brief Move a reader past samples it has read.
+ *
+ * @param reader Open reader.
+ * @param len    Number of samples read, at most the count claimed.
+ *
+ * @return 0 on success, or -EOVERFLOW if the capture overwrote the samples
+ *         while they were read, in which case the reader skips ahead to the
+ *         newest audio.
+ */
+int audio_reader_release(struct audio_reader *reader, int len);
+
+/**
+ * @brief Number of times a reader overran and skipped ahead.
+ *
+ * @param reader Open reader.
+ */
+uint32_t audio_reader_overruns(const struct audio_reader *reader);
+
 #endif
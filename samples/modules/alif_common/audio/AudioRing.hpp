@@ -0,0 +1,79 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#ifndef AUDIORING_H
+#define AUDIORING_H
+
+#include "AudioBackend.hpp"
+
+#include <errno.h>
+#include <stdint.h>
+
+/*
+ * Position arithmetic of a reader of the capture ring, apart from the capture
+ * so that it can be tested without a microphone. written counts the samples
+ * captured so far, and block is the most the capture writes at a time, which
+ * can land over the oldest samples of a full ring.
+ */
+
+/* Whether the capture may be writing over the reader's next sample */
+static inline bool audio_ring_overran(const struct audio_reader *reader, uint32_t written,
+				      uint32_t ring_samples, uint32_t block)
+{
+	return written - reader->position > ring_samples - block;
+}
+
+/* Move an overrun reader to the newest audio */
+static inline void audio_ring_skip_ahead(struct audio_reader *reader, uint32_t written)
+{
+	reader->position = written;
+	reader->overruns++;
+}
+
+/*
+ * Look for len samples past the reader's position. Returns how many of them
+ * are contiguous from *start, 0 while fewer than len have been captured, or
+ * -EOVERFLOW after skipping ahead.
+ */
+static inline int audio_ring_claim(struct audio_reader *reader, uint32_t written,
+				   uint32_t ring_samples, uint32_t block, int len,
+				   uint32_t *start)
+{
+	if (audio_ring_overran(reader, written, ring_samples, block)) {
+		audio_ring_skip_ahead(reader, written);
+		return -EOVERFLOW;
+	}
+
+	if (written - reader->position < (uint32_t)len) {
+		return 0;
+	}
+
+	*start = reader->position & (ring_samples - 1);
+
+	return MIN(len, (int)(ring_samples - *start));
+}
+
+/*
+ * Move the reader past len samples it has read. Returns -EOVERFLOW, after
+ * skipping ahead, if the capture may have written over them meanwhile.
+ */
+static inline int audio_ring_release(struct audio_reader *reader, uint32_t written,
+				     uint32_t ring_samples, uint32_t block, int len)
+{
+	if (audio_ring_overran(reader, written, ring_samples, block)) {
+		audio_ring_skip_ahead(reader, written);
+		return -EOVERFLOW;
+	}
+
+	reader->position += len;
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,91 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+#ifndef ASR_STREAMING_WINDOWS_HPP
+#define ASR_STREAMING_WINDOWS_HPP
+
+#include <cstddef>
+
+namespace arm
+{
+namespace app
+{
+
+/**
+ * Hands out the overlapping inference windows of a clip while it is still being recorded, each
+ * one as soon as its audio is in. The windows are those FractionalSlidingWindow makes over the
+ * whole clip, so the results are the same as processing the clip once recording has ended, but
+ * only the windows that the last of the audio completes are left to run by then.
+ */
+class StreamingWindows
+{
+public:
+	struct Window {
+		size_t index;
+		/* First sample of the window in the clip */
+		size_t start;
+		/* Samples in the window, fewer than the window length only for the last one */
+		size_t length;
+		/* Whether the clip ends within this window */
+		bool last;
+	};
+
+	StreamingWindows(size_t windowLen, size_t windowStride)
+		: m_windowLen(windowLen), m_windowStride(windowStride)
+	{
+	}
+
+	/**
+	 * @brief       Get the next window to run.
+	 * @param[in]   available   Samples of the clip recorded so far.
+	 * @param[in]   ended       Whether the clip ends at available.
+	 * @param[out]  window      The next window, if there is one.
+	 * @return      true if the next window can run now. While recording, a window whose audio
+	 *              ends at available is held back, as it is the last one if the clip ends there.
+	 **/
+	bool Next(size_t available, bool ended, Window &window)
+	{
+		const size_t start = m_next * m_windowStride;
+
+		if (ended) {
+			if (m_next >= TotalWindows(available)) {
+				return false;
+			}
+		} else if (start + m_windowLen >= available) {
+			return false;
+		}
+
+		window.index = m_next;
+		window.start = start;
+		window.length = (start + m_windowLen <= available) ? m_windowLen : available - start;
+		window.last = ended && (m_next + 1 == TotalWindows(available));
+		m_next++;
+
+		return true;
+	}
+
+	/* Windows FractionalSlidingWindow makes over a clip of length samples */
+	size_t TotalWindows(size_t length) const
+	{
+		if (length <= m_windowLen) {
+			return 1;
+		}
+
+		return 1 + (length - m_windowLen + m_windowStride - 1) / m_windowStride;
+	}
+
+private:
+	const size_t m_windowLen;
+	const size_t m_windowStride;
+	size_t m_next = 0;
+};
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* ASR_STREAMING_WINDOWS_HPP */
@@ -35,11 +35,11 @@
 
 #include "mlek/use_case/asr/AsrClassifier.hpp"
 #include "mlek/use_case/asr/AsrResult.hpp"
-#include "mlek/common/AudioSlidingWindow.hpp"
 #include "mlek/use_case/asr/OutputDecode.hpp"
 #include "mlek/use_case/asr/Wav2LetterPostprocess.hpp"
 #include "mlek/use_case/asr/Wav2LetterPreprocess.hpp"
 #include "mlek/fwk/tflm/Wav2LetterModel.hpp"
+#include "StreamingWindows.hpp"
 #include <zephyr/logging/log.h>
 #include <zephyr/kernel.h>
 #include <zephyr/audio/codec.h>
@@ -145,6 +145,13 @@ namespace app
  **/
 static bool PresentInferenceResult(std::vector<asr::AsrResult> &results);
 
+/**
+ * @brief       Decodes the results of the windows so far into one transcript.
+ * @param[in]   results   Vector of ASR classification results, one per window.
+ * @return      The transcript.
+ **/
+static std::string DecodeCombinedResult(const std::vector<asr::AsrResult> &results);
+
 /* ASR inference handler. */
 bool ClassifyAudioHandler(ApplicationContext &ctx)
 {
@@ -189,6 +196,53 @@ bool ClassifyAudioHandler(ApplicationContext &ctx)
 			       inputCtxLen, fwk::tflm::Wav2LetterModel::ms_blankTokenIdx,
 			       fwk::tflm::Wav2LetterModel::ms_outputRowsIdx);
 
+	/* Declare a container for final results. */
+	std::vector<asr::AsrResult> finalResults;
+	StreamingWindows windows(audioDataWindowLen, audioDataWindowStride);
+	StreamingWindows::Window window;
+	/* Longest a window has taken, to report if the capture overruns the ring meanwhile */
+	uint32_t maxWindowCycles = 0;
+
+	/* Run the pre-processing, inference and post-processing of one window. */
+	auto runWindow = [&](const StreamingWindows::Window &w) {
+		const uint32_t ts_window = k_cycle_get_32();
+
+		LOG_INF("Inference %zu%s\n", w.index + 1, w.last ? " (last)" : "");
+
+		if (!preProcess.DoPreProcess(&audio_inf[w.start], w.length)) {
+			LOG_ERR("Pre-processing failed.");
+			return false;
+		}
+
+		if (!model.RunInference()) {
+			LOG_ERR("Inference failed.");
+			return false;
+		}
+
+		LOG_INF("NPU inference done.");
+
+		/* Post processing needs to know if we are on the last audio window. */
+		postProcess.m_lastIteration = w.last;
+		if (!postProcess.DoPostProcess()) {
+			LOG_ERR("Post-processing failed.");
+			return false;
+		}
+
+		/* Add results from this window to our final results vector. */
+		finalResults.emplace_back(asr::AsrResult(singleInfResult,
+							 (w.index * secondsPerSample * audioDataWindowStride),
+							 w.index, scoreThreshold));
+
+		if (!w.last) {
+			LOG_INF("Partial recognition: %s\n",
+				DecodeCombinedResult(finalResults).c_str());
+		}
+
+		maxWindowCycles = MAX(maxWindowCycles, k_cycle_get_32() - ts_window);
+
+		return true;
+	};
+
 #ifndef CONFIG_PUSH_TO_TALK
 	// Application is not in push-to-talk mode. Start capturing audio once the button is pressed
 	// for the first time, and keep capturing until we have the max number of samples or button
@@ -213,16 +267,30 @@ bool ClassifyAudioHandler(ApplicationContext &ctx)
 	// Capture audio as long as button is kept pressed or until we have max samples
 	int16_t *audio_inf_ptr = &audio_inf[0];
 	int audio_idx = 0;
+	/* When the last chunk was captured, to time the final result from */
+	uint32_t ts_capture_done = 0;
 
 	get_audio_data(audio_inf_ptr, AUDIO_CHUNK_SIZE_SAMPLES);
 
 	while (1) {
 		err = wait_for_audio();
+		if (err == -EOVERFLOW) {
+			/* The chunk does not follow the previous one, so the clip cannot be decoded */
+			LOG_ERR("Audio lost after %d ms: the capture ring holds %u ms, the longest "
+				"inference window took %u ms. Dropping the recording.",
+				(audio_idx * AUDIO_CHUNK_SIZE_SAMPLES * 1000) / AUDIO_RATE,
+				static_cast<unsigned>(
+					(CONFIG_AUDIO_RING_SAMPLES * 1000ULL) / AUDIO_RATE),
+				static_cast<unsigned>(k_cyc_to_ms_ceil32(maxWindowCycles)));
+			audio_uninit();
+			return false;
+		}
 		if (err) {
 			LOG_ERR("hal_get_audio_data failed with error: %d", err);
 			audio_uninit();
 			return false;
 		}
+		ts_capture_done = k_cycle_get_32();
 
 		// Start next chunk
 		if (audio_idx < (AUDIO_CHUNKS - 1)) {
@@ -233,6 +301,16 @@ bool ClassifyAudioHandler(ApplicationContext &ctx)
 		audio_preprocessing(audio_inf_ptr + (audio_idx * AUDIO_CHUNK_SIZE_SAMPLES),
 				    AUDIO_CHUNK_SIZE_SAMPLES);
 
+#ifdef CONFIG_ASR_STREAMING
+		/* Run the windows whose audio is in while the next chunks are captured. */
+		while (windows.Next((audio_idx + 1) * AUDIO_CHUNK_SIZE_SAMPLES, false, window)) {
+			if (!runWindow(window)) {
+				audio_uninit();
+				return false;
+			}
+		}
+#endif /* CONFIG_ASR_STREAMING */
+
 		if (!button_pressed) {
 			break;
 		}
@@ -240,11 +318,11 @@ bool ClassifyAudioHandler(ApplicationContext &ctx)
 		if (audio_idx >= (AUDIO_CHUNKS - 1)) {
 			break;
 		}
+
 		audio_idx++;
 	}
 	LOG_INF("Audio capture finished.\n");
 
-	int16_t *audioArr = audio_inf;
 	uint32_t audioArrSize = (audio_idx + 1) * AUDIO_CHUNK_SIZE_SAMPLES;
 
 #if CONFIG_OUTPUT_TO_LINE_OUT
@@ -355,55 +433,16 @@ bool ClassifyAudioHandler(ApplicationContext &ctx)
 		return false;
 	}
 
-	/* Creating a sliding window through the whole audio clip. */
-	auto audioDataSlider = audio::FractionalSlidingWindow<const int16_t>(
-		audioArr, audioArrSize, audioDataWindowLen, audioDataWindowStride);
-
-	/* Declare a container for final results. */
-	std::vector<asr::AsrResult> finalResults;
-	size_t inferenceWindowLen = audioDataWindowLen;
-
-	/* Start sliding through audio clip. */
-	while (audioDataSlider.HasNext()) {
-
-		/* If not enough audio, see how much can be sent for processing. */
-		size_t nextStartIndex = audioDataSlider.NextWindowStartIndex();
-		if (nextStartIndex + audioDataWindowLen > audioArrSize) {
-			inferenceWindowLen = audioArrSize - nextStartIndex;
-		}
-
-		const int16_t *inferenceWindow = audioDataSlider.Next();
-
-		LOG_INF("Inference %zu/%zu\n", audioDataSlider.Index() + 1,
-			static_cast<size_t>(ceilf(audioDataSlider.FractionalTotalStrides() + 1)));
-
-		/* Run the pre-processing, inference and post-processing. */
-		if (!preProcess.DoPreProcess(inferenceWindow, inferenceWindowLen)) {
-			LOG_ERR("Pre-processing failed.");
-			return false;
-		}
-
-		if (!model.RunInference()) {
-			LOG_ERR("Inference failed.");
-			return false;
-		}
-
-		LOG_INF("NPU inference done.");
-
-		/* Post processing needs to know if we are on the last audio window. */
-		postProcess.m_lastIteration = !audioDataSlider.HasNext();
-		if (!postProcess.DoPostProcess()) {
-			LOG_ERR("Post-processing failed.");
+	/* Run the windows left. When streaming, these are at most the two the last chunk ends. */
+	while (windows.Next(audioArrSize, true, window)) {
+		if (!runWindow(window)) {
+			audio_uninit();
 			return false;
 		}
+	}
 
-		/* Add results from this window to our final results vector. */
-		finalResults.emplace_back(asr::AsrResult(
-			singleInfResult,
-			(audioDataSlider.Index() * secondsPerSample * audioDataWindowStride),
-			audioDataSlider.Index(), scoreThreshold));
-
-	} /* while (audioDataSlider.HasNext()) */
+	LOG_INF("Time to final result: %u ms\n",
+		static_cast<unsigned>(k_cyc_to_ms_floor32(k_cycle_get_32() - ts_capture_done)));
 
 	PresentInferenceResult(finalResults);
 	audio_uninit();
@@ -417,13 +456,22 @@ static bool PresentInferenceResult(std::vector<asr::AsrResult> &results)
 	LOG_INF("Total number of inferences: %zu\n", results.size());
 
 	/* Get each inference result string using the decoder. */
-	std::string combinedResultStr;
 	for (const auto &result : results) {
 		std::string infResultStr = audio::asr::DecodeOutput(result.m_resultVec);
 
 		LOG_INF("For timestamp: %f (inference #: %" PRIu32 "); label: %s\n",
 			(double)result.m_timeStamp, result.m_inferenceNumber, infResultStr.c_str());
-		combinedResultStr += infResultStr;
+	}
+
+	LOG_INF("Complete recognition: %s\n", DecodeCombinedResult(results).c_str());
+	return true;
+}
+
+static std::string DecodeCombinedResult(const std::vector<asr::AsrResult> &results)
+{
+	std::string combinedResultStr;
+	for (const auto &result : results) {
+		combinedResultStr += audio::asr::DecodeOutput(result.m_resultVec);
 	}
 
 	ClassificationResult res;
@@ -432,10 +480,7 @@ static bool PresentInferenceResult(std::vector<asr::AsrResult> &results)
 	combinedResults.push_back(res);
 
 	/* Get the decoded result for the combined result. */
-	std::string finalResultStr = audio::asr::DecodeOutput(combinedResults);
-
-	LOG_INF("Complete recognition: %s\n", finalResultStr.c_str());
-	return true;
+	return audio::asr::DecodeOutput(combinedResults);
 }
 
 } /* namespace app */
@@ -12,8 +12,10 @@ LOG_MODULE_REGISTER(KWSModel);
 // these can be move into the class, but then these must be allocated dynamically
 static uint8_t tensorArena[CONFIG_ACTIVATION_BUF_SZ] ACTIVATION_BUF_ATTRIBUTE;
 
+#if !defined(CONFIG_KWS_MFCC_FIXED_POINT)
 // Full 1 second sample buffer
 static int16_t audio_inf[CONFIG_I2S_SAMPLE_RATE];
+#endif
 
 static const char *labelsVec[] LABELS_ATTRIBUTE = {
 	"down",  "go",   "left", "no",  "off",       "on",
@@ -53,14 +55,48 @@ bool KWSModel::Init()
 	int mfccFrameLength = arm::app::kws::g_FrameLength;
 	int mfccFrameStride = arm::app::kws::g_FrameStride;
 
-	m_preProcess = std::make_unique<arm::app::KwsPreProcess>(
-		inputTensor, numMfccFeatures, numMfccFrames, mfccFrameLength, mfccFrameStride);
+#if defined(CONFIG_KWS_MFCC_FIXED_POINT)
+	if (inputTensor->type != kTfLiteInt8 ||
+	    inputTensor->quantization.type != kTfLiteAffineQuantization) {
+		LOG_ERR("Fixed-point features need a quantised int8 input tensor");
+		return false;
+	}
+
+	const auto *quantParams =
+		static_cast<const TfLiteAffineQuantization *>(inputTensor->quantization.params);
+
+	m_featureStream = std::make_unique<arm::app::KwsFeatureStream>(
+		numMfccFeatures, numMfccFrames, mfccFrameLength, mfccFrameStride,
+		InputSize / sizeof(int16_t));
+
+	if (!m_featureStream->Init(quantParams->scale->data[0],
+				   quantParams->zero_point->data[0])) {
+		LOG_ERR("Feature stream init failed");
+		return false;
+	}
+#else
+	m_preProcessTensor = *inputTensor;
+	m_preProcess = std::make_unique<arm::app::KwsPreProcess>(&m_preProcessTensor,
+								 numMfccFeatures, numMfccFrames,
+								 mfccFrameLength, mfccFrameStride);
+#endif
 
 	return true;
 }
 
-bool KWSModel::PreProcess()
+bool KWSModel::PreProcessInto(void *tensorData)
 {
+#if defined(CONFIG_KWS_MFCC_FIXED_POINT)
+	// only the frames of the new stride are computed, the rest of the window is kept
+	if (!m_featureStream->Update()) {
+		LOG_ERR("Feature stream update failed");
+		return false;
+	}
+
+	m_featureStream->CopyFeatures(static_cast<int8_t *>(tensorData));
+#else
+	m_preProcessTensor.data.data = tensorData;
+
 	if (!m_preProcess->DoPreProcess(audio_inf, m_index)) {
 		LOG_ERR("DoPreProcess failed");
 		return false;
@@ -71,10 +107,16 @@ bool KWSModel::PreProcess()
 	// move buffer down by one stride, clearing space at the end for the next stride
 	std::copy(audio_inf + (CONFIG_I2S_SAMPLE_RATE / 2), audio_inf + CONFIG_I2S_SAMPLE_RATE,
 		  audio_inf);
+#endif
 
 	return true;
 }
 
+bool KWSModel::PreProcess()
+{
+	return PreProcessInto(m_pInterpreter->input(0)->data.data);
+}
+
 bool KWSModel::RunInference()
 {
 	const auto rc = m_pInterpreter->Invoke();
@@ -86,6 +128,24 @@ bool KWSModel::RunInference()
 	return true;
 }
 
+bool KWSModel::PreProcess(size_t slot)
+{
+	auto &buffer = m_slots[slot];
+
+	buffer.resize(m_pInterpreter->input(0)->bytes);
+
+	return PreProcessInto(buffer.data());
+}
+
+bool KWSModel::RunInference(size_t slot)
+{
+	const auto &buffer = m_slots[slot];
+
+	std::copy(buffer.begin(), buffer.end(), m_pInterpreter->input(0)->data.int8);
+
+	return RunInference();
+}
+
 bool KWSModel::PostProcess()
 {
 	m_output.confidences.clear();
@@ -106,8 +166,23 @@ bool KWSModel::PostProcess()
 
 void *KWSModel::GetInputBuffer()
 {
+#if defined(CONFIG_KWS_MFCC_FIXED_POINT)
+	return m_featureStream->GetAudioBuffer();
+#else
 	// Fill input data to last stride in the buffer
 	return &audio_inf[CONFIG_I2S_SAMPLE_RATE / 2];
+#endif
+}
+
+void KWSModel::ResetInput()
+{
+#if defined(CONFIG_KWS_MFCC_FIXED_POINT)
+	m_featureStream->Restart();
+#else
+	// the stride before the new one was dropped, and no features of it can be reused
+	std::fill(audio_inf, audio_inf + (CONFIG_I2S_SAMPLE_RATE / 2), 0);
+	m_index = 0;
+#endif
 }
 
 KWSModel::Result KWSModel::GetResult()
@@ -7,7 +7,11 @@
 #include <tensorflow/lite/micro/micro_interpreter.h>
 #include <tensorflow/lite/micro/micro_mutable_op_resolver.h>
 
+#if defined(CONFIG_KWS_MFCC_FIXED_POINT)
+#include "mfcc/KwsFeatureStream.hpp"
+#else
 #include "mfcc/KwsProcessing.hpp"
+#endif
 
 class KWSModel
 {
@@ -25,15 +29,30 @@ public:
 	bool Init(void);
 	bool PreProcess(void);
 	bool RunInference(void);
+	/* Pre-process into one of two inputs, and run on it, for pipelined inference */
+	bool PreProcess(size_t slot);
+	bool RunInference(size_t slot);
 	bool PostProcess(void);
 	void *GetInputBuffer(void);
+	/* Start the window over from silence, keeping the stride in the input buffer */
+	void ResetInput(void);
 	Result GetResult(void);
 
 private:
+	bool PreProcessInto(void *tensorData);
+
 	std::unique_ptr<tflite::MicroInterpreter> m_pInterpreter;
+#if defined(CONFIG_KWS_MFCC_FIXED_POINT)
+	/* Features of each stride of audio as it arrives, kept for the whole window */
+	std::unique_ptr<arm::app::KwsFeatureStream> m_featureStream;
+#else
 	std::unique_ptr<arm::app::KwsPreProcess> m_preProcess;
-	tflite::MicroMutableOpResolver<1> m_resolver;
+	/* Input tensor that pre-processing writes, pointing at the model input or a slot */
+	TfLiteTensor m_preProcessTensor;
 	int m_index = 0;
+#endif
+	std::vector<int8_t> m_slots[2];
+	tflite::MicroMutableOpResolver<1> m_resolver;
 	Result m_output;
 };
 
@@ -3,6 +3,8 @@
 
 #include <cstddef>
 
+#include "AudioBackend.hpp"
+
 class LiveMicInput
 {
 public:
@@ -12,6 +14,12 @@ public:
 	bool Start();
 	bool Stop();
 	bool GetInputData(void *buffer);
+	/* Whether audio was lost to an overrun before the stride GetInputData last wrote */
+	bool Discontinuous() const;
+
+private:
+	struct audio_reader m_reader;
+	bool m_discontinuous = false;
 };
 
 #endif /* LIVEMICINPUT_H */
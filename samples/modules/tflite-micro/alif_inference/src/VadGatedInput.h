@@ -0,0 +1,153 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+#ifndef VADGATEDINPUT_H
+#define VADGATEDINPUT_H
+
+#include <zephyr/kernel.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "VoiceActivityDetector.h"
+
+/* Strides read from the input, and those of them not passed on */
+struct VadGateStats {
+	uint32_t strides;
+	uint32_t gated;
+};
+
+/**
+ * Input for InferenceRunner that passes on only the strides of Input with voice activity, so that
+ * the model neither pre-processes nor runs on the others. When activity starts, the stride before
+ * it is passed on first, as the word may have started there. That stride is kept in a buffer of
+ * its own. Discontinuous() tells the model when strides were dropped before the one passed on, by
+ * the gate or by Input, so that it does not join it to older audio.
+ */
+template <typename Input>
+class VadGatedInput
+{
+public:
+	static constexpr size_t OutputSize = Input::OutputSize;
+
+	explicit VadGatedInput(const VoiceActivityDetector::Config &config) : m_vad(config)
+	{
+	}
+
+	bool Start()
+	{
+		m_vad.Reset();
+		m_preRollValid = false;
+		m_pending = false;
+		m_dropped = false;
+		m_discontinuous = false;
+
+		return m_input.Start();
+	}
+
+	bool Stop()
+	{
+		return m_input.Stop();
+	}
+
+	/* Blocks until a stride to pass on has been written to buffer */
+	bool GetInputData(void *buffer)
+	{
+		int16_t *samples = static_cast<int16_t *>(buffer);
+
+		if (m_pending) {
+			std::copy(m_preRoll, m_preRoll + Samples, samples);
+			m_pending = false;
+			m_discontinuous = false;
+			return true;
+		}
+
+		while (true) {
+			if (!m_input.GetInputData(buffer)) {
+				return false;
+			}
+
+			/* The stride kept before this one does not lead into it */
+			if (m_input.Discontinuous()) {
+				m_dropped = true;
+				m_preRollValid = false;
+			}
+
+			const bool active = m_vad.Process(samples, Samples);
+
+			k_spinlock_key_t key = k_spin_lock(&m_statsLock);
+
+			m_stats.strides++;
+			if (!active) {
+				m_stats.gated++;
+			} else if (m_preRollValid && m_stats.gated > 0) {
+				m_stats.gated--;
+			}
+
+			k_spin_unlock(&m_statsLock, key);
+
+			if (!active) {
+				/* The stride kept before this one is dropped */
+				m_dropped = m_dropped || m_preRollValid;
+				std::copy(samples, samples + Samples, m_preRoll);
+				m_preRollValid = true;
+				continue;
+			}
+
+			/* Pass on the stride before this one first, and this one on the next call */
+			if (m_preRollValid) {
+				std::swap_ranges(samples, samples + Samples, m_preRoll);
+				m_preRollValid = false;
+				m_pending = true;
+			}
+
+			m_discontinuous = m_dropped;
+			m_dropped = false;
+
+			return true;
+		}
+	}
+
+	/* Whether strides were dropped before the one GetInputData last wrote */
+	bool Discontinuous() const
+	{
+		return m_discontinuous;
+	}
+
+	VadGateStats GetStats(bool clear = false)
+	{
+		k_spinlock_key_t key = k_spin_lock(&m_statsLock);
+		const VadGateStats stats = m_stats;
+
+		if (clear) {
+			m_stats = {};
+		}
+
+		k_spin_unlock(&m_statsLock, key);
+
+		return stats;
+	}
+
+private:
+	static constexpr size_t Samples = OutputSize / sizeof(int16_t);
+
+	Input m_input;
+	VoiceActivityDetector m_vad;
+	/* The last stride, while it was gated, or the active one that follows it */
+	int16_t m_preRoll[Samples];
+	bool m_preRollValid = false;
+	bool m_pending = false;
+	/* Strides were dropped since the last one passed on */
+	bool m_dropped = false;
+	bool m_discontinuous = false;
+	struct k_spinlock m_statsLock;
+	VadGateStats m_stats = {};
+};
+
+#endif /* VADGATEDINPUT_H */
@@ -0,0 +1,112 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+#include "VoiceActivityDetector.h"
+
+#include "arm_math.h"
+
+/* 10 * log10(2), in units of 1 / 10000 dB, to turn decibels into log2 */
+#define DB_PER_LOG2 30103
+
+/* Fractional bits of the noise floor beyond those of the levels, so that it can rise slowly */
+#define FLOOR_EXTRA_BITS 8
+
+/* The noise floor falls to a quieter frame within a few frames and rises over seconds */
+#define FLOOR_FALL_SHIFT 2
+#define FLOOR_RISE_SHIFT 9
+
+static int32_t DbToLog2Q8(int32_t db)
+{
+	return db * 256 * 10000 / DB_PER_LOG2;
+}
+
+VoiceActivityDetector::VoiceActivityDetector(const Config &config)
+	: m_config(config), m_margin(DbToLog2Q8(config.marginDb)),
+	  m_minLevel(30 * 256 + DbToLog2Q8(config.minLevelDbfs)),
+	  m_zcrMax(config.zcrMaxPercent * (config.frameLength - 1) / 100)
+{
+}
+
+void VoiceActivityDetector::Reset(void)
+{
+	m_noiseFloor = 0;
+	m_noiseFloorValid = false;
+	m_hangoverLeft = 0;
+}
+
+int32_t VoiceActivityDetector::Log2Q8(uint64_t value)
+{
+	if (value == 0) {
+		return 0;
+	}
+
+	const int32_t exponent = 63 - __builtin_clzll(value);
+	const uint64_t mantissa = (exponent >= 16) ? (value >> (exponent - 16))
+						   : (value << (16 - exponent));
+	const uint64_t fraction = mantissa & 0xFFFF;
+
+	/* log2(1 + f) ~ f + 0.3466 f (1 - f), within 0.002 */
+	const uint64_t correction = ((fraction * (65536 - fraction)) >> 16) * 22713 >> 16;
+
+	return (exponent << 8) + static_cast<int32_t>((fraction + correction) >> 8);
+}
+
+bool VoiceActivityDetector::IsSpeechFrame(const int16_t *frame)
+{
+	const uint32_t length = m_config.frameLength;
+	q63_t sumOfSquares;
+	uint32_t crossings = 0;
+
+	arm_power_q15(frame, length, &sumOfSquares);
+
+	for (uint32_t i = 1; i < length; i++) {
+		crossings += ((frame[i - 1] ^ frame[i]) < 0) ? 1 : 0;
+	}
+
+	const int32_t level = Log2Q8(static_cast<uint64_t>(sumOfSquares) / length);
+	const int32_t levelFloor = level << FLOOR_EXTRA_BITS;
+
+	if (!m_noiseFloorValid) {
+		m_noiseFloor = levelFloor;
+		m_noiseFloorValid = true;
+	}
+
+	/* Noise crosses zero about as often as fricatives do, so it takes more to count */
+	const int32_t margin = (crossings > m_zcrMax) ? 2 * m_margin : m_margin;
+	const bool speech = (level >= m_minLevel) &&
+			    (level - (m_noiseFloor >> FLOOR_EXTRA_BITS) >= margin);
+
+	const int32_t shift = (levelFloor < m_noiseFloor) ? FLOOR_FALL_SHIFT : FLOOR_RISE_SHIFT;
+
+	m_noiseFloor += (levelFloor - m_noiseFloor) / (1 << shift);
+
+	return speech;
+}
+
+bool VoiceActivityDetector::Process(const int16_t *samples, size_t count)
+{
+	uint32_t speechFrames = 0;
+
+	/* Every frame updates the noise floor, so none is skipped */
+	for (size_t start = 0; start + m_config.frameLength <= count;
+	     start += m_config.frameLength) {
+		speechFrames += IsSpeechFrame(&samples[start]) ? 1 : 0;
+	}
+
+	if (speechFrames >= m_config.minSpeechFrames) {
+		m_hangoverLeft = m_config.hangover;
+		return true;
+	}
+
+	if (m_hangoverLeft > 0) {
+		m_hangoverLeft--;
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,66 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+#ifndef VOICEACTIVITYDETECTOR_H
+#define VOICEACTIVITYDETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Fixed-point voice activity detection on blocks of audio, from the level and zero-crossing rate
+ * of short frames. A frame is speech when it stands out from the tracked noise floor by the
+ * margin, or by twice the margin when it crosses zero as often as noise does. A block with enough
+ * speech frames is active, and so are the hangover blocks after it, to catch the end of a word.
+ */
+class VoiceActivityDetector
+{
+public:
+	struct Config {
+		/* Samples per analysis frame */
+		uint32_t frameLength;
+		/* Level above the noise floor at which a frame is speech */
+		int32_t marginDb;
+		/* Level below which no frame is speech, relative to a full scale square wave */
+		int32_t minLevelDbfs;
+		/* Zero-crossing rate above which a frame needs twice the margin */
+		uint32_t zcrMaxPercent;
+		/* Speech frames that make a block active */
+		uint32_t minSpeechFrames;
+		/* Blocks kept active after the last one with speech */
+		uint32_t hangover;
+	};
+
+	explicit VoiceActivityDetector(const Config &config);
+
+	/* Forget the noise floor and the hangover */
+	void Reset(void);
+
+	/* Classify a block of samples, whose trailing partial frame is ignored. Returns whether
+	 * it is active.
+	 */
+	bool Process(const int16_t *samples, size_t count);
+
+private:
+	/* log2 of a level, with 8 fractional bits */
+	static int32_t Log2Q8(uint64_t value);
+
+	bool IsSpeechFrame(const int16_t *frame);
+
+	const Config m_config;
+	const int32_t m_margin;
+	const int32_t m_minLevel;
+	const uint32_t m_zcrMax;
+
+	/* log2 of the mean square of a noise frame, with 8 fractional bits */
+	int32_t m_noiseFloor = 0;
+	bool m_noiseFloorValid = false;
+	uint32_t m_hangoverLeft = 0;
+};
+
+#endif /* VOICEACTIVITYDETECTOR_H */
@@ -9,6 +9,10 @@
 #include "LiveMicInput.h"
 #include "ethosu/InferenceRunner.h"
 
+#if defined(CONFIG_KWS_VAD)
+#include "VadGatedInput.h"
+#endif
+
 LOG_MODULE_REGISTER(main);
 
 template <typename T>
@@ -26,14 +30,54 @@ public:
 	}
 };
 
+#if defined(CONFIG_KWS_VAD)
+/* Microphone input without the strides that have no voice activity */
+class GatedMicInput : public VadGatedInput<LiveMicInput>
+{
+public:
+	GatedMicInput()
+		: VadGatedInput({
+			  .frameLength = CONFIG_I2S_SAMPLE_RATE / 50,
+			  .marginDb = CONFIG_KWS_VAD_MARGIN_DB,
+			  .minLevelDbfs = CONFIG_KWS_VAD_MIN_LEVEL_DBFS,
+			  .zcrMaxPercent = CONFIG_KWS_VAD_ZCR_MAX_PERCENT,
+			  .minSpeechFrames = CONFIG_KWS_VAD_MIN_SPEECH_FRAMES,
+			  .hangover = CONFIG_KWS_VAD_HANGOVER,
+		  })
+	{
+	}
+};
+
+using KwsInput = GatedMicInput;
+#else
+using KwsInput = LiveMicInput;
+#endif
+
 int main()
 {
-	InferenceRunner<KWSModel, LiveMicInput, PrintHighestConfidence<KWSModel::Result>> runner;
+	/* Static, as the thread stacks and audio buffers are too large for the main stack */
+	static InferenceRunner<KWSModel, KwsInput, PrintHighestConfidence<KWSModel::Result>, 2024,
+			       10, InferenceMode::Pipelined>
+		runner;
 
 	runner.Start();
 
 	while (true) {
-		k_usleep(1000);
+		k_sleep(K_SECONDS(10));
+
+		const InferenceRunnerStats stats = runner.GetStats(true);
+
+		LOG_INF("%u frames: acquire %u us, pre-process %u us, inference %u us, "
+			"post-process %u us",
+			stats.frames, stats.acquireUs, stats.preProcessUs, stats.inferenceUs,
+			stats.postProcessUs);
+
+#if defined(CONFIG_KWS_VAD)
+		const VadGateStats gate = runner.GetInput().GetStats(true);
+
+		LOG_INF("%u of %u strides skipped without voice activity", gate.gated,
+			gate.strides);
+#endif
 	}
 
 	return 0;
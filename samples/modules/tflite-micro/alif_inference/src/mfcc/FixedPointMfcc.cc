@@ -0,0 +1,306 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+#include "FixedPointMfcc.hpp"
+#include "PlatformMath.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(FixedPointMfcc);
+
+namespace arm
+{
+namespace app
+{
+namespace audio
+{
+
+/* Exponent of a filter without energy, whose log is the floor below */
+static constexpr int32_t ZERO_ENERGY = INT32_MIN;
+
+/* ln(FLT_MIN), the smallest log mel energy of MFCC, with ms_logMelFracBits fractional bits */
+static constexpr q15_t LOG_FLOOR = -22358;
+
+/* ln(2) in q5.26, the format of arm_vlog_q31 */
+static constexpr int64_t LN2_Q26 = 46516320;
+
+/* Left shift that takes a non-negative value to at most 2^30, or 0 for 0 */
+static int32_t Headroom(const uint32_t value)
+{
+	return (value == 0) ? 0 : (__builtin_clz(value) - 1);
+}
+
+static q31_t ToQ31(float value)
+{
+	return static_cast<q31_t>(
+		std::min(std::round(static_cast<double>(value) * (1u << 31)), double(INT32_MAX)));
+}
+
+static q15_t ToQ15(float value)
+{
+	return static_cast<q15_t>(
+		std::min(std::round(static_cast<double>(value) * (1u << 15)), double(INT16_MAX)));
+}
+
+FixedPointMFCC::FixedPointMFCC(const MfccParams &params) : m_params(params)
+{
+}
+
+bool FixedPointMFCC::Init()
+{
+	const uint32_t frameLen = m_params.m_frameLen;
+	const uint32_t fftLen = m_params.m_frameLenPadded;
+
+	if (fftLen > ms_maxFftLen || m_params.m_numFbankBins > ms_maxFbankBins ||
+	    m_params.m_numMfccFeatures > ms_maxMfccFeatures) {
+		LOG_ERR("MFCC parameters exceed the table sizes");
+		return false;
+	}
+
+	if (arm_rfft_init_q31(&m_rfft, fftLen, 0, 1) != ARM_MATH_SUCCESS) {
+		LOG_ERR("FFT length %" PRIu32 " not supported", fftLen);
+		return false;
+	}
+
+	/* arm_rfft_q31 scales its output down by fftLen, so it has 31 - log2(fftLen) fractional
+	 * bits (11.21 for 1024 points in the CMSIS-DSP tables). The magnitudes have one less and
+	 * the dot product with the filter weights drops 14.
+	 */
+	m_energyFracBits = (31 - 1 + 31 - 14) - (31 - __builtin_clz(fftLen));
+
+	/* Same window function as MFCC */
+	const auto multiplier = static_cast<float>(2 * M_PI / frameLen);
+
+	for (uint32_t i = 0; i < frameLen; i++) {
+		m_windowFunc[i] = ToQ31(
+			0.5f - 0.5f * math::MathUtils::CosineF32(static_cast<float>(i) * multiplier));
+	}
+
+	if (!CreateMelFilterBank()) {
+		return false;
+	}
+
+	CreateDCTMatrix();
+	m_params.Log();
+	m_initialised = true;
+
+	return true;
+}
+
+bool FixedPointMFCC::CreateMelFilterBank()
+{
+	const uint32_t numFftBins = m_params.m_frameLenPadded / 2;
+	const float fftBinWidth = m_params.m_samplingFreq / m_params.m_frameLenPadded;
+	const bool useHtk = m_params.m_useHtkMethod;
+
+	const float melLowFreq = MFCC::MelScale(m_params.m_melLoFreq, useHtk);
+	const float melHighFreq = MFCC::MelScale(m_params.m_melHiFreq, useHtk);
+	const float melFreqDelta = (melHighFreq - melLowFreq) / (m_params.m_numFbankBins + 1);
+	uint32_t numWeights = 0;
+
+	for (uint32_t bin = 0; bin < m_params.m_numFbankBins; bin++) {
+		const float leftMel = melLowFreq + bin * melFreqDelta;
+		const float centerMel = melLowFreq + (bin + 1) * melFreqDelta;
+		const float rightMel = melLowFreq + (bin + 2) * melFreqDelta;
+
+		m_filterFirst[bin] = 0;
+		m_filterLength[bin] = 0;
+
+		for (uint32_t i = 0; i < numFftBins; i++) {
+			const float mel = MFCC::MelScale(fftBinWidth * i, useHtk);
+
+			if (mel <= leftMel || mel >= rightMel) {
+				continue;
+			}
+
+			if (numWeights == ms_maxFftLen || m_filterLength[bin] == ms_maxFilterLen) {
+				LOG_ERR("Mel filter bank exceeds the table size");
+				return false;
+			}
+
+			const float weight = (mel <= centerMel)
+						     ? (mel - leftMel) / (centerMel - leftMel)
+						     : (rightMel - mel) / (rightMel - centerMel);
+
+			if (m_filterLength[bin] == 0) {
+				m_filterFirst[bin] = i;
+			}
+
+			m_filterWeights[numWeights++] = ToQ31(weight);
+			m_filterLength[bin]++;
+		}
+	}
+
+	return true;
+}
+
+void FixedPointMFCC::CreateDCTMatrix()
+{
+	const uint32_t numBins = m_params.m_numFbankBins;
+	const uint32_t numFeatures = m_params.m_numMfccFeatures;
+	const float normaliser = math::MathUtils::SqrtF32(2.0f / numBins);
+	const float angleIncr = M_PI / numBins;
+
+	/* The largest coefficient is the normaliser, scale it up as far as q15 allows */
+	m_dctShift = 0;
+	while (normaliser * (2u << m_dctShift) < 1.0f) {
+		m_dctShift++;
+	}
+
+	const float scale = normaliser * (1u << m_dctShift);
+
+	for (uint32_t k = 0; k < numFeatures; k++) {
+		for (uint32_t n = 0; n < numBins; n++) {
+			m_dctMatrix[k * numBins + n] =
+				ToQ15(scale * math::MathUtils::CosineF32((n + 0.5f) * angleIncr * k));
+		}
+	}
+
+	arm_mat_init_q15(&m_dct, numFeatures, numBins, m_dctMatrix);
+}
+
+void FixedPointMFCC::SetQuantParams(const float quantScale, const int quantOffset)
+{
+	const double scale = std::ldexp(quantScale, OutputFracBits());
+
+	m_quantMultiplier = static_cast<int32_t>(std::round((1u << ms_quantShift) / scale));
+	m_quantOffset = quantOffset;
+
+	const double limit = std::ldexp(1.0, 15 - OutputFracBits());
+
+	if ((INT8_MAX - quantOffset) * quantScale > limit ||
+	    (quantOffset - INT8_MIN) * quantScale > limit) {
+		LOG_WRN("Features beyond +-%d saturate before quantisation", int(limit));
+	}
+}
+
+uint32_t FixedPointMFCC::OutputFracBits() const
+{
+	return ms_logMelFracBits + m_dctShift;
+}
+
+void FixedPointMFCC::ApplyMelFilterBank(const int32_t gainShift)
+{
+	const q31_t *weights = m_filterWeights;
+
+	for (uint32_t bin = 0; bin < m_params.m_numFbankBins; bin++) {
+		const q31_t *spectrum = &m_spectrum[2 * m_filterFirst[bin]];
+		const uint32_t length = m_filterLength[bin];
+		int32_t spectrumShift = 0;
+		q63_t energy = 0;
+
+		/* The magnitudes keep about 15 bits below full range, so scale the bins of each
+		 * filter up to it. The bins of a weak band would otherwise all read as zero next to
+		 * a strong one.
+		 */
+		if (length > 0) {
+			q31_t spectrumMax;
+			uint32_t index;
+
+			arm_absmax_q31(spectrum, 2 * length, &spectrumMax, &index);
+			spectrumShift = Headroom(spectrumMax);
+
+			arm_shift_q31(spectrum, spectrumShift, m_filterSpectrum, 2 * length);
+			arm_cmplx_mag_q31(m_filterSpectrum, m_filterMagnitudes, length);
+			arm_dot_prod_q31(m_filterMagnitudes, weights, length, &energy);
+			weights += length;
+		}
+
+		if (energy <= 0) {
+			m_melEnergies[bin] = INT32_MAX;
+			m_melExponents[bin] = ZERO_ENERGY;
+			continue;
+		}
+
+		/* Normalise to [0.5, 1) for the logarithm, keeping the exponent aside */
+		const int32_t shift = 33 - __builtin_clzll(energy);
+
+		m_melEnergies[bin] = (shift >= 0) ? (energy >> shift) : (energy << -shift);
+		m_melExponents[bin] = shift + 31 - static_cast<int32_t>(m_energyFracBits) -
+				      gainShift - spectrumShift;
+	}
+}
+
+void FixedPointMFCC::ConvertToLogarithmicScale()
+{
+	constexpr uint32_t shift = 26 - ms_logMelFracBits;
+
+	arm_vlog_q31(m_melEnergies, m_melEnergies, m_params.m_numFbankBins);
+
+	for (uint32_t bin = 0; bin < m_params.m_numFbankBins; bin++) {
+		if (m_melExponents[bin] == ZERO_ENERGY) {
+			m_logMelEnergies[bin] = LOG_FLOOR;
+			continue;
+		}
+
+		const int64_t logEnergy = m_melEnergies[bin] + m_melExponents[bin] * LN2_Q26;
+
+		m_logMelEnergies[bin] = static_cast<q15_t>(std::clamp<int64_t>(
+			(logEnergy + (1 << (shift - 1))) >> shift, INT16_MIN, INT16_MAX));
+	}
+}
+
+bool FixedPointMFCC::MfccCompute(const int16_t *audioData, q15_t *mfccOut)
+{
+	if (!m_initialised) {
+		LOG_ERR("Filter bank not initialised");
+		return false;
+	}
+
+	const uint32_t frameLen = m_params.m_frameLen;
+	const uint32_t fftLen = m_params.m_frameLenPadded;
+
+	/* Scale the frame up to full range, as quiet input would otherwise lose its precision in
+	 * the FFT. The gain comes off the log energies.
+	 */
+	q15_t frameMax;
+	uint32_t index;
+
+	arm_absmax_q15(audioData, frameLen, &frameMax, &index);
+	const int32_t frameShift = Headroom(static_cast<uint32_t>(frameMax) << 16);
+
+	arm_q15_to_q31(audioData, m_frame, frameLen);
+	arm_shift_q31(m_frame, frameShift, m_frame, frameLen);
+	arm_mult_q31(m_frame, m_windowFunc, m_frame, frameLen);
+	memset(&m_frame[frameLen], 0, (fftLen - frameLen) * sizeof(q31_t));
+
+	arm_rfft_q31(&m_rfft, m_frame, m_spectrum);
+
+	ApplyMelFilterBank(frameShift);
+	ConvertToLogarithmicScale();
+
+	arm_mat_vec_mult_q15(&m_dct, m_logMelEnergies, mfccOut);
+
+	return true;
+}
+
+bool FixedPointMFCC::MfccComputeQuant(const int16_t *audioData, int8_t *mfccOut)
+{
+	if (!MfccCompute(audioData, m_mfcc)) {
+		return false;
+	}
+
+	for (uint32_t i = 0; i < m_params.m_numMfccFeatures; i++) {
+		const int64_t scaled = static_cast<int64_t>(m_mfcc[i]) * m_quantMultiplier;
+		const int32_t value = static_cast<int32_t>(
+			(scaled + (1 << (ms_quantShift - 1))) >> ms_quantShift);
+
+		mfccOut[i] = static_cast<int8_t>(
+			std::clamp<int32_t>(value + m_quantOffset, INT8_MIN, INT8_MAX));
+	}
+
+	return true;
+}
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
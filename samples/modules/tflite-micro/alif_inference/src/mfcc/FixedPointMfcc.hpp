@@ -0,0 +1,125 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+#ifndef FIXED_POINT_MFCC_HPP
+#define FIXED_POINT_MFCC_HPP
+
+#include "Mfcc.hpp"
+
+#include "arm_math.h"
+
+#include <cstdint>
+
+namespace arm
+{
+namespace app
+{
+namespace audio
+{
+
+/**
+ * @brief   Fixed-point counterpart of MFCC, for the same parameters and without its filter bank
+ *          normalisation. The frame is windowed and transformed in q31, the mel energies are
+ *          taken from sparse filter weights and the cepstrum is a q15 matrix-vector product
+ *          with a precomputed DCT matrix. All of it runs on CMSIS-DSP, which uses Helium where
+ *          the core has it. The tables and buffers are members, so that computing features
+ *          does not allocate.
+ */
+class FixedPointMFCC
+{
+public:
+	static constexpr uint32_t ms_maxFftLen = 1024;
+	static constexpr uint32_t ms_maxFbankBins = 40;
+	static constexpr uint32_t ms_maxMfccFeatures = 16;
+	static constexpr uint32_t ms_maxFilterLen = 64;
+
+	explicit FixedPointMFCC(const MfccParams &params);
+
+	FixedPointMFCC() = delete;
+
+	~FixedPointMFCC() = default;
+
+	/**
+	 * @brief   Compute the window, the mel filter bank and the DCT matrix.
+	 * @return  true if successful, false if the parameters exceed the table sizes.
+	 */
+	bool Init();
+
+	/**
+	 * @brief       Set the quantisation of the features written by MfccComputeQuant.
+	 * @param[in]   quantScale    Quantisation scale.
+	 * @param[in]   quantOffset   Quantisation offset.
+	 */
+	void SetQuantParams(float quantScale, int quantOffset);
+
+	/** @brief  Number of fractional bits of the features written by MfccCompute. */
+	uint32_t OutputFracBits() const;
+
+	/**
+	 * @brief       Extract the MFCC features of one frame, saturated to the q15 range.
+	 * @param[in]   audioData   Frame length audio samples.
+	 * @param[out]  mfccOut     Features with OutputFracBits() fractional bits.
+	 * @return      true if successful, false otherwise.
+	 */
+	bool MfccCompute(const int16_t *audioData, q15_t *mfccOut);
+
+	/**
+	 * @brief       Extract the MFCC features of one frame and quantise them to int8.
+	 * @param[in]   audioData   Frame length audio samples.
+	 * @param[out]  mfccOut     Quantised features.
+	 * @return      true if successful, false otherwise.
+	 */
+	bool MfccComputeQuant(const int16_t *audioData, int8_t *mfccOut);
+
+private:
+	/* Fractional bits of the log mel energies and of the quantisation multiplier */
+	static constexpr uint32_t ms_logMelFracBits = 8;
+	static constexpr uint32_t ms_quantShift = 20;
+
+	MfccParams m_params;
+	bool m_initialised = false;
+
+	arm_rfft_instance_q31 m_rfft;
+	/* Fractional bits of the mel energies, which depend on the FFT scaling */
+	uint32_t m_energyFracBits = 0;
+	q31_t m_frame[ms_maxFftLen];
+	q31_t m_spectrum[2 * ms_maxFftLen];
+	q31_t m_windowFunc[ms_maxFftLen];
+
+	/* Non-zero weights of each filter, starting at FFT bin m_filterFirst */
+	q31_t m_filterWeights[ms_maxFftLen];
+	uint32_t m_filterFirst[ms_maxFbankBins];
+	uint32_t m_filterLength[ms_maxFbankBins];
+	q31_t m_filterSpectrum[2 * ms_maxFilterLen];
+	q31_t m_filterMagnitudes[ms_maxFilterLen];
+
+	/* Scaled up by 2^m_dctShift, for precision */
+	q15_t m_dctMatrix[ms_maxMfccFeatures * ms_maxFbankBins];
+	arm_matrix_instance_q15 m_dct;
+	uint32_t m_dctShift = 0;
+
+	q31_t m_melEnergies[ms_maxFbankBins];
+	int32_t m_melExponents[ms_maxFbankBins];
+	q15_t m_logMelEnergies[ms_maxFbankBins];
+	q15_t m_mfcc[ms_maxMfccFeatures];
+
+	/* Quantisation as a multiplier with ms_quantShift fractional bits */
+	int32_t m_quantMultiplier = 0;
+	int32_t m_quantOffset = 0;
+
+	bool CreateMelFilterBank();
+	void CreateDCTMatrix();
+	void ApplyMelFilterBank(int32_t gainShift);
+	void ConvertToLogarithmicScale();
+};
+
+} /* namespace audio */
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* FIXED_POINT_MFCC_HPP */
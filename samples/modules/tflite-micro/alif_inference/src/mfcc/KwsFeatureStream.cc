@@ -0,0 +1,101 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+#include "KwsFeatureStream.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(KwsFeatureStream);
+
+namespace arm
+{
+namespace app
+{
+
+KwsFeatureStream::KwsFeatureStream(size_t numFeatures, size_t numFeatureFrames,
+				   size_t mfccFrameLength, size_t mfccFrameStride,
+				   size_t audioStride)
+	: m_numFeatures{numFeatures}, m_numFeatureFrames{numFeatureFrames},
+	  m_mfccFrameStride{mfccFrameStride}, m_audioStride{audioStride},
+	  m_frameOverlap{mfccFrameLength - std::min(mfccFrameStride, mfccFrameLength)},
+	  m_mfcc{numFeatures, mfccFrameLength}, m_audio(m_frameOverlap + audioStride),
+	  m_silence(numFeatures), m_features(numFeatureFrames * numFeatures)
+{
+}
+
+bool KwsFeatureStream::Init(float quantScale, int quantOffset)
+{
+	if (m_mfccFrameStride == 0 || m_audioStride % m_mfccFrameStride != 0 ||
+	    m_audioStride / m_mfccFrameStride > m_numFeatureFrames) {
+		LOG_ERR("Audio stride %u does not fit the MFCC frames", unsigned(m_audioStride));
+		return false;
+	}
+
+	if (!m_mfcc.Init()) {
+		return false;
+	}
+
+	m_mfcc.SetQuantParams(quantScale, quantOffset);
+
+	/* The audio buffer starts out silent and holds at least one frame */
+	if (!m_mfcc.MfccComputeQuant(m_audio.data(), m_silence.data())) {
+		return false;
+	}
+
+	Restart();
+
+	return true;
+}
+
+void KwsFeatureStream::Restart()
+{
+	std::fill(m_audio.begin(), m_audio.begin() + m_frameOverlap, 0);
+
+	for (size_t frame = 0; frame < m_numFeatureFrames; frame++) {
+		std::memcpy(&m_features[frame * m_numFeatures], m_silence.data(), m_numFeatures);
+	}
+
+	m_nextFrame = 0;
+}
+
+int16_t *KwsFeatureStream::GetAudioBuffer()
+{
+	return &m_audio[m_frameOverlap];
+}
+
+bool KwsFeatureStream::Update()
+{
+	for (size_t start = 0; start < m_audioStride; start += m_mfccFrameStride) {
+		int8_t *features = &m_features[m_nextFrame * m_numFeatures];
+
+		if (!m_mfcc.MfccComputeQuant(&m_audio[start], features)) {
+			return false;
+		}
+
+		m_nextFrame = (m_nextFrame + 1 == m_numFeatureFrames) ? 0 : m_nextFrame + 1;
+	}
+
+	/* Keep the start of the first frame of the next stride */
+	std::copy(m_audio.end() - m_frameOverlap, m_audio.end(), m_audio.begin());
+
+	return true;
+}
+
+void KwsFeatureStream::CopyFeatures(int8_t *features) const
+{
+	const size_t split = m_nextFrame * m_numFeatures;
+
+	std::copy(m_features.begin() + split, m_features.end(), features);
+	std::copy(m_features.begin(), m_features.begin() + split,
+		  features + (m_features.size() - split));
+}
+
+} /* namespace app */
+} /* namespace arm */
@@ -0,0 +1,96 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+#ifndef KWS_FEATURE_STREAM_HPP
+#define KWS_FEATURE_STREAM_HPP
+
+#include "MicroNetKwsMfcc.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace arm
+{
+namespace app
+{
+
+/**
+ * @brief   Streaming pre-processing for Keyword Spotting, the counterpart of KwsPreProcess for
+ *          audio that arrives one stride at a time. Only the new stride and the frame overlap
+ *          before it are kept, the features of the frames it completes are computed and written
+ *          to a ring of feature vectors, and the ring is unrolled in time order for the model.
+ *          Before the first stride the window holds silence, as with KwsPreProcess, and
+ *          again after Restart() when audio was dropped.
+ */
+class KwsFeatureStream
+{
+public:
+	/**
+	 * @brief       Constructor
+	 * @param[in]   numFeatures        How many MFCC features to use.
+	 * @param[in]   numFeatureFrames   Number of MFCC vectors the model takes.
+	 * @param[in]   mfccFrameLength    Number of audio samples of one MFCC frame.
+	 * @param[in]   mfccFrameStride    Number of audio samples between consecutive frames.
+	 * @param[in]   audioStride        Number of audio samples that arrive at a time, a
+	 *                                 multiple of mfccFrameStride.
+	 */
+	KwsFeatureStream(size_t numFeatures, size_t numFeatureFrames, size_t mfccFrameLength,
+			 size_t mfccFrameStride, size_t audioStride);
+
+	/**
+	 * @brief       Set up the MFCC and fill the window with the features of silence.
+	 * @param[in]   quantScale    Quantisation scale of the model input.
+	 * @param[in]   quantOffset   Quantisation offset of the model input.
+	 * @return      true if successful, false if the parameters are not supported.
+	 */
+	bool Init(float quantScale, int quantOffset);
+
+	/** @brief  Buffer of audioStride samples for the next stride of audio. */
+	int16_t *GetAudioBuffer();
+
+	/**
+	 * @brief   Fill the window with the features of silence again, keeping the stride already
+	 *          written to GetAudioBuffer(), for when the audio before it was dropped.
+	 */
+	void Restart();
+
+	/**
+	 * @brief   Compute the features of the stride written to GetAudioBuffer().
+	 * @return  true if successful, false otherwise.
+	 */
+	bool Update();
+
+	/**
+	 * @brief       Copy the features of the window, oldest first.
+	 * @param[out]  features   numFeatureFrames * numFeatures quantised features.
+	 */
+	void CopyFeatures(int8_t *features) const;
+
+private:
+	const size_t m_numFeatures;
+	const size_t m_numFeatureFrames;
+	const size_t m_mfccFrameStride;
+	const size_t m_audioStride;
+	/* Samples of the last frame of a stride that the next frame reuses */
+	const size_t m_frameOverlap;
+
+	audio::MicroNetKwsFixedPointMFCC m_mfcc;
+	/* The frame overlap followed by the new stride */
+	std::vector<int16_t> m_audio;
+	/* Feature vector of a silent frame */
+	std::vector<int8_t> m_silence;
+	/* Feature vectors, with the oldest at m_nextFrame */
+	std::vector<int8_t> m_features;
+	size_t m_nextFrame = 0;
+};
+
+} /* namespace app */
+} /* namespace arm */
+
+#endif /* KWS_FEATURE_STREAM_HPP */
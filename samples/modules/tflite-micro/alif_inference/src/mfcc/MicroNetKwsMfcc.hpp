@@ -18,6 +18,7 @@
 #define KWS_MICRONET_MFCC_HPP
 
 #include "Mfcc.hpp"
+#include "FixedPointMfcc.hpp"
 
 namespace arm {
 namespace app {
@@ -43,6 +44,22 @@ namespace audio {
         ~MicroNetKwsMFCC() = default;
     };
 
+    /* Fixed-point counterpart of MicroNetKwsMFCC. */
+    class MicroNetKwsFixedPointMFCC : public FixedPointMFCC {
+
+    public:
+        explicit MicroNetKwsFixedPointMFCC(const size_t numFeats, const size_t frameLen)
+            :  FixedPointMFCC(MfccParams(
+                        MicroNetKwsMFCC::ms_defaultSamplingFreq,
+                        MicroNetKwsMFCC::ms_defaultNumFbankBins,
+                        MicroNetKwsMFCC::ms_defaultMelLoFreq,
+                        MicroNetKwsMFCC::ms_defaultMelHiFreq,
+                        numFeats, frameLen, MicroNetKwsMFCC::ms_defaultUseHtkMethod))
+        {}
+        MicroNetKwsFixedPointMFCC()  = delete;
+        ~MicroNetKwsFixedPointMFCC() = default;
+    };
+
 } /* namespace audio */
 } /* namespace app */
 } /* namespace arm */
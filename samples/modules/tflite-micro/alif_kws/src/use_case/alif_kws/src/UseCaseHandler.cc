@@ -127,11 +127,18 @@ bool ClassifyAudioHandler(ApplicationContext &ctx, bool oneshot)
 		// Wait until stride buffer is full - initiated above or by previous interation of
 		// loop
 		int err = wait_for_audio();
-		if (err) {
+		const bool overrun = (err == -EOVERFLOW);
+		if (err && !overrun) {
 			LOG_ERR("hal_get_audio_data failed with error: %d", err);
 			return false;
 		}
 
+		// the new stride does not follow the window after an overrun, so the window starts
+		// over from silence and no features of the old audio are reused
+		if (overrun) {
+			std::fill(audio_inf + AUDIO_STRIDE, audio_inf + AUDIO_SAMPLES, 0);
+		}
+
 		// move buffer down by one stride, clearing space at the end for the next stride
 		std::copy(audio_inf + AUDIO_STRIDE, audio_inf + AUDIO_STRIDE + AUDIO_SAMPLES,
 			  audio_inf);
@@ -146,7 +153,7 @@ bool ClassifyAudioHandler(ApplicationContext &ctx, bool oneshot)
 
 		uint32_t start = k_cycle_get_32();
 		/* Run the pre-processing, inference and post-processing. */
-		if (!preProcess.DoPreProcess(inferenceWindow, index)) {
+		if (!preProcess.DoPreProcess(inferenceWindow, overrun ? 0 : index)) {
 			LOG_ERR("Pre-processing failed.");
 			return false;
 		}
@@ -8,7 +8,7 @@
  * Includes
  ****************************************************************************/
 
-#include "inference_process.hpp"
+#include "inference_scheduler.hpp"
 
 #include <inttypes.h>
 #include <string>
@@ -32,13 +32,8 @@ using namespace InferenceProcess;
  * Defines
  ****************************************************************************/
 
-/* Number of worker threads running the inferences. There should typically be
- * one worker thread per NPU. */
-#ifndef NUM_INFERENCE_TASKS
-#define NUM_INFERENCE_TASKS 1
-#endif
-
-/* Number of sender tasks, that post inference requests to the worker threads. */
+/* Number of sender tasks, that post inference requests to the scheduler. Sender n submits its
+ * jobs with priority n, so sender 0 models the low-latency client. */
 #ifndef NUM_JOB_TASKS
 #define NUM_JOB_TASKS 2
 #endif
@@ -48,161 +43,90 @@ using namespace InferenceProcess;
 #define NUM_JOBS_PER_TASK 2
 #endif
 
+/* Time from submission by which each job should complete. */
+#ifndef JOB_DEADLINE_MS
+#define JOB_DEADLINE_MS 1000
+#endif
+
 /****************************************************************************
  * InferenceJob
  ****************************************************************************/
 
 namespace
 {
-struct InferenceProcessParams {
-	InferenceProcessParams() : tensorArena(nullptr), arenaSize(0)
-	{
-	}
-
-	InferenceProcessParams(k_queue *_queue, uint8_t *_tensorArena, size_t _arenaSize)
-		: queueHandle(_queue), tensorArena(_tensorArena), arenaSize(_arenaSize)
-	{
-	}
-
-	k_queue *queueHandle;
-	uint8_t *tensorArena;
-	size_t arenaSize;
-};
-
-/* Wrapper around InferenceProcess::InferenceJob. Adds responseQueue and status
- * for Zephyr multi-tasking purposes. */
-struct xInferenceJob : public InferenceJob {
-	xInferenceJob() : InferenceJob(), responseQueue(nullptr), status(false)
-	{
-	}
-
-	xInferenceJob(const string &_name, const DataPtr &_networkModel,
-		      const vector<DataPtr> &_input, const vector<DataPtr> &_output,
-		      const vector<DataPtr> &_expectedOutput, k_queue *_queue)
-		: InferenceJob(_name, _networkModel, _input, _output, _expectedOutput),
-		  responseQueue(_queue), status(false)
-	{
-	}
-
-	k_queue *responseQueue;
-	bool status;
-};
-
 /* Number of total completed jobs, needed to exit application correctly if
  * NUM_JOB_TASKS > 1 */
-volatile int totalCompletedJobs = 0;
+atomic_t totalCompletedJobs = ATOMIC_INIT(0);
 
-/* TensorArena static initialisation - use TENSOR_ARENA_SIZE from model header
+/* One tensor arena, shared by all jobs as the scheduler runs them one at a time.
+ * TENSOR_ARENA_SIZE comes from the model header.
  * Place in standard BSS section (will use SRAM1 when enabled) */
 __attribute__((section(".bss.tflm_arena"), aligned(16)))
-uint8_t inferenceProcessTensorArena[NUM_INFERENCE_TASKS][TENSOR_ARENA_SIZE];
+uint8_t inferenceProcessTensorArena[TENSOR_ARENA_SIZE];
 
-/* Allocate and initialize heap */
-void *allocateHeap(const size_t size)
-{
-	k_heap *heap = static_cast<k_heap *>(k_malloc(sizeof(k_heap)));
-	uint8_t *buf = static_cast<uint8_t *>(k_malloc(size));
+K_THREAD_STACK_DEFINE(schedulerStack, 8192);
+InferenceScheduler scheduler(inferenceProcessTensorArena, TENSOR_ARENA_SIZE);
 
-	if ((buf == nullptr) || (heap == nullptr)) {
-		printk("Heap allocation failed. heap=%p, buf=%p, size=%zu\n", heap, buf, size);
-		exit(1);
-	}
-
-	k_heap_init(heap, buf, size);
-
-	return static_cast<void *>(heap);
+/* Called by the scheduler thread when a job completed */
+void jobDone(ScheduledJob &job, void *userData)
+{
+	k_sem_give(static_cast<k_sem *>(userData));
 }
 
-/* inferenceProcessTask - Run jobs from queue with available driver */
-void inferenceProcessTask(void *_name, void *heap, void *_params)
+/* inferenceSenderTask - Submits NUM_JOBS_PER_TASK jobs with the priority of the task, and
+ * then waits for them to complete */
+void inferenceSenderTask(void *_name, void *_priority, void *)
 {
 	string *name = static_cast<string *>(_name);
-	InferenceProcessParams *params = static_cast<InferenceProcessParams *>(_params);
-
-	/* Assign the pre allocated heap - used in the k_queue_alloc_append */
-	k_thread_heap_assign(k_current_get(), static_cast<k_heap *>(heap));
-
-	class InferenceProcess inferenceProcess(params->tensorArena, params->arenaSize);
-
-	for (;;) {
-		/* Receive inference job */
-		xInferenceJob *job =
-			static_cast<xInferenceJob *>(k_queue_get(params->queueHandle, K_FOREVER));
+	int priority = POINTER_TO_INT(_priority);
+	int ret = 0;
 
-		printk("%s: Received inference job. job=%p\n", name->c_str(), job);
+	k_sem doneSem;
+	k_sem_init(&doneSem, 0, NUM_JOBS_PER_TASK);
 
-		/* Run inference */
-		job->status = inferenceProcess.runJob(*job);
+	/* Loop over all jobs and submit them to the scheduler */
+	ScheduledJob jobs[NUM_JOBS_PER_TASK];
+	for (int n = 0; n < NUM_JOBS_PER_TASK; n++) {
+		auto &job = jobs[n];
+		job = ScheduledJob(modelName,
+				   DataPtr((void*)networkModelData, networkModelDataSize),
+				   { DataPtr((void*)inputData, inputDataSize) },
+				   {},
+				   { DataPtr((void*)expectedOutputData, expectedOutputDataSize) },
+				   priority, k_uptime_get() + JOB_DEADLINE_MS, jobDone, &doneSem);
 
-		printk("%s: Sending inference response. job=%p\n", name->c_str(), job);
+		printk("%s: Sending inference. job=%p, name=%s, priority=%d\n", name->c_str(), &job,
+		       job.name.c_str(), priority);
 
-		/* Return inference message */
-		int ret = k_queue_alloc_append(job->responseQueue, job);
-		if (0 != ret) {
-			printk("%s: Failed to send message\n", name->c_str());
-			exit(1);
-		}
+		scheduler.submit(job);
 	}
 
-	k_thread_abort(k_current_get());
-
-	CODE_UNREACHABLE;
-}
-
-/* inferenceSenderTask - Creates NUM_INFERENCE_JOBS jobs, queues them, and then
- * listens for completion status */
-void inferenceSenderTask(void *_name, void *heap, void *_queue)
-{
-	string *name = static_cast<string *>(_name);
-	k_queue *inferenceQueue = static_cast<k_queue *>(_queue);
-	int ret = 0;
-
-	/* Assign the pre allocated heap - used in the k_queue_alloc_append */
-	k_thread_heap_assign(k_current_get(), static_cast<k_heap *>(heap));
-
-	/* Create queue for response messages */
-	k_queue senderQueue;
-	k_queue_init(&senderQueue);
-
-	/* Loop over all jobs and push them to inference queue */
-	xInferenceJob jobs[NUM_JOBS_PER_TASK];
+	/* Wait for completion status */
 	for (int n = 0; n < NUM_JOBS_PER_TASK; n++) {
-		auto &job = jobs[n];
-		job = xInferenceJob(modelName,
-				    DataPtr((void*)networkModelData, networkModelDataSize),
-				    { DataPtr((void*)inputData, inputDataSize) },
-				    {},
-				    { DataPtr((void*)expectedOutputData, expectedOutputDataSize) },
-				    &senderQueue);
-
-		printk("%s: Sending inference. job=%p, name=%s\n", name->c_str(), &job,
-		       job.name.c_str());
-
-		/* Queue job */
-		ret = k_queue_alloc_append(inferenceQueue, &job);
-		if (0 != ret) {
-			printk("%s: Failed to send message\n", name->c_str());
-			exit(1);
-		}
+		k_sem_take(&doneSem, K_FOREVER);
 	}
 
-	/* Listen for completion status */
-	do {
-		xInferenceJob *job =
-			static_cast<xInferenceJob *>(k_queue_get(&senderQueue, K_FOREVER));
+	for (auto &job : jobs) {
+		printk("%s: Received job response. job=%p, status=%u, queued=%u us, deadline %s\n",
+		       name->c_str(), &job, job.status, job.queueDelayUs,
+		       job.deadlineMissed ? "missed" : "met");
 
-		printk("%s: Received job response. job=%p, status=%u\n", name->c_str(), job,
-		       job->status);
+		ret |= job.status;
+	}
 
-		totalCompletedJobs++;
+	atomic_val_t completed =
+		atomic_add(&totalCompletedJobs, NUM_JOBS_PER_TASK) + NUM_JOBS_PER_TASK;
 
-		ret |= job->status;
-		if (job->status != 0) {
-			break;
-		}
-	} while (totalCompletedJobs < NUM_JOBS_PER_TASK * NUM_JOB_TASKS);
+	/* The last sender to complete reports for all */
+	if ((ret != 0) || (completed == NUM_JOBS_PER_TASK * NUM_JOB_TASKS)) {
+		SchedulerStats stats = scheduler.getStats();
 
-	exit(ret);
+		printk("Scheduler: jobs=%u, deadline misses=%u, queue delay avg=%u us max=%u us\n",
+		       stats.jobs, stats.deadlineMisses, stats.queueDelayAvgUs,
+		       stats.queueDelayMaxUs);
+
+		exit(ret);
+	}
 }
 
 } /* namespace */
@@ -213,22 +137,15 @@ int main()
 	struct {
 		k_thread thread;
 		k_tid_t id;
-	} threads[NUM_JOB_TASKS + NUM_INFERENCE_TASKS];
+	} threads[NUM_JOB_TASKS];
 	size_t nthreads = 0;
 
 	printk("Starting BERT-Tiny Transformer Model Demo on Ethos-U85 NPU\n");
 	printk("Model: %s\n", modelName);
 	printk("Tensor arena size: %zu bytes\n", tensorArenaSize);
-	printk("Number of inference tasks: %d\n", NUM_INFERENCE_TASKS);
 	printk("Number of job tasks: %d\n", NUM_JOB_TASKS);
 
-	/* Allocate one global heap for all threads (1KB for k_queue allocations) */
-	void *heapPtr = allocateHeap(1024);
-
-	k_queue inferenceQueue;
-	k_queue_init(&inferenceQueue);
-
-	/* inferenceSender tasks to create and queue the jobs */
+	/* inferenceSender tasks to create and submit the jobs */
 	for (int n = 0; n < NUM_JOB_TASKS; n++) {
 		const size_t stackSize = 2048;
 		k_thread_stack_t *stack = static_cast<k_thread_stack_t *>(k_malloc(stackSize));
@@ -241,7 +158,7 @@ int main()
 		string *name = new string("sender " + to_string(n));
 
 		thread.id = k_thread_create(&thread.thread, stack, stackSize, inferenceSenderTask,
-					    name, heapPtr, &inferenceQueue, 3, 0, K_FOREVER);
+					    name, INT_TO_POINTER(n), NULL, 3, 0, K_FOREVER);
 		if (thread.id == 0) {
 			printk("Failed to create 'inferenceSenderTask%i'\n", n);
 			exit(1);
@@ -250,31 +167,8 @@ int main()
 		nthreads++;
 	}
 
-	/* Create inferenceProcess tasks to process the queued jobs */
-	InferenceProcessParams taskParams[NUM_INFERENCE_TASKS];
-	for (int n = 0; n < NUM_INFERENCE_TASKS; n++) {
-		const size_t stackSize = 8192;
-		k_thread_stack_t *stack = static_cast<k_thread_stack_t *>(k_malloc(stackSize));
-		if (stack == nullptr) {
-			printk("Failed to allocate stack to 'inferenceProcessTask%i'\n", n);
-			exit(1);
-		}
-
-		auto &thread = threads[nthreads];
-		auto &taskParam = taskParams[n];
-		taskParam = InferenceProcessParams(&inferenceQueue, inferenceProcessTensorArena[n],
-						   tensorArenaSize);
-		string *name = new string("runner " + to_string(n));
-
-		thread.id = k_thread_create(&thread.thread, stack, stackSize, inferenceProcessTask,
-					    name, heapPtr, &taskParam, 2, 0, K_FOREVER);
-		if (thread.id == 0) {
-			printk("Failed to create 'inferenceProcessTask%i'\n", n);
-			exit(1);
-		}
-
-		nthreads++;
-	}
+	/* The scheduler thread owns the NPU and runs the submitted jobs */
+	scheduler.start(schedulerStack, K_THREAD_STACK_SIZEOF(schedulerStack), 2);
 
 	/* start Scheduler */
 	for (size_t n = 0; n < nthreads; n++) {
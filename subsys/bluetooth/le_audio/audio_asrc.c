@@ -0,0 +1,210 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/__assert.h>
+#include <zephyr/sys/util.h>
+#include "audio_asrc.h"
+
+#if __ARM_FEATURE_MVE & 1
+#include <arm_mve.h>
+#endif
+
+#if CONFIG_ALIF_BLE_AUDIO_USE_RAMFUNC
+#define INT_RAMFUNC __ramfunc
+#else
+#define INT_RAMFUNC
+#endif
+
+#define FRAC_BITS 30
+#define FRAC_ONE  (1UL << FRAC_BITS)
+#define FRAC_MASK (FRAC_ONE - 1)
+
+/* The read position is kept as an integer frame index into the work buffer plus a Q30 fraction.
+ * The index addresses the first of the four interpolator taps, so output is interpolated between
+ * work[index + 1] and work[index + 2].
+ */
+#define START_INDEX 0
+
+static inline uint32_t pos_index(uint32_t const pos)
+{
+	return pos >> FRAC_BITS;
+}
+
+static inline int32_t mul_q31(int32_t const a, int32_t const b)
+{
+	/* Matches the truncating behaviour of vqdmulhq_s32 */
+	return (int32_t)(((int64_t)a * b) >> 31);
+}
+
+/* Catmull-Rom interpolation in Farrow form, evaluated with Horner's rule. The polynomial
+ * coefficients are scaled by two to keep them integer.
+ */
+INT_RAMFUNC static inline pcm_sample_t interpolate(const pcm_sample_t *const taps,
+						   size_t const stride, int32_t const mu)
+{
+	int32_t const xm1 = taps[0];
+	int32_t const x0 = taps[stride];
+	int32_t const x1 = taps[2 * stride];
+	int32_t const x2 = taps[3 * stride];
+
+	int32_t const c1 = x1 - xm1;
+	int32_t const c2 = 2 * xm1 - 5 * x0 + 4 * x1 - x2;
+	int32_t const c3 = (x2 - xm1) + 3 * (x0 - x1);
+
+	int32_t acc = mul_q31(c3, mu) + c2;
+
+	acc = mul_q31(acc, mu) + c1;
+	acc = mul_q31(acc, mu) + 2 * x0;
+
+	return CLAMP(acc >> 1, INT16_MIN, INT16_MAX);
+}
+
+#if __ARM_FEATURE_MVE & 1
+/* Interpolate four output samples at once. Each lane has its own tap offset (in samples) and
+ * fractional position, so frames and channels can be mixed freely across lanes.
+ */
+INT_RAMFUNC static inline void interpolate_x4(const pcm_sample_t *const work, size_t const stride,
+					      const uint32_t *const offsets,
+					      const int32_t *const mus, pcm_sample_t *const out)
+{
+	uint32x4_t const offs = vld1q_u32(offsets);
+	int32x4_t const mu = vld1q_s32(mus);
+
+	int32x4_t const xm1 = vldrhq_gather_shifted_offset_s32(work, offs);
+	int32x4_t const x0 = vldrhq_gather_shifted_offset_s32(work + stride, offs);
+	int32x4_t const x1 = vldrhq_gather_shifted_offset_s32(work + 2 * stride, offs);
+	int32x4_t const x2 = vldrhq_gather_shifted_offset_s32(work + 3 * stride, offs);
+
+	int32x4_t const c1 = vsubq_s32(x1, xm1);
+	int32x4_t const c2 = vsubq_s32(vaddq_s32(vshlq_n_s32(xm1, 1), vshlq_n_s32(x1, 2)),
+				       vaddq_s32(vmulq_n_s32(x0, 5), x2));
+	int32x4_t const c3 = vaddq_s32(vsubq_s32(x2, xm1), vmulq_n_s32(vsubq_s32(x0, x1), 3));
+
+	int32x4_t acc = vaddq_s32(vqdmulhq_s32(c3, mu), c2);
+
+	acc = vaddq_s32(vqdmulhq_s32(acc, mu), c1);
+	acc = vaddq_s32(vqdmulhq_s32(acc, mu), vshlq_n_s32(x0, 1));
+	acc = vshrq_n_s32(acc, 1);
+	acc = vmaxq_s32(vminq_s32(acc, vdupq_n_s32(INT16_MAX)), vdupq_n_s32(INT16_MIN));
+
+	vstrhq_s32(out, acc);
+}
+#endif
+
+int audio_asrc_init(struct audio_asrc *const asrc, uint8_t const num_channels)
+{
+	if (!asrc || !num_channels || num_channels > MAX_NUMBER_OF_CHANNELS) {
+		return -EINVAL;
+	}
+
+	asrc->num_channels = num_channels;
+	asrc->step = FRAC_ONE;
+	asrc->pos = START_INDEX << FRAC_BITS;
+	memset(asrc->work, 0, sizeof(asrc->work));
+
+	return 0;
+}
+
+void audio_asrc_set_ratio_ppm(struct audio_asrc *const asrc, int32_t ppm)
+{
+	ppm = CLAMP(ppm, -AUDIO_ASRC_MAX_PPM, AUDIO_ASRC_MAX_PPM);
+
+	/* A single aligned word write, so the ISR sees either the old or the new step */
+	asrc->step = FRAC_ONE + (int32_t)(((int64_t)ppm * (int64_t)FRAC_ONE) / 1000000);
+}
+
+INT_RAMFUNC size_t audio_asrc_process(struct audio_asrc *const asrc, const pcm_sample_t *const in,
+				      size_t const in_frames, pcm_sample_t *const out,
+				      size_t const max_out_frames)
+{
+	size_t const channels = asrc->num_channels;
+	pcm_sample_t *const work = asrc->work;
+	uint32_t const step = asrc->step;
+
+	__ASSERT(in_frames && in_frames <= MAX_SAMPLES_PER_AUDIO_BLOCK, "Invalid block length");
+	__ASSERT(max_out_frames >= in_frames + AUDIO_ASRC_MAX_EXTRA_FRAMES,
+		 "Output buffer too small");
+
+	memcpy(&work[AUDIO_ASRC_HISTORY_FRAMES * channels], in,
+	       in_frames * channels * sizeof(pcm_sample_t));
+
+	/* The last position whose four taps all lie within the work buffer. The integer index
+	 * would overflow a Q2.30 word over a full block, so it is tracked separately from the
+	 * fraction here.
+	 */
+	uint32_t const last_index = in_frames + AUDIO_ASRC_HISTORY_FRAMES - 4;
+	uint32_t index = pos_index(asrc->pos);
+	uint32_t frac = asrc->pos & FRAC_MASK;
+	size_t out_frames = 0;
+	size_t out_samples = 0;
+
+#if __ARM_FEATURE_MVE & 1
+	uint32_t offsets[4];
+	int32_t mus[4];
+	size_t lane = 0;
+#endif
+
+	while (index <= last_index && out_frames < max_out_frames) {
+		int32_t const mu = (int32_t)(frac << 1);
+
+		for (size_t ch = 0; ch < channels; ch++) {
+#if __ARM_FEATURE_MVE & 1
+			offsets[lane] = index * channels + ch;
+			mus[lane] = mu;
+			if (++lane == ARRAY_SIZE(offsets)) {
+				interpolate_x4(work, channels, offsets, mus, &out[out_samples]);
+				out_samples += ARRAY_SIZE(offsets);
+				lane = 0;
+			}
+#else
+			out[out_samples++] =
+				interpolate(&work[index * channels + ch], channels, mu);
+#endif
+		}
+
+		out_frames++;
+		frac += step;
+		index += frac >> FRAC_BITS;
+		frac &= FRAC_MASK;
+	}
+
+#if __ARM_FEATURE_MVE & 1
+	for (size_t i = 0; i < lane; i++) {
+		out[out_samples++] = interpolate(&work[offsets[i]], channels, mus[i]);
+	}
+#endif
+
+	/* Keep the newest frames as history for the next block, and rebase the read position so
+	 * that it is relative to the moved history
+	 */
+	memmove(work, &work[in_frames * channels],
+		AUDIO_ASRC_HISTORY_FRAMES * channels * sizeof(pcm_sample_t));
+
+	index = MAX(index, last_index + 1) - in_frames;
+	asrc->pos = (index << FRAC_BITS) | frac;
+
+	return out_frames;
+}
+
+uint32_t audio_asrc_delay_frames(const struct audio_asrc *const asrc)
+{
+	/* The next output sample is interpolated at (index + 1 + frac), while the first frame of
+	 * the next input block will be placed at AUDIO_ASRC_HISTORY_FRAMES
+	 */
+	uint32_t const read_index = pos_index(asrc->pos) + 1;
+	uint32_t delay = AUDIO_ASRC_HISTORY_FRAMES - read_index;
+
+	if (asrc->pos & FRAC_MASK) {
+		delay--;
+	}
+
+	return delay;
+}
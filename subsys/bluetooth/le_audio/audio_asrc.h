@@ -0,0 +1,95 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#ifndef _AUDIO_ASRC_H
+#define _AUDIO_ASRC_H
+
+/**
+ * @file
+ * @brief Fixed-point asynchronous sample-rate converter
+ *
+ * Resamples interleaved 16-bit PCM by a ratio very close to one, using a 4-tap cubic (Catmull-Rom)
+ * interpolator evaluated in Farrow form. This is intended to absorb the drift between the clock
+ * of the audio source and the local audio clock, so that presentation delay can be held without
+ * inserting or dropping samples. Each call consumes one block of input and produces however many
+ * output frames fall within it at the current ratio, which is within a frame or two of the input
+ * length.
+ */
+
+#include <zephyr/kernel.h>
+#include "audio_queue.h"
+
+/* Number of input frames kept from the previous block for the interpolator taps */
+#define AUDIO_ASRC_HISTORY_FRAMES 3
+
+/* Maximum number of output frames produced in excess of the input frame count */
+#define AUDIO_ASRC_MAX_EXTRA_FRAMES 4
+
+/* Maximum supported ratio deviation from unity in parts per million */
+#define AUDIO_ASRC_MAX_PPM 5000
+
+struct audio_asrc {
+	/* Input frames consumed per output frame, Q2.30 */
+	uint32_t step;
+	/* Read position into the work buffer, Q2.30 relative to the first history frame */
+	uint32_t pos;
+	uint8_t num_channels;
+	pcm_sample_t work[(AUDIO_ASRC_HISTORY_FRAMES + MAX_SAMPLES_PER_AUDIO_BLOCK) *
+			  MAX_NUMBER_OF_CHANNELS];
+};
+
+/**
+ * @brief Initialise the sample-rate converter to unity ratio with silent history
+ *
+ * @param asrc Converter to initialise
+ * @param num_channels Number of interleaved channels in each frame
+ *
+ * @retval 0 if successful
+ * @retval Negative error code on failure
+ */
+int audio_asrc_init(struct audio_asrc *asrc, uint8_t num_channels);
+
+/**
+ * @brief Set the conversion ratio
+ *
+ * May be called from any context while the converter is running, the new ratio takes effect from
+ * the next call to @ref audio_asrc_process.
+ *
+ * @param asrc Converter to update
+ * @param ppm Ratio deviation from unity in parts per million. A positive value consumes input
+ * faster than it is output, reducing the amount of audio buffered ahead of the converter.
+ * Clamped to +/- AUDIO_ASRC_MAX_PPM.
+ */
+void audio_asrc_set_ratio_ppm(struct audio_asrc *asrc, int32_t ppm);
+
+/**
+ * @brief Resample one block of interleaved audio
+ *
+ * @param asrc Converter to use
+ * @param in Interleaved input samples
+ * @param in_frames Number of input frames, at most MAX_SAMPLES_PER_AUDIO_BLOCK
+ * @param out Interleaved output buffer
+ * @param max_out_frames Size of the output buffer in frames. A buffer of
+ * in_frames + AUDIO_ASRC_MAX_EXTRA_FRAMES frames is always sufficient.
+ *
+ * @return Number of output frames written
+ */
+size_t audio_asrc_process(struct audio_asrc *asrc, const pcm_sample_t *in, size_t in_frames,
+			  pcm_sample_t *out, size_t max_out_frames);
+
+/**
+ * @brief Get the latency added by the converter
+ *
+ * @param asrc Converter to query
+ *
+ * @return Delay through the converter in frames, rounded down
+ */
+uint32_t audio_asrc_delay_frames(const struct audio_asrc *asrc);
+
+#endif /* _AUDIO_ASRC_H */
@@ -13,14 +13,19 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/pm/pm.h>
 #include <zephyr/pm/policy.h>
-#include <stdlib.h>
+#if __ARM_FEATURE_MVE & 1
+#include <arm_mve.h>
+#endif
 
 #include "alif_lc3.h"
 #include "lc3_api.h"
 #include "audio_queue.h"
+#include "audio_queue_depth.h"
+#include "codec_mem.h"
 #include "sdu_queue.h"
 #include "gapi_isooshm.h"
 #include "audio_decoder.h"
+#include "datapath_trace.h"
 
 #include "bluetooth/le_audio/audio_sink_i2s.h"
 #include "bluetooth/le_audio/iso_datapath_ctoh.h"
@@ -33,6 +38,16 @@
 
 #define AUDIO_QUEUE_MARGIN_US     (CONFIG_ALIF_BLE_AUDIO_PRESENTATION_DELAY_QUEUE_MARGIN * 1000)
 #define MIN_PRESENTATION_DELAY_US (CONFIG_ALIF_BLE_AUDIO_MIN_PRESENTATION_DELAY_MS * 1000)
+#define PARTNER_WAIT_TIMEOUT      K_USEC(CONFIG_ALIF_BLE_AUDIO_DECODER_PARTNER_WAIT_US)
+
+#if CONFIG_ALIF_BLE_AUDIO_DECODER_MIXER
+#define DECODER_MAX_CHANNELS CONFIG_ALIF_BLE_AUDIO_DECODER_MAX_STREAMS
+#else
+#define DECODER_MAX_CHANNELS CONFIG_ALIF_BLE_AUDIO_NMB_CHANNELS
+#endif
+
+/* Callbacks which can be registered, space for them is reserved in the codec memory */
+#define DECODER_MAX_CALLBACKS 4
 
 /* Send same input data to both channels if one channel is not present.
  * This might happen at the start of the streams.
@@ -118,17 +133,32 @@ struct channel_data {
 	int32_t *lc3_status;
 	uint32_t stream_id;
 	bool enabled;
+#if CONFIG_ALIF_BLE_AUDIO_DECODER_MIXER
+	/* Q15 gain into each output channel */
+	int32_t gain[MAX_NUMBER_OF_CHANNELS];
+#endif
+	/* Decoding statistics */
+	uint32_t frames;
+	uint32_t bad_frames;
+	uint32_t cycles_last;
+	uint32_t cycles_max;
+	uint64_t cycles_total;
 };
 
 struct audio_decoder {
+	/* Region holding the decoder and all its codec state */
+	struct codec_mem mem;
 	volatile bool thread_abort;
 	struct audio_queue *audio_queue;
-	struct channel_data channel[CONFIG_ALIF_BLE_AUDIO_NMB_CHANNELS];
+	struct channel_data channel[DECODER_MAX_CHANNELS];
 	/* LC3 configuration, decoder instances and memory */
 	lc3_cfg_t lc3_cfg;
 	int32_t *lc3_scratch;
 	/* Linked list of registered callbacks */
 	struct cb_list *cb_list;
+#if CONFIG_ALIF_BLE_AUDIO_ADAPTIVE_QUEUE_DEPTH
+	struct audio_queue_depth queue_depth;
+#endif
 	/* Decoder thread */
 	struct k_thread thread;
 	k_tid_t tid;
@@ -136,15 +166,94 @@ struct audio_decoder {
 
 K_THREAD_STACK_DEFINE(decoder_stack, CONFIG_LC3_DECODER_STACK_SIZE);
 
-#if !CONFIG_I2S_SYNC_BUFFER_FORMAT_SEQUENTIAL
+#if CONFIG_ALIF_BLE_AUDIO_CODEC_STATIC_MEM
+/* Only one decoder can exist at a time, as it shares the thread stack */
+static uint8_t __attribute__((section(CONFIG_ALIF_BLE_AUDIO_CODEC_MEM_SECTION)))
+	decoder_mem[AUDIO_DECODER_MEM_SIZE] __aligned(CODEC_MEM_ALIGN);
+#endif
+
+#if !CONFIG_I2S_SYNC_BUFFER_FORMAT_SEQUENTIAL && !CONFIG_ALIF_BLE_AUDIO_DECODER_MIXER
 /* Audio output data must be in "interleaved" format meaning that every even pcm data is left
  * channel and every odd is right channel.
- * Temporary buffer is needed to handle LC3 output per input channel.
+ * The left channel is decoded straight into the upper half of the audio block and interleaved in
+ * place, so a temporary buffer is only needed for the right channel.
  */
-static pcm_sample_t pcm_temp_buffer[CONFIG_ALIF_BLE_AUDIO_NMB_CHANNELS]
-				   [MAX_SAMPLES_PER_AUDIO_BLOCK];
+#if CONFIG_ALIF_BLE_AUDIO_NMB_CHANNELS > 1
+static pcm_sample_t pcm_temp_buffer[MAX_SAMPLES_PER_AUDIO_BLOCK];
+#endif
+
+/* Measure cycles spent in producing the interleaved output. Keep for debugging. */
+#define INTERLEAVE_CYCLES_DEBUG 0
+
+#if INTERLEAVE_CYCLES_DEBUG
+struct interleave_cycles_debug {
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint64_t total;
+};
+static struct interleave_cycles_debug interleave_cycles = {.min = UINT32_MAX};
+
+static void interleave_cycles_record(uint32_t const cycles)
+{
+	struct interleave_cycles_debug *const p_debug = &interleave_cycles;
+
+	p_debug->min = MIN(p_debug->min, cycles);
+	p_debug->max = MAX(p_debug->max, cycles);
+	p_debug->total += cycles;
+	if (++p_debug->count >= 1000) {
+		LOG_INF("Interleave cycles: min %u, avg %u, max %u", p_debug->min,
+			(uint32_t)(p_debug->total / p_debug->count), p_debug->max);
+		*p_debug = (struct interleave_cycles_debug){.min = UINT32_MAX};
+	}
+}
 #endif
 
+static inline pcm_sample_t *channel_decode_buffer(struct audio_block *const audio,
+						  size_t const block_samples, size_t const channel)
+{
+#if CONFIG_ALIF_BLE_AUDIO_NMB_CHANNELS > 1
+	if (channel) {
+		return pcm_temp_buffer;
+	}
+#endif
+	return audio->buf_left + block_samples;
+}
+
+/**
+ * @brief Interleave left and right channel samples into the output buffer
+ *
+ * The left channel input may be located in the upper half of the output buffer, since every
+ * input sample is read before the output positions at or beyond it are written. The same input
+ * can be given for both channels to duplicate a mono channel.
+ */
+INT_RAMFUNC static void interleave_channels(pcm_sample_t *p_dst, pcm_sample_t const *p_left,
+					    pcm_sample_t const *p_right, size_t samples)
+{
+#if __ARM_FEATURE_MVE & 1
+	int16x8x2_t vec;
+
+	while (samples >= 8) {
+		vec.val[0] = vld1q_s16(p_left);
+		vec.val[1] = vld1q_s16(p_right);
+		vst2q_s16(p_dst, vec);
+		p_left += 8;
+		p_right += 8;
+		p_dst += 16;
+		samples -= 8;
+	}
+#endif
+
+	while (samples--) {
+		pcm_sample_t const left = *p_left++;
+		pcm_sample_t const right = *p_right++;
+
+		*p_dst++ = left;
+		*p_dst++ = right;
+	}
+}
+#endif /* !CONFIG_I2S_SYNC_BUFFER_FORMAT_SEQUENTIAL && !CONFIG_ALIF_BLE_AUDIO_DECODER_MIXER */
+
 static int alloc_channel_index(struct audio_decoder const *const decoder)
 {
 	for (size_t iter = 0; iter < ARRAY_SIZE(decoder->channel); iter++) {
@@ -166,6 +275,157 @@ static int get_channel_index(struct audio_decoder const *const decoder, uint32_t
 	return -EINVAL;
 }
 
+static uint32_t enabled_channels(struct audio_decoder const *const decoder)
+{
+	uint32_t mask = 0;
+
+	for (size_t iter = 0; iter < ARRAY_SIZE(decoder->channel); iter++) {
+		if (decoder->channel[iter].sdu_queue && decoder->channel[iter].enabled) {
+			mask |= BIT(iter);
+		}
+	}
+
+	return mask;
+}
+
+/**
+ * @brief Wait for SDUs to become available on the enabled channels
+ *
+ * Blocks on the SDU queues of all enabled channels at once instead of polling them.
+ *
+ * @param dec Decoder instance
+ * @param mask Bitmask of the channels to wait on, disabled channels are ignored
+ * @param wait_all Wait until every channel waited on has an SDU instead of just one of them
+ * @param timeout Maximum time to wait
+ *
+ * @return Bitmask of enabled channels which have an SDU available
+ */
+INT_RAMFUNC static uint32_t wait_for_sdus(struct audio_decoder *const dec, uint32_t const mask,
+					  bool const wait_all, k_timeout_t const timeout)
+{
+	struct k_poll_event events[ARRAY_SIZE(dec->channel)];
+	struct block_ring *rings[ARRAY_SIZE(dec->channel)];
+	k_timepoint_t const end = sys_timepoint_calc(timeout);
+	uint32_t ready;
+
+	while (true) {
+		int num_events = 0;
+
+		ready = 0;
+
+		for (size_t iter = 0; iter < ARRAY_SIZE(dec->channel); iter++) {
+			struct channel_data *const channel = &dec->channel[iter];
+
+			if (!channel->sdu_queue || !channel->enabled || !(mask & BIT(iter))) {
+				continue;
+			}
+
+			if (!block_ring_poll_init(&channel->sdu_queue->ring, &events[num_events])) {
+				ready |= BIT(iter);
+				continue;
+			}
+
+			rings[num_events++] = &channel->sdu_queue->ring;
+		}
+
+		if (dec->thread_abort || !num_events || (ready && !wait_all) ||
+		    sys_timepoint_expired(end)) {
+			for (int i = 0; i < num_events; i++) {
+				block_ring_poll_done(rings[i]);
+			}
+			if (!num_events && !ready && !dec->thread_abort) {
+				/* No channels enabled, idle until the timeout expires */
+				k_sleep(sys_timepoint_timeout(end));
+			}
+			return ready;
+		}
+
+		(void)k_poll(events, num_events, sys_timepoint_timeout(end));
+
+		for (int i = 0; i < num_events; i++) {
+			block_ring_poll_done(rings[i]);
+		}
+	}
+}
+
+#if CONFIG_ALIF_BLE_AUDIO_ADAPTIVE_QUEUE_DEPTH
+/**
+ * @brief Limit the audio queue to the depth needed for the measured link jitter
+ *
+ * The delay and loss statistics are gathered by the ISO datapath of each channel as SDUs arrive,
+ * so they are not affected by the decoder waiting for space in the audio queue.
+ */
+static void update_queue_depth(struct audio_decoder *const dec)
+{
+	uint32_t delay_us = 0;
+	uint32_t lost = 0;
+
+	for (size_t iter = 0; iter < ARRAY_SIZE(dec->channel); iter++) {
+		struct sdu_queue *const queue = dec->channel[iter].sdu_queue;
+
+		if (!queue || !dec->channel[iter].enabled) {
+			continue;
+		}
+
+		delay_us = MAX(delay_us, (uint32_t)MAX(atomic_clear(&queue->peak_delay_us), 0));
+		lost = MAX(lost, (uint32_t)atomic_clear(&queue->lost));
+	}
+
+	uint16_t const target = audio_queue_depth_update(&dec->queue_depth, delay_us, lost);
+
+	if (target != dec->audio_queue->ring.limit) {
+		LOG_INF("Audio queue depth %u of %u blocks", target,
+			dec->audio_queue->ring.block_count);
+		block_ring_set_limit(&dec->audio_queue->ring, target);
+	}
+}
+#endif
+
+INT_RAMFUNC static void record_frame(struct channel_data *const channel, uint32_t const cycles,
+				     bool const bad_frame)
+{
+	channel->frames++;
+	channel->bad_frames += bad_frame;
+	channel->cycles_last = cycles;
+	channel->cycles_max = MAX(channel->cycles_max, cycles);
+	channel->cycles_total += cycles;
+}
+
+/**
+ * @brief Pass a decoded audio block on to the audio sink
+ */
+INT_RAMFUNC static void publish_block(struct audio_decoder *const dec,
+				      struct audio_block *const audio, uint32_t const timestamp,
+				      uint16_t const sdu_seq)
+{
+	audio->timestamp = timestamp;
+	audio->sdu_seq = sdu_seq;
+
+	/* Notify datapath that SDUs are completed. This also triggers next read
+	 * if last one was failed for some reason. Do this before the audio queue
+	 * put so ISO RX can re-arm immediately even if the audio queue is full.
+	 */
+	for (int i = 0; i < ARRAY_SIZE(dec->channel); i++) {
+		iso_datapath_ctoh_notify_sdu_done(dec->channel[i].iso_dp, timestamp, sdu_seq);
+	}
+
+	/* Notify listeners that a block is completed */
+	struct cb_list *cb_item = dec->cb_list;
+
+	while (cb_item) {
+		cb_item->cb(cb_item->context, timestamp, sdu_seq);
+		cb_item = cb_item->next;
+	}
+
+	/* Push the audio data to queue. Space was reserved when the block was acquired */
+	block_ring_commit(&dec->audio_queue->ring, audio);
+	datapath_trace_record(DATAPATH_TRACE_AUDIO_QUEUED, DATAPATH_TRACE_ANY_CHANNEL, sdu_seq);
+
+	/* Notify I2S sink that it has a buffer available */
+	audio_sink_i2s_notify_buffer_available(NULL, 0, 0);
+}
+
+#if !CONFIG_ALIF_BLE_AUDIO_DECODER_MIXER
 INT_RAMFUNC static void audio_decoder_thread_func(void *p1, void *p2, void *p3)
 {
 	struct audio_decoder *dec = (struct audio_decoder *)p1;
@@ -183,6 +443,8 @@ INT_RAMFUNC static void audio_decoder_thread_func(void *p1, void *p2, void *p3)
 	size_t last_sdu_seq = 0;
 	uint32_t timestamp;
 	uint8_t bec_detect;
+	uint32_t ready;
+	uint32_t enabled;
 
 #if DT_NODE_EXISTS(GPIO_TEST0_NODE)
 	set_test_pin(&test_pin0, 0);
@@ -196,53 +458,39 @@ INT_RAMFUNC static void audio_decoder_thread_func(void *p1, void *p2, void *p3)
 
 	while (!dec->thread_abort) {
 		/* Get a free audio block to decode into. Use a bounded wait so
-		 * the thread is never parked indefinitely on the slab waitq -
-		 * if delete is called while we're blocked here, we'd otherwise
-		 * leak a dangling waitq entry into the kernel scheduler.
+		 * the thread notices thread_abort within ~20 ms when the audio
+		 * queue is full and delete is called.
 		 */
-		audio = NULL;
-		ret = k_mem_slab_alloc(&audio_queue->slab, (void **)&audio, K_MSEC(20));
-		if (ret == -EAGAIN) {
+		audio = block_ring_acquire(&audio_queue->ring, K_MSEC(20));
+		if (!audio) {
 			/* Timed out - re-check thread_abort and try again */
 			continue;
 		}
-		if (ret || !audio) {
-			k_sleep(K_MSEC(2));
-			LOG_ERR("Failed to allocate audio block");
-			continue;
-		}
 
 		timestamp = 0;
 		num_channels = 0;
+		enabled = enabled_channels(dec);
 
-get_next_sdus:
+		/* Block until at least one enabled channel has an SDU available, then give the
+		 * remaining channels a short window to deliver the partner SDU of the same frame.
+		 */
+		ready = wait_for_sdus(dec, enabled, false, K_MSEC(20));
+		if (ready && ready != enabled) {
+			ready = wait_for_sdus(dec, enabled, true, PARTNER_WAIT_TIMEOUT);
+		}
 
 		iter = ARRAY_SIZE(dec->channel);
 
 		while (iter--) {
 			struct channel_data *channel = &dec->channel[iter];
 
-			if (!channel->sdu_queue || !channel->enabled) {
+			if (!(ready & BIT(iter))) {
 				continue;
 			}
 
 			/* Get an SDU */
-			p_sdu = NULL;
-
-			ret = k_msgq_get(&channel->sdu_queue->msgq, &p_sdu, K_NO_WAIT);
-			if (ret || !p_sdu) {
-				continue;
-			}
-
-			/* A NULL SDU can be sent to the queue to wake up and abort the
-			 * thread. Stop processing for this loop and check thread abort
-			 * flag.
-			 */
+			p_sdu = block_ring_get(&channel->sdu_queue->ring, K_NO_WAIT);
 			if (!p_sdu) {
-				if (dec->thread_abort) {
-					LOG_DBG("Decoder thread aborting");
-					goto decode_finalize;
-				}
 				continue;
 			}
 
@@ -253,7 +501,8 @@ get_next_sdus:
 			pcm_sample_t *const p_audio_data =
 				audio->buf_left + audio_block_samples * iter;
 #else
-			pcm_sample_t *const p_audio_data = pcm_temp_buffer[iter];
+			pcm_sample_t *const p_audio_data =
+				channel_decode_buffer(audio, audio_block_samples, iter);
 #endif
 
 			bool const bad_frame = (p_sdu->status != GAPI_ISOOSHM_SDU_STATUS_VALID);
@@ -267,14 +516,22 @@ get_next_sdus:
 #if DT_NODE_EXISTS(GPIO_TEST0_NODE)
 			set_test_pin(&test_pin0, 1);
 #endif
+			datapath_trace_record(DATAPATH_TRACE_DECODE_START, channel->stream_id,
+					      p_sdu->seq_num);
+			uint32_t const start_cycles = k_cycle_get_32();
+
 			ret = lc3_api_decode_frame(&dec->lc3_cfg, channel->lc3_decoder, p_sdu->data,
 						   p_sdu->sdu_len, bad_frame, &bec_detect,
 						   p_audio_data, dec->lc3_scratch);
+			record_frame(channel, k_cycle_get_32() - start_cycles, bad_frame || bec_detect);
+			datapath_trace_record(DATAPATH_TRACE_DECODE_END, channel->stream_id,
+					      p_sdu->seq_num);
 #if DT_NODE_EXISTS(GPIO_TEST0_NODE)
 			set_test_pin(&test_pin0, 0);
 #endif
 			if (ret) {
 				LOG_ERR("LC3 decoding failed on channel %d with err %d", iter, ret);
+				block_ring_release(&channel->sdu_queue->ring, p_sdu);
 				continue;
 			}
 
@@ -288,17 +545,20 @@ get_next_sdus:
 				last_sdu_seq = p_sdu->seq_num;
 			}
 
-			/* SDU is no longer needed, free it */
-			k_mem_slab_free(&channel->sdu_queue->slab, p_sdu);
+			/* SDU is no longer needed, release it */
+			block_ring_release(&channel->sdu_queue->ring, p_sdu);
+		}
+
+#if CONFIG_ALIF_BLE_AUDIO_ADAPTIVE_QUEUE_DEPTH
+		if (ready) {
+			update_queue_depth(dec);
 		}
+#endif
 
 		if (!num_channels) {
-			if (dec->thread_abort) {
-				break;
-			}
-			/* No channels present, wait for next block */
-			k_sleep(K_MSEC(1));
-			goto get_next_sdus;
+			/* Nothing decoded, release the audio block and wait for the next frame */
+			block_ring_cancel(&audio_queue->ring, audio);
+			continue;
 		}
 
 #if CONFIG_I2S_SYNC_BUFFER_FORMAT_SEQUENTIAL
@@ -338,28 +598,28 @@ get_next_sdus:
 		}
 
 #else /* !CONFIG_I2S_SYNC_BUFFER_FORMAT_SEQUENTIAL */
-		/* fill the audio buffer with proper data format */
-		pcm_sample_t *p_audio_out = audio->buf_left;
+		/* fill the audio buffer with proper data format, a missing channel is replaced
+		 * with the other one
+		 */
+		pcm_sample_t const *p_left = audio->buf_left + audio_block_samples;
+		pcm_sample_t const *p_right = p_left;
 
-		if (num_channels != (LEFT_CH + RIGHT_CH)) {
-			pcm_sample_t sample;
-			pcm_sample_t const *p_in =
-				(num_channels & LEFT_CH) ? pcm_temp_buffer[0] : pcm_temp_buffer[1];
-
-			iter = audio_block_samples;
-			while (iter--) {
-				sample = *p_in++;
-				*p_audio_out++ = sample;
-				*p_audio_out++ = sample;
-			}
-		} else {
-			for (size_t sample = 0; sample < audio_block_samples; sample++) {
-				*p_audio_out++ = pcm_temp_buffer[0][sample];
 #if CONFIG_ALIF_BLE_AUDIO_NMB_CHANNELS > 1
-				*p_audio_out++ = pcm_temp_buffer[1][sample];
-#endif
-			}
+		if (num_channels & RIGHT_CH) {
+			p_right = pcm_temp_buffer;
+		}
+		if (!(num_channels & LEFT_CH)) {
+			p_left = p_right;
 		}
+#endif
+
+#if INTERLEAVE_CYCLES_DEBUG
+		uint32_t const start_cycles = k_cycle_get_32();
+#endif
+		interleave_channels(audio->buf_left, p_left, p_right, audio_block_samples);
+#if INTERLEAVE_CYCLES_DEBUG
+		interleave_cycles_record(k_cycle_get_32() - start_cycles);
+#endif
 
 #endif /* CONFIG_I2S_SYNC_BUFFER_FORMAT_SEQUENTIAL */
 
@@ -369,55 +629,288 @@ get_next_sdus:
 		}
 #endif
 
-decode_finalize:
-	audio->timestamp = timestamp;
-	audio->num_channels = (num_channels == (LEFT_CH + RIGHT_CH)) ? 2 : 1;
+		audio->num_channels = (num_channels == (LEFT_CH + RIGHT_CH)) ? 2 : 1;
+		publish_block(dec, audio, timestamp, last_sdu_seq);
+	}
 
-	/* Notify datapath that SDUs are completed. This also triggers next read
-	 * if last one was failed for some reason. Do this before the audio queue
-	 * put so ISO RX can re-arm immediately even if the audio queue is full.
-	 */
-	for (int i = 0; i < ARRAY_SIZE(dec->channel); i++) {
-		iso_datapath_ctoh_notify_sdu_done(dec->channel[i].iso_dp, timestamp,
-						  last_sdu_seq);
+	LOG_DBG("Decoder thread finished");
+}
+#endif /* !CONFIG_ALIF_BLE_AUDIO_DECODER_MIXER */
+
+#if CONFIG_ALIF_BLE_AUDIO_DECODER_MIXER
+/* Each stream is decoded into a temporary buffer and added into a 32-bit accumulator for each
+ * output channel, which is saturated into the audio block once all streams have been mixed.
+ */
+static pcm_sample_t mix_decode_buffer[MAX_SAMPLES_PER_AUDIO_BLOCK];
+static int32_t mix_accumulator[MAX_NUMBER_OF_CHANNELS][MAX_SAMPLES_PER_AUDIO_BLOCK];
+
+/**
+ * @brief Add a decoded stream into the mix accumulators
+ *
+ * @param channel Channel the samples were decoded from
+ * @param samples Number of samples in the frame
+ * @param first The first stream of a frame overwrites the accumulators instead of adding to them
+ */
+INT_RAMFUNC static void mix_stream(struct channel_data const *const channel, size_t const samples,
+				   bool const first)
+{
+	for (size_t out = 0; out < MAX_NUMBER_OF_CHANNELS; out++) {
+		int32_t const gain = channel->gain[out];
+		pcm_sample_t const *p_in = mix_decode_buffer;
+		int32_t *p_acc = mix_accumulator[out];
+		size_t count = samples;
+
+#if __ARM_FEATURE_MVE & 1
+		while (count >= 4) {
+			int32x4_t const in = vldrhq_s32(p_in);
+			int32x4_t mixed = vshrq_n_s32(vmulq_n_s32(in, gain), 15);
+
+			if (!first) {
+				mixed = vaddq_s32(mixed, vld1q_s32(p_acc));
+			}
+			vst1q_s32(p_acc, mixed);
+			p_in += 4;
+			p_acc += 4;
+			count -= 4;
+		}
+#endif
+
+		while (count--) {
+			int32_t const mixed = (*p_in++ * gain) >> 15;
+
+			*p_acc = first ? mixed : *p_acc + mixed;
+			p_acc++;
+		}
 	}
+}
 
-	/* Notify listeners that a block is completed. Do this before the audio
-	 * queue put so callbacks (e.g., sequence tracking) fire even when the
-	 * audio queue is full and the frame is dropped.
-	 */
-	struct cb_list *cb_item = dec->cb_list;
+/**
+ * @brief Saturate the mix accumulators into the audio block in the I2S buffer format
+ */
+INT_RAMFUNC static void store_mix(struct audio_block *const audio, size_t const samples)
+{
+	for (size_t out = 0; out < MAX_NUMBER_OF_CHANNELS; out++) {
+		int32_t const *p_acc = mix_accumulator[out];
+#if CONFIG_I2S_SYNC_BUFFER_FORMAT_SEQUENTIAL
+		pcm_sample_t *p_dst = audio->buf_left + out * samples;
+		size_t const stride = 1;
+#else
+		pcm_sample_t *p_dst = audio->buf_left + out;
+		size_t const stride = MAX_NUMBER_OF_CHANNELS;
+#endif
+		size_t count = samples;
 
-	while (cb_item) {
-		cb_item->cb(cb_item->context, timestamp, last_sdu_seq);
-		cb_item = cb_item->next;
+#if __ARM_FEATURE_MVE & 1
+		int32x4_t const max = vdupq_n_s32(INT16_MAX);
+		int32x4_t const min = vdupq_n_s32(INT16_MIN);
+		uint32x4_t const offsets = vmulq_n_u32(vidupq_n_u32(0, 1), stride);
+
+		while (count >= 4) {
+			int32x4_t const acc = vmaxq_s32(vminq_s32(vld1q_s32(p_acc), max), min);
+
+			vstrhq_scatter_shifted_offset_s32(p_dst, offsets, acc);
+			p_acc += 4;
+			p_dst += 4 * stride;
+			count -= 4;
+		}
+#endif
+
+		while (count--) {
+			*p_dst = CLAMP(*p_acc, INT16_MIN, INT16_MAX);
+			p_acc++;
+			p_dst += stride;
+		}
 	}
+}
+
+/**
+ * @brief Decode the SDU of a channel and add it to the mix
+ *
+ * @retval true if a valid frame was mixed
+ * @retval false if no valid frame was available
+ */
+INT_RAMFUNC static bool decode_and_mix(struct audio_decoder *const dec, size_t const iter,
+				       size_t const samples, bool const first,
+				       uint32_t *const p_timestamp, uint16_t *const p_sdu_seq)
+{
+	struct channel_data *const channel = &dec->channel[iter];
+	gapi_isooshm_sdu_buf_t *const p_sdu = block_ring_get(&channel->sdu_queue->ring, K_NO_WAIT);
+	uint8_t bec_detect;
+
+	if (!p_sdu) {
+		return false;
+	}
+
+	bool const bad_frame = (p_sdu->status != GAPI_ISOOSHM_SDU_STATUS_VALID);
+	uint32_t const start_cycles = k_cycle_get_32();
+
+	datapath_trace_record(DATAPATH_TRACE_DECODE_START, channel->stream_id, p_sdu->seq_num);
+	int const ret = lc3_api_decode_frame(&dec->lc3_cfg, channel->lc3_decoder, p_sdu->data,
+					     p_sdu->sdu_len, bad_frame, &bec_detect,
+					     mix_decode_buffer, dec->lc3_scratch);
+	bool const valid = !ret && !bec_detect && !bad_frame && p_sdu->sdu_len;
+
+	if (valid) {
+		mix_stream(channel, samples, first);
+		*p_timestamp = p_sdu->timestamp;
+		*p_sdu_seq = p_sdu->seq_num;
+	}
+
+	record_frame(channel, k_cycle_get_32() - start_cycles, !valid);
+	datapath_trace_record(DATAPATH_TRACE_DECODE_END, channel->stream_id, p_sdu->seq_num);
 
-	/* Push the audio data to queue. Use a bounded wait so the thread
-	 * is never parked indefinitely on the msgq waitq during teardown.
-	 * If the queue is full and we time out, free the block and drop
-	 * the frame rather than retrying forever.
-	 */
-	ret = k_msgq_put(&audio_queue->msgq, (void **)&audio, K_MSEC(20));
 	if (ret) {
-		k_mem_slab_free(&audio_queue->slab, audio);
-		if (dec->thread_abort) {
-			break;
+		LOG_ERR("LC3 decoding failed on channel %d with err %d", iter, ret);
+	}
+
+	/* SDU is no longer needed, release it */
+	block_ring_release(&channel->sdu_queue->ring, p_sdu);
+
+	return valid;
+}
+
+INT_RAMFUNC static void audio_decoder_thread_func(void *p1, void *p2, void *p3)
+{
+	struct audio_decoder *dec = (struct audio_decoder *)p1;
+	struct audio_queue *const audio_queue = dec->audio_queue;
+	size_t const samples = audio_queue->audio_block_samples;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	LOG_DBG("Decoder mixer thread started");
+
+	while (!dec->thread_abort) {
+		/* Bounded wait so that thread_abort is noticed when the audio queue is full */
+		struct audio_block *const audio = block_ring_acquire(&audio_queue->ring, K_MSEC(20));
+
+		if (!audio) {
+			continue;
 		}
-		LOG_WRN("Audio queue full, dropped frame (err %d)", ret);
-		continue;
+
+		uint32_t const enabled = enabled_channels(dec);
+		uint32_t pending = enabled;
+		uint32_t timestamp = 0;
+		uint16_t sdu_seq = 0;
+		bool mixed = false;
+
+		/* Decode each stream as soon as its SDU arrives rather than once the SDUs of all
+		 * streams are available, so that decoding is spread over the time the SDUs of a
+		 * frame take to arrive. The remaining streams are given the partner window from the
+		 * arrival of the first SDU.
+		 */
+		uint32_t ready = wait_for_sdus(dec, pending, false, K_MSEC(20));
+		k_timepoint_t const partner_end = sys_timepoint_calc(PARTNER_WAIT_TIMEOUT);
+
+		while (ready) {
+			for (size_t iter = 0; iter < ARRAY_SIZE(dec->channel); iter++) {
+				if (!(ready & BIT(iter))) {
+					continue;
+				}
+
+				pending &= ~BIT(iter);
+				if (decode_and_mix(dec, iter, samples, !mixed, &timestamp,
+						   &sdu_seq)) {
+					mixed = true;
+				}
+			}
+
+			if (!pending || dec->thread_abort) {
+				break;
+			}
+
+			ready = wait_for_sdus(dec, pending, false,
+					      sys_timepoint_timeout(partner_end));
+		}
+
+#if CONFIG_ALIF_BLE_AUDIO_ADAPTIVE_QUEUE_DEPTH
+		if (pending != enabled) {
+			update_queue_depth(dec);
+		}
+#endif
+
+		if (!mixed) {
+			/* Nothing decoded, release the audio block and wait for the next frame */
+			block_ring_cancel(&audio_queue->ring, audio);
+			continue;
+		}
+
+		store_mix(audio, samples);
+		audio->num_channels = MAX_NUMBER_OF_CHANNELS;
+		publish_block(dec, audio, timestamp, sdu_seq);
 	}
 
-	/* Notify I2S sink that it has a buffer available */
-	audio_sink_i2s_notify_buffer_available(NULL, 0, 0);
+	LOG_DBG("Decoder mixer thread finished");
+}
+#endif /* CONFIG_ALIF_BLE_AUDIO_DECODER_MIXER */
+
+static int configure_lc3(lc3_cfg_t *const lc3_cfg, struct audio_decoder_params const *const params)
+{
+	uint32_t const lc3_duration =
+		params->frame_duration_us == 10000 ? FRAME_DURATION_10_MS : FRAME_DURATION_7_5_MS;
+
+	return lc3_api_configure(lc3_cfg, params->sampling_rate_hz, lc3_duration);
+}
+
+/* Memory needed whatever the LC3 configuration, allowing for aligning the start of a caller
+ * provided region
+ */
+#define DECODER_FIXED_MEM_SIZE                                                                     \
+	(CODEC_MEM_ALIGN + CODEC_MEM_SIZEOF(sizeof(struct audio_decoder)) +                        \
+	 DECODER_MAX_CHANNELS * CODEC_MEM_SIZEOF(sizeof(lc3_decoder_t)) +                          \
+	 DECODER_MAX_CALLBACKS * CODEC_MEM_SIZEOF(sizeof(struct cb_list)))
+
+static size_t required_mem_size(lc3_cfg_t const *const lc3_cfg)
+{
+	return DECODER_FIXED_MEM_SIZE + CODEC_MEM_SIZEOF(lc3_api_decoder_scratch_size(lc3_cfg)) +
+	       DECODER_MAX_CHANNELS * CODEC_MEM_SIZEOF(lc3_api_decoder_status_size(lc3_cfg));
+}
+
+size_t audio_decoder_mem_size(struct audio_decoder_params const *const params)
+{
+	lc3_cfg_t lc3_cfg;
+
+	if (!params || configure_lc3(&lc3_cfg, params)) {
+		return 0;
 	}
 
-	LOG_DBG("Decoder thread finished");
+	return required_mem_size(&lc3_cfg);
 }
 
+#if CONFIG_ALIF_BLE_AUDIO_CODEC_STATIC_MEM
+/* The LC3 scratch and status sizes are only known from the codec library at run time, so the
+ * rest of the static memory is checked at build time and the total for the configured stream at
+ * boot
+ */
+BUILD_ASSERT(AUDIO_DECODER_MEM_SIZE >= DECODER_FIXED_MEM_SIZE,
+	     "CONFIG_ALIF_BLE_AUDIO_DECODER_MEM_SIZE is too small for the decoder state");
+
+static int audio_decoder_check_static_mem(void)
+{
+	struct audio_decoder_params const params = {
+		.frame_duration_us =
+			IS_ENABLED(CONFIG_ALIF_BLE_AUDIO_FRAME_DURATION_10MS) ? 10000 : 7500,
+		.sampling_rate_hz = CONFIG_ALIF_BLE_AUDIO_FS_HZ,
+	};
+	size_t const needed = audio_decoder_mem_size(&params);
+
+	if (needed > sizeof(decoder_mem)) {
+		LOG_ERR("CONFIG_ALIF_BLE_AUDIO_DECODER_MEM_SIZE must be at least %u for %u Hz",
+			needed, params.sampling_rate_hz);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+/* After the LC3 codec is initialised */
+SYS_INIT(audio_decoder_check_static_mem, APPLICATION, 1);
+#endif
+
 struct audio_decoder *audio_decoder_create(struct audio_decoder_params const *const params)
 {
 	struct audio_decoder *dec;
+	struct codec_mem mem;
+	lc3_cfg_t lc3_cfg;
 	int ret;
 
 	if (!params || !params->i2s_dev) {
@@ -429,13 +922,41 @@ struct audio_decoder *audio_decoder_create(struct audio_decoder_params const *co
 		return NULL;
 	}
 
-	dec = calloc(1, sizeof(*dec));
+	/* Configure LC3 codec first, the memory it needs depends on the configuration */
+	ret = configure_lc3(&lc3_cfg, params);
+	if (ret) {
+		LOG_ERR("Failed to configure LC3 codec, err %d", ret);
+		return NULL;
+	}
+
+	size_t const mem_size = required_mem_size(&lc3_cfg);
+	void *region = params->mem;
+	size_t region_size = params->mem_size;
 
-	if (!dec) {
+#if CONFIG_ALIF_BLE_AUDIO_CODEC_STATIC_MEM
+	if (!region) {
+		region = decoder_mem;
+		region_size = sizeof(decoder_mem);
+	}
+#endif
+	if (!region) {
+		region_size = mem_size;
+	} else if (region_size < mem_size) {
+		LOG_ERR("Decoder needs %u bytes of memory, only %u available", mem_size,
+			region_size);
+		return NULL;
+	}
+
+	if (codec_mem_init(&mem, region, region_size)) {
 		LOG_ERR("Failed to allocate audio decoder");
 		return NULL;
 	}
 
+	/* Cannot fail, the region was checked to be large enough for everything */
+	dec = codec_mem_alloc(&mem, sizeof(*dec));
+	dec->mem = mem;
+	dec->lc3_cfg = lc3_cfg;
+
 	size_t iter = params->num_queues;
 
 	while (iter--) {
@@ -457,55 +978,38 @@ struct audio_decoder *audio_decoder_create(struct audio_decoder_params const *co
 					      params->frame_duration_us);
 
 	if (!dec->audio_queue) {
-		free(dec);
+		codec_mem_release(dec->mem);
 		LOG_ERR("Failed to create audio queue");
 		return NULL;
 	}
 
-	ret = audio_sink_i2s_configure(params->i2s_dev, dec->audio_queue);
+#if CONFIG_ALIF_BLE_AUDIO_ADAPTIVE_QUEUE_DEPTH
+	/* The margin is only used when the link needs it, otherwise the queue is limited to what
+	 * the presentation delay alone requires. The blocks stay allocated, the limit shows how
+	 * much of the margin the link actually needs.
+	 */
+	audio_queue_depth_init(&dec->queue_depth, params->frame_duration_us,
+			       CONFIG_ALIF_BLE_AUDIO_ADAPTIVE_QUEUE_WINDOW,
+			       1 + pres_delay_us / params->frame_duration_us, audio_queue_len_blocks);
+#endif
+
+	ret = audio_sink_i2s_configure(params->i2s_dev, dec->audio_queue, params->pres_delay_us);
 	if (ret != 0) {
 		LOG_ERR("Failed to configure audio sink I2S, err %d", ret);
 		audio_decoder_delete(dec);
 		return NULL;
 	}
 
-	uint32_t const lc3_duration =
-		params->frame_duration_us == 10000 ? FRAME_DURATION_10_MS : FRAME_DURATION_7_5_MS;
-
-	/* Configure LC3 codec and allocate required memory */
-	ret = lc3_api_configure(&dec->lc3_cfg, params->sampling_rate_hz, lc3_duration);
-
-	if (ret) {
-		LOG_ERR("Failed to configure LC3 codec, err %d", ret);
-		audio_decoder_delete(dec);
-		return NULL;
-	}
-
-	dec->lc3_scratch = malloc(lc3_api_decoder_scratch_size(&dec->lc3_cfg));
-	if (!dec->lc3_scratch) {
-		LOG_ERR("Failed to allocate decoder scratch memory");
-		audio_decoder_delete(dec);
-		return NULL;
-	}
+	dec->lc3_scratch = codec_mem_alloc(&dec->mem, lc3_api_decoder_scratch_size(&dec->lc3_cfg));
 
 	size_t const status_size = lc3_api_decoder_status_size(&dec->lc3_cfg);
 	lc3_decoder_t *lc3_decoder;
 	void *lc3_status;
 
 	for (int i = 0; i < ARRAY_SIZE(dec->channel); i++) {
-		dec->channel[i].lc3_decoder = lc3_decoder = malloc(sizeof(*lc3_decoder));
-		if (!lc3_decoder) {
-			LOG_ERR("Failed to allocate LC3 decoder");
-			audio_decoder_delete(dec);
-			return NULL;
-		}
-
-		dec->channel[i].lc3_status = lc3_status = malloc(status_size);
-		if (!lc3_status) {
-			LOG_ERR("Failed to allocate LC3 status memory");
-			audio_decoder_delete(dec);
-			return NULL;
-		}
+		dec->channel[i].lc3_decoder = lc3_decoder =
+			codec_mem_alloc(&dec->mem, sizeof(*lc3_decoder));
+		dec->channel[i].lc3_status = lc3_status = codec_mem_alloc(&dec->mem, status_size);
 
 		ret = lc3_api_initialise_decoder(&dec->lc3_cfg, lc3_decoder, lc3_status);
 		if (ret) {
@@ -550,8 +1054,20 @@ int audio_decoder_add_channel(struct audio_decoder *const decoder, size_t const
 		return ch_index;
 	}
 
-	decoder->channel[ch_index].stream_id = stream_id;
-	decoder->channel[ch_index].enabled = false;
+	struct channel_data *const channel = &decoder->channel[ch_index];
+
+	channel->stream_id = stream_id;
+	channel->enabled = false;
+	channel->frames = 0;
+	channel->bad_frames = 0;
+	channel->cycles_last = 0;
+	channel->cycles_max = 0;
+	channel->cycles_total = 0;
+#if CONFIG_ALIF_BLE_AUDIO_DECODER_MIXER
+	for (size_t out = 0; out < ARRAY_SIZE(channel->gain); out++) {
+		channel->gain[out] = AUDIO_DECODER_GAIN_UNITY;
+	}
+#endif
 
 	struct sdu_queue *queue = decoder->channel[ch_index].sdu_queue;
 	struct iso_datapath_ctoh *iso_dp = decoder->channel[ch_index].iso_dp;
@@ -621,6 +1137,84 @@ int audio_decoder_stop_channel(struct audio_decoder *const decoder, size_t const
 	return 0;
 }
 
+struct audio_queue *audio_decoder_audio_queue_get(struct audio_decoder *const decoder)
+{
+	if (!decoder) {
+		return NULL;
+	}
+
+	return decoder->audio_queue;
+}
+
+struct sdu_queue *audio_decoder_sdu_queue_get(struct audio_decoder *const decoder,
+					      uint32_t const stream_id)
+{
+	if (!decoder) {
+		return NULL;
+	}
+
+	int const ch_index = get_channel_index(decoder, stream_id);
+
+	return ch_index < 0 ? NULL : decoder->channel[ch_index].sdu_queue;
+}
+
+#if CONFIG_ALIF_BLE_AUDIO_DECODER_MIXER
+int audio_decoder_set_channel_gain(struct audio_decoder *const decoder, uint32_t const stream_id,
+				   uint32_t const gain_left, uint32_t const gain_right)
+{
+	if (!decoder || gain_left > AUDIO_DECODER_GAIN_MAX || gain_right > AUDIO_DECODER_GAIN_MAX) {
+		return -EINVAL;
+	}
+
+	int const ch_index = get_channel_index(decoder, stream_id);
+
+	if (ch_index < 0) {
+		return ch_index;
+	}
+
+	/* Each gain is a single word, so the decoder thread sees either the old or the new value */
+	decoder->channel[ch_index].gain[0] = gain_left;
+	decoder->channel[ch_index].gain[1] = gain_right;
+
+	return 0;
+}
+#endif
+
+int audio_decoder_get_channel_stats(struct audio_decoder *const decoder, uint32_t const stream_id,
+				    struct audio_decoder_stream_stats *const stats, bool const clear)
+{
+	if (!decoder || !stats) {
+		return -EINVAL;
+	}
+
+	int const ch_index = get_channel_index(decoder, stream_id);
+
+	if (ch_index < 0) {
+		return ch_index;
+	}
+
+	struct channel_data *const channel = &decoder->channel[ch_index];
+	uint32_t const frames = channel->frames;
+
+	stats->frames = frames;
+	stats->bad_frames = channel->bad_frames;
+	stats->cycles_last = channel->cycles_last;
+	stats->cycles_max = channel->cycles_max;
+	stats->cycles_avg = frames ? (uint32_t)(channel->cycles_total / frames) : 0;
+	stats->frame_budget_cycles = (uint32_t)(((uint64_t)sys_clock_hw_cycles_per_sec() *
+						 decoder->audio_queue->frame_duration_us) /
+						USEC_PER_SEC);
+
+	if (clear) {
+		channel->frames = 0;
+		channel->bad_frames = 0;
+		channel->cycles_max = 0;
+		channel->cycles_total = 0;
+	}
+
+	return 0;
+}
+
 int audio_decoder_register_cb(struct audio_decoder *const decoder, audio_decoder_sdu_cb_t const cb,
 			      void *const context)
 {
@@ -628,7 +1222,8 @@ int audio_decoder_register_cb(struct audio_decoder *const decoder, audio_decoder
 		return -EINVAL;
 	}
 
-	struct cb_list *cb_item = malloc(sizeof(*cb_item));
+	/* Space for DECODER_MAX_CALLBACKS is left in the codec memory */
+	struct cb_list *cb_item = codec_mem_alloc(&decoder->mem, sizeof(*cb_item));
 
 	if (!cb_item) {
 		return -ENOMEM;
@@ -659,25 +1254,14 @@ int audio_decoder_delete(struct audio_decoder *decoder)
 	k_thread_join(&decoder->thread, K_FOREVER);
 
 	for (int i = 0; i < ARRAY_SIZE(decoder->channel); i++) {
-		free(decoder->channel[i].lc3_decoder);
-		free(decoder->channel[i].lc3_status);
 		iso_datapath_ctoh_delete(decoder->channel[i].iso_dp);
 		sdu_queue_delete(decoder->channel[i].sdu_queue);
 	}
 
-	free(decoder->lc3_scratch);
-
-	/* Free linked list of callbacks */
-	while (decoder->cb_list) {
-		struct cb_list *tmp = decoder->cb_list;
-
-		decoder->cb_list = tmp->next;
-		free(tmp);
-	}
-
 	audio_queue_delete(decoder->audio_queue);
 
-	free(decoder);
+	/* Codec state and callbacks were all allocated from the codec memory */
+	codec_mem_release(decoder->mem);
 
 	/* allow OFF state when decoder is deleted */
 	pm_policy_state_lock_put(PM_STATE_SUSPEND_TO_RAM, PM_ALL_SUBSTATES);
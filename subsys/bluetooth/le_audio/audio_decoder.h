@@ -15,7 +15,44 @@
 #include "audio_queue.h"
 #include "sdu_queue.h"
 
+/** Unity gain of a stream mixed by the decoder, gains are Q15 fixed point */
+#define AUDIO_DECODER_GAIN_UNITY (1 << 15)
+/** Maximum gain of a stream mixed by the decoder */
+#define AUDIO_DECODER_GAIN_MAX   (2 * AUDIO_DECODER_GAIN_UNITY)
+
+/**
+ * Decoding statistics of a stream
+ *
+ * The number of streams of a given configuration that fit on the core running the decoder can be
+ * estimated as frame_budget_cycles / cycles_avg, leaving some headroom for the rest of the system.
+ */
+struct audio_decoder_stream_stats {
+	/** Frames decoded */
+	uint32_t frames;
+	/** Frames received in error and concealed by the codec */
+	uint32_t bad_frames;
+	/** Cycles spent decoding and mixing the most recent frame */
+	uint32_t cycles_last;
+	/** Largest number of cycles spent on a frame */
+	uint32_t cycles_max;
+	/** Average number of cycles spent on a frame */
+	uint32_t cycles_avg;
+	/** Cycles available in each frame interval */
+	uint32_t frame_budget_cycles;
+};
+
+#if CONFIG_ALIF_BLE_AUDIO_CODEC_STATIC_MEM
+/** Size of the static region holding the decoder state when no region is provided */
+#define AUDIO_DECODER_MEM_SIZE CONFIG_ALIF_BLE_AUDIO_DECODER_MEM_SIZE
+#endif
+
 struct audio_decoder_params {
+	/** Region to hold the decoder state, or NULL to use the static region if
+	 * CONFIG_ALIF_BLE_AUDIO_CODEC_STATIC_MEM is enabled, or the heap otherwise
+	 */
+	void *mem;
+	/** Size of the region, at least audio_decoder_mem_size() bytes */
+	size_t mem_size;
 	const struct device *i2s_dev;
 	uint32_t pres_delay_us;
 	uint32_t frame_duration_us;
@@ -33,12 +70,27 @@ struct audio_decoder_params {
  */
 typedef void (*audio_decoder_sdu_cb_t)(void *context, uint32_t timestamp, uint16_t sdu_seq);
 
+/**
+ * @brief Get the size of the memory region needed by an audio decoder
+ *
+ * The region holds the decoder instance, the LC3 decoder state and scratch memory, and the
+ * registered callbacks. It does not hold the SDU and audio queues.
+ *
+ * @param params Audio decoder configuration parameters
+ *
+ * @retval Size of the region in bytes
+ * @retval 0 if the parameters are invalid
+ */
+size_t audio_decoder_mem_size(struct audio_decoder_params const *params);
+
 /**
  * @brief Create and start an audio decoder instance
  *
  * The audio decoder instance waits on SDUs to be available in the provided SDU queue(s). When an
  * SDU is available, it is decoded using the LC3 codec and pushed into the provided audio queue.
- * Either single or dual channel decoding is supported.
+ * Either single or dual channel decoding is supported. With CONFIG_ALIF_BLE_AUDIO_DECODER_MIXER
+ * up to CONFIG_ALIF_BLE_AUDIO_DECODER_MAX_STREAMS streams are decoded and mixed into a stereo
+ * output instead.
  *
  * @note The stack for the decoder thread is currently passed in as a parameter since at the time of
  * writing, the targeted Zephyr version does not support dynamically allocating thread stacks. It
@@ -55,6 +107,27 @@ typedef void (*audio_decoder_sdu_cb_t)(void *context, uint32_t timestamp, uint16
  */
 struct audio_decoder *audio_decoder_create(struct audio_decoder_params const *params);
 
+/**
+ * @brief Get the audio queue of the audio decoder
+ *
+ * @param decoder Audio decoder instance
+ *
+ * @retval Audio queue if successful
+ * @retval NULL on failure
+ */
+struct audio_queue *audio_decoder_audio_queue_get(struct audio_decoder *decoder);
+
+/**
+ * @brief Get the SDU queue of a channel of the audio decoder
+ *
+ * @param decoder Audio decoder instance
+ * @param stream_id Stream ID of the channel
+ *
+ * @retval SDU queue if successful
+ * @retval NULL if the channel does not exist
+ */
+struct sdu_queue *audio_decoder_sdu_queue_get(struct audio_decoder *decoder, uint32_t stream_id);
+
 /**
  * @brief Add a channel to the decoder
  *
@@ -90,6 +163,41 @@ int audio_decoder_start_channel(struct audio_decoder *decoder, uint32_t stream_i
  */
 int audio_decoder_stop_channel(struct audio_decoder *decoder, uint32_t stream_id);
 
+#if CONFIG_ALIF_BLE_AUDIO_DECODER_MIXER
+/**
+ * @brief Set the gain of a stream in the stereo mix
+ *
+ * Streams are added to the mix with unity gain on both output channels. The mix is saturated, so
+ * gains should be reduced when many loud streams are mixed.
+ *
+ * @param decoder Audio decoder instance
+ * @param stream_id Stream ID of the channel
+ * @param gain_left Gain into the left output channel, Q15 up to AUDIO_DECODER_GAIN_MAX
+ * @param gain_right Gain into the right output channel, Q15 up to AUDIO_DECODER_GAIN_MAX
+ *
+ * @retval 0 if successful
+ * @retval -EINVAL if the channel does not exist or a gain is out of range
+ */
+int audio_decoder_set_channel_gain(struct audio_decoder *decoder, uint32_t stream_id,
+				   uint32_t gain_left, uint32_t gain_right);
+#endif
+
+/**
+ * @brief Get the decoding statistics of a channel
+ *
+ * The statistics are updated by the decoder thread, and may be read while the decoder is running.
+ *
+ * @param decoder Audio decoder instance
+ * @param stream_id Stream ID of the channel
+ * @param stats Statistics of the channel
+ * @param clear Reset the statistics after reading them
+ *
+ * @retval 0 if successful
+ * @retval -EINVAL if the channel does not exist
+ */
+int audio_decoder_get_channel_stats(struct audio_decoder *decoder, uint32_t stream_id,
+				    struct audio_decoder_stream_stats *stats, bool clear);
+
 /**
  * @brief Register a callback to be called on completion of each decoded frame
  *
@@ -97,7 +205,8 @@ int audio_decoder_stop_channel(struct audio_decoder *decoder, uint32_t stream_id
  * @param cb Callback function
  *
  * @retval 0 if successful
- * @retval Negative error code on failure
+ * @retval -ENOMEM if four callbacks are already registered
+ * @retval Negative error code on other failures
  */
 int audio_decoder_register_cb(struct audio_decoder *decoder, audio_decoder_sdu_cb_t cb,
 			      void *context);
@@ -14,7 +14,6 @@
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/pm/pm.h>
 #include <zephyr/pm/policy.h>
-#include <stdlib.h>
 
 #include "alif_lc3.h"
 #include "gapi_isooshm.h"
@@ -23,6 +22,8 @@
 #include "bluetooth/le_audio/audio_source_pdm.h"
 #include "bluetooth/le_audio/iso_datapath_htoc.h"
 #include "bluetooth/le_audio/audio_encoder.h"
+#include "codec_mem.h"
+#include "datapath_trace.h"
 
 #if CONFIG_ALIF_BLE_AUDIO_USE_RAMFUNC
 #define INT_RAMFUNC __ramfunc
@@ -33,6 +34,9 @@
 #define AUDIO_QUEUE_MARGIN_US     (CONFIG_ALIF_BLE_AUDIO_PRESENTATION_DELAY_QUEUE_MARGIN * 1000)
 #define MIN_PRESENTATION_DELAY_US (CONFIG_ALIF_BLE_AUDIO_MIN_PRESENTATION_DELAY_MS * 1000)
 
+/* Callbacks which can be registered, space for them is reserved in the codec memory */
+#define ENCODER_MAX_CALLBACKS 4
+
 LOG_MODULE_REGISTER(audio_encoder, CONFIG_BLE_AUDIO_LOG_LEVEL);
 
 #define GPIO_TEST0_NODE DT_ALIAS(encoder_test0)
@@ -120,9 +124,21 @@ struct channel_data {
 	lc3_encoder_t *lc3_encoder;
 	uint32_t stream_id;
 	bool enabled;
+	/* Backpressure handling, whether AUDIO_ENCODER_BACKPRESSURE_SKIP has paused encoding, and
+	 * whether the current SDU took the block AUDIO_ENCODER_BACKPRESSURE_DROP_OLDEST keeps in
+	 * reserve. The counters are cleared by audio_encoder_get_channel_stats from other threads.
+	 */
+	enum audio_encoder_backpressure policy;
+	bool paused;
+	bool reserve_used;
+	atomic_t encoded;
+	atomic_t dropped;
+	atomic_t skipped;
 };
 
 struct audio_encoder {
+	/* Region holding the encoder and all its codec state */
+	struct codec_mem mem;
 	volatile bool thread_abort;
 	struct audio_queue *audio_queue;
 	struct channel_data channel[CONFIG_ALIF_BLE_AUDIO_NMB_CHANNELS];
@@ -131,6 +147,8 @@ struct audio_encoder {
 	int32_t *lc3_scratch;
 	/* Linked list of registered callbacks */
 	struct cb_list *cb_list;
+	audio_encoder_backpressure_cb_t backpressure_cb;
+	void *backpressure_context;
 	/* Encoder thread */
 	struct k_thread thread;
 	k_tid_t tid;
@@ -140,6 +158,12 @@ struct audio_encoder {
 
 K_THREAD_STACK_DEFINE(encoder_stack, CONFIG_LC3_ENCODER_STACK_SIZE);
 
+#if CONFIG_ALIF_BLE_AUDIO_CODEC_STATIC_MEM
+/* Only one encoder can exist at a time, as it shares the thread stack */
+static uint8_t __attribute__((section(CONFIG_ALIF_BLE_AUDIO_CODEC_MEM_SECTION)))
+	encoder_mem[AUDIO_ENCODER_MEM_SIZE] __aligned(CODEC_MEM_ALIGN);
+#endif
+
 static int alloc_channel_index(struct audio_encoder const *const encoder)
 {
 	for (size_t iter = 0; iter < ARRAY_SIZE(encoder->channel); iter++) {
@@ -161,6 +185,71 @@ static int get_channel_index(struct audio_encoder const *const encoder, uint32_t
 	return -EINVAL;
 }
 
+/* Decide whether the next frame of a channel can be encoded, and apply the backpressure policy of
+ * the channel if not. Returns the SDU to encode into, or NULL if the frame is not to be encoded.
+ *
+ * AUDIO_ENCODER_BACKPRESSURE_DROP_OLDEST keeps the last block of the SDU queue in reserve. When the
+ * rest of the queue is full the new frame is encoded into the reserve block, and once it has been
+ * committed the ISO datapath is asked to drop the oldest queued SDU, which frees the reserve again.
+ */
+INT_RAMFUNC static gapi_isooshm_sdu_buf_t *acquire_sdu(struct audio_encoder *const enc,
+							struct channel_data *const p_channel,
+							uint16_t const sdu_seq)
+{
+	struct sdu_queue *const p_sdu_queue = p_channel->sdu_queue;
+	struct block_ring *const p_ring = &p_sdu_queue->ring;
+	bool const drop_oldest = p_channel->policy == AUDIO_ENCODER_BACKPRESSURE_DROP_OLDEST;
+	gapi_isooshm_sdu_buf_t *p_sdu = NULL;
+
+	p_channel->reserve_used = false;
+	block_ring_set_limit(p_ring, p_sdu_queue->item_count - (drop_oldest ? 1 : 0));
+
+	if (p_channel->policy == AUDIO_ENCODER_BACKPRESSURE_SKIP) {
+		/* Hysteresis so that a stream which keeps up only intermittently is paused for a
+		 * run of frames rather than every other frame
+		 */
+		uint32_t const used = block_ring_num_used(p_ring);
+
+		if (p_channel->paused) {
+			p_channel->paused = used > p_sdu_queue->item_count / 4;
+		} else {
+			p_channel->paused = used >= (p_sdu_queue->item_count * 3) / 4;
+		}
+	}
+
+	if (!p_channel->paused) {
+		p_sdu = block_ring_acquire(p_ring, K_NO_WAIT);
+	}
+
+	if (!p_sdu && drop_oldest) {
+		block_ring_set_limit(p_ring, p_sdu_queue->item_count);
+		p_sdu = block_ring_acquire(p_ring, K_NO_WAIT);
+		p_channel->reserve_used = !!p_sdu;
+	}
+
+	if (p_sdu) {
+		return p_sdu;
+	}
+
+	/* The reserve block of AUDIO_ENCODER_BACKPRESSURE_DROP_OLDEST is also in use if the ISO
+	 * datapath has not yet dropped the oldest SDU for the previous frame, so this frame is
+	 * dropped instead
+	 */
+	if (p_channel->paused) {
+		atomic_inc(&p_channel->skipped);
+	} else {
+		LOG_DBG("SDU queue of stream %u is full", p_channel->stream_id);
+		atomic_inc(&p_channel->dropped);
+	}
+
+	if (enc->backpressure_cb) {
+		enc->backpressure_cb(enc->backpressure_context, p_channel->stream_id,
+				     p_channel->policy, sdu_seq);
+	}
+
+	return NULL;
+}
+
 INT_RAMFUNC static void audio_encoder_thread_func(void *p1, void *p2, void *p3)
 {
 	struct audio_encoder *enc = (struct audio_encoder *)p1;
@@ -173,8 +262,7 @@ INT_RAMFUNC static void audio_encoder_thread_func(void *p1, void *p2, void *p3)
 	size_t iter;
 	gapi_isooshm_sdu_buf_t *p_sdu;
 	struct sdu_queue *p_sdu_queue;
-	struct k_mem_slab *const p_audio_queue_slab = &enc->audio_queue->slab;
-	struct k_msgq *const p_audio_msg_queue = &enc->audio_queue->msgq;
+	struct block_ring *const p_audio_ring = &enc->audio_queue->ring;
 	struct audio_block *audio;
 	/* Sequence number applied to each outging SDU clipped to uint16_t */
 	size_t sdu_seq = 0;
@@ -189,19 +277,13 @@ INT_RAMFUNC static void audio_encoder_thread_func(void *p1, void *p2, void *p3)
 	while (!enc->thread_abort) {
 
 		/* Get the next audio block */
-		audio = NULL;
-		ret = k_msgq_get(p_audio_msg_queue, &audio, K_FOREVER);
-		if (ret) {
-			k_sleep(K_MSEC(2));
-			LOG_ERR("Failed to get audio block");
-			continue;
-		}
+		audio = block_ring_get(p_audio_ring, K_FOREVER);
 
 #if DT_NODE_EXISTS(GPIO_TEST1_NODE)
 		set_test_pin(&test_pin1, 1);
 #endif
 
-		/* A NULL audio block can be sent to the queue to wake up and abort thread. Continue
+		/* The wait returns without a block when the thread is woken up to abort. Continue
 		 * and check thread abort flag.
 		 */
 		if (!audio) {
@@ -228,24 +310,29 @@ INT_RAMFUNC static void audio_encoder_thread_func(void *p1, void *p2, void *p3)
 			}
 			size_t const sdu_len = p_sdu_queue->payload_size;
 
-			/* Allocate SDU and encode audio into it */
-			ret = k_mem_slab_alloc(&p_sdu_queue->slab, (void *)&p_sdu, K_NO_WAIT);
-			if (ret || !p_sdu) {
-				LOG_WRN("SDU queue %u is full", iter);
+			/* Acquire SDU and encode audio into it. A frame which cannot be queued is
+			 * not encoded at all.
+			 */
+			p_sdu = acquire_sdu(enc, p_channel, sdu_seq);
+			if (!p_sdu) {
 				continue;
 			}
 
 #if DT_NODE_EXISTS(GPIO_TEST0_NODE)
 			set_test_pin(&test_pin0, 1);
 #endif
+			datapath_trace_record(DATAPATH_TRACE_ENCODE_START, p_channel->stream_id,
+					      sdu_seq);
 			ret = lc3_api_encode_frame(&enc->lc3_cfg, p_channel->lc3_encoder,
 						   audio->channels[iter], p_sdu->data, sdu_len,
 						   enc->lc3_scratch);
+			datapath_trace_record(DATAPATH_TRACE_ENCODE_END, p_channel->stream_id,
+					      sdu_seq);
 #if DT_NODE_EXISTS(GPIO_TEST0_NODE)
 			set_test_pin(&test_pin0, 0);
 #endif
 			if (ret) {
-				k_mem_slab_free(&p_sdu_queue->slab, p_sdu);
+				block_ring_cancel(&p_sdu_queue->ring, p_sdu);
 				LOG_ERR("LC3 encoding failed, err %d", ret);
 				continue;
 			}
@@ -255,11 +342,13 @@ INT_RAMFUNC static void audio_encoder_thread_func(void *p1, void *p2, void *p3)
 			p_sdu->has_timestamp = !!capture_timestamp;
 			p_sdu->timestamp = capture_timestamp;
 
-			ret = k_msgq_put(&p_sdu_queue->msgq, &p_sdu, K_FOREVER);
-			if (ret) {
-				k_mem_slab_free(&p_sdu_queue->slab, p_sdu);
-				LOG_ERR("Failed to put SDU to msgq, err %d", ret);
-				continue;
+			/* Space was reserved when the SDU was acquired, so this cannot block */
+			block_ring_commit(&p_sdu_queue->ring, p_sdu);
+			atomic_inc(&p_channel->encoded);
+
+			/* Only now that the new SDU is queued may the oldest be dropped for it */
+			if (p_channel->reserve_used) {
+				atomic_inc(&p_sdu_queue->flush_request);
 			}
 
 			/* Notify datapath that SDUs are completed. This also triggers next read
@@ -271,7 +360,7 @@ INT_RAMFUNC static void audio_encoder_thread_func(void *p1, void *p2, void *p3)
 			}
 		}
 
-		k_mem_slab_free(p_audio_queue_slab, audio);
+		block_ring_release(p_audio_ring, audio);
 
 		/* Notify listeners that a block is completed */
 		struct cb_list *cb_item = enc->cb_list;
@@ -290,10 +379,72 @@ INT_RAMFUNC static void audio_encoder_thread_func(void *p1, void *p2, void *p3)
 	}
 }
 
+static int configure_lc3(lc3_cfg_t *const lc3_cfg, struct audio_encoder_params const *const params)
+{
+	uint32_t const lc3_duration =
+		params->frame_duration_us == 10000 ? FRAME_DURATION_10_MS : FRAME_DURATION_7_5_MS;
+
+	return lc3_api_configure(lc3_cfg, params->sampling_rate_hz, lc3_duration);
+}
+
+/* Memory needed whatever the LC3 configuration, allowing for aligning the start of a caller
+ * provided region
+ */
+#define ENCODER_FIXED_MEM_SIZE                                                                     \
+	(CODEC_MEM_ALIGN + CODEC_MEM_SIZEOF(sizeof(struct audio_encoder)) +                        \
+	 CONFIG_ALIF_BLE_AUDIO_NMB_CHANNELS * CODEC_MEM_SIZEOF(sizeof(lc3_encoder_t)) +            \
+	 ENCODER_MAX_CALLBACKS * CODEC_MEM_SIZEOF(sizeof(struct cb_list)))
+
+static size_t required_mem_size(lc3_cfg_t const *const lc3_cfg)
+{
+	return ENCODER_FIXED_MEM_SIZE + CODEC_MEM_SIZEOF(lc3_api_encoder_scratch_size(lc3_cfg));
+}
+
+size_t audio_encoder_mem_size(struct audio_encoder_params const *const params)
+{
+	lc3_cfg_t lc3_cfg;
+
+	if (!params || configure_lc3(&lc3_cfg, params)) {
+		return 0;
+	}
+
+	return required_mem_size(&lc3_cfg);
+}
+
+#if CONFIG_ALIF_BLE_AUDIO_CODEC_STATIC_MEM
+/* The LC3 scratch size is only known from the codec library at run time, so the rest of the
+ * static memory is checked at build time and the total for the configured stream at boot
+ */
+BUILD_ASSERT(AUDIO_ENCODER_MEM_SIZE >= ENCODER_FIXED_MEM_SIZE,
+	     "CONFIG_ALIF_BLE_AUDIO_ENCODER_MEM_SIZE is too small for the encoder state");
+
+static int audio_encoder_check_static_mem(void)
+{
+	struct audio_encoder_params const params = {
+		.frame_duration_us =
+			IS_ENABLED(CONFIG_ALIF_BLE_AUDIO_FRAME_DURATION_10MS) ? 10000 : 7500,
+		.sampling_rate_hz = CONFIG_ALIF_BLE_AUDIO_FS_HZ,
+	};
+	size_t const needed = audio_encoder_mem_size(&params);
+
+	if (needed > sizeof(encoder_mem)) {
+		LOG_ERR("CONFIG_ALIF_BLE_AUDIO_ENCODER_MEM_SIZE must be at least %u for %u Hz",
+			needed, params.sampling_rate_hz);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+/* After the LC3 codec is initialised */
+SYS_INIT(audio_encoder_check_static_mem, APPLICATION, 1);
+#endif
+
 struct audio_encoder *audio_encoder_create(struct audio_encoder_params const *params)
 {
 	int ret;
 	struct audio_encoder *enc;
+	struct codec_mem mem;
+	lc3_cfg_t lc3_cfg;
 
 	if (!params) {
 		LOG_ERR("Audio encoder parameters must be provided");
@@ -305,13 +456,41 @@ struct audio_encoder *audio_encoder_create(struct audio_encoder_params const *pa
 		return NULL;
 	}
 
-	enc = calloc(1, sizeof(*enc));
+	/* Configure LC3 codec first, the memory it needs depends on the configuration */
+	ret = configure_lc3(&lc3_cfg, params);
+	if (ret) {
+		LOG_ERR("Failed to configure LC3 codec, err %d", ret);
+		return NULL;
+	}
+
+	size_t const mem_size = required_mem_size(&lc3_cfg);
+	void *region = params->mem;
+	size_t region_size = params->mem_size;
 
-	if (!enc) {
+#if CONFIG_ALIF_BLE_AUDIO_CODEC_STATIC_MEM
+	if (!region) {
+		region = encoder_mem;
+		region_size = sizeof(encoder_mem);
+	}
+#endif
+	if (!region) {
+		region_size = mem_size;
+	} else if (region_size < mem_size) {
+		LOG_ERR("Encoder needs %u bytes of memory, only %u available", mem_size,
+			region_size);
+		return NULL;
+	}
+
+	if (codec_mem_init(&mem, region, region_size)) {
 		LOG_ERR("Failed to allocate audio encoder");
 		return NULL;
 	}
 
+	/* Cannot fail, the region was checked to be large enough for everything */
+	enc = codec_mem_alloc(&mem, sizeof(*enc));
+	enc->mem = mem;
+	enc->lc3_cfg = lc3_cfg;
+
 	for (size_t iter = 0; iter < ARRAY_SIZE(enc->channel); iter++) {
 		enc->channel[iter].stream_id = UINT32_MAX;
 	}
@@ -331,7 +510,7 @@ struct audio_encoder *audio_encoder_create(struct audio_encoder_params const *pa
 					      params->frame_duration_us);
 
 	if (!enc->audio_queue) {
-		free(enc);
+		codec_mem_release(enc->mem);
 		LOG_ERR("Failed to create audio queue");
 		return NULL;
 	}
@@ -361,34 +540,13 @@ struct audio_encoder *audio_encoder_create(struct audio_encoder_params const *pa
 		return NULL;
 	}
 
-	uint32_t const lc3_duration =
-		params->frame_duration_us == 10000 ? FRAME_DURATION_10_MS : FRAME_DURATION_7_5_MS;
-
-	/* Configure LC3 codec and allocate required memory */
-	ret = lc3_api_configure(&enc->lc3_cfg, params->sampling_rate_hz, lc3_duration);
-	if (ret) {
-		LOG_ERR("Failed to configure LC3 codec, err %d", ret);
-		audio_encoder_delete(enc);
-		return NULL;
-	}
-
-	enc->lc3_scratch = malloc(lc3_api_encoder_scratch_size(&enc->lc3_cfg));
-	if (!enc->lc3_scratch) {
-		LOG_ERR("Failed to allocate encoder scratch memory");
-		audio_encoder_delete(enc);
-		return NULL;
-	}
+	enc->lc3_scratch = codec_mem_alloc(&enc->mem, lc3_api_encoder_scratch_size(&enc->lc3_cfg));
 
 	for (int i = 0; i < ARRAY_SIZE(enc->channel); i++) {
 		lc3_encoder_t *lc3_encoder;
 
-		enc->channel[i].lc3_encoder = lc3_encoder = malloc(sizeof(*lc3_encoder));
-
-		if (!lc3_encoder) {
-			LOG_ERR("Failed to allocate LC3 encoder");
-			audio_encoder_delete(enc);
-			return NULL;
-		}
+		enc->channel[i].lc3_encoder = lc3_encoder =
+			codec_mem_alloc(&enc->mem, sizeof(*lc3_encoder));
 
 		ret = lc3_api_initialise_encoder(&enc->lc3_cfg, lc3_encoder);
 		if (ret) {
@@ -425,6 +583,18 @@ struct audio_queue *audio_encoder_audio_queue_get(struct audio_encoder *encoder)
 	return encoder->audio_queue;
 }
 
+struct sdu_queue *audio_encoder_sdu_queue_get(struct audio_encoder *const encoder,
+					      uint32_t const stream_id)
+{
+	if (!encoder) {
+		return NULL;
+	}
+
+	int const ch_index = get_channel_index(encoder, stream_id);
+
+	return ch_index < 0 ? NULL : encoder->channel[ch_index].sdu_queue;
+}
+
 int audio_encoder_add_channel(struct audio_encoder *const encoder, size_t const octets_per_frame,
 			      uint32_t const stream_id)
 {
@@ -443,6 +613,12 @@ int audio_encoder_add_channel(struct audio_encoder *const encoder, size_t const
 
 	encoder->channel[ch_index].enabled = false;
 	encoder->channel[ch_index].stream_id = stream_id;
+	encoder->channel[ch_index].policy = AUDIO_ENCODER_BACKPRESSURE_DROP_NEWEST;
+	encoder->channel[ch_index].paused = false;
+	encoder->channel[ch_index].reserve_used = false;
+	atomic_set(&encoder->channel[ch_index].encoded, 0);
+	atomic_set(&encoder->channel[ch_index].dropped, 0);
+	atomic_set(&encoder->channel[ch_index].skipped, 0);
 
 	struct sdu_queue *queue = encoder->channel[ch_index].sdu_queue;
 	struct iso_datapath_htoc *iso_dp = encoder->channel[ch_index].iso_dp;
@@ -544,7 +720,8 @@ int audio_encoder_register_cb(struct audio_encoder *const encoder, audio_encoder
 		return -EINVAL;
 	}
 
-	struct cb_list *cb_item = malloc(sizeof(*cb_item));
+	/* Space for ENCODER_MAX_CALLBACKS is left in the codec memory */
+	struct cb_list *cb_item = codec_mem_alloc(&encoder->mem, sizeof(*cb_item));
 
 	if (!cb_item) {
 		return -ENOMEM;
@@ -559,6 +736,75 @@ int audio_encoder_register_cb(struct audio_encoder *const encoder, audio_encoder
 	return 0;
 }
 
+int audio_encoder_set_backpressure_policy(struct audio_encoder *const encoder,
+					  uint32_t const stream_id,
+					  enum audio_encoder_backpressure const policy)
+{
+	if (!encoder || policy > AUDIO_ENCODER_BACKPRESSURE_SKIP) {
+		return -EINVAL;
+	}
+
+	int const ch_index = get_channel_index(encoder, stream_id);
+
+	if (ch_index < 0) {
+		return ch_index;
+	}
+
+	encoder->channel[ch_index].policy = policy;
+	encoder->channel[ch_index].paused = false;
+
+	return 0;
+}
+
+int audio_encoder_register_backpressure_cb(struct audio_encoder *const encoder,
+					   audio_encoder_backpressure_cb_t const cb,
+					   void *const context)
+{
+	if (!encoder) {
+		return -EINVAL;
+	}
+
+	/* Clear the callback first so the encoder thread never pairs it with a stale context */
+	encoder->backpressure_cb = NULL;
+	encoder->backpressure_context = context;
+	encoder->backpressure_cb = cb;
+
+	return 0;
+}
+
+int audio_encoder_get_channel_stats(struct audio_encoder *const encoder, uint32_t const stream_id,
+				    struct audio_encoder_stream_stats *const stats, bool const clear)
+{
+	if (!encoder || !stats) {
+		return -EINVAL;
+	}
+
+	int const ch_index = get_channel_index(encoder, stream_id);
+
+	if (ch_index < 0) {
+		return ch_index;
+	}
+
+	struct channel_data *const channel = &encoder->channel[ch_index];
+
+	if (clear) {
+		/* Read and clear each counter at once so that no frame counted meanwhile is lost */
+		stats->encoded = atomic_clear(&channel->encoded);
+		stats->dropped = atomic_clear(&channel->dropped);
+		stats->skipped = atomic_clear(&channel->skipped);
+		stats->flushed =
+			channel->sdu_queue ? atomic_clear(&channel->sdu_queue->flushed) : 0;
+	} else {
+		stats->encoded = atomic_get(&channel->encoded);
+		stats->dropped = atomic_get(&channel->dropped);
+		stats->skipped = atomic_get(&channel->skipped);
+		stats->flushed =
+			channel->sdu_queue ? atomic_get(&channel->sdu_queue->flushed) : 0;
+	}
+
+	return 0;
+}
+
 int audio_encoder_delete(struct audio_encoder *encoder)
 {
 	if (!encoder) {
@@ -571,9 +817,7 @@ int audio_encoder_delete(struct audio_encoder *encoder)
 
 	/* Signal to thread that it should abort */
 	encoder->thread_abort = true;
-	void *dummy_queue_item = NULL;
-
-	k_msgq_put(&encoder->audio_queue->msgq, &dummy_queue_item, K_FOREVER);
+	block_ring_wakeup(&encoder->audio_queue->ring);
 
 	/* Join thread before freeing anything */
 	k_thread_join(&encoder->thread, K_FOREVER);
@@ -581,22 +825,12 @@ int audio_encoder_delete(struct audio_encoder *encoder)
 	for (size_t iter = 0; iter < ARRAY_SIZE(encoder->channel); iter++) {
 		iso_datapath_htoc_delete(encoder->channel[iter].iso_dp);
 		sdu_queue_delete(encoder->channel[iter].sdu_queue);
-		free(encoder->channel[iter].lc3_encoder);
 	}
 
-	free(encoder->lc3_scratch);
-
 	audio_queue_delete(encoder->audio_queue);
 
-	/* Free linked list of callbacks */
-	while (encoder->cb_list) {
-		struct cb_list *tmp = encoder->cb_list;
-
-		encoder->cb_list = tmp->next;
-		free(tmp);
-	}
-
-	free(encoder);
+	/* Codec state and callbacks were all allocated from the codec memory */
+	codec_mem_release(encoder->mem);
 
 	/* allow OFF state when encoder is deleted */
 	pm_policy_state_lock_put(PM_STATE_SUSPEND_TO_RAM, PM_ALL_SUBSTATES);
@@ -15,7 +15,18 @@
 #include "bluetooth/le_audio/audio_queue.h"
 #include "bluetooth/le_audio/sdu_queue.h"
 
+#if CONFIG_ALIF_BLE_AUDIO_CODEC_STATIC_MEM
+/** Size of the static region holding the encoder state when no region is provided */
+#define AUDIO_ENCODER_MEM_SIZE CONFIG_ALIF_BLE_AUDIO_ENCODER_MEM_SIZE
+#endif
+
 struct audio_encoder_params {
+	/** Region to hold the encoder state, or NULL to use the static region if
+	 * CONFIG_ALIF_BLE_AUDIO_CODEC_STATIC_MEM is enabled, or the heap otherwise
+	 */
+	void *mem;
+	/** Size of the region, at least audio_encoder_mem_size() bytes */
+	size_t mem_size;
 	const struct device *i2s_dev;
 	const struct device *pdm_dev;
 	uint32_t audio_buffer_len_us;
@@ -25,6 +36,51 @@ struct audio_encoder_params {
 	struct sdu_queue *p_sdu_queues[];
 };
 
+/** Action taken when the SDU queue of a stream cannot accept the next frame */
+enum audio_encoder_backpressure {
+	/** Drop the new frame without encoding it, the queued SDUs are still sent */
+	AUDIO_ENCODER_BACKPRESSURE_DROP_NEWEST,
+	/** Encode the new frame, and have the ISO datapath discard the oldest queued SDU in its
+	 * place. The last block of the SDU queue is kept in reserve for this, so the new frame is
+	 * only dropped if the ISO datapath has not yet discarded an SDU for the previous one.
+	 */
+	AUDIO_ENCODER_BACKPRESSURE_DROP_OLDEST,
+	/** Stop encoding the stream once its SDU queue is three quarters full, and resume once it
+	 * has drained to a quarter full
+	 */
+	AUDIO_ENCODER_BACKPRESSURE_SKIP,
+};
+
+/** Backpressure counters of a stream */
+struct audio_encoder_stream_stats {
+	/** Frames encoded and queued */
+	uint32_t encoded;
+	/** Frames dropped without encoding because the SDU queue was full */
+	uint32_t dropped;
+	/** Frames not encoded while the stream was paused by AUDIO_ENCODER_BACKPRESSURE_SKIP */
+	uint32_t skipped;
+	/** Queued SDUs discarded by AUDIO_ENCODER_BACKPRESSURE_DROP_OLDEST to make room for newer
+	 * frames
+	 */
+	uint32_t flushed;
+};
+
+/**
+ * @brief Callback function signature for frames not encoded due to backpressure
+ *
+ * Called from the encoder thread for every frame of a stream which is dropped or skipped. Queued
+ * SDUs discarded by AUDIO_ENCODER_BACKPRESSURE_DROP_OLDEST are only counted in the stream's
+ * flushed counter.
+ *
+ * @param context User-defined context to be passed to callback
+ * @param stream_id Stream ID of the channel
+ * @param policy Backpressure policy of the stream
+ * @param sdu_seq Sequence number the SDU would have had
+ */
+typedef void (*audio_encoder_backpressure_cb_t)(void *context, uint32_t stream_id,
+						enum audio_encoder_backpressure policy,
+						uint16_t sdu_seq);
+
 /**
  * @brief Callback function signature for SDU completion
  *
@@ -34,6 +90,19 @@ struct audio_encoder_params {
  */
 typedef void (*audio_encoder_sdu_cb_t)(void *context, uint32_t capture_timestamp, uint16_t sdu_seq);
 
+/**
+ * @brief Get the size of the memory region needed by an audio encoder
+ *
+ * The region holds the encoder instance, the LC3 encoder state and scratch memory, and the
+ * registered callbacks. It does not hold the SDU and audio queues.
+ *
+ * @param params Audio encoder configuration parameters
+ *
+ * @retval Size of the region in bytes
+ * @retval 0 if the parameters are invalid
+ */
+size_t audio_encoder_mem_size(struct audio_encoder_params const *params);
+
 /**
  * @brief Create and start an audio encoder instance
  *
@@ -66,6 +135,17 @@ struct audio_encoder *audio_encoder_create(struct audio_encoder_params const *pa
  */
 struct audio_queue *audio_encoder_audio_queue_get(struct audio_encoder *encoder);
 
+/**
+ * @brief Get the SDU queue of a channel of the audio encoder
+ *
+ * @param encoder Audio encoder instance
+ * @param stream_id Stream ID of the channel
+ *
+ * @retval SDU queue if successful
+ * @retval NULL if the channel does not exist
+ */
+struct sdu_queue *audio_encoder_sdu_queue_get(struct audio_encoder *encoder, uint32_t stream_id);
+
 /**
  * @brief Add a channel to the audio encoder
  *
@@ -108,11 +188,57 @@ int audio_encoder_stop_channel(struct audio_encoder *encoder, uint32_t stream_id
  * @param cb Callback function
  *
  * @retval 0 if successful
- * @retval Negative error code on failure
+ * @retval -ENOMEM if four callbacks are already registered
+ * @retval Negative error code on other failures
  */
 int audio_encoder_register_cb(struct audio_encoder *encoder, audio_encoder_sdu_cb_t cb,
 			      void *context);
 
+/**
+ * @brief Set the action taken when the SDU queue of a stream is full
+ *
+ * Streams are added with AUDIO_ENCODER_BACKPRESSURE_DROP_NEWEST. A stream whose SDU queue is full
+ * never blocks the encoder, whatever the policy.
+ *
+ * @param encoder Audio encoder instance
+ * @param stream_id Stream ID of the channel
+ * @param policy Backpressure policy
+ *
+ * @retval 0 if successful
+ * @retval -EINVAL if the channel does not exist or the policy is invalid
+ */
+int audio_encoder_set_backpressure_policy(struct audio_encoder *encoder, uint32_t stream_id,
+					  enum audio_encoder_backpressure policy);
+
+/**
+ * @brief Register a callback to be called for each frame not encoded due to backpressure
+ *
+ * Only one callback can be registered, registering again replaces it.
+ *
+ * @param encoder Audio encoder instance to register with
+ * @param cb Callback function, or NULL to remove the callback
+ * @param context User-defined context to be passed to callback
+ *
+ * @retval 0 if successful
+ * @retval Negative error code on failure
+ */
+int audio_encoder_register_backpressure_cb(struct audio_encoder *encoder,
+					   audio_encoder_backpressure_cb_t cb, void *context);
+
+/**
+ * @brief Get the backpressure counters of a channel
+ *
+ * @param encoder Audio encoder instance
+ * @param stream_id Stream ID of the channel
+ * @param stats Counters of the channel
+ * @param clear Reset the counters after reading them
+ *
+ * @retval 0 if successful
+ * @retval -EINVAL if the channel does not exist
+ */
+int audio_encoder_get_channel_stats(struct audio_encoder *encoder, uint32_t stream_id,
+				    struct audio_encoder_stream_stats *stats, bool clear);
+
 /**
  * @brief Stop and delete an audio encoder instance
  *
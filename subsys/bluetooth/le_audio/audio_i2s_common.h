@@ -12,6 +12,13 @@
 
 #include <zephyr/kernel.h>
 
+/* Blocks kept queued in the I2S driver in each direction. With more than two, the blocks queued
+ * behind the one being transferred are linked into the DMA transfer as it starts, so the
+ * controller moves on to them without waiting for the completion interrupt. Each block queued
+ * adds a block of latency.
+ */
+#define AUDIO_I2S_QUEUED_BLOCKS CONFIG_I2S_SYNC_QUEUE_DEPTH
+
 struct audio_i2s_timing {
 	struct k_spinlock lock;
 	int32_t correction_us;
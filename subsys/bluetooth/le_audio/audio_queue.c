@@ -35,8 +35,7 @@ struct audio_queue *audio_queue_create(size_t const item_count, size_t const sam
 	/* Each item must be 4-byte aligned */
 	size_t const padded_size = ROUND_UP(item_size, 4);
 
-	size_t const total_size = sizeof(struct audio_queue) + (item_count * padded_size) +
-				  (item_count * sizeof(void *));
+	size_t const total_size = sizeof(struct audio_queue) + (item_count * padded_size);
 
 	struct audio_queue *hdr = (struct audio_queue *)malloc(total_size);
 
@@ -48,15 +47,7 @@ struct audio_queue *audio_queue_create(size_t const item_count, size_t const sam
 	/* malloc should give a minimum of 4-byte alignment, but confirm this */
 	__ASSERT(IS_PTR_ALIGNED(hdr->buf, 4), "Audio buffer is not 4-byte aligned");
 
-	int ret = k_mem_slab_init(&hdr->slab, hdr->buf, padded_size, item_count);
-
-	if (ret) {
-		LOG_ERR("Failed to initialise audio queue mem slab");
-		return NULL;
-	}
-
-	k_msgq_init(&hdr->msgq, (char *)(hdr->buf + (item_count * padded_size)), sizeof(void *),
-		    item_count);
+	block_ring_init(&hdr->ring, hdr->buf, padded_size, item_count);
 
 	hdr->audio_block_samples = block_samples;
 	hdr->frame_duration_us = frame_duration_us;
@@ -11,6 +11,7 @@
 #define _AUDIO_QUEUE_H
 
 #include <zephyr/kernel.h>
+#include "block_ring.h"
 
 /* Max supported sampling rate is 48kHz.
  * 10ms frame has 480 bytes and 7.5ms has 360 bytes.
@@ -22,6 +23,8 @@ typedef int16_t pcm_sample_t;
 
 struct audio_block {
 	uint32_t timestamp;
+	/** Sequence number of the SDU the block was decoded from, for tracing */
+	uint16_t sdu_seq;
 	/** Number of audio channels in this block */
 	size_t num_channels;
 	/** 16-bit signed PCM values */
@@ -42,8 +45,8 @@ struct audio_queue {
 	uint16_t audio_block_samples;
 	uint16_t frame_duration_us;
 	size_t sampling_freq_hz;
-	struct k_mem_slab slab;
-	struct k_msgq msgq;
+	/* Audio blocks are passed from producer to consumer through a lock-free block ring */
+	struct block_ring ring;
 	uint8_t buf[];
 };
 
@@ -0,0 +1,97 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include "audio_queue_depth.h"
+
+static void start_window(struct audio_queue_depth *const depth)
+{
+	depth->frames = 0;
+	depth->min_delay_us = UINT32_MAX;
+	depth->max_delay_us = 0;
+	depth->lost = 0;
+}
+
+static uint16_t calculate_target(struct audio_queue_depth const *const depth)
+{
+	uint32_t const jitter_blocks = DIV_ROUND_UP(depth->jitter_us, depth->frame_duration_us);
+
+	return MIN(depth->base_blocks + jitter_blocks + depth->burst_blocks, depth->max_blocks);
+}
+
+void audio_queue_depth_init(struct audio_queue_depth *const depth,
+			    uint32_t const frame_duration_us, uint32_t const window_frames,
+			    uint16_t const base_blocks, uint16_t const max_blocks)
+{
+	depth->frame_duration_us = frame_duration_us;
+	depth->window_frames = window_frames;
+	depth->max_blocks = max_blocks;
+	depth->base_blocks = MIN(base_blocks, max_blocks);
+	depth->burst_blocks = 0;
+	depth->jitter_us = 0;
+	depth->floor_delay_us = UINT32_MAX;
+
+	/* Start from the full allocation until the link has been measured */
+	depth->target_blocks = max_blocks;
+
+	start_window(depth);
+}
+
+uint16_t audio_queue_depth_update(struct audio_queue_depth *const depth, uint32_t const delay_us,
+				  uint32_t const lost)
+{
+	if (delay_us) {
+		depth->min_delay_us = MIN(depth->min_delay_us, delay_us);
+		depth->max_delay_us = MAX(depth->max_delay_us, delay_us);
+
+		/* Grow straight away for an SDU later than any seen recently */
+		uint32_t const floor_us = MIN(depth->floor_delay_us, depth->min_delay_us);
+
+		depth->jitter_us = MAX(depth->jitter_us, delay_us - floor_us);
+	}
+
+	if (lost) {
+		depth->lost += lost;
+		depth->burst_blocks = MAX(depth->burst_blocks, MIN(lost, depth->max_blocks));
+	}
+
+	if (++depth->frames >= depth->window_frames) {
+		if (depth->max_delay_us) {
+			uint32_t const window_jitter_us = depth->max_delay_us - depth->min_delay_us;
+
+			if (!depth->lost) {
+				/* Clean window, decay towards the jitter that was measured. The
+				 * minimum step makes sure a small estimate decays to nothing.
+				 */
+				uint32_t const decay_us = MAX(depth->jitter_us / 4,
+							      depth->frame_duration_us / 8);
+				uint32_t const jitter_us =
+					depth->jitter_us > decay_us ? depth->jitter_us - decay_us : 0;
+
+				depth->jitter_us = MAX(window_jitter_us, jitter_us);
+			}
+
+			/* Follow changes in the fixed part of the link delay */
+			depth->floor_delay_us = depth->min_delay_us;
+		}
+
+		if (!depth->lost && depth->burst_blocks) {
+			depth->burst_blocks--;
+		}
+
+		start_window(depth);
+		depth->target_blocks = calculate_target(depth);
+	} else {
+		/* Only grow within a window, shrinking waits for the window to complete */
+		depth->target_blocks = MAX(depth->target_blocks, calculate_target(depth));
+	}
+
+	return depth->target_blocks;
+}
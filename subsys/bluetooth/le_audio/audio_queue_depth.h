@@ -0,0 +1,72 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#ifndef _AUDIO_QUEUE_DEPTH_H
+#define _AUDIO_QUEUE_DEPTH_H
+
+/**
+ * @file
+ * @brief Audio queue depth estimation from measured link jitter and loss
+ *
+ * Tracks how late SDUs arrive relative to their anchor points, and how many are lost, to decide
+ * how many audio blocks the decoder needs to keep queued. The depth never drops below the base
+ * depth needed to hold the presentation delay, so it does not interfere with presentation
+ * compensation. It is raised as soon as a late SDU or a loss burst is seen, and lowered gradually
+ * after each measurement window in which no SDUs were lost.
+ *
+ * The depth only limits how many of the allocated blocks are used. It frees no memory and does
+ * not change the presentation delay, so it is mainly a measure of the queue margin a link needs.
+ */
+
+#include <zephyr/kernel.h>
+
+struct audio_queue_depth {
+	uint32_t frame_duration_us;
+	uint32_t window_frames;
+	uint16_t base_blocks;
+	uint16_t max_blocks;
+	uint16_t target_blocks;
+	/* Extra blocks held after a loss burst */
+	uint16_t burst_blocks;
+	/* Estimated jitter, above the lowest delay of the previous window */
+	uint32_t jitter_us;
+	uint32_t floor_delay_us;
+	/* Current measurement window */
+	uint32_t frames;
+	uint32_t min_delay_us;
+	uint32_t max_delay_us;
+	uint32_t lost;
+};
+
+/**
+ * @brief Initialise the depth estimator
+ *
+ * @param depth Estimator to initialise
+ * @param frame_duration_us Duration of each audio block
+ * @param window_frames Number of frames in each measurement window
+ * @param base_blocks Depth needed for the presentation delay on a link with no jitter
+ * @param max_blocks Number of blocks allocated to the queue
+ */
+void audio_queue_depth_init(struct audio_queue_depth *depth, uint32_t frame_duration_us,
+			    uint32_t window_frames, uint16_t base_blocks, uint16_t max_blocks);
+
+/**
+ * @brief Update the estimate with the link statistics of a decoded frame
+ *
+ * @param depth Estimator to update
+ * @param delay_us Largest delay from SDU anchor point to reception of the frame, or zero if no
+ * SDU arrived since the last frame
+ * @param lost Number of consecutive SDUs lost on any channel since the last frame
+ *
+ * @return Number of audio blocks to keep queued
+ */
+uint16_t audio_queue_depth_update(struct audio_queue_depth *depth, uint32_t delay_us,
+				  uint32_t lost);
+
+#endif /* _AUDIO_QUEUE_DEPTH_H */
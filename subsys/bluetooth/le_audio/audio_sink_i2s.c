@@ -15,7 +15,9 @@
 #include "gapi_isooshm.h"
 #include "presentation_compensation.h"
 #include "audio_i2s_common.h"
+#include "audio_asrc.h"
 #include "audio_sink_i2s.h"
+#include "datapath_trace.h"
 
 LOG_MODULE_REGISTER(audio_sink_i2s, CONFIG_BLE_AUDIO_LOG_LEVEL);
 
@@ -78,13 +80,30 @@ static int audio_sink_i2s_init(void)
 SYS_INIT(audio_sink_i2s_init, APPLICATION, 0);
 #endif
 
+/* A block queued in the I2S driver */
+struct queued_block {
+	/* Audio block to release once sent, NULL for silence or resampled samples */
+	struct audio_block *block;
+	uint32_t duration_us;
+};
+
 struct audio_sink_i2s {
 	const struct device *dev;
 	struct audio_queue *audio_queue;
-	struct audio_block *current_block;
+	/* Blocks queued in the I2S driver oldest first, and their total duration */
+	struct queued_block queued[AUDIO_I2S_QUEUED_BLOCKS];
+	uint8_t queued_head;
+	uint8_t queued_count;
+	uint32_t queued_us;
 	bool awaiting_buffer;
 
 	struct audio_i2s_timing timing;
+
+#if CONFIG_ALIF_BLE_AUDIO_SINK_ASRC
+	struct audio_asrc asrc;
+	uint8_t num_channels;
+	uint8_t asrc_out_idx;
+#endif
 };
 
 struct pres_delay_work {
@@ -97,9 +116,46 @@ static struct pres_delay_work pd_work;
 
 static pcm_sample_t silence[MAX_SAMPLES_PER_AUDIO_BLOCK];
 
-INT_RAMFUNC static void send_next_block(const struct device *dev, uint32_t const time_now)
+#if CONFIG_ALIF_BLE_AUDIO_SINK_ASRC
+/* The delay is measured at the sink, a delay which is too long needs a faster playback ratio */
+BUILD_ASSERT(IS_ENABLED(CONFIG_PRESENTATION_COMPENSATION_DIRECTION_SINK),
+	     "The sink sample-rate converter needs sink presentation compensation direction");
+
+/* The converter resamples interleaved frames, a planar block would be resampled across the join
+ * between its left and right halves
+ */
+BUILD_ASSERT(!IS_ENABLED(CONFIG_I2S_SYNC_BUFFER_FORMAT_SEQUENTIAL),
+	     "The sink sample-rate converter needs interleaved I2S buffers");
+
+/* Resampled output, one buffer per block queued in the I2S driver, used in turn so that the next
+ * block can be prepared while the others may still be referenced by the driver
+ */
+static pcm_sample_t asrc_out[AUDIO_I2S_QUEUED_BLOCKS]
+			    [(MAX_SAMPLES_PER_AUDIO_BLOCK + AUDIO_ASRC_MAX_EXTRA_FRAMES) *
+			     MAX_NUMBER_OF_CHANNELS];
+#endif
+
+/* Pass a block to the I2S driver, behind the blocks already queued */
+INT_RAMFUNC static void queue_block(const struct device *dev, void *const buf, size_t const samples,
+				    struct audio_block *const block)
+{
+	struct queued_block *const entry =
+		&audio_sink.queued[(audio_sink.queued_head + audio_sink.queued_count) %
+				   ARRAY_SIZE(audio_sink.queued)];
+
+	i2s_sync_send(dev, buf, samples * sizeof(pcm_sample_t));
+
+	entry->block = block;
+	entry->duration_us = audio_i2s_samples_to_us(samples, audio_sink.timing.us_per_block,
+						     audio_sink.timing.samples_per_block);
+	audio_sink.queued_count++;
+	audio_sink.queued_us += entry->duration_us;
+}
+
+/* Queue the next block for the I2S driver. Returns false if no audio block is available. */
+INT_RAMFUNC static bool send_next_block(const struct device *dev, uint32_t const time_now)
 {
-	struct audio_block *block = NULL;
+	struct audio_block *block;
 	int32_t const correction_samples = audio_i2s_get_sample_correction(&audio_sink.timing);
 
 	/* Send required size of silence and return */
@@ -107,47 +163,78 @@ INT_RAMFUNC static void send_next_block(const struct device *dev, uint32_t const
 #if DT_NODE_EXISTS(GPIO_TEST1_NODE)
 		set_test_pin(&test_pin1, 1);
 #endif
-		i2s_sync_send(dev, silence, correction_samples * sizeof(silence[0]));
-		return;
+		queue_block(dev, silence, correction_samples, NULL);
+		return true;
 	}
 
-	int ret = k_msgq_get(&audio_sink.audio_queue->msgq, &block, K_NO_WAIT);
+	block = block_ring_get(&audio_sink.audio_queue->ring, K_NO_WAIT);
 
-	if (ret || !block) {
-		/* If there is no available buffer, disable I2S transmitter and flag waiting for
-		 * data
-		 */
-		i2s_sync_disable(dev, I2S_DIR_TX);
-		audio_sink.awaiting_buffer = true;
-		return;
+	if (!block) {
+		return false;
 	}
 
 #if DT_NODE_EXISTS(GPIO_TEST0_NODE)
 	set_test_pin(&test_pin0, 1);
 #endif
 
+	uint32_t const timestamp = block->timestamp;
+
+	datapath_trace_record(DATAPATH_TRACE_I2S_SEND, DATAPATH_TRACE_ANY_CHANNEL, block->sdu_seq);
+	pcm_sample_t *tx_buf = block->buf_left;
 	size_t tx_count = audio_sink.timing.samples_per_block;
 	size_t tx_offset = 0;
-	uint32_t pres_delay_offset = 0;
+	/* The block is played out once the blocks queued ahead of it have been */
+	int32_t pres_delay_offset = -(int32_t)audio_sink.queued_us;
+
+#if CONFIG_ALIF_BLE_AUDIO_SINK_ASRC
+	/* Frames held back by the converter are played out ahead of this block, which delays its
+	 * presentation by the same amount
+	 */
+	int32_t const asrc_delay_us = audio_i2s_samples_to_us(
+		audio_asrc_delay_frames(&audio_sink.asrc) * audio_sink.num_channels,
+		audio_sink.timing.us_per_block, audio_sink.timing.samples_per_block);
+
+	tx_buf = asrc_out[audio_sink.asrc_out_idx];
+	audio_sink.asrc_out_idx = (audio_sink.asrc_out_idx + 1) % ARRAY_SIZE(asrc_out);
+	tx_count = audio_sink.num_channels *
+		   audio_asrc_process(&audio_sink.asrc, block->buf_left,
+				      audio_sink.audio_queue->audio_block_samples, tx_buf,
+				      ARRAY_SIZE(asrc_out[0]) / audio_sink.num_channels);
+
+	/* The samples have been copied into the converter, so the block can be returned now */
+	block_ring_release(&audio_sink.audio_queue->ring, block);
+	block = NULL;
+	pres_delay_offset -= asrc_delay_us;
+#endif
 
 	/* If necessary drop some samples from the start of the buffer */
 	if (correction_samples < 0) {
 		tx_count += correction_samples;
 		tx_offset = -correction_samples;
-		pres_delay_offset =
+		pres_delay_offset +=
 			audio_i2s_samples_to_us(-correction_samples, audio_sink.timing.us_per_block,
 						audio_sink.timing.samples_per_block);
 	}
 
-	i2s_sync_send(dev, block->buf_left + tx_offset, tx_count * sizeof(pcm_sample_t));
+	queue_block(dev, tx_buf + tx_offset, tx_count, block);
 
 	/* Calculate presentation delay, and then sumbit a work item to perform presentation
 	 * compensation calculations so that this is deferred and not performed in ISR context
 	 */
-	pd_work.pres_delay_us = time_now - block->timestamp - pres_delay_offset;
+	pd_work.pres_delay_us = time_now - timestamp - pres_delay_offset;
 	k_work_submit(&pd_work.work);
 
-	audio_sink.current_block = block;
+	return true;
+}
+
+/* Keep the I2S driver queue full, so that it can link the queued blocks into its transfer */
+INT_RAMFUNC static void send_blocks(const struct device *dev, uint32_t const time_now)
+{
+	while (audio_sink.queued_count < ARRAY_SIZE(audio_sink.queued)) {
+		if (!send_next_block(dev, time_now)) {
+			break;
+		}
+	}
 }
 
 INT_RAMFUNC static void on_i2s_complete(const struct device *dev, enum i2s_sync_status status,
@@ -164,26 +251,44 @@ INT_RAMFUNC static void on_i2s_complete(const struct device *dev, enum i2s_sync_
 
 	/* Capture timestamp before doing anything else to reduce jitter */
 	uint32_t const time_now = gapi_isooshm_dp_get_local_time();
-	struct audio_block *const block = audio_sink.current_block;
+	struct queued_block const done = audio_sink.queued[audio_sink.queued_head];
 
-	audio_sink.current_block = NULL;
+	__ASSERT_NO_MSG(audio_sink.queued_count);
+	audio_sink.queued_head = (audio_sink.queued_head + 1) % ARRAY_SIZE(audio_sink.queued);
+	audio_sink.queued_count--;
+	audio_sink.queued_us -= done.duration_us;
 
-	send_next_block(dev, time_now);
+	send_blocks(dev, time_now);
 
-	if (block) {
-		k_mem_slab_free(&audio_sink.audio_queue->slab, block);
+	if (done.block) {
+		block_ring_release(&audio_sink.audio_queue->ring, done.block);
+	}
+
+	if (!audio_sink.queued_count) {
+		/* Nothing left to play, so disable I2S transmitter and flag waiting for data */
+		i2s_sync_disable(dev, I2S_DIR_TX);
+		audio_sink.awaiting_buffer = true;
+		datapath_trace_record(DATAPATH_TRACE_I2S_UNDERRUN, DATAPATH_TRACE_ANY_CHANNEL, 0);
 	}
 }
 
 INT_RAMFUNC static void submit_presentation_delay(struct k_work *item)
 {
+#if CONFIG_ALIF_BLE_AUDIO_SINK_ASRC
+	/* The converter ratio is driven by the presentation compensation controller */
+	struct pres_delay_work *w = CONTAINER_OF(item, struct pres_delay_work, work);
+
+	presentation_compensation_notify_timing(w->pres_delay_us);
+#else
 	(void)item;
 	/* struct pres_delay_work *w = CONTAINER_OF(item, struct pres_delay_work, work); */
 
 	/* presentation_compensation_notify_timing(w->pres_delay_us); */
+#endif
 }
 
-int audio_sink_i2s_configure(const struct device *dev, struct audio_queue *audio_queue)
+int audio_sink_i2s_configure(const struct device *dev, struct audio_queue *audio_queue,
+			     uint32_t pres_delay_us)
 {
 	if ((dev == NULL) || (audio_queue == NULL)) {
 		return -EINVAL;
@@ -203,11 +308,15 @@ int audio_sink_i2s_configure(const struct device *dev, struct audio_queue *audio
 		return -EIO;
 	}
 
-	size_t const samples_per_full_block =
-		i2s_cfg.channel_count * audio_queue->audio_block_samples;
+	/* Channels of the buffers, which may be a subset of the slots on the bus */
+	uint8_t const channels = i2s_sync_channels(&i2s_cfg, I2S_DIR_TX);
+	size_t const samples_per_full_block = channels * audio_queue->audio_block_samples;
 
 	audio_sink.dev = dev;
 	audio_sink.audio_queue = audio_queue;
+	audio_sink.queued_head = 0;
+	audio_sink.queued_count = 0;
+	audio_sink.queued_us = 0;
 	audio_sink.timing.correction_us = 0;
 	audio_sink.timing.us_per_block = audio_queue->frame_duration_us;
 	audio_sink.timing.samples_per_block = samples_per_full_block;
@@ -220,6 +329,44 @@ int audio_sink_i2s_configure(const struct device *dev, struct audio_queue *audio
 	 */
 	audio_sink.timing.min_single_correction = 2 - (int32_t)samples_per_full_block;
 
+#if CONFIG_ALIF_BLE_AUDIO_SINK_ASRC
+	int ret_asrc = audio_asrc_init(&audio_sink.asrc, channels);
+
+	if (ret_asrc) {
+		LOG_ERR("Failed to initialise sample-rate converter");
+		return ret_asrc;
+	}
+
+	audio_sink.num_channels = channels;
+	audio_sink.asrc_out_idx = 0;
+
+	/* The converter may output one frame less than a full block */
+	audio_sink.timing.min_single_correction += channels;
+
+	/* The controller steers the converter ratio, and falls back to inserting silence or
+	 * dropping samples only for errors above its threshold
+	 */
+	ret_asrc = presentation_compensation_configure(NULL, pres_delay_us);
+	if (ret_asrc) {
+		LOG_ERR("Failed to configure presentation compensation");
+		return ret_asrc;
+	}
+
+	ret_asrc = presentation_compensation_register_ratio_cb(
+		audio_sink_i2s_apply_rate_correction);
+	if (ret_asrc == 0) {
+		ret_asrc = presentation_compensation_register_cb(
+			audio_sink_i2s_apply_timing_correction);
+	}
+
+	if (ret_asrc) {
+		LOG_ERR("Failed to register presentation compensation callbacks");
+		return ret_asrc;
+	}
+#else
+	ARG_UNUSED(pres_delay_us);
+#endif
+
 	k_work_init(&pd_work.work, submit_presentation_delay);
 
 	int ret = i2s_sync_register_cb(dev, I2S_DIR_TX, on_i2s_complete);
@@ -253,13 +400,33 @@ INT_RAMFUNC void audio_sink_i2s_notify_buffer_available(void *param, uint32_t co
 		return;
 	}
 
+	/* Wait until there are enough blocks to fill the I2S driver queue, and one more for the
+	 * block decoded while the first is played. Otherwise the queue would run with fewer blocks
+	 * from then on, as one block is decoded for each one played.
+	 */
+	struct block_ring *const ring = &audio_sink.audio_queue->ring;
+
+	if (block_ring_num_used(ring) < MIN(AUDIO_I2S_QUEUED_BLOCKS + 1, ring->limit)) {
+		return;
+	}
+
 	uint32_t time_now = gapi_isooshm_dp_get_local_time();
 
+	/* Start with one block, the completion callback then fills the I2S driver queue */
 	audio_sink.awaiting_buffer = false;
-	send_next_block(audio_sink.dev, time_now);
+	if (!send_next_block(audio_sink.dev, time_now)) {
+		audio_sink.awaiting_buffer = true;
+	}
 }
 
 INT_RAMFUNC void audio_sink_i2s_apply_timing_correction(int32_t correction_us)
 {
 	audio_i2s_timing_apply_correction(&audio_sink.timing, correction_us);
 }
+
+#if CONFIG_ALIF_BLE_AUDIO_SINK_ASRC
+void audio_sink_i2s_apply_rate_correction(int32_t const ratio_ppm)
+{
+	audio_asrc_set_ratio_ppm(&audio_sink.asrc, ratio_ppm);
+}
+#endif
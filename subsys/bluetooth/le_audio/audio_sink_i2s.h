@@ -20,11 +20,15 @@
  *
  * @param dev I2S device to use
  * @param audio_queue Audio queue that data will be retrieved from
+ * @param pres_delay_us Target presentation delay in microseconds. With
+ * CONFIG_ALIF_BLE_AUDIO_SINK_ASRC the sink configures the presentation compensation module with it
+ * and drives the sample-rate converter from the controller, otherwise it is unused.
  *
  * @retval 0 if successful
  * @retval Negative error code on failure
  */
-int audio_sink_i2s_configure(const struct device *dev, struct audio_queue *audio_queue);
+int audio_sink_i2s_configure(const struct device *dev, struct audio_queue *audio_queue,
+			     uint32_t pres_delay_us);
 
 /**
  * @brief Notify audio sink that a new buffer is available containing audio data
@@ -44,4 +48,17 @@ void audio_sink_i2s_notify_buffer_available(void *param, uint32_t timestamp, uin
  */
 void audio_sink_i2s_apply_timing_correction(int32_t correction_us);
 
+#if CONFIG_ALIF_BLE_AUDIO_SINK_ASRC
+/**
+ * @brief Adjust the rate at which the audio sink consumes audio data
+ *
+ * Updates the ratio of the sample-rate converter between the audio queue and I2S. Suitable for use
+ * as a presentation compensation ratio callback.
+ *
+ * @param ratio_ppm Deviation from the nominal rate in parts per million. A positive number
+ * indicates that audio data should be consumed faster, reducing presentation delay.
+ */
+void audio_sink_i2s_apply_rate_correction(int32_t ratio_ppm);
+#endif
+
 #endif /* _AUDIO_SINK_I2S_H */
@@ -15,6 +15,7 @@
 #include "gapi_isooshm.h"
 #include "audio_i2s_common.h"
 #include "audio_source_i2s.h"
+#include "datapath_trace.h"
 
 LOG_MODULE_REGISTER(audio_source_i2s, CONFIG_BLE_AUDIO_LOG_LEVEL);
 
@@ -104,21 +105,29 @@ struct audio_source_i2s {
 	size_t block_samples;
 	size_t number_of_channels;
 	bool drop_next_audio_block;
-	bool ping_pong_buffer;
+	uint8_t next_buffer;
 	bool started;
 };
 static struct audio_source_i2s audio_source;
 
+#if CONFIG_ALIF_BLE_AUDIO_SOURCE_I2S_STREAM
+/** Ring of two periods for 16-bit PCM samples and two channels, captured by the I2S stream */
+static pcm_sample_t stream_ring[2 * NUMBER_OF_CHANNELS * MAX_SAMPLES_PER_BLOCK];
+#else
 struct audio_input_buffer {
 	uint32_t timestamp;
 	pcm_sample_t buf[NUMBER_OF_CHANNELS * MAX_SAMPLES_PER_BLOCK];
 };
-/** Ping pong input buffer for 16-bit PCM samples and two channels */
-static struct audio_input_buffer samples_input_buffer[2];
+/** Input buffers for 16-bit PCM samples and two channels, used in turn. One for each block queued
+ * in the I2S driver, and one for the block being copied to the audio queue.
+ */
+static struct audio_input_buffer samples_input_buffer[AUDIO_I2S_QUEUED_BLOCKS + 1];
+#endif
 
 struct last_block_job {
 	struct k_work work;
-	struct audio_input_buffer *p_block;
+	const pcm_sample_t *p_samples;
+	uint32_t timestamp;
 };
 
 K_KERNEL_STACK_DEFINE(i2s_worker_stack, 2048);
@@ -127,17 +136,16 @@ static struct k_work_q i2s_worker_queue;
 INT_RAMFUNC static void finish_last_block(struct k_work *work)
 {
 	struct last_block_job *p_context = CONTAINER_OF(work, struct last_block_job, work);
-	struct audio_input_buffer *p_block = p_context->p_block;
+	const pcm_sample_t *const p_samples = p_context->p_samples;
 
 #if DT_NODE_EXISTS(GPIO_TEST0_NODE)
 	set_test_pin(&test_pin0, 1);
 #endif
 
-	struct audio_block *p_audiobuf = NULL;
-	int ret =
-		k_mem_slab_alloc(&audio_source.audio_queue->slab, (void **)&p_audiobuf, K_NO_WAIT);
+	struct audio_block *const p_audiobuf =
+		block_ring_acquire(&audio_source.audio_queue->ring, K_NO_WAIT);
 
-	if (ret || !p_audiobuf) {
+	if (!p_audiobuf) {
 		/* No buffer available, just drop it */
 		/* LOG_ERR("Audio queue is empty, dropping frame"); */
 #if DT_NODE_EXISTS(GPIO_TEST0_NODE)
@@ -149,26 +157,26 @@ INT_RAMFUNC static void finish_last_block(struct k_work *work)
 	bool const has_right_channel = audio_source.number_of_channels > 1;
 
 	/* Populate the capture timestamp of the block */
-	p_audiobuf->timestamp = p_block->timestamp;
+	p_audiobuf->timestamp = p_context->timestamp;
 	p_audiobuf->num_channels = 1 + has_right_channel;
 
 #if CONFIG_I2S_SYNC_BUFFER_FORMAT_SEQUENTIAL
 	size_t const block_samples = audio_source.block_samples;
 
-	size_t const num_of_block_bytes = block_samples * sizeof(p_block->buf[0]);
+	size_t const num_of_block_bytes = block_samples * sizeof(p_samples[0]);
 	/* Copy left buffer */
-	memcpy(p_audiobuf->channels[0], p_block->buf, num_of_block_bytes);
+	memcpy(p_audiobuf->channels[0], p_samples, num_of_block_bytes);
 #if CONFIG_ALIF_BLE_AUDIO_NMB_CHANNELS > 1
 	if (has_right_channel) {
 		/* Copy right buffer */
-		memcpy(p_audiobuf->channels[1], p_block->buf + block_samples, num_of_block_bytes);
+		memcpy(p_audiobuf->channels[1], p_samples + block_samples, num_of_block_bytes);
 	}
 #endif
 
 #else /* CONFIG_I2S_SYNC_BUFFER_FORMAT_SEQUENTIAL */
 	size_t const input_block_samples = audio_source.timing.samples_per_block;
 
-	pcm_sample_t const *p_input = p_block->buf;
+	pcm_sample_t const *p_input = p_samples;
 	/* Loop input samples and copy sequentially.
 	 * Every even sample is for left channel.
 	 */
@@ -187,11 +195,9 @@ INT_RAMFUNC static void finish_last_block(struct k_work *work)
 	}
 #endif /* CONFIG_I2S_SYNC_BUFFER_FORMAT_SEQUENTIAL */
 
-	if (k_msgq_put(&audio_source.audio_queue->msgq, &p_audiobuf, K_NO_WAIT)) {
-		/* Failed to put into queue */
-		k_mem_slab_free(&audio_source.audio_queue->slab, p_audiobuf);
-		LOG_ERR("Audio msg queue is full, frame dropped");
-	}
+	/* Space was reserved when the block was acquired, so this cannot fail */
+	block_ring_commit(&audio_source.audio_queue->ring, p_audiobuf);
+	datapath_trace_record(DATAPATH_TRACE_AUDIO_CAPTURED, DATAPATH_TRACE_ANY_CHANNEL, 0);
 #if DT_NODE_EXISTS(GPIO_TEST0_NODE)
 	set_test_pin(&test_pin0, 0);
 #endif
@@ -199,16 +205,59 @@ INT_RAMFUNC static void finish_last_block(struct k_work *work)
 
 static struct last_block_job finish_last_block_job = {
 	.work = Z_WORK_INITIALIZER(finish_last_block),
-	.p_block = NULL,
+	.p_samples = NULL,
 };
 
-INT_RAMFUNC static void recv_next_block(const struct device *dev, uint32_t timestamp)
+#if CONFIG_ALIF_BLE_AUDIO_SOURCE_I2S_STREAM
+INT_RAMFUNC static void on_i2s_period(const struct device *dev, enum i2s_sync_status status,
+				      void *period, uint32_t timestamp, void *user_data)
 {
-	bool const ping_pong = audio_source.ping_pong_buffer ^ true;
+	ARG_UNUSED(dev);
+	ARG_UNUSED(user_data);
+
+#if DT_NODE_EXISTS(GPIO_TEST0_NODE)
+	set_test_pin(&test_pin0, 1);
+#endif
+
+	/* A period with an overrun or error has lost samples and is dropped */
+	if (status == I2S_SYNC_STATUS_OK) {
+		finish_last_block_job.p_samples = period;
+#if CONFIG_ALIF_BLE_AUDIO_SOURCE_TRANSMISSION_DELAY_ENABLED
+		/* The timestamp is local time at the end of the period */
+		finish_last_block_job.timestamp =
+			timestamp - audio_source.timing.us_per_block + TRANSMISSION_DELAY_US;
+#else
+		finish_last_block_job.timestamp = 0;
+#endif
+		k_work_submit_to_queue(&i2s_worker_queue, &finish_last_block_job.work);
+	}
 
-	audio_source.ping_pong_buffer = ping_pong;
+#if DT_NODE_EXISTS(GPIO_TEST0_NODE)
+	set_test_pin(&test_pin0, 0);
+#endif
+}
+
+/* Capture continuously into a ring of two blocks, without a receive per block */
+static int start_capture(void)
+{
+	struct i2s_sync_stream_config const stream = {
+		.buf = stream_ring,
+		.len = 2 * audio_source.timing.samples_per_block * sizeof(stream_ring[0]),
+		.periods = 2,
+		.cb = on_i2s_period,
+		.get_time = gapi_isooshm_dp_get_local_time,
+	};
+
+	return i2s_sync_stream_start(audio_source.dev, I2S_DIR_RX, &stream);
+}
+#else
+/* Queue the next block for the I2S driver, timestamp is the time it starts to be captured */
+INT_RAMFUNC static void recv_next_block(const struct device *dev, uint32_t timestamp)
+{
+	struct audio_input_buffer *const p_buffer = &samples_input_buffer[audio_source.next_buffer];
 
-	struct audio_input_buffer *const p_buffer = &samples_input_buffer[ping_pong];
+	audio_source.next_buffer =
+		(audio_source.next_buffer + 1) % ARRAY_SIZE(samples_input_buffer);
 
 	/* TODO: implement timing fix if needed... Always zero for now so ignore adjustment code! */
 #if CORRECTION_SAMPLES_ENABLED
@@ -263,12 +312,18 @@ INT_RAMFUNC static void on_i2s_complete(const struct device *dev, enum i2s_sync_
 	set_test_pin(&test_pin0, 1);
 #endif
 
-	recv_next_block(dev, time_now);
+	/* The new block is captured after the blocks still queued ahead of it */
+	recv_next_block(dev,
+			time_now + (AUDIO_I2S_QUEUED_BLOCKS - 1) * audio_source.timing.us_per_block);
 
 	if (audio_source.drop_next_audio_block || !block) {
 		audio_source.drop_next_audio_block = false;
 	} else {
-		finish_last_block_job.p_block = CONTAINER_OF(block, struct audio_input_buffer, buf);
+		struct audio_input_buffer const *const p_block =
+			CONTAINER_OF(block, struct audio_input_buffer, buf);
+
+		finish_last_block_job.p_samples = p_block->buf;
+		finish_last_block_job.timestamp = p_block->timestamp;
 		k_work_submit_to_queue(&i2s_worker_queue, &finish_last_block_job.work);
 	}
 
@@ -277,6 +332,21 @@ INT_RAMFUNC static void on_i2s_complete(const struct device *dev, enum i2s_sync_
 #endif
 }
 
+/* Fill the I2S receive queue, each block then receives the next one when it completes. Keeping
+ * the queue full lets the driver link the queued blocks into its transfer.
+ */
+static int start_capture(void)
+{
+	const uint32_t time_now = gapi_isooshm_dp_get_local_time();
+
+	for (uint32_t i = 0; i < AUDIO_I2S_QUEUED_BLOCKS; i++) {
+		recv_next_block(audio_source.dev, time_now + i * audio_source.timing.us_per_block);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_ALIF_BLE_AUDIO_SOURCE_I2S_STREAM */
+
 int audio_source_i2s_configure(const struct device *dev, struct audio_queue *audio_queue)
 {
 	if (!dev || !audio_queue) {
@@ -291,8 +361,11 @@ int audio_source_i2s_configure(const struct device *dev, struct audio_queue *aud
 		return -EIO;
 	}
 
-	if (i2s_cfg.channel_count > NUMBER_OF_CHANNELS) {
-		LOG_ERR("Invalid I2S channel count %u", i2s_cfg.channel_count);
+	/* Channels of the buffers, which may be a subset of the slots on the bus */
+	uint8_t const channels = i2s_sync_channels(&i2s_cfg, I2S_DIR_RX);
+
+	if (channels > NUMBER_OF_CHANNELS) {
+		LOG_ERR("Invalid I2S channel count %u", channels);
 		return -EINVAL;
 	}
 
@@ -307,9 +380,9 @@ int audio_source_i2s_configure(const struct device *dev, struct audio_queue *aud
 					     ? (i2s_cfg.sample_rate * 10) / 1000
 					     : (i2s_cfg.sample_rate * 75) / 10000;
 
-	size_t const samples_per_full_block = i2s_cfg.channel_count * block_samples;
+	size_t const samples_per_full_block = channels * block_samples;
 
-	if (samples_per_full_block > ARRAY_SIZE(samples_input_buffer[0].buf)) {
+	if (samples_per_full_block > NUMBER_OF_CHANNELS * MAX_SAMPLES_PER_BLOCK) {
 		LOG_ERR("Invalid I2S block size %u", samples_per_full_block);
 		return -EINVAL;
 	}
@@ -323,9 +396,9 @@ int audio_source_i2s_configure(const struct device *dev, struct audio_queue *aud
 
 	audio_source.dev = dev;
 	audio_source.audio_queue = audio_queue;
-	audio_source.number_of_channels = i2s_cfg.channel_count;
+	audio_source.number_of_channels = channels;
 	audio_source.block_samples = block_samples;
-	audio_source.ping_pong_buffer = false;
+	audio_source.next_buffer = 0;
 	audio_source.started = false;
 	audio_source.timing.correction_us = 0;
 	audio_source.timing.us_per_block = audio_queue->frame_duration_us;
@@ -339,12 +412,14 @@ int audio_source_i2s_configure(const struct device *dev, struct audio_queue *aud
 	/* Minimum negative correction is one full audio block */
 	audio_source.timing.min_single_correction = -samples_per_full_block;
 
+#if !CONFIG_ALIF_BLE_AUDIO_SOURCE_I2S_STREAM
 	int ret = i2s_sync_register_cb(dev, I2S_DIR_RX, on_i2s_complete);
 
 	if (ret) {
 		LOG_ERR("Failed to register I2S callback");
 		return ret;
 	}
+#endif
 
 	static bool thread_started;
 
@@ -372,12 +447,14 @@ void audio_source_i2s_start(void)
 		return;
 	}
 
-	audio_source.started = true;
+	int const ret = start_capture();
 
-	/* Kick the I2S receive operation */
-	const uint32_t time_now = gapi_isooshm_dp_get_local_time();
+	if (ret) {
+		LOG_ERR("Failed to start I2S capture, err %d", ret);
+		return;
+	}
 
-	recv_next_block(audio_source.dev, time_now);
+	audio_source.started = true;
 }
 
 void audio_source_i2s_stop(void)
@@ -51,6 +51,7 @@
 #include "gapi_isooshm.h"
 #include "audio_i2s_common.h"
 #include "audio_source_pdm.h"
+#include "datapath_trace.h"
 
 LOG_MODULE_REGISTER(audio_source_pdm, CONFIG_BLE_AUDIO_LOG_LEVEL);
 
@@ -265,11 +266,10 @@ INT_RAMFUNC static void process_audio_block(void const *buffer, size_t const siz
 	set_test_pin(&test_pin0, 1);
 #endif
 
-	struct audio_block *p_audiobuf = NULL;
-	int ret =
-		k_mem_slab_alloc(&audio_source.audio_queue->slab, (void **)&p_audiobuf, K_NO_WAIT);
+	struct audio_block *const p_audiobuf =
+		block_ring_acquire(&audio_source.audio_queue->ring, K_NO_WAIT);
 
-	if (ret || !p_audiobuf) {
+	if (!p_audiobuf) {
 		/* No buffer available, just drop it */
 #if DT_NODE_EXISTS(GPIO_TEST0_NODE)
 		set_test_pin(&test_pin0, 0);
@@ -311,11 +311,9 @@ INT_RAMFUNC static void process_audio_block(void const *buffer, size_t const siz
 		*p_out_left++ = *p_input++;
 	}
 
-	if (k_msgq_put(&audio_source.audio_queue->msgq, &p_audiobuf, K_NO_WAIT)) {
-		/* Failed to put into queue */
-		k_mem_slab_free(&audio_source.audio_queue->slab, p_audiobuf);
-		LOG_ERR("Audio msg queue is full, frame dropped");
-	}
+	/* Space was reserved when the block was acquired, so this cannot fail */
+	block_ring_commit(&audio_source.audio_queue->ring, p_audiobuf);
+	datapath_trace_record(DATAPATH_TRACE_AUDIO_CAPTURED, DATAPATH_TRACE_ANY_CHANNEL, 0);
 #if DT_NODE_EXISTS(GPIO_TEST0_NODE)
 	set_test_pin(&test_pin0, 0);
 #endif
@@ -0,0 +1,221 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/__assert.h>
+#include <zephyr/sys/util.h>
+#include "block_ring.h"
+
+#if CONFIG_ALIF_BLE_AUDIO_USE_RAMFUNC
+#define INT_RAMFUNC __ramfunc
+#else
+#define INT_RAMFUNC
+#endif
+
+/* Indices run from 0 to (2 * block_count - 1) so that a full ring can be told apart from an
+ * empty one without wasting a block.
+ */
+static inline uint32_t ring_next(struct block_ring const *const ring, uint32_t const idx)
+{
+	return (idx + 1 == 2 * ring->block_count) ? 0 : idx + 1;
+}
+
+static inline uint32_t ring_prev(struct block_ring const *const ring, uint32_t const idx)
+{
+	return idx ? idx - 1 : 2 * ring->block_count - 1;
+}
+
+static inline uint32_t ring_distance(struct block_ring const *const ring, uint32_t const from,
+				     uint32_t const to)
+{
+	return (to >= from) ? to - from : to + 2 * ring->block_count - from;
+}
+
+static inline void *ring_block(struct block_ring const *const ring, uint32_t idx)
+{
+	if (idx >= ring->block_count) {
+		idx -= ring->block_count;
+	}
+
+	return ring->buf + idx * ring->block_size;
+}
+
+static inline void ring_notify(struct block_ring *const ring)
+{
+	/* Only pay for the kernel call if the other side is actually blocked */
+	if (atomic_get(&ring->waiting)) {
+		k_sem_give(&ring->sem);
+	}
+}
+
+INT_RAMFUNC static void *try_acquire(struct block_ring *const ring)
+{
+	uint32_t const tail = atomic_get(&ring->tail);
+
+	if (ring_distance(ring, tail, ring->acquire_idx) >= ring->limit) {
+		return NULL;
+	}
+
+	void *const block = ring_block(ring, ring->acquire_idx);
+
+	ring->acquire_idx = ring_next(ring, ring->acquire_idx);
+
+	return block;
+}
+
+INT_RAMFUNC static void *try_get(struct block_ring *const ring)
+{
+	uint32_t const head = atomic_get(&ring->head);
+
+	if (ring->get_idx == head) {
+		return NULL;
+	}
+
+	void *const block = ring_block(ring, ring->get_idx);
+
+	ring->get_idx = ring_next(ring, ring->get_idx);
+
+	return block;
+}
+
+static void *wait_for_block(struct block_ring *const ring,
+			    void *(*try_fn)(struct block_ring *const ring), k_timeout_t const timeout)
+{
+	void *block = try_fn(ring);
+
+	if (block || K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		return block;
+	}
+
+	k_timepoint_t const end = sys_timepoint_calc(timeout);
+
+	/* Drop any stale signal from an earlier commit or release, then flag that we are waiting
+	 * before checking again, so that a block made available in between is either seen here or
+	 * signalled through the semaphore
+	 */
+	(void)k_sem_take(&ring->sem, K_NO_WAIT);
+	atomic_set(&ring->waiting, 1);
+
+	while (true) {
+		block = try_fn(ring);
+		if (block || atomic_clear(&ring->wakeup)) {
+			break;
+		}
+
+		if (k_sem_take(&ring->sem, sys_timepoint_timeout(end))) {
+			break;
+		}
+	}
+
+	atomic_set(&ring->waiting, 0);
+
+	return block;
+}
+
+void block_ring_init(struct block_ring *const ring, void *const buf, size_t const block_size,
+		     size_t const block_count)
+{
+	__ASSERT(block_count > 0, "Block ring must have at least one block");
+
+	ring->buf = buf;
+	ring->block_size = block_size;
+	ring->block_count = block_count;
+	ring->limit = block_count;
+	ring->acquire_idx = 0;
+	ring->get_idx = 0;
+	atomic_set(&ring->head, 0);
+	atomic_set(&ring->tail, 0);
+	atomic_set(&ring->waiting, 0);
+	atomic_set(&ring->wakeup, 0);
+	k_sem_init(&ring->sem, 0, 1);
+}
+
+void block_ring_set_limit(struct block_ring *const ring, uint32_t const limit)
+{
+	ring->limit = CLAMP(limit, 1, ring->block_count);
+}
+
+INT_RAMFUNC void *block_ring_acquire(struct block_ring *const ring, k_timeout_t const timeout)
+{
+	return wait_for_block(ring, try_acquire, timeout);
+}
+
+INT_RAMFUNC void block_ring_commit(struct block_ring *const ring, void *const block)
+{
+	uint32_t const head = atomic_get(&ring->head);
+
+	__ASSERT(head != ring->acquire_idx, "No acquired block to commit");
+	__ASSERT(block == ring_block(ring, head), "Blocks must be committed in order");
+	ARG_UNUSED(block);
+
+	atomic_set(&ring->head, ring_next(ring, head));
+	ring_notify(ring);
+}
+
+INT_RAMFUNC void block_ring_cancel(struct block_ring *const ring, void *const block)
+{
+	uint32_t const prev = ring_prev(ring, ring->acquire_idx);
+
+	__ASSERT(ring->acquire_idx != atomic_get(&ring->head), "No acquired block to cancel");
+	__ASSERT(block == ring_block(ring, prev), "Only the newest acquired block can be cancelled");
+	ARG_UNUSED(block);
+
+	ring->acquire_idx = prev;
+}
+
+INT_RAMFUNC void *block_ring_get(struct block_ring *const ring, k_timeout_t const timeout)
+{
+	return wait_for_block(ring, try_get, timeout);
+}
+
+INT_RAMFUNC void block_ring_release(struct block_ring *const ring, void *const block)
+{
+	uint32_t const tail = atomic_get(&ring->tail);
+
+	__ASSERT(tail != ring->get_idx, "No received block to release");
+	__ASSERT(block == ring_block(ring, tail), "Blocks must be released in order");
+	ARG_UNUSED(block);
+
+	atomic_set(&ring->tail, ring_next(ring, tail));
+	ring_notify(ring);
+}
+
+INT_RAMFUNC uint32_t block_ring_num_used(struct block_ring *const ring)
+{
+	return ring_distance(ring, ring->get_idx, atomic_get(&ring->head));
+}
+
+void block_ring_wakeup(struct block_ring *const ring)
+{
+	atomic_set(&ring->wakeup, 1);
+	k_sem_give(&ring->sem);
+}
+
+bool block_ring_poll_init(struct block_ring *const ring, struct k_poll_event *const event)
+{
+	/* k_poll does not consume the semaphore, so drop any stale signal from an earlier commit
+	 * to avoid returning immediately
+	 */
+	(void)k_sem_take(&ring->sem, K_NO_WAIT);
+	atomic_set(&ring->waiting, 1);
+
+	if (block_ring_num_used(ring)) {
+		atomic_set(&ring->waiting, 0);
+		return false;
+	}
+
+	k_poll_event_init(event, K_POLL_TYPE_SEM_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY, &ring->sem);
+
+	return true;
+}
+
+void block_ring_poll_done(struct block_ring *const ring)
+{
+	atomic_set(&ring->waiting, 0);
+}
@@ -0,0 +1,160 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#ifndef _BLOCK_RING_H
+#define _BLOCK_RING_H
+
+/**
+ * @file
+ * @brief Lock-free single-producer/single-consumer ring of fixed-size blocks
+ *
+ * The producer acquires a free block, fills it and commits it. The consumer gets the oldest
+ * committed block, processes it and releases it back to the producer. Blocks are committed in
+ * the order they were acquired and released in the order they were received, and either side
+ * may hold more than one block at a time. No kernel calls or interrupt locking are performed on
+ * these paths, so they are safe to use from ISRs.
+ *
+ * A side that must block (thread context only) can wait with a timeout, and is woken by the
+ * other side through a semaphore that is only given while someone is actually waiting. Only one
+ * side of a ring may block.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+struct block_ring {
+	uint8_t *buf;
+	size_t block_size;
+	uint32_t block_count;
+	/* Maximum number of blocks in use at once, owned by the producer */
+	uint32_t limit;
+	/* Next block to acquire, owned by the producer */
+	uint32_t acquire_idx;
+	/* Next block to get, owned by the consumer */
+	uint32_t get_idx;
+	/* Next block to commit, written by the producer only */
+	atomic_t head;
+	/* Next block to release, written by the consumer only */
+	atomic_t tail;
+	/* Set while the producer or consumer is blocked on the ring */
+	atomic_t waiting;
+	/* Set by block_ring_wakeup() until a blocked wait has returned for it */
+	atomic_t wakeup;
+	struct k_sem sem;
+};
+
+/**
+ * @brief Initialise a block ring over caller provided storage
+ *
+ * @param ring Ring to initialise
+ * @param buf Storage of block_count * block_size bytes
+ * @param block_size Size of each block in bytes
+ * @param block_count Number of blocks
+ */
+void block_ring_init(struct block_ring *ring, void *buf, size_t block_size, size_t block_count);
+
+/**
+ * @brief Limit the number of blocks in use at once (producer)
+ *
+ * Blocks acquired, committed or not yet released by the consumer all count towards the limit.
+ * Lowering the limit below the number of blocks currently in use does not affect them, further
+ * acquires fail until enough blocks have been released.
+ *
+ * @param ring Ring to limit
+ * @param limit Maximum number of blocks in use, clamped to between one and the block count
+ */
+void block_ring_set_limit(struct block_ring *ring, uint32_t limit);
+
+/**
+ * @brief Acquire a free block to write into (producer)
+ *
+ * @param ring Ring to acquire from
+ * @param timeout Time to wait for a free block. Must be K_NO_WAIT in ISR context.
+ *
+ * @retval Pointer to the acquired block
+ * @retval NULL if the ring is full, or the wait was interrupted by @ref block_ring_wakeup
+ */
+void *block_ring_acquire(struct block_ring *ring, k_timeout_t timeout);
+
+/**
+ * @brief Publish the oldest acquired block to the consumer (producer)
+ *
+ * @param ring Ring the block belongs to
+ * @param block Block to commit, must be the oldest uncommitted block
+ */
+void block_ring_commit(struct block_ring *ring, void *block);
+
+/**
+ * @brief Return the most recently acquired block to the ring unused (producer)
+ *
+ * @param ring Ring the block belongs to
+ * @param block Block to cancel, must be the newest acquired block and not yet committed
+ */
+void block_ring_cancel(struct block_ring *ring, void *block);
+
+/**
+ * @brief Get the oldest committed block (consumer)
+ *
+ * @param ring Ring to get from
+ * @param timeout Time to wait for a block. Must be K_NO_WAIT in ISR context.
+ *
+ * @retval Pointer to the block
+ * @retval NULL if the ring is empty, or the wait was interrupted by @ref block_ring_wakeup
+ */
+void *block_ring_get(struct block_ring *ring, k_timeout_t timeout);
+
+/**
+ * @brief Release the oldest received block back to the producer (consumer)
+ *
+ * @param ring Ring the block belongs to
+ * @param block Block to release, must be the oldest unreleased block
+ */
+void block_ring_release(struct block_ring *ring, void *block);
+
+/**
+ * @brief Get the number of committed blocks not yet received by the consumer
+ *
+ * @param ring Ring to query
+ *
+ * @return Number of blocks available to the consumer
+ */
+uint32_t block_ring_num_used(struct block_ring *ring);
+
+/**
+ * @brief Wake up a thread blocked on the ring, e.g. to let it check an abort flag
+ *
+ * If no thread is blocked, the next blocking acquire or get returns NULL at once instead.
+ *
+ * @param ring Ring to wake
+ */
+void block_ring_wakeup(struct block_ring *ring);
+
+/**
+ * @brief Prepare to wait for data on the ring with k_poll (consumer)
+ *
+ * Allows a consumer to wait on several rings at once. If the ring is empty, the poll event is
+ * initialised and the producer will signal it on the next commit. @ref block_ring_poll_done must
+ * be called for every ring prepared this way once k_poll has returned.
+ *
+ * @param ring Ring to wait on
+ * @param event Poll event to initialise
+ *
+ * @retval true if the event was initialised and should be polled
+ * @retval false if data is already available
+ */
+bool block_ring_poll_init(struct block_ring *ring, struct k_poll_event *event);
+
+/**
+ * @brief Finish waiting on a ring prepared with @ref block_ring_poll_init
+ *
+ * @param ring Ring that was waited on
+ */
+void block_ring_poll_done(struct block_ring *ring);
+
+#endif /* _BLOCK_RING_H */
@@ -0,0 +1,60 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "codec_mem.h"
+
+int codec_mem_init(struct codec_mem *const mem, void *region, size_t size)
+{
+	mem->heap = NULL;
+
+	if (!region) {
+		region = malloc(size);
+		if (!region) {
+			return -ENOMEM;
+		}
+		mem->heap = region;
+	}
+
+	/* Caller provided regions need not be aligned */
+	uintptr_t const start = ROUND_UP((uintptr_t)region, CODEC_MEM_ALIGN);
+	uintptr_t const end = (uintptr_t)region + size;
+
+	mem->next = (uint8_t *)start;
+	mem->end = (uint8_t *)MAX(start, end);
+
+	return 0;
+}
+
+void *codec_mem_alloc(struct codec_mem *const mem, size_t const size)
+{
+	size_t const used = CODEC_MEM_SIZEOF(size);
+
+	if (used > codec_mem_available(mem)) {
+		return NULL;
+	}
+
+	void *const p = mem->next;
+
+	mem->next += used;
+	memset(p, 0, size);
+
+	return p;
+}
+
+size_t codec_mem_available(struct codec_mem const *const mem)
+{
+	return mem->end - mem->next;
+}
+
+void codec_mem_release(struct codec_mem const mem)
+{
+	free(mem.heap);
+}
@@ -0,0 +1,81 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#ifndef _CODEC_MEM_H
+#define _CODEC_MEM_H
+
+/**
+ * @file
+ * @brief Memory region holding the state of an audio encoder or decoder
+ *
+ * All allocations made while creating a codec instance are carved linearly out of a single region,
+ * and the whole region is given back at once when the instance is deleted. The region is either
+ * provided by the caller, or allocated from the heap in one piece, so creating and deleting
+ * codecs repeatedly does not fragment the heap and takes a bounded time.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+/** Alignment of each allocation from the region */
+#define CODEC_MEM_ALIGN 8
+
+/** Space used in the region by an allocation of the given size */
+#define CODEC_MEM_SIZEOF(size) ROUND_UP(size, CODEC_MEM_ALIGN)
+
+struct codec_mem {
+	uint8_t *next;
+	uint8_t *end;
+	/* Region allocated from the heap, or NULL if provided by the caller */
+	void *heap;
+};
+
+/**
+ * @brief Initialise a codec memory region
+ *
+ * @param mem Region to initialise
+ * @param region Memory to allocate from, or NULL to allocate the region from the heap
+ * @param size Size of the region in bytes
+ *
+ * @retval 0 if successful
+ * @retval -ENOMEM if the region could not be allocated from the heap
+ */
+int codec_mem_init(struct codec_mem *mem, void *region, size_t size);
+
+/**
+ * @brief Allocate zeroed memory from a codec memory region
+ *
+ * @param mem Region to allocate from
+ * @param size Number of bytes to allocate
+ *
+ * @retval Allocated memory, aligned to CODEC_MEM_ALIGN
+ * @retval NULL if the region is exhausted
+ */
+void *codec_mem_alloc(struct codec_mem *mem, size_t size);
+
+/**
+ * @brief Number of bytes of a codec memory region still available
+ *
+ * @param mem Region to check
+ *
+ * @return Available bytes
+ */
+size_t codec_mem_available(struct codec_mem const *mem);
+
+/**
+ * @brief Give back all memory allocated from a codec memory region
+ *
+ * The region must not be used afterwards, unless it is initialised again. The structure can itself
+ * have been allocated from the region, so it is passed by value.
+ *
+ * @param mem Region to release
+ */
+void codec_mem_release(struct codec_mem mem);
+
+#endif /* _CODEC_MEM_H */
@@ -0,0 +1,92 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+#include "gapi_isooshm.h"
+#include "datapath_trace.h"
+
+#if CONFIG_ALIF_BLE_AUDIO_USE_RAMFUNC
+#define INT_RAMFUNC __ramfunc
+#else
+#define INT_RAMFUNC
+#endif
+
+#define TRACE_SIZE CONFIG_ALIF_BLE_AUDIO_DATAPATH_TRACE_SIZE
+#define TRACE_MASK (TRACE_SIZE - 1)
+
+BUILD_ASSERT(IS_POWER_OF_TWO(TRACE_SIZE), "Trace size must be a power of two");
+
+static struct datapath_trace_entry trace_ring[TRACE_SIZE];
+/* Total number of events recorded, the low bits index the next entry to write */
+static atomic_t trace_head;
+
+static const char *const event_names[] = {
+	[DATAPATH_TRACE_ISO_RX_DONE] = "iso_rx",
+	[DATAPATH_TRACE_SDU_QUEUED] = "sdu_queued",
+	[DATAPATH_TRACE_DECODE_START] = "decode_start",
+	[DATAPATH_TRACE_DECODE_END] = "decode_end",
+	[DATAPATH_TRACE_AUDIO_QUEUED] = "audio_queued",
+	[DATAPATH_TRACE_I2S_SEND] = "i2s_send",
+	[DATAPATH_TRACE_I2S_UNDERRUN] = "i2s_underrun",
+	[DATAPATH_TRACE_PRES_CORRECTION] = "pres_correction",
+	[DATAPATH_TRACE_RATE_CORRECTION] = "rate_correction",
+	[DATAPATH_TRACE_AUDIO_CAPTURED] = "audio_captured",
+	[DATAPATH_TRACE_ENCODE_START] = "encode_start",
+	[DATAPATH_TRACE_ENCODE_END] = "encode_end",
+	[DATAPATH_TRACE_ISO_TX_DONE] = "iso_tx",
+};
+
+BUILD_ASSERT(ARRAY_SIZE(event_names) == DATAPATH_TRACE_EVENT_COUNT);
+
+INT_RAMFUNC void datapath_trace_record(enum datapath_trace_event const event,
+				       uint8_t const channel, uint16_t const arg)
+{
+	atomic_val_t const idx = atomic_inc(&trace_head);
+
+	trace_ring[idx & TRACE_MASK] = (struct datapath_trace_entry){
+		.time_us = gapi_isooshm_dp_get_local_time(),
+		.event = event,
+		.channel = channel,
+		.arg = arg,
+	};
+}
+
+size_t datapath_trace_snapshot(struct datapath_trace_entry *const entries,
+			       size_t const max_entries)
+{
+	uint32_t const head = (uint32_t)atomic_get(&trace_head);
+	size_t const count = MIN(MIN(head, TRACE_SIZE), max_entries);
+	uint32_t const start = head - count;
+
+	for (size_t i = 0; i < count; i++) {
+		entries[i] = trace_ring[(start + i) & TRACE_MASK];
+	}
+
+	return count;
+}
+
+void datapath_trace_clear(void)
+{
+	atomic_set(&trace_head, 0);
+}
+
+bool datapath_trace_same_frame(const struct datapath_trace_entry *const a,
+			       const struct datapath_trace_entry *const b)
+{
+	return a->arg == b->arg &&
+	       (a->channel == b->channel || a->channel == DATAPATH_TRACE_ANY_CHANNEL ||
+		b->channel == DATAPATH_TRACE_ANY_CHANNEL);
+}
+
+const char *datapath_trace_event_name(uint8_t const event)
+{
+	return event < ARRAY_SIZE(event_names) ? event_names[event] : "unknown";
+}
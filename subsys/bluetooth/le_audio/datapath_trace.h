@@ -0,0 +1,115 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#ifndef _DATAPATH_TRACE_H
+#define _DATAPATH_TRACE_H
+
+/**
+ * @file
+ * @brief Per-frame timing trace of the LE audio datapath
+ *
+ * Each stage of the datapath records an event in a ring buffer as a frame passes through it. An
+ * event is 8 bytes and recording one is a single atomic increment and store, so the trace can be
+ * left enabled in production builds. Events of the same frame share the SDU sequence number, so
+ * that the time spent in each stage can be reconstructed from a snapshot of the ring.
+ *
+ * The ring is written from ISR and thread context without locking. An event being written while
+ * a snapshot is taken may be seen half-written, which is acceptable for diagnostics.
+ */
+
+#include <zephyr/kernel.h>
+
+/* Channel of events that apply to all channels of a frame */
+#define DATAPATH_TRACE_ANY_CHANNEL UINT8_MAX
+
+enum datapath_trace_event {
+	/* Sink direction, argument is the SDU sequence number */
+	DATAPATH_TRACE_ISO_RX_DONE,
+	DATAPATH_TRACE_SDU_QUEUED,
+	DATAPATH_TRACE_DECODE_START,
+	DATAPATH_TRACE_DECODE_END,
+	DATAPATH_TRACE_AUDIO_QUEUED,
+	DATAPATH_TRACE_I2S_SEND,
+	/* I2S sink stopped since no audio was ready, no argument */
+	DATAPATH_TRACE_I2S_UNDERRUN,
+	/* Presentation compensation, argument is the correction in us or the ratio in ppm */
+	DATAPATH_TRACE_PRES_CORRECTION,
+	DATAPATH_TRACE_RATE_CORRECTION,
+	/* Source direction. Capture has no argument, the others the SDU sequence number */
+	DATAPATH_TRACE_AUDIO_CAPTURED,
+	DATAPATH_TRACE_ENCODE_START,
+	DATAPATH_TRACE_ENCODE_END,
+	DATAPATH_TRACE_ISO_TX_DONE,
+
+	DATAPATH_TRACE_EVENT_COUNT,
+};
+
+struct datapath_trace_entry {
+	/* Local time from gapi_isooshm_dp_get_local_time() */
+	uint32_t time_us;
+	uint8_t event;
+	uint8_t channel;
+	uint16_t arg;
+};
+
+#if CONFIG_ALIF_BLE_AUDIO_DATAPATH_TRACE
+
+/**
+ * @brief Record an event in the trace ring
+ *
+ * May be called from any context.
+ *
+ * @param event Event type
+ * @param channel Stream ID, as passed to the ISO datapath, or DATAPATH_TRACE_ANY_CHANNEL
+ * @param arg Event argument, see @ref datapath_trace_event
+ */
+void datapath_trace_record(enum datapath_trace_event event, uint8_t channel, uint16_t arg);
+
+/**
+ * @brief Copy the events in the trace ring, oldest first
+ *
+ * @param entries Buffer to copy events to
+ * @param max_entries Size of the buffer in events
+ *
+ * @return Number of events copied
+ */
+size_t datapath_trace_snapshot(struct datapath_trace_entry *entries, size_t max_entries);
+
+/**
+ * @brief Discard all events in the trace ring
+ */
+void datapath_trace_clear(void);
+
+/**
+ * @brief Check whether two events belong to the same frame
+ *
+ * Events of a frame carry the same SDU sequence number, and the same stream ID unless one of
+ * them applies to all channels.
+ */
+bool datapath_trace_same_frame(const struct datapath_trace_entry *a,
+			       const struct datapath_trace_entry *b);
+
+/**
+ * @brief Get the name of an event type
+ */
+const char *datapath_trace_event_name(uint8_t event);
+
+#else
+
+static inline void datapath_trace_record(enum datapath_trace_event event, uint8_t channel,
+					 uint16_t arg)
+{
+	ARG_UNUSED(event);
+	ARG_UNUSED(channel);
+	ARG_UNUSED(arg);
+}
+
+#endif /* CONFIG_ALIF_BLE_AUDIO_DATAPATH_TRACE */
+
+#endif /* _DATAPATH_TRACE_H */
@@ -0,0 +1,231 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/util.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "datapath_trace.h"
+
+/* Histogram buckets are powers of two in microseconds, the last one is open ended */
+#define HIST_BUCKETS 17
+/* Events searched backwards for the start of a stage */
+#define MATCH_WINDOW 64
+
+struct histogram {
+	uint32_t buckets[HIST_BUCKETS];
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint64_t sum;
+};
+
+struct stage {
+	const char *name;
+	uint8_t from;
+	uint8_t to;
+};
+
+static const struct stage stages[] = {
+	{"iso rx -> sdu queued", DATAPATH_TRACE_ISO_RX_DONE, DATAPATH_TRACE_SDU_QUEUED},
+	{"sdu queued -> decode", DATAPATH_TRACE_SDU_QUEUED, DATAPATH_TRACE_DECODE_START},
+	{"decode", DATAPATH_TRACE_DECODE_START, DATAPATH_TRACE_DECODE_END},
+	{"decode -> audio queued", DATAPATH_TRACE_DECODE_END, DATAPATH_TRACE_AUDIO_QUEUED},
+	{"audio queued -> i2s", DATAPATH_TRACE_AUDIO_QUEUED, DATAPATH_TRACE_I2S_SEND},
+	{"iso rx -> i2s (total)", DATAPATH_TRACE_ISO_RX_DONE, DATAPATH_TRACE_I2S_SEND},
+	{"encode", DATAPATH_TRACE_ENCODE_START, DATAPATH_TRACE_ENCODE_END},
+	{"encode -> iso tx", DATAPATH_TRACE_ENCODE_END, DATAPATH_TRACE_ISO_TX_DONE},
+};
+
+/* Snapshot of the ring, too large for the shell thread stack */
+static struct datapath_trace_entry snapshot[CONFIG_ALIF_BLE_AUDIO_DATAPATH_TRACE_SIZE];
+static struct histogram hist;
+
+static void hist_reset(void)
+{
+	memset(&hist, 0, sizeof(hist));
+	hist.min = UINT32_MAX;
+}
+
+static void hist_add(uint32_t const value)
+{
+	size_t const bucket = value ? MIN(LOG2(value) + 1, HIST_BUCKETS - 1) : 0;
+
+	hist.buckets[bucket]++;
+	hist.count++;
+	hist.sum += value;
+	hist.min = MIN(hist.min, value);
+	hist.max = MAX(hist.max, value);
+}
+
+static void hist_print(const struct shell *sh, const char *const name)
+{
+	if (!hist.count) {
+		return;
+	}
+
+	shell_print(sh, "%s: n %u, min %u us, avg %u us, max %u us", name, hist.count, hist.min,
+		    (uint32_t)(hist.sum / hist.count), hist.max);
+
+	for (size_t i = 0; i < HIST_BUCKETS; i++) {
+		if (!hist.buckets[i]) {
+			continue;
+		}
+
+		if (i == HIST_BUCKETS - 1) {
+			shell_print(sh, "  >= %6u us: %u", (uint32_t)BIT(i - 1), hist.buckets[i]);
+		} else {
+			shell_print(sh, "  < %7u us: %u", (uint32_t)BIT(i), hist.buckets[i]);
+		}
+	}
+}
+
+static void analyse_stage(const struct stage *const stage, size_t const count)
+{
+	hist_reset();
+
+	for (size_t to = 0; to < count; to++) {
+		if (snapshot[to].event != stage->to) {
+			continue;
+		}
+
+		size_t const end = to > MATCH_WINDOW ? to - MATCH_WINDOW : 0;
+
+		for (size_t from = to; from-- > end;) {
+			if (snapshot[from].event == stage->from &&
+			    datapath_trace_same_frame(&snapshot[from], &snapshot[to])) {
+				hist_add(snapshot[to].time_us - snapshot[from].time_us);
+				break;
+			}
+		}
+	}
+}
+
+static void analyse_interval(uint8_t const event, uint8_t const channel, size_t const count)
+{
+	bool have_last = false;
+	uint32_t last_us = 0;
+
+	hist_reset();
+
+	for (size_t i = 0; i < count; i++) {
+		if (snapshot[i].event != event || snapshot[i].channel != channel) {
+			continue;
+		}
+
+		if (have_last) {
+			hist_add(snapshot[i].time_us - last_us);
+		}
+
+		last_us = snapshot[i].time_us;
+		have_last = true;
+	}
+}
+
+static int cmd_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	size_t const count = datapath_trace_snapshot(snapshot, ARRAY_SIZE(snapshot));
+
+	shell_print(sh, "%zu events, %u us", count,
+		    count ? snapshot[count - 1].time_us - snapshot[0].time_us : 0);
+
+	shell_print(sh, "\nStage latency:");
+	for (size_t i = 0; i < ARRAY_SIZE(stages); i++) {
+		analyse_stage(&stages[i], count);
+		hist_print(sh, stages[i].name);
+	}
+
+	/* Interval between consecutive events of each stage, per channel, to show jitter */
+	shell_print(sh, "\nStage intervals:");
+	for (uint8_t event = 0; event < DATAPATH_TRACE_EVENT_COUNT; event++) {
+		uint32_t channels = 0;
+		bool any_channel = false;
+
+		for (size_t i = 0; i < count; i++) {
+			if (snapshot[i].event != event) {
+				continue;
+			}
+			if (snapshot[i].channel == DATAPATH_TRACE_ANY_CHANNEL) {
+				any_channel = true;
+			} else if (snapshot[i].channel < 32) {
+				channels |= BIT(snapshot[i].channel);
+			}
+		}
+
+		if (any_channel) {
+			analyse_interval(event, DATAPATH_TRACE_ANY_CHANNEL, count);
+			hist_print(sh, datapath_trace_event_name(event));
+		}
+
+		for (uint8_t ch = 0; channels; ch++, channels >>= 1) {
+			char name[32];
+
+			if (!(channels & 1)) {
+				continue;
+			}
+
+			snprintf(name, sizeof(name), "%s[%u]", datapath_trace_event_name(event),
+				 ch);
+			analyse_interval(event, ch, count);
+			hist_print(sh, name);
+		}
+	}
+
+	return 0;
+}
+
+static int cmd_dump(const struct shell *sh, size_t argc, char **argv)
+{
+	size_t const count = datapath_trace_snapshot(snapshot, ARRAY_SIZE(snapshot));
+	size_t limit = count;
+
+	if (argc > 1) {
+		limit = MIN(strtoul(argv[1], NULL, 0), count);
+	}
+
+	for (size_t i = count - limit; i < count; i++) {
+		const struct datapath_trace_entry *const e = &snapshot[i];
+		bool const is_correction = e->event == DATAPATH_TRACE_PRES_CORRECTION ||
+					   e->event == DATAPATH_TRACE_RATE_CORRECTION;
+		int32_t const arg = is_correction ? (int16_t)e->arg : e->arg;
+
+		if (e->channel == DATAPATH_TRACE_ANY_CHANNEL) {
+			shell_print(sh, "%10u %-16s  - %6d", e->time_us,
+				    datapath_trace_event_name(e->event), arg);
+		} else {
+			shell_print(sh, "%10u %-16s %2u %6d", e->time_us,
+				    datapath_trace_event_name(e->event), e->channel, arg);
+		}
+	}
+
+	return 0;
+}
+
+static int cmd_clear(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(sh);
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	datapath_trace_clear();
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+	sub_cmds, SHELL_CMD_ARG(stats, NULL, "Stage latency and interval histograms", cmd_stats, 1, 0),
+	SHELL_CMD_ARG(dump, NULL, "Print the newest events: dump [count]", cmd_dump, 1, 1),
+	SHELL_CMD_ARG(clear, NULL, "Discard recorded events", cmd_clear, 1, 0),
+	SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(le_audio_trace, &sub_cmds, "LE audio datapath timing trace", NULL);
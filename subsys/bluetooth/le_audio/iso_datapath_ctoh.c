@@ -14,6 +14,7 @@
 #include <alif_ble.h>
 #include "gapi_isooshm.h"
 #include "iso_datapath_ctoh.h"
+#include "datapath_trace.h"
 
 LOG_MODULE_REGISTER(iso_datapath_ctoh, CONFIG_BLE_AUDIO_LOG_LEVEL);
 
@@ -91,15 +92,26 @@ struct iso_datapath_ctoh {
 	bool awaiting_buffer;
 };
 
-#define TIMESTAMP_DEBUG 0
+#if CONFIG_ALIF_BLE_AUDIO_ADAPTIVE_QUEUE_DEPTH
+/* Record how late the SDU arrived relative to its anchor point, so the consumer can size its
+ * buffering to the jitter of the link
+ */
+INT_RAMFUNC static void record_link_stats(struct sdu_queue *const sdu_queue,
+					  gapi_isooshm_sdu_buf_t const *const p_sdu)
+{
+	if (p_sdu->status != GAPI_ISOOSHM_SDU_STATUS_VALID) {
+		atomic_inc(&sdu_queue->lost);
+		return;
+	}
 
-#if TIMESTAMP_DEBUG
-struct timestamp_debug {
-	size_t timestamp_idx;
-	uint32_t timestamps[128];
-};
-struct timestamp_debug timestamps_debug[CONFIG_ALIF_BLE_AUDIO_NMB_CHANNELS]
-	__attribute__((__used__));
+	uint32_t const now_us = gapi_isooshm_dp_get_local_time();
+	atomic_val_t const delay_us = (int32_t)(now_us - p_sdu->timestamp);
+	atomic_val_t peak_us;
+
+	do {
+		peak_us = atomic_get(&sdu_queue->peak_delay_us);
+	} while (delay_us > peak_us && !atomic_cas(&sdu_queue->peak_delay_us, peak_us, delay_us));
+}
 #endif
 
 INT_RAMFUNC static void finish_last_sdu(struct sdu_queue *sdu_queue,
@@ -110,9 +122,13 @@ INT_RAMFUNC static void finish_last_sdu(struct sdu_queue *sdu_queue,
 	set_test_pin(&test_pin1, 1);
 #endif
 
+#if CONFIG_ALIF_BLE_AUDIO_ADAPTIVE_QUEUE_DEPTH
+	record_link_stats(sdu_queue, p_sdu);
+#endif
+
 	if (p_sdu->status != GAPI_ISOOSHM_SDU_STATUS_VALID) {
 		/* LOG_ERR("Invalid status %u", p_sdu->status); */
-		k_mem_slab_free(&sdu_queue->slab, p_sdu);
+		block_ring_cancel(&sdu_queue->ring, p_sdu);
 #if DT_NODE_EXISTS(GPIO_TEST1_NODE)
 		set_test_pin(&test_pin1, 0);
 #endif
@@ -123,19 +139,11 @@ INT_RAMFUNC static void finish_last_sdu(struct sdu_queue *sdu_queue,
 		LOG_ERR("Invalid timestamp %u", p_sdu->timestamp);
 	}
 
-#if TIMESTAMP_DEBUG
-	struct timestamp_debug *p_debug = &timestamps_debug[stream_id];
+	uint16_t const seq_num = p_sdu->seq_num;
 
-	p_debug->timestamps[p_debug->timestamp_idx++] = p_sdu->timestamp;
-	if (p_debug->timestamp_idx >= ARRAY_SIZE(p_debug->timestamps)) {
-		p_debug->timestamp_idx = 0;
-	}
-#endif
-
-	if (k_msgq_put(&sdu_queue->msgq, (void *)&p_sdu, K_NO_WAIT)) {
-		/* Failed to send for decoding -> just ignore the packet to avoid memory lost */
-		k_mem_slab_free(&sdu_queue->slab, p_sdu);
-	}
+	/* Space for the SDU was reserved when it was acquired, so this cannot fail */
+	block_ring_commit(&sdu_queue->ring, p_sdu);
+	datapath_trace_record(DATAPATH_TRACE_SDU_QUEUED, stream_id, seq_num);
 
 #if DT_NODE_EXISTS(GPIO_TEST1_NODE)
 	set_test_pin(&test_pin1, 0);
@@ -151,10 +159,11 @@ INT_RAMFUNC static int recv_next_sdu(struct iso_datapath_ctoh *const datapath, b
 	set_test_pin(&test_pin1, 1);
 #endif
 
-	/* Allocate a new SDU buffer */
-	int ret = k_mem_slab_alloc(&sdu_queue->slab, (void **)&p_sdu, K_NO_WAIT);
+	/* Acquire a new SDU buffer */
+	int ret = 0;
 
-	if (ret || !p_sdu) {
+	p_sdu = block_ring_acquire(&sdu_queue->ring, K_NO_WAIT);
+	if (!p_sdu) {
 		LOG_ERR("Not enough memory to allocate receiving buffer [ch %u]",
 			datapath->stream_id);
 		datapath->awaiting_buffer = true;
@@ -187,7 +196,7 @@ INT_RAMFUNC static int recv_next_sdu(struct iso_datapath_ctoh *const datapath, b
 	if (err) {
 		LOG_ERR("Failed to set next ISO buffer, err %u", err);
 		datapath->awaiting_buffer = true;
-		k_mem_slab_free(&sdu_queue->slab, p_sdu);
+		block_ring_cancel(&sdu_queue->ring, p_sdu);
 		p_sdu = NULL;
 		ret = -EIO;
 	}
@@ -208,15 +217,21 @@ INT_RAMFUNC static void on_dp_transfer_complete(gapi_isooshm_dp_t *const dp,
 
 	struct iso_datapath_ctoh *const datapath = CONTAINER_OF(dp, struct iso_datapath_ctoh, dp);
 
-	if (!datapath->stop) {
-		recv_next_sdu(datapath, false);
-	}
-
+	/* Finish the last SDU before acquiring the next one. Blocks leave the SDU ring in order,
+	 * so an invalid SDU can only be returned while it is the newest acquired block. Both
+	 * operations are lock-free so this adds no noticeable delay to re-arming the datapath.
+	 */
 	if (buf) {
+		datapath_trace_record(DATAPATH_TRACE_ISO_RX_DONE, datapath->stream_id,
+				      buf->seq_num);
 		finish_last_sdu(datapath->sdu_queue, buf, datapath->stream_id,
 				datapath->start_timestamp_us);
 	}
 
+	if (!datapath->stop) {
+		recv_next_sdu(datapath, false);
+	}
+
 #if DT_NODE_EXISTS(GPIO_TEST0_NODE)
 	set_test_pin(&test_pin0, 0);
 #endif
@@ -253,8 +268,8 @@ static int iso_datapath_ctoh_unbind(struct iso_datapath_ctoh *const datapath)
 	gapi_isooshm_dp_unbind(&datapath->dp, &pending_buffer);
 
 	if (pending_buffer) {
-		/* Free the buffer that was pending in the datapath */
-		k_mem_slab_free(&datapath->sdu_queue->slab, pending_buffer);
+		/* Return the buffer that was pending in the datapath */
+		block_ring_cancel(&datapath->sdu_queue->ring, pending_buffer);
 	}
 
 	return 0;
@@ -15,6 +15,7 @@
 #include "gapi_isooshm.h"
 #include "iso_datapath_htoc.h"
 #include "presentation_compensation.h"
+#include "datapath_trace.h"
 
 LOG_MODULE_REGISTER(iso_datapath_htoc, CONFIG_BLE_AUDIO_LOG_LEVEL);
 
@@ -91,12 +92,29 @@ struct sdu_timing_info {
 	uint16_t seq_num;
 };
 
+INT_RAMFUNC static void flush_old_sdus(struct sdu_queue *const sdu_queue)
+{
+	atomic_val_t requested = atomic_clear(&sdu_queue->flush_request);
+
+	/* Called with no SDU outstanding, so the discarded SDUs are released in order. One SDU
+	 * is dropped per request, and the newest is always kept to be sent.
+	 */
+	while (requested-- > 0 && block_ring_num_used(&sdu_queue->ring) > 1) {
+		void *const p_sdu = block_ring_get(&sdu_queue->ring, K_NO_WAIT);
+
+		block_ring_release(&sdu_queue->ring, p_sdu);
+		atomic_inc(&sdu_queue->flushed);
+	}
+}
+
 INT_RAMFUNC static void send_next_sdu(struct iso_datapath_htoc *const datapath, bool const lock)
 {
-	void *p_sdu = NULL;
-	int ret = k_msgq_get(&datapath->sdu_queue->msgq, (void *)&p_sdu, K_NO_WAIT);
+	flush_old_sdus(datapath->sdu_queue);
+
+	void *p_sdu = block_ring_get(&datapath->sdu_queue->ring, K_NO_WAIT);
+	int ret;
 
-	if (ret || !p_sdu) {
+	if (!p_sdu) {
 		datapath->awaiting_sdu = true;
 		return;
 	}
@@ -118,8 +136,8 @@ INT_RAMFUNC static void send_next_sdu(struct iso_datapath_htoc *const datapath,
 		return;
 	}
 
-	/* Free current current block (just ignore) and wait next trigger for retry */
-	k_mem_slab_free(&datapath->sdu_queue->slab, p_sdu);
+	/* Release current block (just ignore) and wait next trigger for retry */
+	block_ring_release(&datapath->sdu_queue->ring, p_sdu);
 	datapath->awaiting_sdu = true;
 
 	LOG_ERR("Failed to set next ISO buffer, err %u", ret);
@@ -134,12 +152,15 @@ INT_RAMFUNC static void on_dp_transfer_complete(gapi_isooshm_dp_t *const dp,
 
 	struct iso_datapath_htoc *const datapath = CONTAINER_OF(dp, struct iso_datapath_htoc, dp);
 
-	send_next_sdu(datapath, false);
-
+	/* Release the sent SDU first, blocks must be returned to the SDU ring in order */
 	if (buf) {
-		k_mem_slab_free(&datapath->sdu_queue->slab, buf);
+		datapath_trace_record(DATAPATH_TRACE_ISO_TX_DONE, datapath->stream_id,
+				      buf->seq_num);
+		block_ring_release(&datapath->sdu_queue->ring, buf);
 	}
 
+	send_next_sdu(datapath, false);
+
 #if DT_NODE_EXISTS(GPIO_TEST0_NODE)
 	set_test_pin(&test_pin0, 0);
 #endif
@@ -255,8 +276,8 @@ int iso_datapath_htoc_unbind(struct iso_datapath_htoc *const datapath)
 	gapi_isooshm_dp_unbind(&datapath->dp, &pending_buffer);
 
 	if (pending_buffer) {
-		/* Free the buffer that was pending in the datapath */
-		k_mem_slab_free(&datapath->sdu_queue->slab, pending_buffer);
+		/* Release the buffer that was pending in the datapath */
+		block_ring_release(&datapath->sdu_queue->ring, pending_buffer);
 	}
 
 	return 0;
@@ -10,8 +10,10 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/drivers/clock_control.h>
+#include <zephyr/sys/util.h>
 #include <string.h>
 #include "presentation_compensation.h"
+#include "datapath_trace.h"
 
 LOG_MODULE_REGISTER(presentation_compensation, CONFIG_BLE_AUDIO_LOG_LEVEL);
 
@@ -26,6 +28,15 @@ LOG_MODULE_REGISTER(presentation_compensation, CONFIG_BLE_AUDIO_LOG_LEVEL);
 BUILD_ASSERT(CONFIG_PRESENTATION_COMPENSATION_CORRECTION_FACTOR != 0,
 	     "Correction factor cannot be zero");
 
+/* Saturation limit of the PI controller output, in ppm when driving a sample-rate converter or in
+ * Hz when driving the audio clock
+ */
+#ifdef CONFIG_PRESENTATION_COMPENSATION_ASRC
+#define PI_OUTPUT_MAX CONFIG_PRESENTATION_COMPENSATION_ASRC_MAX_PPM
+#else
+#define PI_OUTPUT_MAX CONFIG_PRESENTATION_COMPENSATION_MAX_DELTA_F
+#endif
+
 struct presentation_compensation_stats {
 	int32_t err_max;
 	int32_t err_min;
@@ -40,6 +51,10 @@ struct presentation_compensation_env {
 	const struct device *clock_dev;
 	uint32_t target_delay_us;
 	presentation_compensation_cb_t cb;
+#ifdef CONFIG_PRESENTATION_COMPENSATION_ASRC
+	presentation_compensation_ratio_cb_t ratio_cb;
+	int32_t last_ratio_ppm;
+#endif
 	float integrator;
 	uint32_t initial_freq;
 	uint32_t last_freq;
@@ -71,14 +86,23 @@ static void reset_stats(void)
 int presentation_compensation_configure(const struct device *clock_dev,
 					uint32_t presentation_delay_us)
 {
+	env.target_delay_us = presentation_delay_us;
+	env.integrator = 0.0f;
+
+#ifdef CONFIG_PRESENTATION_COMPENSATION_ASRC
+	/* Drift is absorbed by a sample-rate converter, the audio clock is left untouched */
+	ARG_UNUSED(clock_dev);
+	env.clock_dev = NULL;
+	env.initial_freq = 0;
+	env.last_freq = 0;
+	env.last_ratio_ppm = 0;
+#else
 	if (!device_is_ready(clock_dev)) {
 		LOG_ERR("Clock device is not ready");
 		return -ENODEV;
 	}
 
 	env.clock_dev = clock_dev;
-	env.target_delay_us = presentation_delay_us;
-	env.integrator = 0.0f;
 
 	uint32_t clock_rate;
 	int ret = clock_control_get_rate(clock_dev, NULL, &clock_rate);
@@ -90,6 +114,7 @@ int presentation_compensation_configure(const struct device *clock_dev,
 
 	env.initial_freq = clock_rate / CONFIG_AUDIO_CLOCK_DIVIDER;
 	env.last_freq = env.initial_freq;
+#endif
 
 #ifdef CONFIG_PRESENTATION_COMPENSATION_PRINT_STATS
 	reset_stats();
@@ -100,6 +125,7 @@ int presentation_compensation_configure(const struct device *clock_dev,
 	return 0;
 }
 
+#ifndef CONFIG_PRESENTATION_COMPENSATION_ASRC
 static void adjust_clock(int32_t delta_f)
 {
 	uint32_t freq = env.initial_freq + delta_f;
@@ -146,6 +172,26 @@ static void adjust_clock(int32_t delta_f)
 
 	env.last_freq = freq;
 }
+#endif
+
+#ifdef CONFIG_PRESENTATION_COMPENSATION_ASRC
+static void adjust_ratio(int32_t ratio_ppm)
+{
+	if (ratio_ppm == env.last_ratio_ppm) {
+		/* No adjustment required */
+		return;
+	}
+
+	if (env.ratio_cb) {
+		env.ratio_cb(ratio_ppm);
+	}
+
+	datapath_trace_record(DATAPATH_TRACE_RATE_CORRECTION, DATAPATH_TRACE_ANY_CHANNEL,
+			      (uint16_t)ratio_ppm);
+
+	env.last_ratio_ppm = ratio_ppm;
+}
+#endif
 
 static float run_clock_pi_controller(int32_t err)
 {
@@ -171,10 +217,10 @@ static float run_clock_pi_controller(int32_t err)
 	output = Kp * err + Ki * env.integrator;
 
 	/* Saturate the output */
-	if (output > CONFIG_PRESENTATION_COMPENSATION_MAX_DELTA_F) {
-		output_saturated = CONFIG_PRESENTATION_COMPENSATION_MAX_DELTA_F;
-	} else if (output < -CONFIG_PRESENTATION_COMPENSATION_MAX_DELTA_F) {
-		output_saturated = -CONFIG_PRESENTATION_COMPENSATION_MAX_DELTA_F;
+	if (output > PI_OUTPUT_MAX) {
+		output_saturated = PI_OUTPUT_MAX;
+	} else if (output < -PI_OUTPUT_MAX) {
+		output_saturated = -PI_OUTPUT_MAX;
 	} else {
 		output_saturated = output;
 	}
@@ -192,7 +238,11 @@ static float run_clock_pi_controller(int32_t err)
 		env.integrator += err * SECONDS_PER_FRAME;
 	}
 
+#ifdef CONFIG_PRESENTATION_COMPENSATION_ASRC
+	adjust_ratio(output_saturated);
+#else
 	adjust_clock(output_saturated);
+#endif
 	return output_saturated;
 }
 
@@ -281,6 +331,9 @@ void presentation_compensation_notify_timing(uint32_t presentation_delay_us)
 		env.cb(correction);
 	}
 
+	datapath_trace_record(DATAPATH_TRACE_PRES_CORRECTION, DATAPATH_TRACE_ANY_CHANNEL,
+			      (uint16_t)CLAMP(correction, INT16_MIN, INT16_MAX));
+
 #ifdef CONFIG_PRESENTATION_COMPENSATION_PRINT_STATS
 	update_stats(presentation_error_us, correction);
 #endif
@@ -297,6 +350,19 @@ int presentation_compensation_register_cb(presentation_compensation_cb_t cb)
 	return 0;
 }
 
+#ifdef CONFIG_PRESENTATION_COMPENSATION_ASRC
+int presentation_compensation_register_ratio_cb(presentation_compensation_ratio_cb_t cb)
+{
+	if (cb == NULL) {
+		return -EINVAL;
+	}
+
+	env.ratio_cb = cb;
+
+	return 0;
+}
+#endif
+
 #ifdef CONFIG_PRESENTATION_COMPENSATION_DEBUG
 int presentation_compensation_register_debug_cb(presentation_comp_debug_cb_t cb)
 {
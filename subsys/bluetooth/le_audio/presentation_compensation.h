@@ -25,11 +25,23 @@
  */
 typedef void (*presentation_compensation_cb_t)(int32_t correction_us);
 
+/**
+ * @brief Presentation compensation ratio callback signature
+ *
+ * Used instead of adjusting the audio clock when CONFIG_PRESENTATION_COMPENSATION_ASRC is enabled,
+ * to notify listeners of the rate at which audio should be consumed. A positive number indicates
+ * that audio should be consumed faster than nominal, reducing presentation delay.
+ *
+ * @param ratio_ppm Deviation from the nominal rate in parts per million
+ */
+typedef void (*presentation_compensation_ratio_cb_t)(int32_t ratio_ppm);
+
 /**
  * @brief Configure the presentation compensation module
  *
  * @param clock_dev The clock device used to adjust audio playback speed. This device must support
- * the clock_control.h API.
+ * the clock_control.h API. Unused, and may be NULL, if CONFIG_PRESENTATION_COMPENSATION_ASRC is
+ * enabled.
  * @param presentation_delay_us The target presentation delay in microseconds
  *
  * @retval 0 if successful
@@ -57,6 +69,18 @@ void presentation_compensation_notify_timing(uint32_t presentation_delay_us);
  */
 int presentation_compensation_register_cb(presentation_compensation_cb_t cb);
 
+#ifdef CONFIG_PRESENTATION_COMPENSATION_ASRC
+/**
+ * @brief Register a callback to be notified of the sample-rate conversion ratio to apply
+ *
+ * @param cb Callback to register
+ *
+ * @retval 0 if successful
+ * @retval Negative error code on failure
+ */
+int presentation_compensation_register_ratio_cb(presentation_compensation_ratio_cb_t cb);
+#endif
+
 #ifdef CONFIG_PRESENTATION_COMPENSATION_DEBUG
 struct presentation_comp_debug_data {
 	int32_t err_us;
@@ -23,8 +23,7 @@ struct sdu_queue *sdu_queue_create(size_t item_count, size_t payload_size)
 	/* Each item must be 4-byte aligned */
 	size_t padded_size = ROUND_UP(item_size, 4);
 
-	size_t total_size = sizeof(struct sdu_queue) + (item_count * padded_size) +
-			    (item_count * sizeof(void *));
+	size_t total_size = sizeof(struct sdu_queue) + (item_count * padded_size);
 
 	struct sdu_queue *hdr = (struct sdu_queue *)malloc(total_size);
 
@@ -40,19 +39,15 @@ struct sdu_queue *sdu_queue_create(size_t item_count, size_t payload_size)
 		return NULL;
 	}
 
-	int ret = k_mem_slab_init(&hdr->slab, hdr->buf, padded_size, item_count);
-
-	if (ret) {
-		free(hdr);
-		LOG_ERR("Failed to initialise SDU queue mem slab");
-		return NULL;
-	}
-
-	k_msgq_init(&hdr->msgq, hdr->buf + (item_count * padded_size), sizeof(void *), item_count);
+	block_ring_init(&hdr->ring, hdr->buf, padded_size, item_count);
 
 	hdr->payload_size = payload_size;
 	hdr->item_count = item_count;
 	hdr->item_size = item_size;
+	atomic_set(&hdr->peak_delay_us, 0);
+	atomic_set(&hdr->lost, 0);
+	atomic_set(&hdr->flush_request, 0);
+	atomic_set(&hdr->flushed, 0);
 
 	return hdr;
 }
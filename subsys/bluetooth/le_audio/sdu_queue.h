@@ -11,13 +11,28 @@
 #define _SDU_QUEUE_H
 
 #include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include "block_ring.h"
 
+/**
+ * SDUs are passed from producer to consumer through a lock-free block ring. The producer acquires
+ * an SDU from the ring and commits it once filled, the consumer gets it and releases it when done.
+ */
 struct sdu_queue {
 	size_t item_count;
 	size_t item_size;
 	size_t payload_size;
-	struct k_mem_slab slab;
-	struct k_msgq msgq;
+	/* Largest delay from SDU anchor point to reception, and number of SDUs lost. Updated by the
+	 * ISO datapath as SDUs arrive and cleared by the consumer when read.
+	 */
+	atomic_t peak_delay_us;
+	atomic_t lost;
+	/* Incremented by the producer to have the consumer discard that many of the oldest queued
+	 * SDUs, and the number of SDUs discarded this way
+	 */
+	atomic_t flush_request;
+	atomic_t flushed;
+	struct block_ring ring;
 	uint8_t buf[];
 };
 
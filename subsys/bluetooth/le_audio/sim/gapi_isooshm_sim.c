@@ -0,0 +1,328 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
+#include "gapi_isooshm.h"
+#include "alif_ble.h"
+
+LOG_MODULE_REGISTER(gapi_isooshm_sim, CONFIG_BLE_AUDIO_LOG_LEVEL);
+
+static const struct gapi_isooshm_sim_trace default_trace = {
+	.interval_us = 10000,
+	.sdu_len = 100,
+	.seed = 1,
+};
+
+static const struct gapi_isooshm_sim_trace *trace = &default_trace;
+static gapi_isooshm_sim_sdu_hook_t output_hook;
+static gapi_isooshm_sim_sdu_hook_t input_hook;
+static struct gapi_isooshm_sim_stream_stats stream_stats[CONFIG_ALIF_BLE_AUDIO_SIM_MAX_STREAMS];
+static uint32_t rand_state = 1;
+static struct k_spinlock lock;
+
+K_MUTEX_DEFINE(ble_mutex);
+
+static uint32_t sim_rand(void)
+{
+	/* xorshift32, deterministic for a given trace seed */
+	uint32_t x = rand_state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	rand_state = x;
+
+	return x;
+}
+
+static bool chance(uint16_t const permille)
+{
+	return permille && (sim_rand() % 1000) < permille;
+}
+
+static void generate_output_event(gapi_isooshm_dp_t *const dp)
+{
+	uint32_t delay_us;
+	uint8_t status = GAPI_ISOOSHM_SDU_STATUS_VALID;
+
+	if (trace->events && trace->num_events) {
+		const struct gapi_isooshm_sim_trace_event *const event =
+			&trace->events[dp->trace_idx++ % trace->num_events];
+
+		delay_us = event->delay_us;
+		status = event->status;
+	} else {
+		bool in_burst = false;
+
+		if (dp->burst_left) {
+			dp->burst_left--;
+			in_burst = true;
+		} else if (trace->burst_len && chance(trace->burst_permille)) {
+			dp->burst_left = trace->burst_len - 1;
+			in_burst = true;
+		}
+
+		delay_us = trace->delay_us;
+		if (trace->jitter_us) {
+			delay_us += sim_rand() % (trace->jitter_us + 1);
+		}
+
+		if (in_burst) {
+			delay_us += trace->burst_delay_us;
+		}
+
+		if (chance(in_burst ? trace->burst_loss_permille : trace->loss_permille)) {
+			status = GAPI_ISOOSHM_SDU_STATUS_LOST;
+		}
+	}
+
+	/* SDUs are delivered in order, so a late SDU holds back the ones behind it */
+	dp->event_us = MAX(dp->anchor_us + delay_us, dp->event_us);
+	dp->event_status = status;
+}
+
+static void on_output_event(gapi_isooshm_dp_t *const dp)
+{
+	struct gapi_isooshm_sim_stream_stats *const stats = &stream_stats[dp->stream_lid];
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	gapi_isooshm_sdu_buf_t *const buf = dp->buf;
+
+	dp->buf = NULL;
+	k_spin_unlock(&lock, key);
+
+	stats->anchors++;
+	if (dp->event_status != GAPI_ISOOSHM_SDU_STATUS_VALID) {
+		stats->lost++;
+	}
+
+	if (!buf) {
+		stats->overflows++;
+	} else {
+		bool const valid = dp->event_status == GAPI_ISOOSHM_SDU_STATUS_VALID;
+
+		buf->status = dp->event_status;
+		buf->seq_num = dp->seq_num;
+		buf->timestamp = (uint32_t)dp->anchor_us;
+		buf->has_timestamp = true;
+		buf->sdu_len = valid ? MIN(buf->sdu_len, trace->sdu_len) : 0;
+
+		if (valid) {
+			stats->sdus++;
+			if (output_hook) {
+				output_hook(dp->stream_lid, buf, (uint32_t)dp->anchor_us);
+			}
+		}
+
+		dp->cb(dp, buf);
+	}
+
+	dp->seq_num++;
+	dp->anchor_us += trace->interval_us;
+	generate_output_event(dp);
+	k_timer_start(&dp->timer, K_TIMEOUT_ABS_US(dp->event_us), K_NO_WAIT);
+}
+
+static void on_input_event(gapi_isooshm_dp_t *const dp)
+{
+	struct gapi_isooshm_sim_stream_stats *const stats = &stream_stats[dp->stream_lid];
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	gapi_isooshm_sdu_buf_t *const buf = dp->buf;
+
+	dp->buf = NULL;
+	k_spin_unlock(&lock, key);
+
+	stats->anchors++;
+
+	if (!buf) {
+		stats->underruns++;
+	} else {
+		stats->sdus++;
+		if (dp->has_sync) {
+			stats->max_seq_step = MAX(stats->max_seq_step,
+						  (uint16_t)(buf->seq_num - dp->sync.seq_num));
+		}
+		dp->sync.seq_num = buf->seq_num;
+		dp->sync.sdu_anchor = (uint32_t)dp->anchor_us;
+		dp->has_sync = true;
+
+		if (input_hook) {
+			input_hook(dp->stream_lid, buf, (uint32_t)dp->anchor_us);
+		}
+
+		dp->cb(dp, buf);
+	}
+
+	dp->anchor_us += trace->interval_us;
+	k_timer_start(&dp->timer, K_TIMEOUT_ABS_US(dp->anchor_us), K_NO_WAIT);
+}
+
+static void on_timer_expiry(struct k_timer *timer)
+{
+	gapi_isooshm_dp_t *const dp = CONTAINER_OF(timer, gapi_isooshm_dp_t, timer);
+
+	if (!dp->bound) {
+		return;
+	}
+
+	if (dp->direction == GAPI_DP_DIRECTION_OUTPUT) {
+		on_output_event(dp);
+	} else {
+		on_input_event(dp);
+	}
+}
+
+uint16_t gapi_isooshm_dp_init(gapi_isooshm_dp_t *const dp, gapi_isooshm_dp_cb_t const cb)
+{
+	if (!dp || !cb) {
+		return GAP_ERR_INVALID_PARAM;
+	}
+
+	memset(dp, 0, sizeof(*dp));
+	dp->cb = cb;
+	k_timer_init(&dp->timer, on_timer_expiry, NULL);
+
+	return GAP_ERR_NO_ERROR;
+}
+
+uint16_t gapi_isooshm_dp_bind(gapi_isooshm_dp_t *const dp, uint8_t const stream_lid,
+			      uint8_t const direction)
+{
+	if (!dp || stream_lid >= ARRAY_SIZE(stream_stats)) {
+		return GAP_ERR_INVALID_PARAM;
+	}
+
+	if (dp->bound) {
+		return GAP_ERR_COMMAND_DISALLOWED;
+	}
+
+	dp->stream_lid = stream_lid;
+	dp->direction = direction;
+	dp->buf = NULL;
+	dp->seq_num = 0;
+	dp->has_sync = false;
+	dp->trace_idx = 0;
+	dp->burst_left = 0;
+	dp->anchor_us = k_ticks_to_us_floor64(k_uptime_ticks()) + trace->interval_us;
+	dp->event_us = 0;
+	dp->bound = true;
+
+	if (direction == GAPI_DP_DIRECTION_OUTPUT) {
+		generate_output_event(dp);
+		k_timer_start(&dp->timer, K_TIMEOUT_ABS_US(dp->event_us), K_NO_WAIT);
+	} else {
+		k_timer_start(&dp->timer, K_TIMEOUT_ABS_US(dp->anchor_us), K_NO_WAIT);
+	}
+
+	return GAP_ERR_NO_ERROR;
+}
+
+uint16_t gapi_isooshm_dp_unbind(gapi_isooshm_dp_t *const dp, gapi_isooshm_sdu_buf_t **const pp_buf)
+{
+	if (!dp || !dp->bound) {
+		return GAP_ERR_COMMAND_DISALLOWED;
+	}
+
+	k_timer_stop(&dp->timer);
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	dp->bound = false;
+	if (pp_buf) {
+		*pp_buf = dp->buf;
+	}
+	dp->buf = NULL;
+
+	k_spin_unlock(&lock, key);
+
+	return GAP_ERR_NO_ERROR;
+}
+
+uint16_t gapi_isooshm_dp_set_buf(gapi_isooshm_dp_t *const dp, gapi_isooshm_sdu_buf_t *const buf)
+{
+	uint16_t err = GAP_ERR_NO_ERROR;
+
+	if (!dp || !buf) {
+		return GAP_ERR_INVALID_PARAM;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (!dp->bound || dp->buf) {
+		err = GAP_ERR_COMMAND_DISALLOWED;
+	} else {
+		dp->buf = buf;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return err;
+}
+
+uint16_t gapi_isooshm_dp_get_sync(gapi_isooshm_dp_t *const dp, gapi_isooshm_sdu_sync_t *const sync)
+{
+	if (!dp || !sync || !dp->has_sync) {
+		return GAP_ERR_COMMAND_DISALLOWED;
+	}
+
+	*sync = dp->sync;
+
+	return GAP_ERR_NO_ERROR;
+}
+
+uint32_t gapi_isooshm_dp_get_local_time(void)
+{
+	return (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+void gapi_isooshm_sim_configure(const struct gapi_isooshm_sim_trace *const new_trace)
+{
+	trace = new_trace ? new_trace : &default_trace;
+	rand_state = trace->seed ? trace->seed : 1;
+}
+
+void gapi_isooshm_sim_set_hooks(gapi_isooshm_sim_sdu_hook_t const new_output_hook,
+				gapi_isooshm_sim_sdu_hook_t const new_input_hook)
+{
+	output_hook = new_output_hook;
+	input_hook = new_input_hook;
+}
+
+int gapi_isooshm_sim_get_stats(uint8_t const stream_lid,
+			       struct gapi_isooshm_sim_stream_stats *const stats, bool const clear)
+{
+	if (stream_lid >= ARRAY_SIZE(stream_stats)) {
+		return -EINVAL;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (stats) {
+		*stats = stream_stats[stream_lid];
+	}
+	if (clear) {
+		memset(&stream_stats[stream_lid], 0, sizeof(stream_stats[stream_lid]));
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+int alif_ble_mutex_lock(k_timeout_t const timeout)
+{
+	return k_mutex_lock(&ble_mutex, timeout);
+}
+
+void alif_ble_mutex_unlock(void)
+{
+	k_mutex_unlock(&ble_mutex);
+}
@@ -0,0 +1,24 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#ifndef _ALIF_BLE_SIM_H
+#define _ALIF_BLE_SIM_H
+
+#include <zephyr/kernel.h>
+
+/**
+ * @brief Lock the BLE host stack
+ *
+ * In simulation this only serialises callers, there is no host stack behind it.
+ */
+int alif_ble_mutex_lock(k_timeout_t timeout);
+
+void alif_ble_mutex_unlock(void);
+
+#endif /* _ALIF_BLE_SIM_H */
@@ -0,0 +1,22 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#ifndef _ALIF_LC3_SIM_H
+#define _ALIF_LC3_SIM_H
+
+#include "lc3_api.h"
+
+/**
+ * @brief Initialise the LC3 codec
+ *
+ * @retval 0 if successful
+ */
+int alif_lc3_init(void);
+
+#endif /* _ALIF_LC3_SIM_H */
@@ -0,0 +1,177 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#ifndef _GAPI_ISOOSHM_SIM_H
+#define _GAPI_ISOOSHM_SIM_H
+
+/**
+ * @file
+ * @brief Simulated ISO over shared memory datapath
+ *
+ * Provides the subset of the controller ISO datapath API used by the LE audio datapath, for
+ * builds with CONFIG_ALIF_BLE_AUDIO_SIM. Each bound stream is serviced on a simulated ISO
+ * interval. Output (controller to host) streams deliver SDUs according to a trace configured with
+ * @ref gapi_isooshm_sim_configure, and input (host to controller) streams consume the pending SDU
+ * at every SDU anchor point.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <zephyr/kernel.h>
+
+#define GAP_ERR_NO_ERROR           0x00
+#define GAP_ERR_INVALID_PARAM      0x40
+#define GAP_ERR_COMMAND_DISALLOWED 0x43
+
+enum gapi_dp_direction {
+	GAPI_DP_DIRECTION_INPUT = 0,
+	GAPI_DP_DIRECTION_OUTPUT = 1,
+};
+
+enum gapi_isooshm_sdu_status {
+	GAPI_ISOOSHM_SDU_STATUS_VALID = 0,
+	GAPI_ISOOSHM_SDU_STATUS_ERROR,
+	GAPI_ISOOSHM_SDU_STATUS_LOST,
+};
+
+typedef struct gapi_isooshm_sdu_buf {
+	uint32_t timestamp;
+	uint16_t seq_num;
+	uint16_t sdu_len;
+	uint8_t status;
+	bool has_timestamp;
+	uint8_t data[] __aligned(4);
+} gapi_isooshm_sdu_buf_t;
+
+typedef struct gapi_isooshm_sdu_sync {
+	uint32_t sdu_anchor;
+	uint16_t seq_num;
+} gapi_isooshm_sdu_sync_t;
+
+typedef struct gapi_isooshm_dp gapi_isooshm_dp_t;
+
+typedef void (*gapi_isooshm_dp_cb_t)(gapi_isooshm_dp_t *dp, gapi_isooshm_sdu_buf_t *buf);
+
+struct gapi_isooshm_dp {
+	gapi_isooshm_dp_cb_t cb;
+	/* Buffer provided by the host for the next SDU */
+	gapi_isooshm_sdu_buf_t *buf;
+	gapi_isooshm_sdu_sync_t sync;
+	struct k_timer timer;
+	/* Anchor point of the current SDU, and the time it is delivered (output streams) */
+	int64_t anchor_us;
+	int64_t event_us;
+	uint16_t seq_num;
+	uint8_t event_status;
+	uint8_t stream_lid;
+	uint8_t direction;
+	bool bound;
+	bool has_sync;
+	/* Trace state of an output stream */
+	uint32_t trace_idx;
+	uint32_t burst_left;
+};
+
+uint16_t gapi_isooshm_dp_init(gapi_isooshm_dp_t *dp, gapi_isooshm_dp_cb_t cb);
+
+uint16_t gapi_isooshm_dp_bind(gapi_isooshm_dp_t *dp, uint8_t stream_lid, uint8_t direction);
+
+uint16_t gapi_isooshm_dp_unbind(gapi_isooshm_dp_t *dp, gapi_isooshm_sdu_buf_t **pp_buf);
+
+uint16_t gapi_isooshm_dp_set_buf(gapi_isooshm_dp_t *dp, gapi_isooshm_sdu_buf_t *buf);
+
+uint16_t gapi_isooshm_dp_get_sync(gapi_isooshm_dp_t *dp, gapi_isooshm_sdu_sync_t *sync);
+
+uint32_t gapi_isooshm_dp_get_local_time(void);
+
+/** One SDU of a recorded trace */
+struct gapi_isooshm_sim_trace_event {
+	/** Delay from the SDU anchor point until the SDU is delivered to the host */
+	uint32_t delay_us;
+	/** @ref enum gapi_isooshm_sdu_status of the SDU */
+	uint8_t status;
+};
+
+/** Trace used to generate SDUs on simulated output streams */
+struct gapi_isooshm_sim_trace {
+	/** SDU interval in microseconds */
+	uint32_t interval_us;
+	/** Payload length of each SDU */
+	uint16_t sdu_len;
+	/** Fixed delay from SDU anchor to delivery to the host */
+	uint32_t delay_us;
+	/** Maximum random delay added on top of the fixed delay */
+	uint32_t jitter_us;
+	/** Probability of an SDU being lost outside of a burst, in parts per thousand */
+	uint16_t loss_permille;
+	/** Probability of a burst starting at each SDU, in parts per thousand */
+	uint16_t burst_permille;
+	/** Number of SDUs in each burst */
+	uint16_t burst_len;
+	/** Probability of an SDU being lost inside a burst, in parts per thousand */
+	uint16_t burst_loss_permille;
+	/** Additional delay of SDUs inside a burst */
+	uint32_t burst_delay_us;
+	/** Seed of the pseudo-random generator */
+	uint32_t seed;
+	/** Recorded trace to replay instead of generating one, repeated when exhausted */
+	const struct gapi_isooshm_sim_trace_event *events;
+	size_t num_events;
+};
+
+/** Counters of a simulated stream */
+struct gapi_isooshm_sim_stream_stats {
+	/** SDU anchor points passed */
+	uint32_t anchors;
+	/** SDUs delivered to or taken from the host */
+	uint32_t sdus;
+	/** Output SDUs marked lost or in error by the trace */
+	uint32_t lost;
+	/** Output SDUs dropped since the host had no buffer ready */
+	uint32_t overflows;
+	/** Input anchor points with no SDU ready from the host */
+	uint32_t underruns;
+	/** Largest step between the sequence numbers of consecutive input SDUs */
+	uint16_t max_seq_step;
+};
+
+/**
+ * @brief Set the trace used to generate SDUs on output streams bound from now on
+ *
+ * @param trace Trace configuration, must remain valid while streams are bound
+ */
+void gapi_isooshm_sim_configure(const struct gapi_isooshm_sim_trace *trace);
+
+/**
+ * @brief Hook called when an SDU passes through the simulated controller
+ *
+ * For output streams it is called just before the SDU is delivered and may write the payload,
+ * for input streams it is called with the SDU taken from the host at its anchor point.
+ *
+ * @param stream_lid Stream the SDU belongs to
+ * @param sdu SDU buffer
+ * @param anchor_us SDU anchor point in local time
+ */
+typedef void (*gapi_isooshm_sim_sdu_hook_t)(uint8_t stream_lid, gapi_isooshm_sdu_buf_t *sdu,
+					    uint32_t anchor_us);
+
+void gapi_isooshm_sim_set_hooks(gapi_isooshm_sim_sdu_hook_t output_hook,
+				gapi_isooshm_sim_sdu_hook_t input_hook);
+
+/**
+ * @brief Get and optionally clear the counters of a stream
+ *
+ * @retval 0 if successful
+ * @retval -EINVAL if the stream is unknown
+ */
+int gapi_isooshm_sim_get_stats(uint8_t stream_lid, struct gapi_isooshm_sim_stream_stats *stats,
+			       bool clear);
+
+#endif /* _GAPI_ISOOSHM_SIM_H */
@@ -0,0 +1,69 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#ifndef _LC3_API_SIM_H
+#define _LC3_API_SIM_H
+
+/**
+ * @file
+ * @brief Simulated LC3 codec
+ *
+ * Provides the LC3 API used by the LE audio encoder and decoder for builds with
+ * CONFIG_ALIF_BLE_AUDIO_SIM. No audio is coded: the encoder stores the first PCM sample of each
+ * frame in the payload and the decoder fills the frame with the sample stored in the payload, so
+ * that individual frames can be followed through the pipeline. Each call busy-waits for the
+ * configured codec execution time.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {
+	FRAME_DURATION_7_5_MS = 0,
+	FRAME_DURATION_10_MS = 1,
+} lc3_frame_duration_t;
+
+typedef struct {
+	uint32_t sample_rate;
+	uint32_t frame_duration;
+	uint16_t frame_samples;
+} lc3_cfg_t;
+
+typedef struct {
+	int16_t last_sample;
+} lc3_decoder_t;
+
+typedef struct {
+	uint32_t frames;
+} lc3_encoder_t;
+
+/* Number of payload bytes used to carry the frame marker */
+#define LC3_SIM_MARKER_LEN sizeof(int16_t)
+
+int32_t lc3_api_configure(lc3_cfg_t *cfg, uint32_t sample_rate, uint32_t frame_duration);
+
+size_t lc3_api_decoder_scratch_size(const lc3_cfg_t *cfg);
+
+size_t lc3_api_decoder_status_size(const lc3_cfg_t *cfg);
+
+int32_t lc3_api_initialise_decoder(const lc3_cfg_t *cfg, lc3_decoder_t *decoder, void *status);
+
+int32_t lc3_api_decode_frame(const lc3_cfg_t *cfg, lc3_decoder_t *decoder, const uint8_t *input,
+			     uint16_t input_len, bool bad_frame, uint8_t *bec_detect,
+			     int16_t *output, int32_t *scratch);
+
+size_t lc3_api_encoder_scratch_size(const lc3_cfg_t *cfg);
+
+int32_t lc3_api_initialise_encoder(const lc3_cfg_t *cfg, lc3_encoder_t *encoder);
+
+int32_t lc3_api_encode_frame(const lc3_cfg_t *cfg, lc3_encoder_t *encoder, const int16_t *input,
+			     uint8_t *output, uint16_t output_len, int32_t *scratch);
+
+#endif /* _LC3_API_SIM_H */
@@ -0,0 +1,101 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#ifndef _LE_AUDIO_SIM_H
+#define _LE_AUDIO_SIM_H
+
+/**
+ * @file
+ * @brief Measurement harness for the simulated LE audio datapath
+ *
+ * Tags every SDU and audio block passing through the simulated controller and emulated I2S device
+ * with a marker that the simulated codec carries through the encoder and decoder, and uses it to
+ * measure the latency of each frame through the pipeline:
+ *  - Sink latency: from the SDU anchor point until the first sample of the decoded frame is
+ *    played out on I2S.
+ *  - Source latency: from capture of the first sample of a block on I2S until the SDU encoded
+ *    from it is consumed at its anchor point.
+ *
+ * Queue occupancy is sampled every millisecond from the rings registered with
+ * @ref le_audio_sim_watch_queue.
+ */
+
+#include <zephyr/device.h>
+#include "bluetooth/le_audio/block_ring.h"
+#include "gapi_isooshm.h"
+#include <drivers/i2s_sync_emul.h>
+
+#define LE_AUDIO_SIM_MAX_WATCHED_QUEUES 4
+
+struct le_audio_sim_latency {
+	/** Number of frames measured */
+	uint32_t count;
+	/** Percentiles, with the resolution of the latency histogram (100 us) */
+	uint32_t p50_us;
+	uint32_t p90_us;
+	uint32_t p99_us;
+	uint32_t max_us;
+};
+
+struct le_audio_sim_queue_stats {
+	const char *name;
+	/** Mean number of blocks in the queue, in hundredths of a block */
+	uint32_t mean_x100;
+	uint32_t max;
+};
+
+struct le_audio_sim_report {
+	uint32_t duration_ms;
+	struct le_audio_sim_latency sink;
+	struct le_audio_sim_latency source;
+	/** Frames output by the decoder */
+	uint32_t decoded_frames;
+	struct gapi_isooshm_sim_stream_stats streams[CONFIG_ALIF_BLE_AUDIO_SIM_MAX_STREAMS];
+	struct i2s_sync_emul_counters i2s;
+	size_t num_queues;
+	struct le_audio_sim_queue_stats queues[LE_AUDIO_SIM_MAX_WATCHED_QUEUES];
+};
+
+/**
+ * @brief Start a new measurement run
+ *
+ * Installs the measurement hooks on the simulated controller and emulated I2S device and clears
+ * all counters, latency histograms and watched queues.
+ *
+ * @param i2s_dev Emulated I2S device used by the pipeline
+ *
+ * @retval 0 if successful
+ * @retval -EINVAL if the device is not ready
+ */
+int le_audio_sim_reset(const struct device *i2s_dev);
+
+/**
+ * @brief Add a queue to the occupancy measurement of the current run
+ *
+ * @retval 0 if successful
+ * @retval -ENOMEM if too many queues are watched
+ */
+int le_audio_sim_watch_queue(const char *name, struct block_ring *ring);
+
+/**
+ * @brief Decoder callback counting decoded frames, for use with audio_decoder_register_cb()
+ */
+void le_audio_sim_on_decoded(void *context, uint32_t timestamp, uint16_t sdu_seq);
+
+/**
+ * @brief Collect the results of the current run
+ */
+void le_audio_sim_get_report(struct le_audio_sim_report *report);
+
+/**
+ * @brief Print a report to the console
+ */
+void le_audio_sim_print_report(const char *title, const struct le_audio_sim_report *report);
+
+#endif /* _LE_AUDIO_SIM_H */
@@ -0,0 +1,124 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <zephyr/kernel.h>
+#include <errno.h>
+#include <string.h>
+#include "alif_lc3.h"
+
+#define SCRATCH_SIZE 16
+
+int alif_lc3_init(void)
+{
+	return 0;
+}
+
+int32_t lc3_api_configure(lc3_cfg_t *const cfg, uint32_t const sample_rate,
+			  uint32_t const frame_duration)
+{
+	if (!cfg || !sample_rate || sample_rate % 100) {
+		return -EINVAL;
+	}
+
+	cfg->sample_rate = sample_rate;
+	cfg->frame_duration = frame_duration;
+	/* 10 ms frames hold fs / 100 samples, 7.5 ms frames three quarters of that */
+	cfg->frame_samples = frame_duration == FRAME_DURATION_10_MS ? sample_rate / 100
+								    : (sample_rate * 3) / 400;
+
+	return 0;
+}
+
+size_t lc3_api_decoder_scratch_size(const lc3_cfg_t *const cfg)
+{
+	ARG_UNUSED(cfg);
+	return SCRATCH_SIZE;
+}
+
+size_t lc3_api_decoder_status_size(const lc3_cfg_t *const cfg)
+{
+	ARG_UNUSED(cfg);
+	return SCRATCH_SIZE;
+}
+
+int32_t lc3_api_initialise_decoder(const lc3_cfg_t *const cfg, lc3_decoder_t *const decoder,
+				   void *const status)
+{
+	if (!cfg || !decoder || !status) {
+		return -EINVAL;
+	}
+
+	decoder->last_sample = 0;
+
+	return 0;
+}
+
+int32_t lc3_api_decode_frame(const lc3_cfg_t *const cfg, lc3_decoder_t *const decoder,
+			     const uint8_t *const input, uint16_t const input_len,
+			     bool const bad_frame, uint8_t *const bec_detect, int16_t *const output,
+			     int32_t *const scratch)
+{
+	ARG_UNUSED(scratch);
+
+	int16_t sample = 0;
+
+	*bec_detect = 0;
+
+	if (!bad_frame && input_len >= LC3_SIM_MARKER_LEN) {
+		memcpy(&sample, input, sizeof(sample));
+	} else {
+		*bec_detect = !bad_frame;
+	}
+
+	for (size_t i = 0; i < cfg->frame_samples; i++) {
+		output[i] = sample;
+	}
+
+	decoder->last_sample = sample;
+	k_busy_wait(CONFIG_ALIF_BLE_AUDIO_SIM_LC3_DECODE_US);
+
+	return 0;
+}
+
+size_t lc3_api_encoder_scratch_size(const lc3_cfg_t *const cfg)
+{
+	ARG_UNUSED(cfg);
+	return SCRATCH_SIZE;
+}
+
+int32_t lc3_api_initialise_encoder(const lc3_cfg_t *const cfg, lc3_encoder_t *const encoder)
+{
+	if (!cfg || !encoder) {
+		return -EINVAL;
+	}
+
+	encoder->frames = 0;
+
+	return 0;
+}
+
+int32_t lc3_api_encode_frame(const lc3_cfg_t *const cfg, lc3_encoder_t *const encoder,
+			     const int16_t *const input, uint8_t *const output,
+			     uint16_t const output_len, int32_t *const scratch)
+{
+	ARG_UNUSED(cfg);
+	ARG_UNUSED(scratch);
+
+	if (output_len < LC3_SIM_MARKER_LEN) {
+		return -EINVAL;
+	}
+
+	memset(output, 0, output_len);
+	memcpy(output, &input[0], sizeof(input[0]));
+
+	encoder->frames++;
+	k_busy_wait(CONFIG_ALIF_BLE_AUDIO_SIM_LC3_ENCODE_US);
+
+	return 0;
+}
@@ -0,0 +1,327 @@
+/* Copyright (C) 2025 Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
+#include "le_audio_sim.h"
+
+#define LATENCY_BIN_US   100
+#define LATENCY_BINS     ((CONFIG_ALIF_BLE_AUDIO_SIM_LATENCY_MAX_MS * 1000) / LATENCY_BIN_US + 1)
+#define MARKER_RING_SIZE 64
+#define MARKER_MAX       0x7fff
+#define SAMPLE_PERIOD    K_MSEC(1)
+
+/* Markers are non-zero so that they can be told apart from silence */
+#define MARKER(count) ((int16_t)(((count) % MARKER_MAX) + 1))
+
+struct marker_entry {
+	int16_t marker;
+	uint32_t time_us;
+};
+
+struct latency_hist {
+	uint32_t bins[LATENCY_BINS];
+	uint32_t count;
+	uint32_t max_us;
+};
+
+struct watched_queue {
+	const char *name;
+	struct block_ring *ring;
+	uint64_t sum;
+	uint32_t max;
+};
+
+static struct {
+	const struct device *i2s_dev;
+	struct marker_entry anchors[MARKER_RING_SIZE];
+	struct marker_entry captures[MARKER_RING_SIZE];
+	struct latency_hist sink;
+	struct latency_hist source;
+	struct watched_queue queues[LE_AUDIO_SIM_MAX_WATCHED_QUEUES];
+	size_t num_queues;
+	uint32_t samples;
+	uint32_t rx_blocks;
+	uint32_t decoded_frames;
+	int16_t last_tx_marker;
+	int64_t start_ms;
+	struct k_spinlock lock;
+} sim;
+
+static void record_latency(struct latency_hist *const hist, int32_t const latency_us)
+{
+	uint32_t const us = MAX(latency_us, 0);
+
+	hist->bins[MIN(us / LATENCY_BIN_US, LATENCY_BINS - 1)]++;
+	hist->count++;
+	hist->max_us = MAX(hist->max_us, us);
+}
+
+static const struct marker_entry *find_marker(const struct marker_entry *const ring,
+					      int16_t const marker)
+{
+	const struct marker_entry *const entry = &ring[marker % MARKER_RING_SIZE];
+
+	return entry->marker == marker ? entry : NULL;
+}
+
+static void on_output_sdu(uint8_t const stream_lid, gapi_isooshm_sdu_buf_t *const sdu,
+			  uint32_t const anchor_us)
+{
+	ARG_UNUSED(stream_lid);
+
+	int16_t const marker = MARKER(sdu->seq_num);
+
+	if (sdu->sdu_len < sizeof(marker)) {
+		return;
+	}
+
+	/* All channels of a frame carry the same marker */
+	memcpy(sdu->data, &marker, sizeof(marker));
+	sim.anchors[marker % MARKER_RING_SIZE] = (struct marker_entry){marker, anchor_us};
+}
+
+static void on_input_sdu(uint8_t const stream_lid, gapi_isooshm_sdu_buf_t *const sdu,
+			 uint32_t const anchor_us)
+{
+	ARG_UNUSED(stream_lid);
+
+	int16_t marker;
+
+	if (sdu->sdu_len < sizeof(marker)) {
+		return;
+	}
+
+	memcpy(&marker, sdu->data, sizeof(marker));
+
+	const struct marker_entry *const capture = find_marker(sim.captures, marker);
+
+	if (capture) {
+		record_latency(&sim.source, (int32_t)(anchor_us - capture->time_us));
+	}
+}
+
+static void on_i2s_tx(void *const buf, size_t const len, uint32_t const start_us)
+{
+	struct i2s_sync_config cfg;
+	const int16_t *const samples = buf;
+
+	if (i2s_sync_get_config(sim.i2s_dev, &cfg) || !cfg.sample_rate || !cfg.channel_count) {
+		return;
+	}
+
+	size_t const frames = len / (sizeof(samples[0]) * cfg.channel_count);
+
+	/* Find where the next frame starts in this block. It is not necessarily at the start of
+	 * the block, since samples may have been inserted, dropped or resampled ahead of it.
+	 */
+	for (size_t i = 0; i < frames; i++) {
+		int16_t const marker = samples[i * cfg.channel_count];
+
+		if (marker <= 0 || marker == sim.last_tx_marker) {
+			continue;
+		}
+
+		const struct marker_entry *const anchor = find_marker(sim.anchors, marker);
+
+		if (!anchor) {
+			/* Interpolated between two markers by the sample-rate converter */
+			continue;
+		}
+
+		uint32_t const play_us = start_us + (uint32_t)(((uint64_t)i * USEC_PER_SEC) /
+							       cfg.sample_rate);
+
+		record_latency(&sim.sink, (int32_t)(play_us - anchor->time_us));
+		sim.last_tx_marker = marker;
+		break;
+	}
+}
+
+static void on_i2s_rx(void *const buf, size_t const len, uint32_t const start_us)
+{
+	int16_t *const samples = buf;
+	int16_t const marker = MARKER(sim.rx_blocks++);
+
+	for (size_t i = 0; i < len / sizeof(samples[0]); i++) {
+		samples[i] = marker;
+	}
+
+	sim.captures[marker % MARKER_RING_SIZE] = (struct marker_entry){marker, start_us};
+}
+
+static void sample_queues(struct k_timer *timer)
+{
+	ARG_UNUSED(timer);
+
+	for (size_t i = 0; i < sim.num_queues; i++) {
+		struct watched_queue *const q = &sim.queues[i];
+		uint32_t const used = block_ring_num_used(q->ring);
+
+		q->sum += used;
+		q->max = MAX(q->max, used);
+	}
+
+	sim.samples++;
+}
+
+K_TIMER_DEFINE(sample_timer, sample_queues, NULL);
+
+int le_audio_sim_reset(const struct device *const i2s_dev)
+{
+	if (!device_is_ready(i2s_dev)) {
+		return -EINVAL;
+	}
+
+	k_timer_stop(&sample_timer);
+
+	k_spinlock_key_t key = k_spin_lock(&sim.lock);
+
+	memset(&sim, 0, offsetof(typeof(sim), lock));
+	sim.i2s_dev = i2s_dev;
+	sim.start_ms = k_uptime_get();
+
+	k_spin_unlock(&sim.lock, key);
+
+	for (uint8_t i = 0; i < CONFIG_ALIF_BLE_AUDIO_SIM_MAX_STREAMS; i++) {
+		gapi_isooshm_sim_get_stats(i, NULL, true);
+	}
+
+	i2s_sync_emul_get_counters(i2s_dev, NULL, true);
+	gapi_isooshm_sim_set_hooks(on_output_sdu, on_input_sdu);
+	i2s_sync_emul_set_hooks(i2s_dev, on_i2s_tx, on_i2s_rx);
+
+	k_timer_start(&sample_timer, SAMPLE_PERIOD, SAMPLE_PERIOD);
+
+	return 0;
+}
+
+int le_audio_sim_watch_queue(const char *const name, struct block_ring *const ring)
+{
+	if (!ring) {
+		return -EINVAL;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&sim.lock);
+	int ret = -ENOMEM;
+
+	if (sim.num_queues < ARRAY_SIZE(sim.queues)) {
+		sim.queues[sim.num_queues++] = (struct watched_queue){.name = name, .ring = ring};
+		ret = 0;
+	}
+
+	k_spin_unlock(&sim.lock, key);
+
+	return ret;
+}
+
+void le_audio_sim_on_decoded(void *const context, uint32_t const timestamp, uint16_t const sdu_seq)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(timestamp);
+	ARG_UNUSED(sdu_seq);
+
+	sim.decoded_frames++;
+}
+
+static void get_latency(const struct latency_hist *const hist,
+			struct le_audio_sim_latency *const latency)
+{
+	uint32_t const targets[] = {
+		DIV_ROUND_UP(hist->count * 50, 100),
+		DIV_ROUND_UP(hist->count * 90, 100),
+		DIV_ROUND_UP(hist->count * 99, 100),
+	};
+	uint32_t *const results[] = {&latency->p50_us, &latency->p90_us, &latency->p99_us};
+	uint32_t cumulative = 0;
+	size_t next = 0;
+
+	memset(latency, 0, sizeof(*latency));
+	latency->count = hist->count;
+	latency->max_us = hist->max_us;
+
+	for (size_t bin = 0; bin < LATENCY_BINS && next < ARRAY_SIZE(targets); bin++) {
+		cumulative += hist->bins[bin];
+		while (next < ARRAY_SIZE(targets) && hist->count && cumulative >= targets[next]) {
+			/* Report the upper edge of the bin, capped at the maximum seen */
+			*results[next++] = MIN((bin + 1) * LATENCY_BIN_US, hist->max_us);
+		}
+	}
+}
+
+void le_audio_sim_get_report(struct le_audio_sim_report *const report)
+{
+	memset(report, 0, sizeof(*report));
+
+	k_spinlock_key_t key = k_spin_lock(&sim.lock);
+
+	report->duration_ms = (uint32_t)(k_uptime_get() - sim.start_ms);
+	report->decoded_frames = sim.decoded_frames;
+	get_latency(&sim.sink, &report->sink);
+	get_latency(&sim.source, &report->source);
+
+	report->num_queues = sim.num_queues;
+	for (size_t i = 0; i < sim.num_queues; i++) {
+		report->queues[i].name = sim.queues[i].name;
+		report->queues[i].max = sim.queues[i].max;
+		report->queues[i].mean_x100 =
+			sim.samples ? (uint32_t)((sim.queues[i].sum * 100) / sim.samples) : 0;
+	}
+
+	k_spin_unlock(&sim.lock, key);
+
+	for (uint8_t i = 0; i < ARRAY_SIZE(report->streams); i++) {
+		gapi_isooshm_sim_get_stats(i, &report->streams[i], false);
+	}
+
+	if (sim.i2s_dev) {
+		i2s_sync_emul_get_counters(sim.i2s_dev, &report->i2s, false);
+	}
+}
+
+static void print_latency(const char *const name, const struct le_audio_sim_latency *const lat)
+{
+	if (!lat->count) {
+		return;
+	}
+
+	printk("  %s latency (%u frames): p50 %u us, p90 %u us, p99 %u us, max %u us\n", name,
+	       lat->count, lat->p50_us, lat->p90_us, lat->p99_us, lat->max_us);
+}
+
+void le_audio_sim_print_report(const char *const title, const struct le_audio_sim_report *const r)
+{
+	printk("LE audio simulation: %s (%u ms)\n", title, r->duration_ms);
+
+	print_latency("sink", &r->sink);
+	print_latency("source", &r->source);
+
+	for (size_t i = 0; i < ARRAY_SIZE(r->streams); i++) {
+		const struct gapi_isooshm_sim_stream_stats *const s = &r->streams[i];
+
+		if (!s->anchors) {
+			continue;
+		}
+
+		printk("  stream %zu: %u anchors, %u SDUs, %u lost, %u dropped, %u underruns\n", i,
+		       s->anchors, s->sdus, s->lost, s->overflows, s->underruns);
+	}
+
+	for (size_t i = 0; i < r->num_queues; i++) {
+		const struct le_audio_sim_queue_stats *const q = &r->queues[i];
+
+		printk("  queue %s: mean %u.%02u, max %u\n", q->name, q->mean_x100 / 100,
+		       q->mean_x100 % 100, q->max);
+	}
+
+	printk("  decoded %u frames, I2S tx %u blocks, rx %u blocks, %u tx underruns\n",
+	       r->decoded_frames, r->i2s.tx_blocks, r->i2s.rx_blocks, r->i2s.tx_underruns);
+}
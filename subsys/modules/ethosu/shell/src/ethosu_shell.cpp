@@ -18,13 +18,20 @@
 #endif
 
 #include <zephyr/shell/shell.h>
+#include <algorithm>
 #include <inttypes.h>
 #include <string>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <vector>
 #include <zephyr/kernel.h>
 
+#if defined(CONFIG_ALIF_ETHOSU_SHELL_PMU)
+#include <ethosu_driver.h>
+#include <pmu_ethosu.h>
+#endif
+
 static K_THREAD_STACK_DEFINE(ethosu_stack, CONFIG_ALIF_ETHOSU_SHELL_THREAD_STACKSIZE);
 static struct k_thread ethosu_thread;
 static k_sem ethosu_sem;
@@ -55,6 +62,8 @@ static void ethosu_worker(void *, void *, void *)
 	uint32_t jobcnt = 0;
 	uint32_t last_print_jobcnt = 0;
 	int64_t last_print_ms = k_uptime_get();
+	uint64_t setup_cycles = 0;
+	uint64_t invoke_cycles = 0;
 	bool status;
 
 	while (true) {
@@ -74,6 +83,8 @@ static void ethosu_worker(void *, void *, void *)
 
 		status = npu.runJob(job);
 		jobcnt++;
+		setup_cycles += job.setupCycles;
+		invoke_cycles += job.invokeCycles;
 
 		if (atomic_get(&ethosu_verbose) && (jobcnt % verbose_to_cnt()) == 0) {
 			int64_t now_ms = k_uptime_get();
@@ -85,13 +96,332 @@ static void ethosu_worker(void *, void *, void *)
 							  (uint64_t)(now_ms - last_print_ms));
 			}
 
-			printk("jobcnt=%u status=%s rate=%u jobs/s\n", jobcnt,
-			       status ? "failed" : "ok", jobs_per_sec);
+			printk("jobcnt=%u status=%s rate=%u jobs/s setup=%u us invoke=%u us\n", jobcnt,
+			       status ? "failed" : "ok", jobs_per_sec,
+			       (uint32_t)k_cyc_to_us_floor64(setup_cycles / delta_jobs),
+			       (uint32_t)k_cyc_to_us_floor64(invoke_cycles / delta_jobs));
 
 			last_print_jobcnt = jobcnt;
 			last_print_ms = now_ms;
+			setup_cycles = 0;
+			invoke_cycles = 0;
+		}
+	}
+}
+
+/* Models the bench command can run */
+struct bench_model {
+	const char *name;
+	const uint8_t *model;
+	size_t model_size;
+	const uint8_t *input;
+	size_t input_size;
+	const uint8_t *expected_output;
+	size_t expected_output_size;
+};
+
+static const bench_model bench_models[] = {
+	{modelName, networkModelData, sizeof(networkModelData), inputData, sizeof(inputData),
+	 expectedOutputData, sizeof(expectedOutputData)},
+};
+
+enum bench_stage {
+	BENCH_SETUP,
+	BENCH_INPUT,
+	BENCH_INVOKE,
+	BENCH_OUTPUT,
+	BENCH_TOTAL,
+	BENCH_STAGES,
+};
+
+static const char *const bench_stage_names[BENCH_STAGES] = {"setup", "input", "invoke", "output",
+							    "total"};
+
+struct pmu_counters {
+	uint64_t cycles;
+	uint64_t active;
+	uint64_t axi0_read_beats;
+	uint64_t axi0_write_beats;
+	uint64_t axi1_read_beats;
+};
+
+static struct {
+	const bench_model *model;
+	uint32_t iterations;
+	/* Write the input and read the output in the tensor arena, instead of copying them */
+	bool in_place;
+	uint32_t failures;
+	bool output_ok;
+	size_t arena_used;
+	/* Cycles of each stage, per iteration */
+	std::vector<uint32_t> cycles[BENCH_STAGES];
+	pmu_counters pmu;
+} bench;
+
+#if defined(CONFIG_ALIF_ETHOSU_SHELL_PMU)
+static atomic_t pmu_enabled;
+
+/* Ethos-U driver hooks, called around each NPU operator */
+extern "C" void ethosu_inference_begin(struct ethosu_driver *drv, void *)
+{
+	if (!atomic_get(&pmu_enabled)) {
+		return;
+	}
+
+	ETHOSU_PMU_Enable(drv);
+	ETHOSU_PMU_Set_EVTYPER(drv, 0, ETHOSU_PMU_NPU_ACTIVE);
+	ETHOSU_PMU_Set_EVTYPER(drv, 1, ETHOSU_PMU_AXI0_RD_DATA_BEAT_RECEIVED);
+	ETHOSU_PMU_Set_EVTYPER(drv, 2, ETHOSU_PMU_AXI0_WR_DATA_BEAT_WRITTEN);
+	ETHOSU_PMU_Set_EVTYPER(drv, 3, ETHOSU_PMU_AXI1_RD_DATA_BEAT_RECEIVED);
+	ETHOSU_PMU_CYCCNT_Reset(drv);
+	ETHOSU_PMU_EVCNTR_ALL_Reset(drv);
+	ETHOSU_PMU_CNTR_Enable(drv, ETHOSU_PMU_CCNT_Msk | ETHOSU_PMU_CNT1_Msk |
+					    ETHOSU_PMU_CNT2_Msk | ETHOSU_PMU_CNT3_Msk |
+					    ETHOSU_PMU_CNT4_Msk);
+}
+
+extern "C" void ethosu_inference_end(struct ethosu_driver *drv, void *)
+{
+	if (!atomic_get(&pmu_enabled)) {
+		return;
+	}
+
+	ETHOSU_PMU_CNTR_Disable(drv, ETHOSU_PMU_CCNT_Msk | ETHOSU_PMU_CNT1_Msk |
+					     ETHOSU_PMU_CNT2_Msk | ETHOSU_PMU_CNT3_Msk |
+					     ETHOSU_PMU_CNT4_Msk);
+
+	bench.pmu.cycles += ETHOSU_PMU_Get_CCNTR(drv);
+	bench.pmu.active += ETHOSU_PMU_Get_EVCNTR(drv, 0);
+	bench.pmu.axi0_read_beats += ETHOSU_PMU_Get_EVCNTR(drv, 1);
+	bench.pmu.axi0_write_beats += ETHOSU_PMU_Get_EVCNTR(drv, 2);
+	bench.pmu.axi1_read_beats += ETHOSU_PMU_Get_EVCNTR(drv, 3);
+
+	ETHOSU_PMU_Disable(drv);
+}
+#endif
+
+static void bench_worker(void *, void *, void *)
+{
+	const bench_model &model = *bench.model;
+	InferenceProcess::InferenceProcess npu(tensor_arena, TENSOR_ARENA_SIZE);
+	std::vector<uint8_t> output(model.expected_output_size);
+	InferenceProcess::InferenceJob job(
+		model.name,
+		InferenceProcess::DataPtr(const_cast<uint8_t *>(model.model), model.model_size),
+		{InferenceProcess::DataPtr(const_cast<uint8_t *>(model.input), model.input_size)},
+		{InferenceProcess::DataPtr(output.data(), output.size())}, {});
+
+	for (auto &cycles : bench.cycles) {
+		cycles.clear();
+		cycles.reserve(bench.iterations);
+	}
+
+	bench.failures = 0;
+	bench.output_ok = true;
+	bench.pmu = {};
+
+	if (bench.in_place) {
+		if (npu.getTensors(job) || (job.input.size() != 1) || (job.output.size() != 1) ||
+		    (job.input[0].size != model.input_size) ||
+		    (job.output[0].size != model.expected_output_size)) {
+			bench.failures = bench.iterations;
+			bench.arena_used = 0;
+			return;
+		}
+	}
+
+#if defined(CONFIG_ALIF_ETHOSU_SHELL_PMU)
+	atomic_set(&pmu_enabled, 1);
+#endif
+
+	for (uint32_t i = 0; i < bench.iterations; i++) {
+		/* As a producer would, outside of the measured stages. The network may have used
+		 * the input tensor for its activations.
+		 */
+		if (bench.in_place) {
+			memcpy(job.input[0].data, model.input, model.input_size);
+		}
+
+		if (npu.runJob(job)) {
+			bench.failures++;
+			continue;
+		}
+
+		bench.cycles[BENCH_SETUP].push_back(job.setupCycles);
+		bench.cycles[BENCH_INPUT].push_back(job.inputCycles);
+		bench.cycles[BENCH_INVOKE].push_back(job.invokeCycles);
+		bench.cycles[BENCH_OUTPUT].push_back(job.outputCycles);
+		bench.cycles[BENCH_TOTAL].push_back(job.setupCycles + job.inputCycles +
+						    job.invokeCycles + job.outputCycles);
+
+		/* The output is checked outside of the measured stages */
+		if (memcmp(job.output[0].data, model.expected_output, model.expected_output_size) !=
+		    0) {
+			bench.output_ok = false;
+		}
+	}
+
+#if defined(CONFIG_ALIF_ETHOSU_SHELL_PMU)
+	atomic_set(&pmu_enabled, 0);
+#endif
+
+	bench.arena_used = npu.arenaUsedBytes();
+}
+
+struct latency {
+	uint32_t min;
+	uint32_t avg;
+	uint32_t p50;
+	uint32_t p99;
+	uint32_t max;
+};
+
+/* Latency statistics in microseconds, sorting the samples */
+static latency bench_latency(std::vector<uint32_t> &cycles)
+{
+	latency lat = {};
+	uint64_t total = 0;
+	const size_t n = cycles.size();
+
+	if (n == 0) {
+		return lat;
+	}
+
+	std::sort(cycles.begin(), cycles.end());
+	for (uint32_t c : cycles) {
+		total += c;
+	}
+
+	lat.min = k_cyc_to_us_floor32(cycles[0]);
+	lat.avg = (uint32_t)k_cyc_to_us_floor64(total / n);
+	lat.p50 = k_cyc_to_us_floor32(cycles[((n - 1) * 50) / 100]);
+	lat.p99 = k_cyc_to_us_floor32(cycles[((n - 1) * 99) / 100]);
+	lat.max = k_cyc_to_us_floor32(cycles[n - 1]);
+
+	return lat;
+}
+
+static void print_csv(const struct shell *shell, const char *model, const char *metric,
+		      const char *suffix, uint64_t value)
+{
+	shell_fprintf(shell, SHELL_VT100_COLOR_DEFAULT, "csv:%s,%s%s,%llu\n", model, metric, suffix,
+		      (unsigned long long)value);
+}
+
+static int cmd_bench(const struct shell *shell, size_t argc, char **argv)
+{
+	const bench_model *model = nullptr;
+	char *end = NULL;
+	long iterations;
+
+	for (const auto &m : bench_models) {
+		if (strcmp(m.name, argv[1]) == 0) {
+			model = &m;
 		}
 	}
+
+	if (model == nullptr) {
+		shell_fprintf(shell, SHELL_VT100_COLOR_DEFAULT, "Unknown model %s, available:\n",
+			      argv[1]);
+		for (const auto &m : bench_models) {
+			shell_fprintf(shell, SHELL_VT100_COLOR_DEFAULT, "  %s\n", m.name);
+		}
+		return -1;
+	}
+
+	if ((argc > 3) && (strcmp(argv[3], "inplace") != 0)) {
+		shell_fprintf(shell, SHELL_VT100_COLOR_DEFAULT, "Invalid mode %s, expected inplace\n",
+			      argv[3]);
+		return -1;
+	}
+
+	iterations = strtol(argv[2], &end, 10);
+	if ((end == argv[2]) || (*end != '\0') || (iterations < 1) ||
+	    (iterations > CONFIG_ALIF_ETHOSU_SHELL_BENCH_MAX_ITERATIONS)) {
+		shell_fprintf(shell, SHELL_VT100_COLOR_DEFAULT,
+			      "Invalid iterations, expected 1-%d\n",
+			      CONFIG_ALIF_ETHOSU_SHELL_BENCH_MAX_ITERATIONS);
+		return -1;
+	}
+
+	/* The bench uses the inference thread and tensor arena */
+	if (atomic_set(&ethosu_running, 1) == 1) {
+		shell_fprintf(shell, SHELL_VT100_COLOR_DEFAULT, "Ethos-U55 already inferencing\n");
+		return -1;
+	}
+
+	bench.model = model;
+	bench.iterations = (uint32_t)iterations;
+	bench.in_place = (argc > 3);
+
+	k_thread_create(&ethosu_thread, ethosu_stack, K_THREAD_STACK_SIZEOF(ethosu_stack),
+			bench_worker, NULL, NULL, NULL, CONFIG_ALIF_ETHOSU_SHELL_THREAD_PRIORITY, 0,
+			K_NO_WAIT);
+	k_thread_join(&ethosu_thread, K_FOREVER);
+
+	atomic_set(&ethosu_running, 0);
+
+	const uint32_t runs = bench.iterations - bench.failures;
+	latency lat[BENCH_STAGES];
+
+	for (int i = 0; i < BENCH_STAGES; i++) {
+		lat[i] = bench_latency(bench.cycles[i]);
+	}
+
+	shell_fprintf(shell, SHELL_VT100_COLOR_DEFAULT,
+		      "model=%s mode=%s iterations=%u failures=%u output=%s arena_used=%zu/%d "
+		      "bytes\n",
+		      model->name, bench.in_place ? "inplace" : "copy", bench.iterations,
+		      bench.failures, bench.output_ok ? "ok" : "mismatch", bench.arena_used,
+		      TENSOR_ARENA_SIZE);
+	shell_fprintf(shell, SHELL_VT100_COLOR_DEFAULT, "%-8s %8s %8s %8s %8s %8s (us)\n", "stage",
+		      "min", "avg", "p50", "p99", "max");
+	for (int i = 0; i < BENCH_STAGES; i++) {
+		shell_fprintf(shell, SHELL_VT100_COLOR_DEFAULT, "%-8s %8u %8u %8u %8u %8u\n",
+			      bench_stage_names[i], lat[i].min, lat[i].avg, lat[i].p50, lat[i].p99,
+			      lat[i].max);
+	}
+
+	if (IS_ENABLED(CONFIG_ALIF_ETHOSU_SHELL_PMU) && runs) {
+		shell_fprintf(shell, SHELL_VT100_COLOR_DEFAULT,
+			      "pmu per inference: cycles=%llu active=%llu axi0_rd=%llu axi0_wr=%llu "
+			      "axi1_rd=%llu\n",
+			      (unsigned long long)(bench.pmu.cycles / runs),
+			      (unsigned long long)(bench.pmu.active / runs),
+			      (unsigned long long)(bench.pmu.axi0_read_beats / runs),
+			      (unsigned long long)(bench.pmu.axi0_write_beats / runs),
+			      (unsigned long long)(bench.pmu.axi1_read_beats / runs));
+	}
+
+	/* Machine readable results, one metric per line */
+	const char *name = model->name;
+
+	shell_fprintf(shell, SHELL_VT100_COLOR_DEFAULT, "csv:model,metric,value\n");
+	print_csv(shell, name, "iterations", "", bench.iterations);
+	print_csv(shell, name, "failures", "", bench.failures);
+	print_csv(shell, name, "output_ok", "", bench.output_ok ? 1 : 0);
+	print_csv(shell, name, "arena_used_bytes", "", bench.arena_used);
+	for (int i = 0; i < BENCH_STAGES; i++) {
+		print_csv(shell, name, bench_stage_names[i], "_min_us", lat[i].min);
+		print_csv(shell, name, bench_stage_names[i], "_avg_us", lat[i].avg);
+		print_csv(shell, name, bench_stage_names[i], "_p50_us", lat[i].p50);
+		print_csv(shell, name, bench_stage_names[i], "_p99_us", lat[i].p99);
+		print_csv(shell, name, bench_stage_names[i], "_max_us", lat[i].max);
+	}
+	if (IS_ENABLED(CONFIG_ALIF_ETHOSU_SHELL_PMU) && runs) {
+		print_csv(shell, name, "npu_cycles", "", bench.pmu.cycles / runs);
+		print_csv(shell, name, "npu_active_cycles", "", bench.pmu.active / runs);
+		print_csv(shell, name, "axi0_read_beats", "", bench.pmu.axi0_read_beats / runs);
+		print_csv(shell, name, "axi0_write_beats", "", bench.pmu.axi0_write_beats / runs);
+		print_csv(shell, name, "axi1_read_beats", "", bench.pmu.axi1_read_beats / runs);
+	}
+
+	for (auto &cycles : bench.cycles) {
+		cycles.clear();
+		cycles.shrink_to_fit();
+	}
+
+	return 0;
 }
 
 static int cmd_start(const struct shell *shell, size_t, char **)
@@ -151,6 +481,8 @@ static int cmd_verbose(const struct shell *shell, size_t argc, char **argv)
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_cmds, SHELL_CMD_ARG(start, NULL, "start", cmd_start, 1, 10),
 			       SHELL_CMD_ARG(stop, NULL, "stop", cmd_stop, 1, 10),
 			       SHELL_CMD_ARG(verbose, NULL, "verbose <0-5>", cmd_verbose, 2, 0),
+			       SHELL_CMD_ARG(bench, NULL, "bench <model> <iterations> [inplace]",
+					     cmd_bench, 3, 1),
 			       SHELL_SUBCMD_SET_END);
 
 SHELL_CMD_REGISTER(ethosu, &sub_cmds, "Ethos-U55 commands", NULL);
@@ -0,0 +1,190 @@
+/* Copyright Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+/* Feeds a sine through the sample-rate converter while its ratio is stepped, and compares each
+ * output frame with the sine at the input position the converter should be reading, which is
+ * tracked here in the same Q30 fixed point. The reported delay is checked against the same
+ * position after every block.
+ */
+
+#include <math.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include "audio_asrc.h"
+
+#define SAMPLE_RATE 48000
+#define BLOCK       480
+#define TONE_HZ     1000
+#define AMPLITUDE   16000
+
+/* Largest difference from the ideal sine, in LSB, allowed for the interpolated output */
+#define MAX_ERROR 4
+
+#define FRAC_ONE (1LL << 30)
+
+/* The first output frame is interpolated between the two silent history frames before the
+ * first input frame
+ */
+#define START_POS (1 - AUDIO_ASRC_HISTORY_FRAMES)
+
+static struct audio_asrc asrc;
+static pcm_sample_t in[BLOCK * MAX_NUMBER_OF_CHANNELS];
+static pcm_sample_t out[(BLOCK + AUDIO_ASRC_MAX_EXTRA_FRAMES) * MAX_NUMBER_OF_CHANNELS];
+
+static double tone(double const frame, size_t const ch)
+{
+	/* The second channel is in antiphase, to catch channels being swapped or mixed */
+	double const phase = 2.0 * M_PI * TONE_HZ * frame / SAMPLE_RATE;
+
+	return (ch ? -AMPLITUDE : AMPLITUDE) * sin(phase);
+}
+
+static void fill_block(size_t const first_frame, size_t const channels)
+{
+	for (size_t i = 0; i < BLOCK; i++) {
+		for (size_t ch = 0; ch < channels; ch++) {
+			in[i * channels + ch] = (pcm_sample_t)lround(tone(first_frame + i, ch));
+		}
+	}
+}
+
+/* The read position step for a ratio, the way the converter computes it */
+static int64_t ratio_step(int32_t const ppm)
+{
+	int32_t const clamped = CLAMP(ppm, -AUDIO_ASRC_MAX_PPM, AUDIO_ASRC_MAX_PPM);
+
+	return FRAC_ONE + ((int64_t)clamped * FRAC_ONE) / 1000000;
+}
+
+struct run {
+	/* Input frame the next output frame is read at, in Q30 */
+	int64_t pos;
+	size_t in_frames;
+	size_t out_frames;
+	int32_t max_error;
+};
+
+static void run_init(struct run *const r, size_t const channels)
+{
+	zassert_ok(audio_asrc_init(&asrc, channels));
+
+	r->pos = (int64_t)START_POS * FRAC_ONE;
+	r->in_frames = 0;
+	r->out_frames = 0;
+	r->max_error = 0;
+}
+
+static void run_block(struct run *const r, size_t const channels, int32_t const ppm)
+{
+	int64_t const step = ratio_step(ppm);
+
+	audio_asrc_set_ratio_ppm(&asrc, ppm);
+	fill_block(r->in_frames, channels);
+
+	size_t const n = audio_asrc_process(&asrc, in, BLOCK, out, ARRAY_SIZE(out) / channels);
+
+	r->in_frames += BLOCK;
+
+	for (size_t i = 0; i < n; i++) {
+		/* Skip the frames which are interpolated from the silent history */
+		if (r->pos >= FRAC_ONE) {
+			double const frame = (double)r->pos / FRAC_ONE;
+
+			for (size_t ch = 0; ch < channels; ch++) {
+				int32_t const error = abs(out[i * channels + ch] -
+							  (int32_t)lround(tone(frame, ch)));
+
+				r->max_error = MAX(r->max_error, error);
+			}
+		}
+
+		r->pos += step;
+	}
+
+	r->out_frames += n;
+
+	/* Every frame up to the last one whose taps are all in is converted, and no more */
+	int64_t const delay = ((int64_t)r->in_frames * FRAC_ONE - r->pos) >> 30;
+
+	zassert_equal(audio_asrc_delay_frames(&asrc), delay, "%d ppm: delay %u, expected %lld",
+		      ppm, audio_asrc_delay_frames(&asrc), (long long)delay);
+	zassert_true(delay >= 0 && delay < AUDIO_ASRC_HISTORY_FRAMES, "%d ppm: delay %lld", ppm,
+		     (long long)delay);
+}
+
+ZTEST(le_audio_asrc, test_init_rejects_channels)
+{
+	zassert_equal(audio_asrc_init(&asrc, 0), -EINVAL);
+	zassert_equal(audio_asrc_init(&asrc, MAX_NUMBER_OF_CHANNELS + 1), -EINVAL);
+	zassert_equal(audio_asrc_init(NULL, 1), -EINVAL);
+}
+
+ZTEST(le_audio_asrc, test_unity_ratio_is_a_delay)
+{
+	struct run r;
+
+	run_init(&r, 1);
+
+	for (size_t b = 0; b < 4; b++) {
+		run_block(&r, 1, 0);
+		zassert_equal(r.out_frames, r.in_frames, "block %zu", b);
+	}
+
+	/* At unity the taps fall on input frames, so the output is the input delayed exactly */
+	zassert_equal(r.max_error, 0, "error %d", r.max_error);
+}
+
+ZTEST(le_audio_asrc, test_sine_across_ratio_steps)
+{
+	static const int32_t steps[] = {0,    100,  -100,  1000, -1000, 5000,
+					-5000, 20000, -20000, 0,    3333,  -1};
+
+	for (size_t channels = 1; channels <= MAX_NUMBER_OF_CHANNELS; channels++) {
+		struct run r;
+
+		run_init(&r, channels);
+
+		for (size_t s = 0; s < ARRAY_SIZE(steps); s++) {
+			/* A few blocks at each ratio, so that steps land mid-way through the taps */
+			for (size_t b = 0; b < 5; b++) {
+				run_block(&r, channels, steps[s]);
+			}
+		}
+
+		TC_PRINT("%zu channel(s): max error %d LSB\n", channels, r.max_error);
+		zassert_true(r.max_error <= MAX_ERROR, "%zu channel(s): error %d", channels,
+			     r.max_error);
+	}
+}
+
+ZTEST(le_audio_asrc, test_output_frames_follow_ratio)
+{
+	static const int32_t ratios[] = {-AUDIO_ASRC_MAX_PPM, -1000, -100, 100, 1000,
+					 AUDIO_ASRC_MAX_PPM};
+
+	for (size_t i = 0; i < ARRAY_SIZE(ratios); i++) {
+		struct run r;
+
+		run_init(&r, 2);
+
+		/* One second of audio */
+		for (size_t b = 0; b < SAMPLE_RATE / BLOCK; b++) {
+			run_block(&r, 2, ratios[i]);
+		}
+
+		double const expected = r.in_frames / (1.0 + ratios[i] / 1e6);
+
+		zassert_true(fabs(r.out_frames - expected) <= AUDIO_ASRC_HISTORY_FRAMES,
+			     "%d ppm: %zu frames out, expected %.1f", ratios[i], r.out_frames,
+			     expected);
+		zassert_true(r.max_error <= MAX_ERROR, "%d ppm: error %d", ratios[i], r.max_error);
+	}
+}
+
+ZTEST_SUITE(le_audio_asrc, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,242 @@
+/* Copyright Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/irq_offload.h>
+#include <zephyr/ztest.h>
+#include "block_ring.h"
+
+#define BLOCK_SIZE  64
+#define BLOCK_COUNT 3
+/* Number of blocks passed per benchmark run */
+#define BENCH_ITERATIONS 1000
+
+static uint8_t ring_buf[BLOCK_COUNT * BLOCK_SIZE] __aligned(4);
+static struct block_ring ring;
+
+K_MEM_SLAB_DEFINE_STATIC(bench_slab, BLOCK_SIZE, BLOCK_COUNT, 4);
+K_MSGQ_DEFINE(bench_msgq, sizeof(void *), BLOCK_COUNT, 4);
+
+static void *block_ring_setup(void)
+{
+	block_ring_init(&ring, ring_buf, BLOCK_SIZE, BLOCK_COUNT);
+	return NULL;
+}
+
+static void reset_ring(void *fixture)
+{
+	ARG_UNUSED(fixture);
+	block_ring_init(&ring, ring_buf, BLOCK_SIZE, BLOCK_COUNT);
+}
+
+ZTEST(le_audio_block_ring, test_fill_and_drain_in_order)
+{
+	void *blocks[BLOCK_COUNT];
+
+	for (size_t i = 0; i < BLOCK_COUNT; i++) {
+		blocks[i] = block_ring_acquire(&ring, K_NO_WAIT);
+		zassert_not_null(blocks[i], "Acquire %zu failed", i);
+		zassert_equal_ptr(blocks[i], ring_buf + i * BLOCK_SIZE);
+	}
+
+	zassert_is_null(block_ring_acquire(&ring, K_NO_WAIT), "Ring should be full");
+	zassert_is_null(block_ring_get(&ring, K_NO_WAIT), "Nothing committed yet");
+
+	for (size_t i = 0; i < BLOCK_COUNT; i++) {
+		block_ring_commit(&ring, blocks[i]);
+	}
+
+	zassert_equal(block_ring_num_used(&ring), BLOCK_COUNT);
+
+	for (size_t i = 0; i < BLOCK_COUNT; i++) {
+		zassert_equal_ptr(block_ring_get(&ring, K_NO_WAIT), blocks[i]);
+	}
+
+	zassert_is_null(block_ring_get(&ring, K_NO_WAIT), "Ring should be empty");
+	zassert_is_null(block_ring_acquire(&ring, K_NO_WAIT), "Blocks not yet released");
+
+	block_ring_release(&ring, blocks[0]);
+	zassert_equal_ptr(block_ring_acquire(&ring, K_NO_WAIT), blocks[0]);
+}
+
+ZTEST(le_audio_block_ring, test_cancel_returns_newest_block)
+{
+	void *first = block_ring_acquire(&ring, K_NO_WAIT);
+	void *second = block_ring_acquire(&ring, K_NO_WAIT);
+
+	block_ring_commit(&ring, first);
+	block_ring_cancel(&ring, second);
+
+	zassert_equal(block_ring_num_used(&ring), 1);
+	zassert_equal_ptr(block_ring_acquire(&ring, K_NO_WAIT), second, "Cancelled block reused");
+	zassert_equal_ptr(block_ring_get(&ring, K_NO_WAIT), first);
+	zassert_is_null(block_ring_get(&ring, K_NO_WAIT), "Cancelled block must not be received");
+}
+
+ZTEST(le_audio_block_ring, test_wrap_around)
+{
+	/* Run the indices around the ring many times with a non power of two block count */
+	for (uint32_t i = 0; i < 10 * BLOCK_COUNT; i++) {
+		uint32_t *block = block_ring_acquire(&ring, K_NO_WAIT);
+
+		zassert_not_null(block);
+		*block = i;
+		block_ring_commit(&ring, block);
+
+		block = block_ring_get(&ring, K_NO_WAIT);
+		zassert_not_null(block);
+		zassert_equal(*block, i);
+		block_ring_release(&ring, block);
+	}
+
+	zassert_equal(block_ring_num_used(&ring), 0);
+}
+
+ZTEST(le_audio_block_ring, test_limit)
+{
+	block_ring_set_limit(&ring, 1);
+
+	void *first = block_ring_acquire(&ring, K_NO_WAIT);
+
+	zassert_not_null(first);
+	zassert_is_null(block_ring_acquire(&ring, K_NO_WAIT), "Limit of one block exceeded");
+
+	/* A block still held by the consumer counts towards the limit */
+	block_ring_commit(&ring, first);
+	zassert_equal_ptr(block_ring_get(&ring, K_NO_WAIT), first);
+	zassert_is_null(block_ring_acquire(&ring, K_NO_WAIT), "Limit of one block exceeded");
+
+	block_ring_release(&ring, first);
+	zassert_not_null(block_ring_acquire(&ring, K_NO_WAIT));
+
+	/* Raising the limit beyond the block count is clamped */
+	block_ring_set_limit(&ring, BLOCK_COUNT + 1);
+	zassert_not_null(block_ring_acquire(&ring, K_NO_WAIT));
+	zassert_not_null(block_ring_acquire(&ring, K_NO_WAIT));
+	zassert_is_null(block_ring_acquire(&ring, K_NO_WAIT), "Ring should be full");
+}
+
+static void producer_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	void *block = block_ring_acquire(&ring, K_NO_WAIT);
+
+	block_ring_commit(&ring, block);
+}
+
+static K_WORK_DELAYABLE_DEFINE(producer_work, producer_work_handler);
+
+ZTEST(le_audio_block_ring, test_blocking_get)
+{
+	zassert_is_null(block_ring_get(&ring, K_MSEC(5)), "Empty ring should time out");
+
+	k_work_schedule(&producer_work, K_MSEC(5));
+	zassert_not_null(block_ring_get(&ring, K_MSEC(100)), "Consumer not woken by commit");
+
+	block_ring_wakeup(&ring);
+	zassert_is_null(block_ring_get(&ring, K_FOREVER), "Wakeup should end the wait");
+}
+
+ZTEST(le_audio_block_ring, test_blocking_get_ignores_stale_signal)
+{
+	struct k_poll_event event;
+	void *block;
+
+	/* Leave a signal on the semaphore from a commit that was consumed without waiting */
+	zassert_true(block_ring_poll_init(&ring, &event));
+	block_ring_commit(&ring, block_ring_acquire(&ring, K_NO_WAIT));
+	block_ring_poll_done(&ring);
+
+	block = block_ring_get(&ring, K_NO_WAIT);
+	zassert_not_null(block);
+	block_ring_release(&ring, block);
+
+	k_work_schedule(&producer_work, K_MSEC(5));
+	zassert_not_null(block_ring_get(&ring, K_MSEC(100)), "Stale signal ended the wait");
+}
+
+ZTEST(le_audio_block_ring, test_poll)
+{
+	struct k_poll_event event;
+
+	zassert_true(block_ring_poll_init(&ring, &event), "Empty ring should be polled");
+	zassert_equal(k_poll(&event, 1, K_MSEC(5)), -EAGAIN);
+	block_ring_poll_done(&ring);
+
+	zassert_true(block_ring_poll_init(&ring, &event));
+	k_work_schedule(&producer_work, K_MSEC(5));
+	zassert_ok(k_poll(&event, 1, K_MSEC(100)), "Poll not signalled by commit");
+	block_ring_poll_done(&ring);
+
+	zassert_false(block_ring_poll_init(&ring, &event), "Ring has data");
+}
+
+struct bench_result {
+	uint32_t produce_cycles;
+	uint32_t consume_cycles;
+};
+
+static void bench_block_ring_isr(const void *param)
+{
+	struct bench_result *result = (struct bench_result *)param;
+	uint32_t start;
+	void *block;
+
+	for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+		start = k_cycle_get_32();
+		block = block_ring_acquire(&ring, K_NO_WAIT);
+		block_ring_commit(&ring, block);
+		result->produce_cycles += k_cycle_get_32() - start;
+
+		start = k_cycle_get_32();
+		block = block_ring_get(&ring, K_NO_WAIT);
+		block_ring_release(&ring, block);
+		result->consume_cycles += k_cycle_get_32() - start;
+	}
+}
+
+static void bench_slab_msgq_isr(const void *param)
+{
+	struct bench_result *result = (struct bench_result *)param;
+	uint32_t start;
+	void *block;
+
+	for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+		start = k_cycle_get_32();
+		k_mem_slab_alloc(&bench_slab, &block, K_NO_WAIT);
+		k_msgq_put(&bench_msgq, &block, K_NO_WAIT);
+		result->produce_cycles += k_cycle_get_32() - start;
+
+		start = k_cycle_get_32();
+		k_msgq_get(&bench_msgq, &block, K_NO_WAIT);
+		k_mem_slab_free(&bench_slab, block);
+		result->consume_cycles += k_cycle_get_32() - start;
+	}
+}
+
+ZTEST(le_audio_block_ring, test_isr_cost_per_block)
+{
+	struct bench_result ring_result = {0};
+	struct bench_result slab_result = {0};
+
+	irq_offload(bench_block_ring_isr, &ring_result);
+	irq_offload(bench_slab_msgq_isr, &slab_result);
+
+	TC_PRINT("ISR cycles per block (produce / consume):\n");
+	TC_PRINT("  k_mem_slab + k_msgq: %u / %u\n", slab_result.produce_cycles / BENCH_ITERATIONS,
+		 slab_result.consume_cycles / BENCH_ITERATIONS);
+	TC_PRINT("  block_ring:          %u / %u\n", ring_result.produce_cycles / BENCH_ITERATIONS,
+		 ring_result.consume_cycles / BENCH_ITERATIONS);
+
+	zassert_equal(block_ring_num_used(&ring), 0);
+	zassert_equal(k_mem_slab_num_used_get(&bench_slab), 0);
+}
+
+ZTEST_SUITE(le_audio_block_ring, NULL, block_ring_setup, reset_ring, NULL, NULL);
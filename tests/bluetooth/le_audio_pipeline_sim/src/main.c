@@ -0,0 +1,474 @@
+/* Copyright Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include "bluetooth/le_audio/audio_decoder.h"
+#include "bluetooth/le_audio/audio_encoder.h"
+#include "gapi_isooshm.h"
+#include "le_audio_sim.h"
+#if CONFIG_ALIF_BLE_AUDIO_DATAPATH_TRACE
+#include "bluetooth/le_audio/datapath_trace.h"
+#endif
+
+#define SAMPLING_RATE_HZ  48000
+#define FRAME_DURATION_US 10000
+#define OCTETS_PER_FRAME  100
+#define PRES_DELAY_US     40000
+#define NUM_STREAMS       2
+/* Streams decoded and mixed in the mixer test */
+#define MIXER_STREAMS     4
+/* Simulated time of each run */
+#define RUN_TIME          K_SECONDS(5)
+/* Frames expected in a run, allowing for start-up and the presentation delay */
+#define MIN_FRAMES        ((5 * USEC_PER_SEC) / FRAME_DURATION_US - 20)
+/* Time for the pipeline to drain after the streams are stopped */
+#define DRAIN_TIME        K_MSEC(100)
+
+static const struct device *const i2s_dev = DEVICE_DT_GET(DT_NODELABEL(i2s_emul));
+static struct le_audio_sim_report report;
+/* Audio queue blocks allocated, and the depth it was limited to at the end of the last run */
+static uint32_t queue_blocks;
+static uint32_t queue_limit;
+/* I2S driver queue of the direction used, sampled during the last run */
+static struct i2s_sync_queue_status i2s_queue;
+static struct audio_decoder_stream_stats stream_stats[MIXER_STREAMS];
+static struct audio_encoder_stream_stats source_stats[NUM_STREAMS];
+
+/* Streams are numbered from first_stream, and their statistics indexed from 0 */
+static void run_sink(const char *const title, const struct gapi_isooshm_sim_trace *const trace,
+		     uint32_t const first_stream, uint32_t const num_streams)
+{
+	struct audio_decoder_params const params = {
+		.i2s_dev = i2s_dev,
+		.pres_delay_us = PRES_DELAY_US,
+		.frame_duration_us = FRAME_DURATION_US,
+		.sampling_rate_hz = SAMPLING_RATE_HZ,
+	};
+
+	gapi_isooshm_sim_configure(trace);
+
+	struct audio_decoder *const decoder = audio_decoder_create(&params);
+
+	zassert_not_null(decoder, "Failed to create decoder");
+	zassert_ok(le_audio_sim_reset(i2s_dev));
+	zassert_ok(audio_decoder_register_cb(decoder, le_audio_sim_on_decoded, NULL));
+	zassert_ok(le_audio_sim_watch_queue("audio", &audio_decoder_audio_queue_get(decoder)->ring));
+
+	for (uint32_t i = 0; i < num_streams; i++) {
+		uint32_t const stream = first_stream + i;
+
+		zassert_ok(audio_decoder_add_channel(decoder, OCTETS_PER_FRAME, stream));
+#if CONFIG_ALIF_BLE_AUDIO_DECODER_MIXER
+		/* Keep the first stream alone in the left channel, so that its markers can be
+		 * followed to the I2S output
+		 */
+		zassert_ok(audio_decoder_set_channel_gain(
+			decoder, stream, i ? 0 : AUDIO_DECODER_GAIN_UNITY,
+			i ? AUDIO_DECODER_GAIN_UNITY / num_streams : 0));
+#endif
+		if (i < NUM_STREAMS) {
+			zassert_ok(le_audio_sim_watch_queue(
+				i ? "sdu 1" : "sdu 0",
+				&audio_decoder_sdu_queue_get(decoder, stream)->ring));
+		}
+	}
+
+	for (uint32_t i = 0; i < num_streams; i++) {
+		zassert_ok(audio_decoder_start_channel(decoder, first_stream + i));
+	}
+
+	k_sleep(RUN_TIME);
+
+	zassert_ok(i2s_sync_get_queue_status(i2s_dev, I2S_DIR_TX, &i2s_queue));
+	le_audio_sim_get_report(&report);
+	le_audio_sim_print_report(title, &report);
+	queue_blocks = audio_decoder_audio_queue_get(decoder)->ring.block_count;
+	queue_limit = audio_decoder_audio_queue_get(decoder)->ring.limit;
+
+	for (uint32_t i = 0; i < num_streams; i++) {
+		zassert_ok(audio_decoder_get_channel_stats(decoder, first_stream + i,
+							   &stream_stats[i], false));
+		zassert_ok(audio_decoder_stop_channel(decoder, first_stream + i));
+	}
+
+	k_sleep(DRAIN_TIME);
+	i2s_sync_disable(i2s_dev, I2S_DIR_TX);
+	zassert_ok(audio_decoder_delete(decoder));
+}
+
+static void run_source(const char *const title, const struct gapi_isooshm_sim_trace *const trace,
+		       uint32_t const first_stream, enum audio_encoder_backpressure const policy)
+{
+	struct audio_encoder_params const params = {
+		.i2s_dev = i2s_dev,
+		.audio_buffer_len_us = PRES_DELAY_US,
+		.frame_duration_us = FRAME_DURATION_US,
+		.sampling_rate_hz = SAMPLING_RATE_HZ,
+	};
+
+	gapi_isooshm_sim_configure(trace);
+
+	struct audio_encoder *const encoder = audio_encoder_create(&params);
+
+	zassert_not_null(encoder, "Failed to create encoder");
+	zassert_ok(le_audio_sim_reset(i2s_dev));
+	zassert_ok(le_audio_sim_watch_queue("audio", &audio_encoder_audio_queue_get(encoder)->ring));
+
+	for (uint32_t i = 0; i < NUM_STREAMS; i++) {
+		zassert_ok(audio_encoder_add_channel(encoder, OCTETS_PER_FRAME, first_stream + i));
+		zassert_ok(
+			audio_encoder_set_backpressure_policy(encoder, first_stream + i, policy));
+		zassert_ok(le_audio_sim_watch_queue(
+			i ? "sdu 1" : "sdu 0",
+			&audio_encoder_sdu_queue_get(encoder, first_stream + i)->ring));
+	}
+
+	for (uint32_t i = 0; i < NUM_STREAMS; i++) {
+		zassert_ok(audio_encoder_start_channel(encoder, first_stream + i));
+	}
+
+	k_sleep(RUN_TIME);
+
+	zassert_ok(i2s_sync_get_queue_status(i2s_dev, I2S_DIR_RX, &i2s_queue));
+	le_audio_sim_get_report(&report);
+	le_audio_sim_print_report(title, &report);
+
+	for (uint32_t i = 0; i < NUM_STREAMS; i++) {
+		zassert_ok(audio_encoder_get_channel_stats(encoder, first_stream + i,
+							   &source_stats[i], false));
+		zassert_ok(audio_encoder_stop_channel(encoder, first_stream + i));
+	}
+
+	i2s_sync_disable(i2s_dev, I2S_DIR_RX);
+	k_sleep(DRAIN_TIME);
+	zassert_ok(audio_encoder_delete(encoder));
+}
+
+#define TOTAL(field) (report.streams[0].field + report.streams[1].field)
+
+ZTEST(le_audio_pipeline_sim, test_sink_clean)
+{
+	static const struct gapi_isooshm_sim_trace trace = {
+		.interval_us = FRAME_DURATION_US,
+		.sdu_len = OCTETS_PER_FRAME,
+		.delay_us = 1000,
+		.seed = 1,
+	};
+
+	run_sink("sink, clean link", &trace, 0, NUM_STREAMS);
+
+	zassert_true(report.sink.count >= MIN_FRAMES, "Only %u frames played", report.sink.count);
+	zassert_equal(TOTAL(lost), 0);
+	zassert_equal(TOTAL(overflows), 0, "SDUs dropped with no packet loss");
+	zassert_equal(report.i2s.tx_underruns, 0, "I2S underrun with no packet loss");
+	zassert_true(report.sink.max_us - report.sink.p50_us <= 1000,
+		     "Latency varies by more than 1 ms on a clean link");
+	/* A full driver queue is what lets the queued blocks be linked into the DMA transfer */
+	zassert_equal(i2s_queue.queued, i2s_queue.capacity, "Sink kept %u of %u I2S blocks queued",
+		      i2s_queue.queued, i2s_queue.capacity);
+
+	if (IS_ENABLED(CONFIG_ALIF_BLE_AUDIO_ADAPTIVE_QUEUE_DEPTH)) {
+		zassert_true(queue_limit < queue_blocks,
+			     "Audio queue depth not reduced on a clean link");
+	}
+}
+
+ZTEST(le_audio_pipeline_sim, test_sink_jitter)
+{
+	static const struct gapi_isooshm_sim_trace trace = {
+		.interval_us = FRAME_DURATION_US,
+		.sdu_len = OCTETS_PER_FRAME,
+		.delay_us = 1000,
+		.jitter_us = 6000,
+		.seed = 2,
+	};
+
+	run_sink("sink, 6 ms jitter", &trace, 0, NUM_STREAMS);
+
+	zassert_true(report.sink.count >= MIN_FRAMES, "Only %u frames played", report.sink.count);
+	zassert_equal(TOTAL(overflows), 0, "SDUs dropped due to jitter");
+	zassert_equal(report.i2s.tx_underruns, 0, "Jitter within the presentation delay underran");
+}
+
+ZTEST(le_audio_pipeline_sim, test_sink_loss_and_bursts)
+{
+	static const struct gapi_isooshm_sim_trace trace = {
+		.interval_us = FRAME_DURATION_US,
+		.sdu_len = OCTETS_PER_FRAME,
+		.delay_us = 1000,
+		.jitter_us = 2000,
+		.loss_permille = 20,
+		.burst_permille = 10,
+		.burst_len = 5,
+		.burst_loss_permille = 500,
+		.burst_delay_us = 15000,
+		.seed = 3,
+	};
+
+	run_sink("sink, loss and bursts", &trace, 0, NUM_STREAMS);
+
+	zassert_true(TOTAL(lost) > 0, "Trace generated no losses");
+	zassert_true(report.sink.count > MIN_FRAMES / 2, "Only %u frames played",
+		     report.sink.count);
+}
+
+ZTEST(le_audio_pipeline_sim, test_sink_recorded_trace)
+{
+	/* Delivery delays of a link with periodic interference: mostly on time, with a late SDU
+	 * holding back the ones behind it and an occasional lost SDU
+	 */
+	static const struct gapi_isooshm_sim_trace_event events[] = {
+		{1200, GAPI_ISOOSHM_SDU_STATUS_VALID}, {1300, GAPI_ISOOSHM_SDU_STATUS_VALID},
+		{1100, GAPI_ISOOSHM_SDU_STATUS_VALID}, {1250, GAPI_ISOOSHM_SDU_STATUS_VALID},
+		{9800, GAPI_ISOOSHM_SDU_STATUS_VALID}, {1200, GAPI_ISOOSHM_SDU_STATUS_VALID},
+		{1150, GAPI_ISOOSHM_SDU_STATUS_VALID}, {0, GAPI_ISOOSHM_SDU_STATUS_LOST},
+		{1300, GAPI_ISOOSHM_SDU_STATUS_VALID}, {1200, GAPI_ISOOSHM_SDU_STATUS_VALID},
+	};
+	static const struct gapi_isooshm_sim_trace trace = {
+		.interval_us = FRAME_DURATION_US,
+		.sdu_len = OCTETS_PER_FRAME,
+		.events = events,
+		.num_events = ARRAY_SIZE(events),
+	};
+
+	run_sink("sink, recorded trace", &trace, 0, NUM_STREAMS);
+
+	zassert_true(TOTAL(lost) >= report.streams[0].anchors / ARRAY_SIZE(events));
+	zassert_true(report.sink.count > MIN_FRAMES / 2, "Only %u frames played",
+		     report.sink.count);
+}
+
+#if CONFIG_ALIF_BLE_AUDIO_DECODER_MIXER
+ZTEST(le_audio_pipeline_sim, test_sink_mixer)
+{
+	static const struct gapi_isooshm_sim_trace trace = {
+		.interval_us = FRAME_DURATION_US,
+		.sdu_len = OCTETS_PER_FRAME,
+		.delay_us = 1000,
+		.jitter_us = 500,
+		.seed = 4,
+	};
+	uint32_t total_cycles = 0;
+
+	run_sink("sink, mixer", &trace, 0, MIXER_STREAMS);
+
+	zassert_true(report.sink.count >= MIN_FRAMES, "Only %u frames played", report.sink.count);
+	zassert_equal(report.i2s.tx_underruns, 0, "I2S underrun while mixing");
+
+	for (uint32_t stream = 0; stream < MIXER_STREAMS; stream++) {
+		zassert_true(stream_stats[stream].frames >= MIN_FRAMES,
+			     "Only %u frames decoded on stream %u", stream_stats[stream].frames,
+			     stream);
+		total_cycles += stream_stats[stream].cycles_avg;
+	}
+
+	zassert_true(total_cycles < stream_stats[0].frame_budget_cycles,
+		     "Decoding %u streams does not fit in a frame", MIXER_STREAMS);
+	printk("%u streams: %u of %u cycles per frame\n", MIXER_STREAMS, total_cycles,
+	       stream_stats[0].frame_budget_cycles);
+}
+#endif
+
+ZTEST(le_audio_pipeline_sim, test_source)
+{
+	run_source("source", NULL, 0, AUDIO_ENCODER_BACKPRESSURE_DROP_NEWEST);
+
+	zassert_true(report.source.count >= MIN_FRAMES, "Only %u frames sent",
+		     report.source.count);
+	/* Anchor points before the first SDU is encoded are expected to underrun */
+	zassert_true(TOTAL(underruns) <= NUM_STREAMS * (PRES_DELAY_US / FRAME_DURATION_US + 2),
+		     "%u input underruns", TOTAL(underruns));
+	zassert_equal(i2s_queue.queued, i2s_queue.capacity,
+		      "Source kept %u of %u I2S blocks queued", i2s_queue.queued,
+		      i2s_queue.capacity);
+
+	/* The controller keeps up with a clean link, so no frame should hit backpressure */
+	for (uint32_t stream = 0; stream < NUM_STREAMS; stream++) {
+		zassert_true(source_stats[stream].encoded >= MIN_FRAMES, "Stream %u encoded %u",
+			     stream, source_stats[stream].encoded);
+		zassert_equal(source_stats[stream].dropped + source_stats[stream].skipped, 0,
+			      "Stream %u dropped %u and skipped %u frames", stream,
+			      source_stats[stream].dropped, source_stats[stream].skipped);
+	}
+}
+
+ZTEST(le_audio_pipeline_sim, test_source_drop_oldest)
+{
+	/* The controller takes an SDU every 11 ms, slower than the 10 ms frames are encoded, so
+	 * the SDU queues fill up and stay full
+	 */
+	static const struct gapi_isooshm_sim_trace slow_link = {
+		.interval_us = 11000,
+		.sdu_len = OCTETS_PER_FRAME,
+		.seed = 1,
+	};
+
+	run_source("source, slow link, drop oldest", &slow_link, 0,
+		   AUDIO_ENCODER_BACKPRESSURE_DROP_OLDEST);
+
+	for (uint32_t stream = 0; stream < NUM_STREAMS; stream++) {
+		zassert_true(source_stats[stream].flushed > 0, "Stream %u flushed no SDUs",
+			     stream);
+		/* Most frames replace the oldest queued SDU rather than being dropped */
+		zassert_true(source_stats[stream].dropped < source_stats[stream].flushed,
+			     "Stream %u dropped %u frames and flushed %u SDUs", stream,
+			     source_stats[stream].dropped, source_stats[stream].flushed);
+		/* Only single SDUs are discarded, never the whole queue */
+		zassert_true(report.streams[stream].max_seq_step <= 3,
+			     "Stream %u skipped %u sequence numbers at once", stream,
+			     report.streams[stream].max_seq_step - 1);
+	}
+}
+
+#if CONFIG_ALIF_BLE_AUDIO_DATAPATH_TRACE
+/* First stream ID of the trace test. The codecs give the streams channels from 0, so each
+ * stream's ID differs from its channel index.
+ */
+#define TRACE_FIRST_STREAM 2
+/* Events at the start of the snapshot whose earlier stage may have been overwritten */
+#define TRACE_SKIP_EVENTS  128
+
+static struct datapath_trace_entry snapshot[CONFIG_ALIF_BLE_AUDIO_DATAPATH_TRACE_SIZE];
+
+/* Check that every event of stage to follows an event of stage from of the same frame */
+static void check_stage_pairs(uint8_t const from, uint8_t const to)
+{
+	size_t const count = datapath_trace_snapshot(snapshot, ARRAY_SIZE(snapshot));
+	uint32_t checked = 0;
+
+	for (size_t i = TRACE_SKIP_EVENTS; i < count; i++) {
+		if (snapshot[i].event != to) {
+			continue;
+		}
+
+		zassert_true(snapshot[i].channel >= TRACE_FIRST_STREAM &&
+				     snapshot[i].channel < TRACE_FIRST_STREAM + NUM_STREAMS,
+			     "%s recorded on channel %u", datapath_trace_event_name(to),
+			     snapshot[i].channel);
+
+		size_t j = i;
+
+		while (j-- > 0) {
+			if (snapshot[j].event == from &&
+			    datapath_trace_same_frame(&snapshot[j], &snapshot[i])) {
+				break;
+			}
+		}
+
+		zassert_true(j < i, "%s of stream %u frame %u has no %s",
+			     datapath_trace_event_name(to), snapshot[i].channel, snapshot[i].arg,
+			     datapath_trace_event_name(from));
+		checked++;
+	}
+
+	zassert_true(checked > 0, "No %s events traced", datapath_trace_event_name(to));
+}
+
+ZTEST(le_audio_pipeline_sim, test_trace_stream_ids)
+{
+	static const struct gapi_isooshm_sim_trace trace = {
+		.interval_us = FRAME_DURATION_US,
+		.sdu_len = OCTETS_PER_FRAME,
+		.delay_us = 1000,
+		.seed = 5,
+	};
+
+	datapath_trace_clear();
+	run_sink("sink, traced", &trace, TRACE_FIRST_STREAM, NUM_STREAMS);
+	check_stage_pairs(DATAPATH_TRACE_ISO_RX_DONE, DATAPATH_TRACE_SDU_QUEUED);
+	check_stage_pairs(DATAPATH_TRACE_SDU_QUEUED, DATAPATH_TRACE_DECODE_START);
+	check_stage_pairs(DATAPATH_TRACE_DECODE_START, DATAPATH_TRACE_DECODE_END);
+
+	datapath_trace_clear();
+	run_source("source, traced", NULL, TRACE_FIRST_STREAM,
+		   AUDIO_ENCODER_BACKPRESSURE_DROP_NEWEST);
+	check_stage_pairs(DATAPATH_TRACE_ENCODE_START, DATAPATH_TRACE_ENCODE_END);
+	check_stage_pairs(DATAPATH_TRACE_ENCODE_END, DATAPATH_TRACE_ISO_TX_DONE);
+}
+#endif
+
+ZTEST(le_audio_pipeline_sim, test_codec_mem)
+{
+	static uint8_t region[4096] __aligned(8);
+	struct audio_decoder_params params = {
+		.i2s_dev = i2s_dev,
+		.pres_delay_us = PRES_DELAY_US,
+		.frame_duration_us = FRAME_DURATION_US,
+		.sampling_rate_hz = SAMPLING_RATE_HZ,
+	};
+	size_t const mem_size = audio_decoder_mem_size(&params);
+
+	zassert_true(mem_size > 0 && mem_size <= sizeof(region), "Decoder needs %u bytes",
+		     mem_size);
+
+	/* A region which is too small is refused rather than overrun */
+	params.mem = region;
+	params.mem_size = mem_size - 1;
+	zassert_is_null(audio_decoder_create(&params));
+
+	/* The decoder is placed in the region provided, unaligned or not */
+	params.mem = region + 1;
+	params.mem_size = mem_size;
+
+	struct audio_decoder *const decoder = audio_decoder_create(&params);
+
+	zassert_not_null(decoder, "Failed to create decoder in provided region");
+	zassert_true((uint8_t *)decoder > region && (uint8_t *)decoder < region + mem_size);
+	zassert_ok(audio_decoder_register_cb(decoder, le_audio_sim_on_decoded, NULL));
+	zassert_ok(audio_decoder_delete(decoder));
+}
+
+static atomic_t i2s_completed;
+
+static void on_i2s_block(const struct device *dev, enum i2s_sync_status status, void *buf)
+{
+	atomic_inc(&i2s_completed);
+}
+
+ZTEST(le_audio_pipeline_sim, test_i2s_queue)
+{
+	static int16_t blocks[3][2 * SAMPLING_RATE_HZ / 1000];
+	struct i2s_sync_queue_status status;
+
+	zassert_ok(i2s_sync_get_queue_status(i2s_dev, I2S_DIR_TX, &status));
+	uint32_t const underruns = status.underruns;
+
+	zassert_true(status.capacity >= 2, "Queue depth %u", status.capacity);
+
+	/* Blocks beyond the queue depth are refused, the others are played back to back */
+	atomic_clear(&i2s_completed);
+	zassert_ok(i2s_sync_register_cb(i2s_dev, I2S_DIR_TX, on_i2s_block));
+	for (uint32_t i = 0; i < status.capacity; i++) {
+		zassert_ok(i2s_sync_send(i2s_dev, blocks[i % 2], sizeof(blocks[0])));
+	}
+	zassert_equal(i2s_sync_send(i2s_dev, blocks[2], sizeof(blocks[2])), -EINPROGRESS);
+
+	zassert_ok(i2s_sync_get_queue_status(i2s_dev, I2S_DIR_TX, &status));
+	zassert_equal(status.queued, status.capacity);
+
+	/* Each block lasts 1 ms. Nothing follows the last one, so the transmitter runs dry. */
+	k_sleep(K_USEC(status.capacity * 1000 + 500));
+	zassert_equal(atomic_get(&i2s_completed), status.capacity);
+	zassert_ok(i2s_sync_get_queue_status(i2s_dev, I2S_DIR_TX, &status));
+	zassert_equal(status.queued, 0);
+	zassert_equal(status.underruns, underruns + 1);
+
+	i2s_sync_disable(i2s_dev, I2S_DIR_TX);
+	zassert_ok(i2s_sync_register_cb(i2s_dev, I2S_DIR_TX, NULL));
+}
+
+static void *pipeline_sim_setup(void)
+{
+	zassert_true(device_is_ready(i2s_dev), "Emulated I2S device not ready");
+
+	return NULL;
+}
+
+ZTEST_SUITE(le_audio_pipeline_sim, NULL, pipeline_sim_setup, NULL, NULL, NULL);
@@ -0,0 +1,306 @@
+/* Copyright Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <string.h>
+#include <drivers/i2s_sync.h>
+#include <drivers/i2s_sync_emul.h>
+
+#define I2S_NODE DT_NODELABEL(i2s_emul)
+
+#define SAMPLE_RATE    DT_PROP(I2S_NODE, sample_rate)
+#define CHANNELS       2
+#define PERIODS        4
+/* 1 ms periods */
+#define PERIOD_FRAMES  (SAMPLE_RATE / 1000)
+#define PERIOD_SAMPLES (PERIOD_FRAMES * CHANNELS)
+#define PERIOD_BYTES   (PERIOD_SAMPLES * sizeof(int16_t))
+#define MAX_EVENTS     32
+
+static const struct device *const i2s_dev = DEVICE_DT_GET(I2S_NODE);
+
+static int16_t tx_ring[PERIODS * PERIOD_SAMPLES];
+static int16_t rx_ring[PERIODS * PERIOD_SAMPLES];
+
+struct stream_log {
+	void *period[MAX_EVENTS];
+	uint32_t timestamp[MAX_EVENTS];
+	size_t count;
+	/* Next value expected in, or written to, the ring */
+	int16_t next;
+	uint32_t errors;
+};
+
+static struct stream_log tx_log;
+static struct stream_log rx_log;
+
+static void log_period(struct stream_log *const log, void *const period, uint32_t const timestamp)
+{
+	if (log->count < MAX_EVENTS) {
+		log->period[log->count] = period;
+		log->timestamp[log->count] = timestamp;
+	}
+	log->count++;
+}
+
+static void on_tx_period(const struct device *dev, enum i2s_sync_status status, void *period,
+			 uint32_t timestamp, void *user_data)
+{
+	struct stream_log *const log = user_data;
+	int16_t *const samples = period;
+
+	if (status != I2S_SYNC_STATUS_OK) {
+		log->errors++;
+	}
+
+	log_period(log, period, timestamp);
+
+	/* Refill the period that completed with the continuation of the ramp */
+	for (size_t i = 0; i < PERIOD_SAMPLES; i++) {
+		samples[i] = log->next++;
+	}
+}
+
+static void on_rx_period(const struct device *dev, enum i2s_sync_status status, void *period,
+			 uint32_t timestamp, void *user_data)
+{
+	struct stream_log *const log = user_data;
+	int16_t const *const samples = period;
+
+	if (status != I2S_SYNC_STATUS_OK) {
+		log->errors++;
+	}
+
+	log_period(log, period, timestamp);
+
+	for (size_t i = 0; i < PERIOD_SAMPLES; i++) {
+		if (samples[i] != log->next++) {
+			log->errors++;
+		}
+	}
+}
+
+static void fill_tx_ring(void)
+{
+	memset(&tx_log, 0, sizeof(tx_log));
+
+	for (size_t i = 0; i < ARRAY_SIZE(tx_ring); i++) {
+		tx_ring[i] = tx_log.next++;
+	}
+}
+
+static struct i2s_sync_stream_config const tx_stream = {
+	.buf = tx_ring,
+	.len = sizeof(tx_ring),
+	.periods = PERIODS,
+	.cb = on_tx_period,
+	.user_data = &tx_log,
+};
+
+static struct i2s_sync_stream_config const rx_stream = {
+	.buf = rx_ring,
+	.len = sizeof(rx_ring),
+	.periods = PERIODS,
+	.cb = on_rx_period,
+	.user_data = &rx_log,
+};
+
+static void *i2s_sync_emul_setup(void)
+{
+	struct i2s_sync_config const cfg = {
+		.sample_rate = SAMPLE_RATE,
+		.bit_depth = 16,
+		.channel_count = CHANNELS,
+	};
+
+	zassert_true(device_is_ready(i2s_dev));
+	zassert_ok(i2s_sync_configure(i2s_dev, &cfg));
+
+	return NULL;
+}
+
+static void i2s_sync_emul_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+	i2s_sync_disable(i2s_dev, I2S_DIR_BOTH);
+	i2s_sync_emul_set_clock_ppm(i2s_dev, 0);
+	i2s_sync_emul_set_hooks(i2s_dev, NULL, NULL);
+}
+
+ZTEST(i2s_sync_emul, test_stream_periods_wrap)
+{
+	uint32_t const period_cycles = sys_clock_hw_cycles_per_sec() / 1000;
+	uint32_t const tolerance = sys_clock_hw_cycles_per_sec() / CONFIG_SYS_CLOCK_TICKS_PER_SEC;
+
+	fill_tx_ring();
+	zassert_ok(i2s_sync_stream_start(i2s_dev, I2S_DIR_TX, &tx_stream));
+
+	k_sleep(K_USEC(10500));
+	zassert_ok(i2s_sync_disable(i2s_dev, I2S_DIR_TX));
+
+	size_t const count = tx_log.count;
+
+	zassert_equal(count, 10, "%zu periods completed in 10.5 ms", count);
+	zassert_equal(tx_log.errors, 0);
+
+	for (size_t i = 0; i < count; i++) {
+		zassert_equal_ptr(tx_log.period[i], &tx_ring[(i % PERIODS) * PERIOD_SAMPLES],
+				  "period %zu out of order", i);
+		if (i) {
+			uint32_t const delta = tx_log.timestamp[i] - tx_log.timestamp[i - 1];
+
+			zassert_within(delta, period_cycles, tolerance, "period %zu took %u cycles",
+				       i, delta);
+		}
+	}
+
+	/* No further callbacks once disabled */
+	k_sleep(K_MSEC(3));
+	zassert_equal(tx_log.count, count);
+}
+
+ZTEST(i2s_sync_emul, test_stream_loopback)
+{
+	memset(&rx_log, 0, sizeof(rx_log));
+	fill_tx_ring();
+
+	zassert_ok(i2s_sync_stream_start(i2s_dev, I2S_DIR_TX, &tx_stream));
+	zassert_ok(i2s_sync_stream_start(i2s_dev, I2S_DIR_RX, &rx_stream));
+
+	/* Long enough for the TX ring to be refilled several times */
+	k_sleep(K_USEC(20500));
+	zassert_ok(i2s_sync_disable(i2s_dev, I2S_DIR_BOTH));
+
+	zassert_equal(rx_log.count, 20, "%zu periods received in 20.5 ms", rx_log.count);
+	zassert_equal(rx_log.errors, 0, "%u samples not received as transmitted",
+		      rx_log.errors);
+	zassert_equal(rx_log.next, tx_log.next - PERIODS * PERIOD_SAMPLES);
+}
+
+ZTEST(i2s_sync_emul, test_stream_busy)
+{
+	static int16_t block[PERIOD_SAMPLES];
+
+	fill_tx_ring();
+	zassert_ok(i2s_sync_stream_start(i2s_dev, I2S_DIR_TX, &tx_stream));
+
+	zassert_equal(i2s_sync_stream_start(i2s_dev, I2S_DIR_TX, &tx_stream), -EBUSY);
+	zassert_equal(i2s_sync_send(i2s_dev, block, sizeof(block)), -EBUSY);
+
+	/* The other direction is independent */
+	zassert_ok(i2s_sync_recv(i2s_dev, block, sizeof(block)));
+	zassert_equal(i2s_sync_stream_start(i2s_dev, I2S_DIR_RX, &rx_stream), -EBUSY);
+
+	zassert_ok(i2s_sync_disable(i2s_dev, I2S_DIR_BOTH));
+	zassert_ok(i2s_sync_send(i2s_dev, block, sizeof(block)));
+}
+
+static uint32_t uptime_us(void)
+{
+	return (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+ZTEST(i2s_sync_emul, test_stream_clock)
+{
+	struct i2s_sync_stream_config cfg = tx_stream;
+	uint32_t const tick_us = USEC_PER_SEC / CONFIG_SYS_CLOCK_TICKS_PER_SEC;
+
+	/* A clock 10% fast, with the periods timestamped in microseconds */
+	cfg.get_time = uptime_us;
+	i2s_sync_emul_set_clock_ppm(i2s_dev, 100000);
+
+	fill_tx_ring();
+	zassert_ok(i2s_sync_stream_start(i2s_dev, I2S_DIR_TX, &cfg));
+
+	k_sleep(K_USEC(10500));
+	zassert_ok(i2s_sync_disable(i2s_dev, I2S_DIR_TX));
+
+	size_t const count = MIN(tx_log.count, MAX_EVENTS);
+
+	zassert_equal(tx_log.count, 11, "%zu periods completed in 10.5 ms", tx_log.count);
+
+	for (size_t i = 1; i < count; i++) {
+		uint32_t const delta = tx_log.timestamp[i] - tx_log.timestamp[i - 1];
+
+		zassert_within(delta, 909, tick_us, "period %zu took %u us", i, delta);
+	}
+}
+
+static uint32_t hook_start_us;
+static size_t hook_count;
+
+static void on_tx_hook(void *buf, size_t len, uint32_t start_us)
+{
+	hook_start_us = start_us;
+	hook_count++;
+}
+
+static void on_rx_hook(void *buf, size_t len, uint32_t start_us)
+{
+	int16_t *const samples = buf;
+
+	/* Replace what was looped back with the expected ramp */
+	for (size_t i = 0; i < len / sizeof(samples[0]); i++) {
+		samples[i] = (int16_t)(rx_log.next + i);
+	}
+}
+
+ZTEST(i2s_sync_emul, test_hooks_and_counters)
+{
+	static int16_t block[PERIOD_SAMPLES];
+	struct i2s_sync_emul_counters counters;
+
+	memset(&rx_log, 0, sizeof(rx_log));
+	hook_count = 0;
+	i2s_sync_emul_get_counters(i2s_dev, NULL, true);
+	i2s_sync_emul_set_hooks(i2s_dev, on_tx_hook, on_rx_hook);
+
+	uint32_t const start_us = uptime_us();
+
+	/* A single block, so the transmitter runs dry once it completes */
+	zassert_ok(i2s_sync_send(i2s_dev, block, sizeof(block)));
+	zassert_ok(i2s_sync_stream_start(i2s_dev, I2S_DIR_RX, &rx_stream));
+
+	k_sleep(K_USEC(5500));
+	zassert_ok(i2s_sync_disable(i2s_dev, I2S_DIR_BOTH));
+
+	zassert_equal(hook_count, 1);
+	zassert_equal(hook_start_us, start_us);
+	zassert_equal(rx_log.errors, 0, "%u samples not those of the hook", rx_log.errors);
+
+	i2s_sync_emul_get_counters(i2s_dev, &counters, true);
+	zassert_equal(counters.tx_blocks, 1);
+	zassert_equal(counters.tx_underruns, 1);
+	zassert_equal(counters.rx_blocks, 5);
+
+	i2s_sync_emul_get_counters(i2s_dev, &counters, false);
+	zassert_equal(counters.tx_blocks + counters.tx_underruns + counters.rx_blocks, 0);
+}
+
+ZTEST(i2s_sync_emul, test_stream_invalid_config)
+{
+	struct i2s_sync_stream_config cfg = tx_stream;
+
+	cfg.periods = 1;
+	zassert_equal(i2s_sync_stream_start(i2s_dev, I2S_DIR_TX, &cfg), -EINVAL);
+
+	cfg.periods = CONFIG_I2S_SYNC_STREAM_MAX_PERIODS + 1;
+	zassert_equal(i2s_sync_stream_start(i2s_dev, I2S_DIR_TX, &cfg), -EINVAL);
+
+	/* Periods must be whole frames */
+	cfg.periods = PERIODS;
+	cfg.len = PERIODS * (PERIOD_BYTES + sizeof(int16_t));
+	zassert_equal(i2s_sync_stream_start(i2s_dev, I2S_DIR_TX, &cfg), -EINVAL);
+
+	cfg = tx_stream;
+	zassert_equal(i2s_sync_stream_start(i2s_dev, I2S_DIR_BOTH, &cfg), -EINVAL);
+}
+
+ZTEST_SUITE(i2s_sync_emul, NULL, i2s_sync_emul_setup, NULL, i2s_sync_emul_after, NULL);
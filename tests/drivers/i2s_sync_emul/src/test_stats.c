@@ -0,0 +1,119 @@
+/* Copyright Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <drivers/i2s_sync.h>
+
+#define I2S_NODE DT_NODELABEL(i2s_emul)
+
+#define SAMPLE_RATE DT_PROP(I2S_NODE, sample_rate)
+/* 1 ms stereo 16-bit blocks */
+#define BLOCK_SAMPLES ((SAMPLE_RATE / 1000) * 2)
+/* Time the callback takes before it provides the next block */
+#define CALLBACK_US   200
+#define RESENDS       5
+
+static const struct device *const i2s_dev = DEVICE_DT_GET(I2S_NODE);
+
+static int16_t blocks[2][BLOCK_SAMPLES];
+static uint32_t resends;
+
+static void on_tx_block(const struct device *dev, enum i2s_sync_status status, void *buffer)
+{
+	if (resends) {
+		resends--;
+		k_busy_wait(CALLBACK_US);
+		i2s_sync_send(dev, buffer, sizeof(blocks[0]));
+	}
+}
+
+static void *i2s_sync_emul_stats_setup(void)
+{
+	struct i2s_sync_config const cfg = {
+		.sample_rate = SAMPLE_RATE,
+		.bit_depth = 16,
+		.channel_count = 2,
+	};
+
+	zassert_ok(i2s_sync_disable(i2s_dev, I2S_DIR_BOTH));
+	zassert_ok(i2s_sync_configure(i2s_dev, &cfg));
+
+	return NULL;
+}
+
+static void i2s_sync_emul_stats_before(void *fixture)
+{
+	struct i2s_sync_stats stats;
+
+	ARG_UNUSED(fixture);
+
+	resends = 0;
+	zassert_ok(i2s_sync_register_cb(i2s_dev, I2S_DIR_TX, on_tx_block));
+	zassert_ok(i2s_sync_get_stats(i2s_dev, &stats, true));
+}
+
+static void i2s_sync_emul_stats_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	i2s_sync_disable(i2s_dev, I2S_DIR_BOTH);
+	i2s_sync_register_cb(i2s_dev, I2S_DIR_TX, NULL);
+}
+
+ZTEST(i2s_sync_emul_stats, test_queued_blocks)
+{
+	struct i2s_sync_stats stats;
+
+	zassert_ok(i2s_sync_send(i2s_dev, blocks[0], sizeof(blocks[0])));
+	zassert_ok(i2s_sync_send(i2s_dev, blocks[1], sizeof(blocks[1])));
+
+	k_sleep(K_USEC(2500));
+	zassert_ok(i2s_sync_get_stats(i2s_dev, &stats, false));
+
+	zassert_equal(stats.tx.blocks, 2);
+	zassert_equal(stats.tx.underruns, 1);
+	zassert_equal(stats.tx.overruns, 0);
+	zassert_equal(stats.tx.queue_high, 2);
+	/* One block left after the first completed, none after the second */
+	zassert_equal(stats.tx.queue_low, 0);
+	zassert_equal(stats.rx.blocks, 0);
+}
+
+ZTEST(i2s_sync_emul_stats, test_callback_restart)
+{
+	struct i2s_sync_stats stats;
+
+	resends = RESENDS;
+	zassert_ok(i2s_sync_send(i2s_dev, blocks[0], sizeof(blocks[0])));
+
+	k_sleep(K_USEC((RESENDS + 1) * (1000 + CALLBACK_US) + 500));
+	zassert_ok(i2s_sync_get_stats(i2s_dev, &stats, true));
+
+	zassert_equal(stats.tx.blocks, RESENDS + 1);
+	/* Only the last block was not followed by another */
+	zassert_equal(stats.tx.underruns, 1);
+	zassert_equal(stats.tx.queue_high, 1);
+	zassert_true(stats.tx.callback_max_ns >= CALLBACK_US * NSEC_PER_USEC, "%u ns",
+		     stats.tx.callback_max_ns);
+	zassert_true(stats.tx.callback_avg_ns <= stats.tx.callback_max_ns);
+	/* Each block after the first was started from the callback */
+	zassert_true(stats.tx.restart_max_ns >= CALLBACK_US * NSEC_PER_USEC, "%u ns",
+		     stats.tx.restart_max_ns);
+
+	/* Cleared once read */
+	zassert_ok(i2s_sync_get_stats(i2s_dev, &stats, false));
+	zassert_equal(stats.tx.blocks, 0);
+	zassert_equal(stats.tx.underruns, 0);
+	zassert_equal(stats.tx.callback_max_ns, 0);
+	zassert_equal(stats.tx.restart_max_ns, 0);
+}
+
+ZTEST_SUITE(i2s_sync_emul_stats, NULL, i2s_sync_emul_stats_setup, i2s_sync_emul_stats_before,
+	    i2s_sync_emul_stats_after, NULL);
@@ -0,0 +1,318 @@
+/* Copyright Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <string.h>
+#include <drivers/i2s_sync.h>
+
+#define I2S_NODE DT_NODELABEL(i2s_emul)
+
+#define SAMPLE_RATE DT_PROP(I2S_NODE, sample_rate)
+/* 1 ms blocks */
+#define FRAMES      (SAMPLE_RATE / 1000)
+#define MAX_SAMPLES (FRAMES * I2S_SYNC_MAX_SLOTS)
+#define PERIODS     4
+
+static const struct device *const i2s_dev = DEVICE_DT_GET(I2S_NODE);
+
+static int32_t tx_buf[PERIODS * MAX_SAMPLES];
+static int32_t rx_buf[PERIODS * MAX_SAMPLES];
+
+static K_SEM_DEFINE(rx_done, 0, 1);
+
+static struct i2s_sync_config tdm_cfg;
+
+static void on_rx_block(const struct device *dev, enum i2s_sync_status status, void *buffer)
+{
+	k_sem_give(&rx_done);
+}
+
+/* Distinct value for each frame and slot, of both signs, that fits in the bit depth */
+static int32_t test_value(uint32_t const bit_depth, size_t const frame, size_t const slot)
+{
+	int32_t const scale = bit_depth == 16 ? 1 : bit_depth == 24 ? 1000 : 1000000;
+	int32_t const value = (int32_t)((frame * I2S_SYNC_MAX_SLOTS) + slot + 1) * scale;
+
+	return (frame & 1) ? -value : value;
+}
+
+static size_t buf_index(size_t const frames, size_t const frame, size_t const channel,
+			size_t const channels)
+{
+	if (i2s_sync_is_planar(&tdm_cfg)) {
+		return (channel * frames) + frame;
+	}
+
+	return (frame * channels) + channel;
+}
+
+static void put_sample(void *const buf, size_t const idx, int32_t const value)
+{
+	if (tdm_cfg.bit_depth == 16) {
+		((int16_t *)buf)[idx] = (int16_t)value;
+	} else {
+		((int32_t *)buf)[idx] = value;
+	}
+}
+
+static int32_t get_sample(const void *const buf, size_t const idx)
+{
+	if (tdm_cfg.bit_depth == 16) {
+		return ((const int16_t *)buf)[idx];
+	}
+
+	return ((const int32_t *)buf)[idx];
+}
+
+/* Fill a TX buffer of the given frames, starting at frame number first */
+static void fill_tx(void *const buf, size_t const frames, size_t const first)
+{
+	uint8_t const mask = i2s_sync_slot_mask(&tdm_cfg, I2S_DIR_TX);
+	size_t const channels = i2s_sync_channels(&tdm_cfg, I2S_DIR_TX);
+
+	for (size_t frame = 0; frame < frames; frame++) {
+		size_t channel = 0;
+
+		for (size_t slot = 0; slot < I2S_SYNC_MAX_SLOTS; slot++) {
+			if (mask & BIT(slot)) {
+				put_sample(buf, buf_index(frames, frame, channel++, channels),
+					   test_value(tdm_cfg.bit_depth, first + frame, slot));
+			}
+		}
+	}
+}
+
+/* Count the samples of an RX buffer that differ from those transmitted, or from silence on slots
+ * that were not transmitted
+ */
+static uint32_t check_rx(const void *const buf, size_t const frames, size_t const first)
+{
+	uint8_t const tx_mask = i2s_sync_slot_mask(&tdm_cfg, I2S_DIR_TX);
+	uint8_t const rx_mask = i2s_sync_slot_mask(&tdm_cfg, I2S_DIR_RX);
+	size_t const channels = i2s_sync_channels(&tdm_cfg, I2S_DIR_RX);
+	uint32_t errors = 0;
+
+	for (size_t frame = 0; frame < frames; frame++) {
+		size_t channel = 0;
+
+		for (size_t slot = 0; slot < I2S_SYNC_MAX_SLOTS; slot++) {
+			if (!(rx_mask & BIT(slot))) {
+				continue;
+			}
+
+			int32_t const expected = (tx_mask & BIT(slot))
+				? test_value(tdm_cfg.bit_depth, first + frame, slot)
+				: 0;
+
+			if (get_sample(buf, buf_index(frames, frame, channel++, channels)) !=
+			    expected) {
+				errors++;
+			}
+		}
+	}
+
+	return errors;
+}
+
+static void configure_tdm(uint8_t const slots, uint32_t const bit_depth, uint8_t const tx_mask,
+			  uint8_t const rx_mask, enum i2s_sync_layout const layout)
+{
+	/* The configuration can only be changed while both directions are disabled */
+	zassert_ok(i2s_sync_disable(i2s_dev, I2S_DIR_BOTH));
+
+	tdm_cfg = (struct i2s_sync_config){
+		.sample_rate = SAMPLE_RATE,
+		.bit_depth = bit_depth,
+		.channel_count = 2,
+		.slots = slots,
+		.tx_slot_mask = tx_mask,
+		.rx_slot_mask = rx_mask,
+		.layout = layout,
+	};
+
+	zassert_ok(i2s_sync_configure(i2s_dev, &tdm_cfg));
+}
+
+/* Transmit and receive one block, and check what was received */
+static void loopback_block(void)
+{
+	size_t const tx_len = FRAMES * i2s_sync_frame_bytes(&tdm_cfg, I2S_DIR_TX);
+	size_t const rx_len = FRAMES * i2s_sync_frame_bytes(&tdm_cfg, I2S_DIR_RX);
+
+	memset(rx_buf, 0x5a, sizeof(rx_buf));
+	fill_tx(tx_buf, FRAMES, 0);
+
+	zassert_ok(i2s_sync_send(i2s_dev, tx_buf, tx_len));
+	zassert_ok(i2s_sync_recv(i2s_dev, rx_buf, rx_len));
+	zassert_ok(k_sem_take(&rx_done, K_MSEC(5)));
+
+	uint32_t const errors = check_rx(rx_buf, FRAMES, 0);
+
+	zassert_equal(errors, 0, "%u samples received wrong with %u bits, masks 0x%02x 0x%02x",
+		      errors, tdm_cfg.bit_depth, tdm_cfg.tx_slot_mask, tdm_cfg.rx_slot_mask);
+}
+
+static void *i2s_sync_emul_tdm_setup(void)
+{
+	zassert_true(device_is_ready(i2s_dev));
+	zassert_ok(i2s_sync_register_cb(i2s_dev, I2S_DIR_RX, on_rx_block));
+
+	return NULL;
+}
+
+static void i2s_sync_emul_tdm_after(void *fixture)
+{
+	struct i2s_sync_config const stereo = {
+		.sample_rate = SAMPLE_RATE,
+		.bit_depth = 16,
+		.channel_count = 2,
+	};
+
+	ARG_UNUSED(fixture);
+	i2s_sync_disable(i2s_dev, I2S_DIR_BOTH);
+	k_sem_reset(&rx_done);
+	zassert_ok(i2s_sync_configure(i2s_dev, &stereo));
+}
+
+static void i2s_sync_emul_tdm_teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+	i2s_sync_register_cb(i2s_dev, I2S_DIR_RX, NULL);
+}
+
+ZTEST(i2s_sync_emul_tdm, test_slot_mapping)
+{
+	/* Slots 2 and 3 are received from the transmitter, 4 and 5 are silent */
+	configure_tdm(8, 32, 0x0f, 0x3c, I2S_SYNC_LAYOUT_INTERLEAVED);
+	loopback_block();
+
+	/* Sparse masks map to consecutive channels of the buffers */
+	configure_tdm(8, 32, 0xa5, 0x81, I2S_SYNC_LAYOUT_INTERLEAVED);
+	loopback_block();
+
+	configure_tdm(4, 16, 0x06, 0x0c, I2S_SYNC_LAYOUT_PLANAR);
+	loopback_block();
+}
+
+ZTEST(i2s_sync_emul_tdm, test_bit_depths_and_layouts)
+{
+	static const uint32_t bit_depths[] = {16, 24, 32};
+	static const enum i2s_sync_layout layouts[] = {I2S_SYNC_LAYOUT_INTERLEAVED,
+							I2S_SYNC_LAYOUT_PLANAR};
+
+	for (size_t i = 0; i < ARRAY_SIZE(bit_depths); i++) {
+		for (size_t j = 0; j < ARRAY_SIZE(layouts); j++) {
+			configure_tdm(4, bit_depths[i], 0x0f, 0x0f, layouts[j]);
+			loopback_block();
+		}
+	}
+
+	/* Standard two slot frames, right slot only */
+	configure_tdm(0, 16, 0x02, 0x03, I2S_SYNC_LAYOUT_DEFAULT);
+	loopback_block();
+}
+
+ZTEST(i2s_sync_emul_tdm, test_invalid_slots)
+{
+	struct i2s_sync_config cfg = {
+		.sample_rate = SAMPLE_RATE,
+		.bit_depth = 16,
+		.channel_count = 2,
+		.slots = I2S_SYNC_MAX_SLOTS + 1,
+	};
+
+	zassert_equal(i2s_sync_configure(i2s_dev, &cfg), -EINVAL);
+
+	/* Mask selects a slot beyond the frame */
+	cfg.slots = 4;
+	cfg.tx_slot_mask = 0x10;
+	zassert_equal(i2s_sync_configure(i2s_dev, &cfg), -EINVAL);
+
+	/* Blocks must be whole frames of the selected slots */
+	configure_tdm(8, 32, 0x07, 0x07, I2S_SYNC_LAYOUT_INTERLEAVED);
+	zassert_equal(i2s_sync_send(i2s_dev, tx_buf, 2 * sizeof(int32_t)), -EINVAL);
+	zassert_ok(i2s_sync_send(i2s_dev, tx_buf, 3 * sizeof(int32_t)));
+}
+
+struct tdm_stream {
+	size_t periods;
+	size_t frame;
+	uint32_t errors;
+};
+
+static struct tdm_stream tx_stream_state;
+static struct tdm_stream rx_stream_state;
+
+static void on_tdm_tx_period(const struct device *dev, enum i2s_sync_status status, void *period,
+			     uint32_t timestamp, void *user_data)
+{
+	/* Refill with the frames following those still queued in the ring */
+	fill_tx(period, FRAMES, tx_stream_state.frame + (PERIODS * FRAMES));
+	tx_stream_state.frame += FRAMES;
+	tx_stream_state.periods++;
+}
+
+static void on_tdm_rx_period(const struct device *dev, enum i2s_sync_status status, void *period,
+			     uint32_t timestamp, void *user_data)
+{
+	rx_stream_state.errors += check_rx(period, FRAMES, rx_stream_state.frame);
+	rx_stream_state.frame += FRAMES;
+	rx_stream_state.periods++;
+}
+
+ZTEST(i2s_sync_emul_tdm, test_stream_throughput)
+{
+	/* Eight 32-bit slots in both directions, 12.3 Mbit/s each way at 48 kHz */
+	configure_tdm(8, 32, 0xff, 0xff, I2S_SYNC_LAYOUT_INTERLEAVED);
+
+	size_t const period_bytes = FRAMES * i2s_sync_frame_bytes(&tdm_cfg, I2S_DIR_TX);
+	struct i2s_sync_stream_config const tx = {
+		.buf = tx_buf,
+		.len = PERIODS * period_bytes,
+		.periods = PERIODS,
+		.cb = on_tdm_tx_period,
+	};
+	struct i2s_sync_stream_config const rx = {
+		.buf = rx_buf,
+		.len = PERIODS * period_bytes,
+		.periods = PERIODS,
+		.cb = on_tdm_rx_period,
+	};
+
+	memset(&tx_stream_state, 0, sizeof(tx_stream_state));
+	memset(&rx_stream_state, 0, sizeof(rx_stream_state));
+
+	for (size_t i = 0; i < PERIODS; i++) {
+		fill_tx((uint8_t *)tx_buf + (i * period_bytes), FRAMES, i * FRAMES);
+	}
+
+	int64_t const start_ms = k_uptime_get();
+
+	zassert_ok(i2s_sync_stream_start(i2s_dev, I2S_DIR_TX, &tx));
+	zassert_ok(i2s_sync_stream_start(i2s_dev, I2S_DIR_RX, &rx));
+
+	k_sleep(K_USEC(100500));
+	zassert_ok(i2s_sync_disable(i2s_dev, I2S_DIR_BOTH));
+
+	int64_t const elapsed_ms = k_uptime_get() - start_ms;
+	uint64_t const received = (uint64_t)rx_stream_state.periods * period_bytes;
+
+	TC_PRINT("%llu bytes received in %lld ms\n", received, elapsed_ms);
+
+	zassert_equal(rx_stream_state.periods, 100, "%zu periods received",
+		      rx_stream_state.periods);
+	zassert_equal(tx_stream_state.periods, 100, "%zu periods transmitted",
+		      tx_stream_state.periods);
+	zassert_equal(rx_stream_state.errors, 0, "%u samples received wrong",
+		      rx_stream_state.errors);
+}
+
+ZTEST_SUITE(i2s_sync_emul_tdm, NULL, i2s_sync_emul_tdm_setup, NULL, i2s_sync_emul_tdm_after,
+	    i2s_sync_emul_tdm_teardown);
@@ -0,0 +1,152 @@
+/* Copyright Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+/* WM8904 on the emulated I2C bus. Registers are 16 bits behind an 8-bit address, which
+ * auto-increments after each register written or read. Each transfer takes the time it would on
+ * the bus, so that the time taken by the driver can be measured on native_sim.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <string.h>
+
+#include "emul_wm8904.h"
+
+#define DT_DRV_COMPAT cirrus_wm8904
+
+#define REG_SW_RESET_AND_ID 0x00
+#define REG_DC_SERVO_1      0x44
+#define DEV_ID              0x8904
+
+/* Start, address byte with acknowledge, and stop or repeated start */
+#define TRANSFER_OVERHEAD_BITS 11
+#define BITS_PER_BYTE          9
+
+struct wm8904_emul_data {
+	uint16_t regs[256];
+	uint8_t addr;
+	struct wm8904_emul_stats stats;
+};
+
+struct wm8904_emul_cfg {
+	uint32_t bus_freq;
+};
+
+static void write_reg(struct wm8904_emul_data *const data, uint8_t const reg, uint16_t const value)
+{
+	data->stats.reg_writes++;
+
+	switch (reg) {
+	case REG_SW_RESET_AND_ID:
+		memset(data->regs, 0, sizeof(data->regs));
+		break;
+	case REG_DC_SERVO_1:
+		/* Start-up triggers clear themselves */
+		break;
+	default:
+		data->regs[reg] = value;
+		break;
+	}
+}
+
+static uint16_t read_reg(const struct wm8904_emul_data *const data, uint8_t const reg)
+{
+	return reg == REG_SW_RESET_AND_ID ? DEV_ID : data->regs[reg];
+}
+
+static int wm8904_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs,
+				int addr)
+{
+	const struct wm8904_emul_cfg *const cfg = target->cfg;
+	struct wm8904_emul_data *const data = target->data;
+	uint32_t bits = 0;
+
+	ARG_UNUSED(addr);
+
+	for (int i = 0; i < num_msgs; i++) {
+		struct i2c_msg *const msg = &msgs[i];
+
+		bits += TRANSFER_OVERHEAD_BITS + (msg->len * BITS_PER_BYTE);
+		data->stats.bytes += msg->len;
+
+		if (msg->flags & I2C_MSG_READ) {
+			for (uint32_t j = 0; j + 1 < msg->len; j += 2) {
+				uint16_t const value = read_reg(data, data->addr++);
+
+				msg->buf[j] = value >> 8;
+				msg->buf[j + 1] = value & 0xFF;
+			}
+			continue;
+		}
+
+		if (msg->len == 0) {
+			continue;
+		}
+
+		data->addr = msg->buf[0];
+
+		for (uint32_t j = 1; j + 1 < msg->len; j += 2) {
+			write_reg(data, data->addr++, ((uint16_t)msg->buf[j] << 8) | msg->buf[j + 1]);
+		}
+	}
+
+	uint32_t const bus_us = DIV_ROUND_UP(bits * USEC_PER_SEC, cfg->bus_freq);
+
+	data->stats.transfers++;
+	data->stats.bus_us += bus_us;
+	k_busy_wait(bus_us);
+
+	return 0;
+}
+
+void wm8904_emul_get_stats(const struct emul *target, struct wm8904_emul_stats *stats)
+{
+	const struct wm8904_emul_data *const data = target->data;
+
+	*stats = data->stats;
+}
+
+void wm8904_emul_clear_stats(const struct emul *target)
+{
+	struct wm8904_emul_data *const data = target->data;
+
+	memset(&data->stats, 0, sizeof(data->stats));
+}
+
+uint16_t wm8904_emul_get_reg(const struct emul *target, uint8_t reg)
+{
+	const struct wm8904_emul_data *const data = target->data;
+
+	return read_reg(data, reg);
+}
+
+static int wm8904_emul_init(const struct emul *target, const struct device *parent)
+{
+	ARG_UNUSED(target);
+	ARG_UNUSED(parent);
+
+	return 0;
+}
+
+static const struct i2c_emul_api wm8904_emul_api = {
+	.transfer = wm8904_emul_transfer,
+};
+
+#define WM8904_EMUL(n)                                                                             \
+	static struct wm8904_emul_data wm8904_emul_data_##n;                                       \
+	static const struct wm8904_emul_cfg wm8904_emul_cfg_##n = {                                \
+		.bus_freq = DT_PROP_OR(DT_INST_BUS(n), clock_frequency, I2C_BITRATE_STANDARD),     \
+	};                                                                                         \
+	EMUL_DT_INST_DEFINE(n, wm8904_emul_init, &wm8904_emul_data_##n, &wm8904_emul_cfg_##n,      \
+			    &wm8904_emul_api, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(WM8904_EMUL)
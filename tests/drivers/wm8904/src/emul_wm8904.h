@@ -0,0 +1,30 @@
+/* Copyright Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#ifndef EMUL_WM8904_H
+#define EMUL_WM8904_H
+
+#include <zephyr/drivers/emul.h>
+
+struct wm8904_emul_stats {
+	/* I2C transfers addressed to the codec */
+	uint32_t transfers;
+	/* Bytes transferred, excluding the address byte */
+	uint32_t bytes;
+	/* Registers written, counting each register of a burst */
+	uint32_t reg_writes;
+	/* Time the transfers take on the bus at its clock frequency */
+	uint32_t bus_us;
+};
+
+void wm8904_emul_get_stats(const struct emul *target, struct wm8904_emul_stats *stats);
+void wm8904_emul_clear_stats(const struct emul *target);
+uint16_t wm8904_emul_get_reg(const struct emul *target, uint8_t reg);
+
+#endif /* EMUL_WM8904_H */
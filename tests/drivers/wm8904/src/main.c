@@ -0,0 +1,175 @@
+/* Copyright Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/audio/codec.h>
+
+#include "emul_wm8904.h"
+
+#define CODEC_NODE DT_NODELABEL(audio_codec)
+
+#define REG_DAC_DIGITAL_1       0x21
+#define REG_ANALOGUE_OUT1_LEFT  0x39
+#define REG_ANALOGUE_OUT1_RIGHT 0x3A
+#define DAC_MUTE                BIT(3)
+#define OUT1_MUTE               BIT(8)
+#define OUT1_VOL_MASK           0x3F
+/* 0 dB */
+#define OUT1_VOL_DEFAULT        0x39
+
+static const struct device *const codec_dev = DEVICE_DT_GET(CODEC_NODE);
+static const struct emul *const codec_emul = EMUL_DT_GET(CODEC_NODE);
+
+static void print_stats(const char *what, uint32_t elapsed_us)
+{
+	struct wm8904_emul_stats stats;
+
+	wm8904_emul_get_stats(codec_emul, &stats);
+	TC_PRINT("%s: %u us, %u transfers, %u bytes, %u registers, %u us on the bus\n", what,
+		 elapsed_us, stats.transfers, stats.bytes, stats.reg_writes, stats.bus_us);
+}
+
+static uint32_t elapsed_us(uint32_t start_cycles)
+{
+	return (uint32_t)k_cyc_to_us_floor64(k_cycle_get_32() - start_cycles);
+}
+
+static void set_volume(int vol)
+{
+	audio_property_value_t const val = {.vol = vol};
+
+	zassert_ok(audio_codec_set_property(codec_dev, AUDIO_PROPERTY_OUTPUT_VOLUME,
+					    AUDIO_CHANNEL_ALL, val));
+}
+
+static void set_mute(bool mute)
+{
+	audio_property_value_t const val = {.mute = mute};
+
+	zassert_ok(audio_codec_set_property(codec_dev, AUDIO_PROPERTY_OUTPUT_MUTE,
+					    AUDIO_CHANNEL_ALL, val));
+}
+
+static void *wm8904_setup(void)
+{
+	zassert_true(device_is_ready(codec_dev));
+
+	return NULL;
+}
+
+static void wm8904_before(void *fixture)
+{
+	struct audio_codec_cfg cfg = {
+		.mclk_freq = 12288000,
+		.dai_type = AUDIO_DAI_TYPE_I2S,
+		.dai_cfg.i2s = {
+			.word_size = 16,
+			.channels = 2,
+			.format = I2S_FMT_DATA_FORMAT_I2S,
+			.frame_clk_freq = 48000,
+		},
+	};
+
+	ARG_UNUSED(fixture);
+
+	wm8904_emul_clear_stats(codec_emul);
+
+	uint32_t const start = k_cycle_get_32();
+
+	zassert_ok(audio_codec_configure(codec_dev, &cfg));
+	audio_codec_start_output(codec_dev);
+
+	/* Writes at the end of the start sequence are synchronised before it returns */
+	print_stats("Configure to first audio", elapsed_us(start));
+
+	wm8904_emul_clear_stats(codec_emul);
+}
+
+static void wm8904_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	audio_codec_stop_output(codec_dev);
+}
+
+ZTEST(wm8904, test_start_output)
+{
+	uint16_t const left = wm8904_emul_get_reg(codec_emul, REG_ANALOGUE_OUT1_LEFT);
+	uint16_t const right = wm8904_emul_get_reg(codec_emul, REG_ANALOGUE_OUT1_RIGHT);
+
+	zassert_equal(left & OUT1_VOL_MASK, OUT1_VOL_DEFAULT, "0x%04x", left);
+	zassert_equal(right & OUT1_VOL_MASK, OUT1_VOL_DEFAULT, "0x%04x", right);
+	zassert_false(left & OUT1_MUTE);
+	zassert_false(right & OUT1_MUTE);
+	zassert_false(wm8904_emul_get_reg(codec_emul, REG_DAC_DIGITAL_1) & DAC_MUTE);
+}
+
+ZTEST(wm8904, test_restart_batched)
+{
+	struct wm8904_emul_stats stats;
+
+	audio_codec_stop_output(codec_dev);
+	audio_codec_start_output(codec_dev);
+	wm8904_emul_get_stats(codec_emul, &stats);
+
+	/* Adjacent registers share a transfer */
+	if (IS_ENABLED(CONFIG_WM8904_I2C_BURST)) {
+		zassert_true(stats.transfers < stats.reg_writes, "%u transfers for %u registers",
+			     stats.transfers, stats.reg_writes);
+	} else {
+		zassert_equal(stats.transfers, stats.reg_writes);
+	}
+
+	zassert_false(wm8904_emul_get_reg(codec_emul, REG_DAC_DIGITAL_1) & DAC_MUTE);
+}
+
+ZTEST(wm8904, test_volume)
+{
+	struct wm8904_emul_stats stats;
+	uint32_t const start = k_cycle_get_32();
+
+	set_volume(0x40);
+	print_stats("Volume change", elapsed_us(start));
+
+	wm8904_emul_get_stats(codec_emul, &stats);
+	zassert_equal(stats.reg_writes, 2);
+	zassert_equal(stats.transfers, IS_ENABLED(CONFIG_WM8904_I2C_BURST) ? 1 : 2);
+	zassert_equal(wm8904_emul_get_reg(codec_emul, REG_ANALOGUE_OUT1_LEFT) & OUT1_VOL_MASK,
+		      0x20);
+	zassert_equal(wm8904_emul_get_reg(codec_emul, REG_ANALOGUE_OUT1_RIGHT) & OUT1_VOL_MASK,
+		      0x20);
+
+	/* Unchanged registers are not written again */
+	wm8904_emul_clear_stats(codec_emul);
+	set_volume(0x40);
+	wm8904_emul_get_stats(codec_emul, &stats);
+	zassert_equal(stats.transfers, 0);
+
+	set_volume(OUT1_VOL_DEFAULT << 1);
+}
+
+ZTEST(wm8904, test_mute)
+{
+	struct wm8904_emul_stats stats;
+
+	set_mute(true);
+	zassert_true(wm8904_emul_get_reg(codec_emul, REG_DAC_DIGITAL_1) & DAC_MUTE);
+
+	wm8904_emul_clear_stats(codec_emul);
+	set_mute(true);
+	wm8904_emul_get_stats(codec_emul, &stats);
+	zassert_equal(stats.transfers, 0);
+
+	set_mute(false);
+	zassert_false(wm8904_emul_get_reg(codec_emul, REG_DAC_DIGITAL_1) & DAC_MUTE);
+}
+
+ZTEST_SUITE(wm8904, NULL, wm8904_setup, wm8904_before, wm8904_after, NULL);
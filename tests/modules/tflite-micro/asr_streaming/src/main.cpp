@@ -0,0 +1,172 @@
+/* Copyright Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+/* Checks that the alif_asr sample runs the same inference windows when streaming as it does
+ * after capture, and reports the time from the end of the speech to the final result for clips
+ * of up to the ten seconds the sample records, with a fixed processing time per window.
+ */
+
+#include <zephyr/ztest.h>
+
+#include <cmath>
+
+#include "StreamingWindows.hpp"
+
+using arm::app::StreamingWindows;
+
+/* The Wav2Letter model of the sample */
+#define FRAME_LEN     512
+#define FRAME_STRIDE  160
+#define INPUT_ROWS    296
+#define CTX_LEN       98
+#define WINDOW_LEN    ((INPUT_ROWS - 1) * FRAME_STRIDE + FRAME_LEN)
+#define WINDOW_STRIDE ((INPUT_ROWS - 2 * CTX_LEN) * FRAME_STRIDE)
+
+/* The capture of the sample, in chunks of half a second */
+#define SAMPLE_RATE 16000
+#define CHUNK       (SAMPLE_RATE / 2)
+#define MAX_CHUNKS  20
+
+#define MAX_WINDOWS 16
+
+/* Time to pre-process, run and post-process a window, as a share of a chunk */
+#define WINDOW_COST_PERCENT 50
+
+struct clip_windows {
+	StreamingWindows::Window windows[MAX_WINDOWS];
+	size_t count;
+	/* Windows run once the last chunk of the clip is in */
+	size_t after_end;
+};
+
+/* The windows FractionalSlidingWindow makes over a whole clip */
+static void batch_windows(size_t length, clip_windows &out)
+{
+	const float strides = (length < WINDOW_LEN)
+				      ? 0.0f
+				      : static_cast<float>(length - WINDOW_LEN) / WINDOW_STRIDE;
+
+	out.count = 0;
+	for (size_t i = 0; i < 1 + strides; i++) {
+		const size_t start = i * WINDOW_STRIDE;
+		const size_t window_len = MIN(static_cast<size_t>(WINDOW_LEN), length - start);
+
+		out.windows[out.count++] = {i, start, window_len, i + 1 >= 1 + strides};
+	}
+	out.after_end = out.count;
+}
+
+/* The windows the sample runs while capturing a clip of chunks, and after */
+static void streamed_windows(size_t chunks, clip_windows &out)
+{
+	StreamingWindows windows(WINDOW_LEN, WINDOW_STRIDE);
+	StreamingWindows::Window window;
+
+	out.count = 0;
+	out.after_end = 0;
+
+	for (size_t chunk = 1; chunk <= chunks; chunk++) {
+		while (windows.Next(chunk * CHUNK, false, window)) {
+			zassert_true(out.count < MAX_WINDOWS);
+			out.windows[out.count++] = window;
+			out.after_end += (chunk == chunks) ? 1 : 0;
+		}
+	}
+
+	while (windows.Next(chunks * CHUNK, true, window)) {
+		zassert_true(out.count < MAX_WINDOWS);
+		out.windows[out.count++] = window;
+		out.after_end++;
+	}
+}
+
+ZTEST(asr_streaming, test_same_windows_as_batch)
+{
+	clip_windows batch, streamed;
+
+	for (size_t chunks = 1; chunks <= MAX_CHUNKS; chunks++) {
+		batch_windows(chunks * CHUNK, batch);
+		streamed_windows(chunks, streamed);
+
+		zassert_equal(streamed.count, batch.count, "%zu chunks", chunks);
+
+		for (size_t i = 0; i < batch.count; i++) {
+			const StreamingWindows::Window &b = batch.windows[i];
+			const StreamingWindows::Window &s = streamed.windows[i];
+
+			zassert_equal(s.index, b.index, "%zu chunks, window %zu", chunks, i);
+			zassert_equal(s.start, b.start, "%zu chunks, window %zu", chunks, i);
+			zassert_equal(s.length, b.length, "%zu chunks, window %zu", chunks, i);
+			zassert_equal(s.last, b.last, "%zu chunks, window %zu", chunks, i);
+		}
+
+		/* The last chunk can complete one window and end the next */
+		zassert_true(streamed.after_end <= 2, "%zu chunks: %zu windows after the end",
+			     chunks, streamed.after_end);
+	}
+}
+
+ZTEST(asr_streaming, test_windows_of_any_length)
+{
+	StreamingWindows windows(WINDOW_LEN, WINDOW_STRIDE);
+
+	for (size_t length = FRAME_LEN; length <= MAX_CHUNKS * CHUNK; length += 997) {
+		clip_windows batch;
+
+		batch_windows(length, batch);
+		zassert_equal(windows.TotalWindows(length), batch.count, "%zu samples", length);
+	}
+}
+
+/* Seconds from the end of the speech to the final result, with the audio arriving in real time
+ * and each window taking the same time to process
+ */
+static float time_to_final(size_t chunks, bool streaming)
+{
+	const float chunk_time = static_cast<float>(CHUNK) / SAMPLE_RATE;
+	const float window_time = chunk_time * WINDOW_COST_PERCENT / 100;
+	StreamingWindows windows(WINDOW_LEN, WINDOW_STRIDE);
+	StreamingWindows::Window window;
+	float now = 0.0f;
+
+	for (size_t chunk = 1; chunk <= chunks; chunk++) {
+		now = fmaxf(now, chunk * chunk_time);
+
+		while (streaming && windows.Next(chunk * CHUNK, false, window)) {
+			now += window_time;
+		}
+	}
+
+	while (windows.Next(chunks * CHUNK, true, window)) {
+		now += window_time;
+	}
+
+	return now - chunks * chunk_time;
+}
+
+ZTEST(asr_streaming, test_time_to_final)
+{
+	const float window_time = static_cast<float>(CHUNK) / SAMPLE_RATE * WINDOW_COST_PERCENT / 100;
+
+	TC_PRINT("speech (s)  batch (ms)  streaming (ms)\n");
+
+	for (size_t chunks = 2; chunks <= MAX_CHUNKS; chunks += 2) {
+		const float batch = time_to_final(chunks, false);
+		const float streaming = time_to_final(chunks, true);
+
+		TC_PRINT("%10u  %10u  %14u\n", unsigned(chunks * CHUNK / SAMPLE_RATE),
+			 unsigned(lroundf(batch * 1000)), unsigned(lroundf(streaming * 1000)));
+
+		/* Processing keeps up with the capture, so only the last chunk's windows are left */
+		zassert_true(streaming <= 2 * window_time + 1e-3f, "%zu chunks", chunks);
+		zassert_true(streaming <= batch + 1e-3f, "%zu chunks", chunks);
+	}
+}
+
+ZTEST_SUITE(asr_streaming, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,167 @@
+/* Copyright Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+/* Checks that readers of the audio capture ring read the captured samples in order across the
+ * wrap, and that a reader that falls behind skips ahead on its own, without affecting the others.
+ */
+
+#include <zephyr/ztest.h>
+
+#include "AudioRing.hpp"
+
+#define RING_SAMPLES 64
+#define BLOCK        8
+
+static int16_t ring[RING_SAMPLES];
+static uint32_t written;
+
+/* Capture a block, each sample holding its index in the stream */
+static void capture(uint32_t samples)
+{
+	for (uint32_t i = 0; i < samples; i++) {
+		ring[(written + i) % RING_SAMPLES] = static_cast<int16_t>(written + i);
+	}
+
+	written += samples;
+}
+
+static void open_reader(struct audio_reader *reader)
+{
+	reader->position = written;
+	reader->overruns = 0;
+}
+
+/* Read len samples and check that they are the next ones of the stream */
+static int read_next(struct audio_reader *reader, int len)
+{
+	const uint32_t position = reader->position;
+	uint32_t start;
+	int rc = audio_ring_claim(reader, written, RING_SAMPLES, BLOCK, len, &start);
+
+	if (rc <= 0) {
+		return rc;
+	}
+
+	for (int i = 0; i < rc; i++) {
+		zassert_equal(ring[start + i], static_cast<int16_t>(position + i), "sample %u",
+			      position + i);
+	}
+
+	if (audio_ring_release(reader, written, RING_SAMPLES, BLOCK, rc) < 0) {
+		return -EOVERFLOW;
+	}
+
+	return rc;
+}
+
+static void before(void *)
+{
+	written = 0;
+}
+
+ZTEST(audio_ring, test_wait_for_samples)
+{
+	struct audio_reader reader;
+
+	open_reader(&reader);
+	capture(BLOCK);
+
+	zassert_equal(read_next(&reader, 2 * BLOCK), 0);
+	zassert_equal(reader.position, 0);
+
+	capture(BLOCK);
+	zassert_equal(read_next(&reader, 2 * BLOCK), 2 * BLOCK);
+	zassert_equal(reader.position, 2 * BLOCK);
+}
+
+ZTEST(audio_ring, test_wrap)
+{
+	struct audio_reader reader;
+
+	/* Start a block before the end of the ring */
+	capture(RING_SAMPLES - BLOCK);
+	open_reader(&reader);
+	capture(3 * BLOCK);
+
+	/* The samples up to the end of the ring are contiguous, the rest follow from the start */
+	zassert_equal(read_next(&reader, 2 * BLOCK), BLOCK);
+	zassert_equal(read_next(&reader, BLOCK), BLOCK);
+	zassert_equal(read_next(&reader, BLOCK), BLOCK);
+	zassert_equal(reader.position, written);
+	zassert_equal(reader.overruns, 0);
+}
+
+ZTEST(audio_ring, test_overrun_per_reader)
+{
+	struct audio_reader fast, slow;
+
+	open_reader(&fast);
+	open_reader(&slow);
+
+	/* The slow reader reads once, then falls more than the ring behind */
+	capture(BLOCK);
+	zassert_equal(read_next(&slow, BLOCK), BLOCK);
+
+	for (int i = 0; i < RING_SAMPLES / BLOCK + 1; i++) {
+		capture(BLOCK);
+		zassert_equal(read_next(&fast, BLOCK), BLOCK, "block %d", i);
+	}
+
+	zassert_equal(read_next(&fast, BLOCK), 0);
+
+	/* Only the slow reader overruns, and it carries on from the newest audio */
+	zassert_equal(read_next(&slow, BLOCK), -EOVERFLOW);
+	zassert_equal(slow.position, written);
+	zassert_equal(slow.overruns, 1);
+	zassert_equal(fast.position, written);
+	zassert_equal(fast.overruns, 0);
+
+	capture(BLOCK);
+	zassert_equal(read_next(&slow, BLOCK), BLOCK);
+	zassert_equal(read_next(&fast, BLOCK), BLOCK);
+	zassert_equal(slow.overruns, 1);
+}
+
+ZTEST(audio_ring, test_overwritten_while_read)
+{
+	struct audio_reader reader;
+	uint32_t start;
+
+	open_reader(&reader);
+	capture(BLOCK);
+
+	zassert_equal(audio_ring_claim(&reader, written, RING_SAMPLES, BLOCK, BLOCK, &start),
+		      BLOCK);
+
+	/* The capture laps the claimed samples before the reader is done with them */
+	capture(RING_SAMPLES);
+
+	zassert_equal(audio_ring_release(&reader, written, RING_SAMPLES, BLOCK, BLOCK),
+		      -EOVERFLOW);
+	zassert_equal(reader.position, written);
+	zassert_equal(reader.overruns, 1);
+}
+
+ZTEST(audio_ring, test_last_block_before_overrun)
+{
+	struct audio_reader reader;
+
+	open_reader(&reader);
+
+	/* The next block lands on the oldest samples only once the ring is full */
+	capture(RING_SAMPLES - BLOCK);
+	zassert_equal(read_next(&reader, BLOCK), BLOCK);
+	zassert_equal(reader.overruns, 0);
+
+	capture(2 * BLOCK);
+	zassert_equal(read_next(&reader, BLOCK), -EOVERFLOW);
+	zassert_equal(reader.overruns, 1);
+}
+
+ZTEST_SUITE(audio_ring, NULL, NULL, before, NULL, NULL);
@@ -0,0 +1,215 @@
+/* Copyright Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+/* Checks that jobs run with their input and output in the tensor arena, that such jobs are
+ * failed once another model has been prepared in the same arena, and that the scheduler runs the
+ * jobs of two models by priority.
+ */
+
+#include <zephyr/ztest.h>
+
+#include <tensorflow/lite/schema/schema_generated.h>
+
+#include <cstring>
+#include <vector>
+
+#include "inference_process.hpp"
+#include "inference_scheduler.hpp"
+
+using namespace InferenceProcess;
+
+#define ARENA_SIZE (16 * 1024)
+
+static uint8_t tensor_arena[ARENA_SIZE] __aligned(16);
+
+/* The scheduler keeps its interpreter between tests, so it has an arena of its own */
+static uint8_t scheduler_arena[ARENA_SIZE] __aligned(16);
+static InferenceScheduler scheduler(scheduler_arena, sizeof(scheduler_arena));
+K_THREAD_STACK_DEFINE(scheduler_stack, 4096);
+
+/* A model without operators whose only tensor is both the input and the output */
+class IdentityModel {
+    public:
+	explicit IdentityModel(int32_t length)
+	{
+		using namespace tflite;
+		using flatbuffers::Offset;
+
+		const int32_t shape[] = {1, length};
+		const int32_t io[] = {0};
+		/* The first buffer is the empty one that tensors without data refer to */
+		const std::vector<Offset<Buffer>> buffers = {CreateBuffer(fbb)};
+		const std::vector<Offset<Tensor>> tensors = {CreateTensor(
+			fbb, fbb.CreateVector(shape, 2), TensorType_INT8, 0, fbb.CreateString("io"))};
+		const std::vector<Offset<SubGraph>> subgraphs = {CreateSubGraph(
+			fbb, fbb.CreateVector(tensors), fbb.CreateVector(io, 1),
+			fbb.CreateVector(io, 1), fbb.CreateVector(std::vector<Offset<Operator>>()))};
+		auto model = CreateModel(fbb, 3, fbb.CreateVector(std::vector<Offset<OperatorCode>>()),
+					 fbb.CreateVector(subgraphs), fbb.CreateString("identity"),
+					 fbb.CreateVector(buffers));
+
+		FinishModelBuffer(fbb, model);
+	}
+
+	DataPtr data()
+	{
+		return DataPtr(fbb.GetBufferPointer(), fbb.GetSize());
+	}
+
+    private:
+	flatbuffers::FlatBufferBuilder fbb;
+};
+
+static void fill(std::vector<int8_t> &buf, int8_t seed)
+{
+	for (size_t i = 0; i < buf.size(); i++) {
+		buf[i] = static_cast<int8_t>(seed + i);
+	}
+}
+
+ZTEST(ethosu_utils, test_in_place)
+{
+	InferenceProcess::InferenceProcess npu(tensor_arena, sizeof(tensor_arena));
+	IdentityModel model(16);
+	InferenceJob job;
+	std::vector<int8_t> input(16);
+
+	job.name = "in_place";
+	job.networkModel = model.data();
+
+	zassert_false(npu.getTensors(job));
+	zassert_equal(job.input.size(), 1);
+	zassert_equal(job.output.size(), 1);
+	zassert_equal(job.input[0].size, input.size());
+
+	const uint8_t *data = static_cast<const uint8_t *>(job.input[0].data);
+
+	zassert_true(data >= tensor_arena && data < tensor_arena + sizeof(tensor_arena));
+
+	for (int8_t seed = 0; seed < 3; seed++) {
+		fill(input, seed);
+		memcpy(job.input[0].data, input.data(), input.size());
+
+		zassert_false(npu.runJob(job), "run %d", seed);
+		zassert_mem_equal(job.output[0].data, input.data(), input.size(), "run %d", seed);
+	}
+}
+
+ZTEST(ethosu_utils, test_copy)
+{
+	InferenceProcess::InferenceProcess npu(tensor_arena, sizeof(tensor_arena));
+	IdentityModel model(16);
+	std::vector<int8_t> input(16), output(16);
+
+	fill(input, 7);
+
+	InferenceJob job("copy", model.data(), {DataPtr(input.data(), input.size())},
+			 {DataPtr(output.data(), output.size())}, {});
+
+	zassert_false(npu.runJob(job));
+	zassert_mem_equal(output.data(), input.data(), input.size());
+}
+
+ZTEST(ethosu_utils, test_stale_tensors)
+{
+	InferenceProcess::InferenceProcess npu(tensor_arena, sizeof(tensor_arena));
+	IdentityModel small(16), large(256);
+	std::vector<int8_t> input(256), output(256);
+	InferenceJob job;
+
+	job.name = "stale";
+	job.networkModel = small.data();
+	zassert_false(npu.getTensors(job));
+	zassert_false(npu.runJob(job));
+
+	/* Another model takes over the arena */
+	InferenceJob other("other", large.data(), {DataPtr(input.data(), input.size())},
+			   {DataPtr(output.data(), output.size())}, {});
+
+	zassert_false(npu.runJob(other));
+
+	/* Failed even if the model is prepared again with its tensor at the same address */
+	zassert_true(npu.runJob(job));
+
+	zassert_false(npu.getTensors(job));
+	zassert_false(npu.runJob(job));
+
+	/* Jobs that copy are not affected by the change of model */
+	zassert_false(npu.runJob(other));
+}
+
+struct completions {
+	ScheduledJob *order[4];
+	size_t count;
+	struct k_sem done;
+};
+
+static void job_done(ScheduledJob &job, void *userData)
+{
+	completions *c = static_cast<completions *>(userData);
+
+	c->order[c->count++] = &job;
+	k_sem_give(&c->done);
+}
+
+ZTEST(ethosu_utils, test_scheduler_priority)
+{
+	IdentityModel small(16), large(256);
+	std::vector<int8_t> in[4], out[4];
+	ScheduledJob jobs[4];
+	completions c = {};
+
+	k_sem_init(&c.done, 0, ARRAY_SIZE(jobs));
+
+	/* Background jobs of the large model, and urgent ones of the small model */
+	for (size_t i = 0; i < ARRAY_SIZE(jobs); i++) {
+		const bool urgent = (i % 2) != 0;
+		IdentityModel &model = urgent ? small : large;
+		const size_t len = urgent ? 16 : 256;
+
+		in[i].resize(len);
+		out[i].resize(len);
+		fill(in[i], static_cast<int8_t>(i * 16));
+
+		jobs[i] = ScheduledJob(urgent ? "urgent" : "background", model.data(),
+				       {DataPtr(in[i].data(), len)}, {DataPtr(out[i].data(), len)},
+				       {}, urgent ? 0 : 5, 0, job_done, &c);
+	}
+
+	/* Queue all jobs before the scheduler thread can take the first one */
+	k_sched_lock();
+	scheduler.start(scheduler_stack, K_THREAD_STACK_SIZEOF(scheduler_stack),
+			K_LOWEST_APPLICATION_THREAD_PRIO);
+	for (size_t i = 0; i < ARRAY_SIZE(jobs); i++) {
+		scheduler.submit(jobs[i]);
+	}
+	k_sched_unlock();
+
+	for (size_t i = 0; i < ARRAY_SIZE(jobs); i++) {
+		zassert_ok(k_sem_take(&c.done, K_SECONDS(5)), "job %zu", i);
+	}
+
+	/* Urgent jobs first, each priority in submission order */
+	zassert_equal(c.order[0], &jobs[1]);
+	zassert_equal(c.order[1], &jobs[3]);
+	zassert_equal(c.order[2], &jobs[0]);
+	zassert_equal(c.order[3], &jobs[2]);
+
+	for (size_t i = 0; i < ARRAY_SIZE(jobs); i++) {
+		zassert_false(jobs[i].status, "job %zu", i);
+		zassert_mem_equal(out[i].data(), in[i].data(), in[i].size(), "job %zu", i);
+	}
+
+	SchedulerStats stats = scheduler.getStats(true);
+
+	zassert_equal(stats.jobs, ARRAY_SIZE(jobs));
+	zassert_equal(stats.deadlineMisses, 0);
+}
+
+ZTEST_SUITE(ethosu_utils, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,248 @@
+/* Copyright Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+/* Compares the fixed-point KWS features with the float ones they replace, quantised as for the
+ * MicroNet model of the alif_inference sample, on half second clips of the kinds of sound the
+ * microphone picks up.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "MicroNetKwsMfcc.hpp"
+#include "arm_math.h"
+
+using arm::app::audio::MicroNetKwsFixedPointMFCC;
+using arm::app::audio::MicroNetKwsMFCC;
+
+#define SAMPLE_RATE  16000
+#define CLIP_LEN     (SAMPLE_RATE / 2)
+#define FRAME_LEN    640
+#define FRAME_STRIDE 320
+#define NUM_FEATURES 10
+/* FFT points, FRAME_LEN padded to a power of two */
+#define FFT_LEN      1024
+
+/* Input quantisation of the model */
+#define QUANT_SCALE  0.20109497f
+#define QUANT_OFFSET -5
+
+/* Largest and mean difference allowed, in quantisation steps */
+#define MAX_ERROR        2
+#define MEAN_ERROR_MILLI 100
+
+/* Self-noise of a microphone, without which the bands between pure tones hold only rounding */
+#define NOISE_FLOOR 4.0f
+
+static int16_t clip[CLIP_LEN];
+static uint32_t noise_state;
+
+static MicroNetKwsMFCC *reference;
+static MicroNetKwsFixedPointMFCC *fixed;
+
+/* Uniform in [-1, 1) */
+static float noise(void)
+{
+	noise_state = noise_state * 1664525u + 1013904223u;
+
+	return (noise_state >> 8) / 8388608.0f - 1.0f;
+}
+
+static float sine(float freq, size_t i)
+{
+	return sinf(2.0f * float(M_PI) * freq * i / SAMPLE_RATE);
+}
+
+static void store(size_t i, float value)
+{
+	clip[i] = static_cast<int16_t>(std::fmin(std::fmax(value, -32768.0f), 32767.0f));
+}
+
+static void compare_clip(const char *name)
+{
+	std::vector<int16_t> frame(FRAME_LEN);
+	uint32_t max_error = 0;
+	uint32_t total_error = 0;
+	uint32_t count = 0;
+	uint32_t reference_cycles = 0;
+	uint32_t fixed_cycles = 0;
+	uint32_t frames = 0;
+
+	for (size_t start = 0; start + FRAME_LEN <= CLIP_LEN; start += FRAME_STRIDE) {
+		int8_t features[NUM_FEATURES];
+
+		frame.assign(&clip[start], &clip[start + FRAME_LEN]);
+
+		uint32_t cycles = k_cycle_get_32();
+		const std::vector<int8_t> expected =
+			reference->MfccComputeQuant<int8_t>(frame, QUANT_SCALE, QUANT_OFFSET);
+
+		reference_cycles += k_cycle_get_32() - cycles;
+
+		cycles = k_cycle_get_32();
+		zassert_true(fixed->MfccComputeQuant(&clip[start], features));
+		fixed_cycles += k_cycle_get_32() - cycles;
+
+		for (size_t i = 0; i < NUM_FEATURES; i++) {
+			const uint32_t error = std::abs(expected[i] - features[i]);
+
+			max_error = MAX(max_error, error);
+			total_error += error;
+			count++;
+		}
+
+		frames++;
+	}
+
+	const uint32_t mean_error_milli = total_error * 1000 / count;
+
+	TC_PRINT("%s: max error %u, mean error 0.%03u, %u us float, %u us fixed point per frame\n",
+		 name, max_error, mean_error_milli,
+		 k_cyc_to_us_floor32(reference_cycles / frames),
+		 k_cyc_to_us_floor32(fixed_cycles / frames));
+
+	zassert_true(max_error <= MAX_ERROR, "%s: max error %u", name, max_error);
+	zassert_true(mean_error_milli <= MEAN_ERROR_MILLI, "%s: mean error 0.%03u", name,
+		     mean_error_milli);
+}
+
+static void *kws_mfcc_setup(void)
+{
+	static MicroNetKwsMFCC reference_mfcc(NUM_FEATURES, FRAME_LEN);
+	static MicroNetKwsFixedPointMFCC fixed_mfcc(NUM_FEATURES, FRAME_LEN);
+
+	reference_mfcc.Init();
+	zassert_true(fixed_mfcc.Init());
+	fixed_mfcc.SetQuantParams(QUANT_SCALE, QUANT_OFFSET);
+
+	reference = &reference_mfcc;
+	fixed = &fixed_mfcc;
+
+	return NULL;
+}
+
+static void kws_mfcc_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	noise_state = 1;
+}
+
+/* The fixed-point features take arm_rfft_q31 to scale its output down by the FFT length, which the
+ * float reference cannot catch if a stand-in FFT makes the same assumption. A DC input of a quarter
+ * of full range gives FFT_LEN / 4 in bin 0, which is 2^29 with 31 - log2(FFT_LEN) fractional bits.
+ */
+ZTEST(kws_mfcc, test_fft_scale)
+{
+	static q31_t input[FFT_LEN];
+	static q31_t spectrum[2 * FFT_LEN];
+	arm_rfft_instance_q31 rfft;
+
+	zassert_equal(arm_rfft_init_q31(&rfft, FFT_LEN, 0, 1), ARM_MATH_SUCCESS);
+
+	for (size_t i = 0; i < FFT_LEN; i++) {
+		input[i] = 1 << 29;
+	}
+
+	arm_rfft_q31(&rfft, input, spectrum);
+
+	zassert_within(spectrum[0], 1 << 29, 1 << 16, "Bin 0 is %d", spectrum[0]);
+	zassert_within(spectrum[2], 0, 1 << 16, "Bin 1 is %d", spectrum[2]);
+}
+
+ZTEST(kws_mfcc, test_silence)
+{
+	for (size_t i = 0; i < CLIP_LEN; i++) {
+		store(i, 0.0f);
+	}
+
+	compare_clip("silence");
+}
+
+ZTEST(kws_mfcc, test_background_noise)
+{
+	for (size_t i = 0; i < CLIP_LEN; i++) {
+		store(i, 64.0f * noise());
+	}
+
+	compare_clip("background noise");
+}
+
+ZTEST(kws_mfcc, test_loud_noise)
+{
+	for (size_t i = 0; i < CLIP_LEN; i++) {
+		store(i, 6000.0f * noise());
+	}
+
+	compare_clip("loud noise");
+}
+
+ZTEST(kws_mfcc, test_tones)
+{
+	for (size_t i = 0; i < CLIP_LEN; i++) {
+		store(i, 8000.0f * sine(1000.0f, i) + 4000.0f * sine(300.0f, i) +
+			 NOISE_FLOOR * noise());
+	}
+
+	compare_clip("tones");
+}
+
+/* Full scale sweep from 100 Hz to 7 kHz */
+ZTEST(kws_mfcc, test_sweep)
+{
+	for (size_t i = 0; i < CLIP_LEN; i++) {
+		const float t = static_cast<float>(i) / SAMPLE_RATE;
+
+		store(i, 30000.0f * sinf(2.0f * float(M_PI) * (100.0f * t + 6900.0f * t * t)) +
+			 NOISE_FLOOR * noise());
+	}
+
+	compare_clip("sweep");
+}
+
+/* Vowel-like: a gliding pulse train through two formant resonators, in syllables */
+ZTEST(kws_mfcc, test_voiced)
+{
+	const float r = 0.97f;
+	const float a1 = 2.0f * r * cosf(2.0f * float(M_PI) * 700.0f / SAMPLE_RATE);
+	const float b1 = 2.0f * r * cosf(2.0f * float(M_PI) * 1200.0f / SAMPLE_RATE);
+	const float a2 = -r * r;
+	float phase = 0.0f;
+	float y1 = 0.0f, y2 = 0.0f, z1 = 0.0f, z2 = 0.0f;
+
+	for (size_t i = 0; i < CLIP_LEN; i++) {
+		const float t = static_cast<float>(i) / SAMPLE_RATE;
+		const float pitch = 110.0f + 30.0f * sine(3.0f, i);
+		float pulse = 0.0f;
+
+		phase += pitch / SAMPLE_RATE;
+		if (phase >= 1.0f) {
+			phase -= 1.0f;
+			pulse = 20000.0f;
+		}
+
+		const float y = pulse + 200.0f * noise() + a1 * y1 + a2 * y2;
+		const float z = 0.3f * y + b1 * z1 + a2 * z2;
+
+		y2 = y1;
+		y1 = y;
+		z2 = z1;
+		z1 = z;
+
+		store(i, 0.01f * (1.0f - cosf(8.0f * float(M_PI) * t)) * z);
+	}
+
+	compare_clip("voiced");
+}
+
+ZTEST_SUITE(kws_mfcc, NULL, kws_mfcc_setup, kws_mfcc_before, NULL, NULL);
@@ -0,0 +1,127 @@
+/* Copyright Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+/* Checks that the streaming KWS features of each window match those computed over the whole
+ * window, as the sample did before streaming, with silence before the first stride and again
+ * after a restart.
+ */
+
+#include <zephyr/ztest.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "KwsFeatureStream.hpp"
+
+using arm::app::KwsFeatureStream;
+using arm::app::audio::MicroNetKwsFixedPointMFCC;
+
+#define SAMPLE_RATE   16000
+#define AUDIO_STRIDE  (SAMPLE_RATE / 2)
+#define FRAME_LEN     640
+#define FRAME_STRIDE  320
+#define NUM_FEATURES  10
+#define NUM_FRAMES    49
+#define WINDOW_LEN    (NUM_FRAMES * FRAME_STRIDE + FRAME_LEN - FRAME_STRIDE)
+#define NUM_STRIDES   5
+
+#define QUANT_SCALE  0.20109497f
+#define QUANT_OFFSET -5
+
+/* Silence for the part of the first window before the first stride, then the strides */
+static int16_t audio[WINDOW_LEN - AUDIO_STRIDE + NUM_STRIDES * AUDIO_STRIDE];
+
+/* A tone that rises in pitch and level over noise, so that no two strides are alike */
+static const int16_t *fill_strides(void)
+{
+	int16_t *strides = &audio[WINDOW_LEN - AUDIO_STRIDE];
+	uint32_t noise_state = 1;
+
+	for (size_t i = 0; i < NUM_STRIDES * AUDIO_STRIDE; i++) {
+		const float t = static_cast<float>(i) / SAMPLE_RATE;
+
+		noise_state = noise_state * 1664525u + 1013904223u;
+		strides[i] = static_cast<int16_t>(
+			4000.0f * t * sinf(2.0f * float(M_PI) * (200.0f + 300.0f * t) * t) +
+			static_cast<float>(static_cast<int32_t>(noise_state) >> 24));
+	}
+
+	return strides;
+}
+
+ZTEST(kws_feature_stream, test_matches_window)
+{
+	static KwsFeatureStream stream(NUM_FEATURES, NUM_FRAMES, FRAME_LEN, FRAME_STRIDE,
+				       AUDIO_STRIDE);
+	static MicroNetKwsFixedPointMFCC mfcc(NUM_FEATURES, FRAME_LEN);
+	std::vector<int8_t> features(NUM_FRAMES * NUM_FEATURES);
+	std::vector<int8_t> expected(NUM_FRAMES * NUM_FEATURES);
+	const int16_t *strides = fill_strides();
+
+	zassert_true(stream.Init(QUANT_SCALE, QUANT_OFFSET));
+	zassert_true(mfcc.Init());
+	mfcc.SetQuantParams(QUANT_SCALE, QUANT_OFFSET);
+
+	for (size_t stride = 0; stride < NUM_STRIDES; stride++) {
+		const int16_t *window = &audio[stride * AUDIO_STRIDE];
+
+		std::memcpy(stream.GetAudioBuffer(), &strides[stride * AUDIO_STRIDE],
+			    AUDIO_STRIDE * sizeof(int16_t));
+		zassert_true(stream.Update());
+		stream.CopyFeatures(features.data());
+
+		for (size_t frame = 0; frame < NUM_FRAMES; frame++) {
+			zassert_true(mfcc.MfccComputeQuant(&window[frame * FRAME_STRIDE],
+							   &expected[frame * NUM_FEATURES]));
+		}
+
+		zassert_mem_equal(features.data(), expected.data(), features.size(),
+				  "window %u differs", unsigned(stride));
+	}
+}
+
+ZTEST(kws_feature_stream, test_restart)
+{
+	static KwsFeatureStream stream(NUM_FEATURES, NUM_FRAMES, FRAME_LEN, FRAME_STRIDE,
+				       AUDIO_STRIDE);
+	std::vector<int8_t> first(NUM_FRAMES * NUM_FEATURES);
+	std::vector<int8_t> features(NUM_FRAMES * NUM_FEATURES);
+	const int16_t *strides = fill_strides();
+
+	zassert_true(stream.Init(QUANT_SCALE, QUANT_OFFSET));
+
+	for (size_t stride = 0; stride < NUM_STRIDES; stride++) {
+		std::memcpy(stream.GetAudioBuffer(), &strides[stride * AUDIO_STRIDE],
+			    AUDIO_STRIDE * sizeof(int16_t));
+		zassert_true(stream.Update());
+
+		if (stride == 0) {
+			stream.CopyFeatures(first.data());
+		}
+	}
+
+	/* The first stride again after a gap, with the stride already written */
+	std::memcpy(stream.GetAudioBuffer(), strides, AUDIO_STRIDE * sizeof(int16_t));
+	stream.Restart();
+	zassert_true(stream.Update());
+	stream.CopyFeatures(features.data());
+
+	zassert_mem_equal(features.data(), first.data(), features.size());
+}
+
+ZTEST(kws_feature_stream, test_stride_not_multiple_of_frame_stride)
+{
+	static KwsFeatureStream stream(NUM_FEATURES, NUM_FRAMES, FRAME_LEN, FRAME_STRIDE,
+				       AUDIO_STRIDE + 1);
+
+	zassert_false(stream.Init(QUANT_SCALE, QUANT_OFFSET));
+}
+
+ZTEST_SUITE(kws_feature_stream, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,297 @@
+/* Copyright Alif Semiconductor - All Rights Reserved.
+ * Use, distribution and modification of this code is permitted under the
+ * terms stated in the Alif Semiconductor Software License Agreement
+ *
+ * You should have received a copy of the Alif Semiconductor Software
+ * License Agreement with this file. If not, please write to:
+ * contact@alifsemi.com, or visit: https://alifsemi.com/license
+ */
+
+/* Runs the voice activity gate of the alif_inference sample over a minute of background sound
+ * with keywords in it, half a second at a time as the sample does, and reports how much of it the
+ * gate skips and how many keywords it keeps from the model.
+ */
+
+#include <zephyr/ztest.h>
+
+#include <cmath>
+
+#include "VadGatedInput.h"
+
+#define SAMPLE_RATE   16000
+#define STRIDE        (SAMPLE_RATE / 2)
+#define SCENE_STRIDES 120
+#define SCENE_LEN     (SCENE_STRIDES * STRIDE)
+
+/* A keyword is missed if a stride holding this much of it is gated */
+#define KEYWORD_MIN_OVERLAP (SAMPLE_RATE / 10)
+
+#define MAX_KEYWORDS 32
+
+/* The defaults of the sample */
+static const VoiceActivityDetector::Config vad_config = {
+	.frameLength = SAMPLE_RATE / 50,
+	.marginDb = 9,
+	.minLevelDbfs = -60,
+	.zcrMaxPercent = 40,
+	.minSpeechFrames = 2,
+	.hangover = 2,
+};
+
+struct scene {
+	const char *name;
+	/* Uniform noise amplitude before and after the middle of the scene */
+	float noise_level[2];
+	/* One-pole low-pass coefficient of the noise, 0 for white noise */
+	float noise_lowpass;
+	/* Peak of the voiced part of the keywords */
+	float keyword_level;
+	/* Least percentage of strides the gate must skip */
+	uint32_t min_gated_percent;
+};
+
+struct keyword {
+	size_t start;
+	size_t length;
+};
+
+static const scene *current_scene;
+static keyword keywords[MAX_KEYWORDS];
+static size_t num_keywords;
+static uint32_t rand_state;
+
+/* Synthesis state, carried across strides */
+static size_t next_stride;
+static uint32_t stride_sums[SCENE_STRIDES];
+static float noise_lp;
+static float phase, res1[2], res2[2], hp;
+
+/* Uniform in [-1, 1) */
+static float noise(void)
+{
+	rand_state = rand_state * 1664525u + 1013904223u;
+
+	return (rand_state >> 8) / 8388608.0f - 1.0f;
+}
+
+/* Keywords of 0.4 to 0.7 seconds, 6 to 10 seconds apart */
+static void place_keywords(void)
+{
+	size_t start = SAMPLE_RATE + static_cast<size_t>(SAMPLE_RATE * (1.0f + noise()));
+
+	while (num_keywords < MAX_KEYWORDS) {
+		const size_t length = static_cast<size_t>(SAMPLE_RATE * (0.55f + 0.15f * noise()));
+
+		if (start + length > SCENE_LEN) {
+			break;
+		}
+
+		keywords[num_keywords++] = {start, length};
+		start += length + static_cast<size_t>(SAMPLE_RATE * (8.0f + 2.0f * noise()));
+	}
+}
+
+/* An unvoiced onset, then a gliding pulse train through two formant resonators */
+static float keyword_sample(const keyword &kw, size_t i, float level)
+{
+	const float r = 0.97f;
+	const float a1 = 2.0f * r * cosf(2.0f * float(M_PI) * 650.0f / SAMPLE_RATE);
+	const float b1 = 2.0f * r * cosf(2.0f * float(M_PI) * 1700.0f / SAMPLE_RATE);
+	const float a2 = -r * r;
+	const size_t pos = i - kw.start;
+	const size_t onset = kw.length / 6;
+
+	if (pos < onset) {
+		const float n = noise();
+		const float fricative = n - hp;
+
+		hp = n;
+
+		return 0.1f * level * sinf(float(M_PI) * pos / onset) * fricative;
+	}
+
+	const float t = static_cast<float>(pos - onset) / (kw.length - onset);
+	const float pitch = 120.0f + 40.0f * t;
+	float pulse = 0.0f;
+
+	phase += pitch / SAMPLE_RATE;
+	if (phase >= 1.0f) {
+		phase -= 1.0f;
+		pulse = 1.0f;
+	}
+
+	const float y = pulse + a1 * res1[0] + a2 * res1[1];
+	const float z = 0.3f * y + b1 * res2[0] + a2 * res2[1];
+
+	res1[1] = res1[0];
+	res1[0] = y;
+	res2[1] = res2[0];
+	res2[0] = z;
+
+	return 0.25f * level * sinf(float(M_PI) * t) * z;
+}
+
+static void synthesise_stride(const scene &sc, size_t stride, int16_t *stride_buf)
+{
+	size_t kw = 0;
+
+	for (size_t n = 0; n < STRIDE; n++) {
+		const size_t i = stride * STRIDE + n;
+		const float level = sc.noise_level[(i < SCENE_LEN / 2) ? 0 : 1];
+
+		noise_lp = sc.noise_lowpass * noise_lp + (1.0f - sc.noise_lowpass) * noise();
+
+		float value = level * ((sc.noise_lowpass > 0.0f) ? 4.0f * noise_lp : noise_lp);
+
+		while (kw < num_keywords && keywords[kw].start + keywords[kw].length <= i) {
+			kw++;
+		}
+
+		if (kw < num_keywords && i >= keywords[kw].start) {
+			value += keyword_sample(keywords[kw], i, sc.keyword_level);
+		}
+
+		stride_buf[n] = static_cast<int16_t>(fminf(fmaxf(value, -32768.0f), 32767.0f));
+	}
+}
+
+/* Tells the strides apart once they went through the gate */
+static uint32_t checksum(const int16_t *samples)
+{
+	uint32_t sum = 0;
+
+	for (size_t n = 0; n < STRIDE; n++) {
+		sum = sum * 31 + static_cast<uint16_t>(samples[n]);
+	}
+
+	return sum;
+}
+
+/* The current scene, in place of the microphone */
+class SceneInput
+{
+public:
+	static constexpr size_t OutputSize = STRIDE * sizeof(int16_t);
+
+	bool Start()
+	{
+		return true;
+	}
+
+	bool Stop()
+	{
+		return true;
+	}
+
+	bool GetInputData(void *buffer)
+	{
+		int16_t *samples = static_cast<int16_t *>(buffer);
+
+		if (next_stride == SCENE_STRIDES) {
+			return false;
+		}
+
+		synthesise_stride(*current_scene, next_stride, samples);
+		stride_sums[next_stride++] = checksum(samples);
+
+		return true;
+	}
+
+	bool Discontinuous() const
+	{
+		return false;
+	}
+};
+
+static void run_scene(const scene &sc)
+{
+	static VadGatedInput<SceneInput> input(vad_config);
+	static int16_t buffer[STRIDE];
+	bool active[SCENE_STRIDES] = {};
+	uint32_t passed = 0;
+	uint32_t missed = 0;
+	size_t next_passed = 0;
+
+	current_scene = &sc;
+	next_stride = 0;
+	rand_state = 1;
+	noise_lp = phase = hp = 0.0f;
+	res1[0] = res1[1] = res2[0] = res2[1] = 0.0f;
+	num_keywords = 0;
+
+	if (sc.keyword_level > 0.0f) {
+		place_keywords();
+	}
+
+	zassert_true(input.Start());
+	input.GetStats(true);
+
+	while (input.GetInputData(buffer)) {
+		const uint32_t sum = checksum(buffer);
+		size_t stride = 0;
+
+		while (stride < next_stride && (stride_sums[stride] != sum || active[stride])) {
+			stride++;
+		}
+
+		zassert_true(stride < next_stride, "%s: unknown stride passed", sc.name);
+		active[stride] = true;
+		passed++;
+
+		/* The model starts over from silence when the gate dropped the strides before */
+		zassert_equal(input.Discontinuous(), stride != next_passed,
+			      "%s: stride %zu after %zu", sc.name, stride, next_passed);
+		next_passed = stride + 1;
+	}
+
+	const VadGateStats stats = input.GetStats();
+
+	zassert_equal(stats.strides, SCENE_STRIDES);
+	zassert_equal(stats.gated, SCENE_STRIDES - passed);
+
+	for (size_t k = 0; k < num_keywords; k++) {
+		const size_t start = keywords[k].start;
+		const size_t end = start + keywords[k].length;
+
+		for (size_t stride = start / STRIDE; stride * STRIDE < end; stride++) {
+			const size_t overlap =
+				MIN(end, (stride + 1) * STRIDE) - MAX(start, stride * STRIDE);
+
+			if (overlap >= KEYWORD_MIN_OVERLAP && !active[stride]) {
+				missed++;
+				break;
+			}
+		}
+	}
+
+	const uint32_t gated_percent = stats.gated * 100 / SCENE_STRIDES;
+
+	TC_PRINT("%s: %u of %u strides gated (%u%%), %u of %u keywords missed\n", sc.name,
+		 stats.gated, SCENE_STRIDES, gated_percent, missed, unsigned(num_keywords));
+
+	zassert_equal(missed, 0, "%s: %u keywords missed", sc.name, missed);
+	zassert_true(gated_percent >= sc.min_gated_percent, "%s: only %u%% gated", sc.name,
+		     gated_percent);
+}
+
+ZTEST(kws_vad, test_quiet_room)
+{
+	run_scene({"quiet room", {60.0f, 60.0f}, 0.0f, 6000.0f, 60});
+}
+
+ZTEST(kws_vad, test_fan_noise)
+{
+	run_scene({"fan noise", {1500.0f, 1500.0f}, 0.9f, 12000.0f, 60});
+}
+
+ZTEST(kws_vad, test_noise_step)
+{
+	run_scene({"noise step", {60.0f, 800.0f}, 0.0f, 10000.0f, 55});
+}
+
+ZTEST(kws_vad, test_silence)
+{
+	run_scene({"silence", {0.0f, 0.0f}, 0.0f, 0.0f, 100});
+}
+
+ZTEST_SUITE(kws_vad, NULL, NULL, NULL, NULL, NULL);